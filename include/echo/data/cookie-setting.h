@@ -123,6 +123,19 @@ class CookieSetting : public Cookie {
                 std::string domain, std::string comment, int maxAge, bool secure,
                 bool accessRestricted);
 
+  /**
+   * Constructor copying the properties of a prototype with another value. The
+   * formatted "Set-Cookie" attributes of the prototype are reused, which
+   * suits cookies sharing fixed attributes, such as session cookies.
+   * 
+   * @param prototype
+   *            The cookie setting to copy.
+   * @param value
+   *            The cookie's value.
+   * @see #getHeaderAttributes()
+   */
+  CookieSetting(CookieSetting prototype, std::string value);
+
   /**
    * Preferred constructor.
    * 
@@ -157,6 +170,27 @@ class CookieSetting : public Cookie {
     return "Cookie setting";
   }
 
+  /**
+   * Returns the attributes part of the "Set-Cookie" header value, starting
+   * with a "; " separator. It only depends on the version, path, domain,
+   * comment, maximum age, secure and access restriction properties, so it is
+   * formatted once and reused across responses until one of them changes.
+   * This suits cookie settings reused for many clients, such as session
+   * cookies with fixed attributes.
+   * 
+   * @return The attributes part of the "Set-Cookie" header value.
+   */
+  std::string getHeaderAttributes();
+
+  /**
+   * Returns the "Set-Cookie" header value, made of the name and value
+   * followed by the cached attributes.
+   * 
+   * @return The "Set-Cookie" header value.
+   * @see #getHeaderAttributes()
+   */
+  std::string getHeaderValue();
+
   /**
    * Returns the maximum age in seconds.<br>
    * Use 0 to immediately discard an existing cookie.<br>
@@ -202,6 +236,7 @@ class CookieSetting : public Cookie {
    */
   void setAccessRestricted(bool accessRestricted) {
     this->accessRestricted = accessRestricted;
+    this->headerAttributes = NULL;
   }
 
   /**
@@ -212,6 +247,14 @@ class CookieSetting : public Cookie {
    */
   void setComment(std::string comment) {
     this->comment = comment;
+    this->headerAttributes = NULL;
+  }
+
+  /** {@inheritDoc} */
+  //@Override
+  void setDomain(std::string domain) {
+    super.setDomain(domain);
+    this->headerAttributes = NULL;
   }
 
   /**
@@ -224,6 +267,14 @@ class CookieSetting : public Cookie {
    */
   void setMaxAge(int maxAge) {
     this->maxAge = maxAge;
+    this->headerAttributes = NULL;
+  }
+
+  /** {@inheritDoc} */
+  //@Override
+  void setPath(std::string path) {
+    super.setPath(path);
+    this->headerAttributes = NULL;
   }
 
   /**
@@ -234,6 +285,14 @@ class CookieSetting : public Cookie {
    */
   void setSecure(bool secure) {
     this->secure = secure;
+    this->headerAttributes = NULL;
+  }
+
+  /** {@inheritDoc} */
+  //@Override
+  void setVersion(int version) {
+    super.setVersion(version);
+    this->headerAttributes = NULL;
   }
 
 
@@ -248,6 +307,9 @@ class CookieSetting : public Cookie {
   /** The user's comment. */
   volatile std::string comment;
 
+  /** The cached attributes part of the "Set-Cookie" header value. */
+  volatile std::string headerAttributes;
+
   /**
    * The maximum age in seconds. Use 0 to discard an existing cookie.
    */
@@ -601,7 +601,7 @@ class Status {
    * @return True if the status is a client error status.
    */
   static bool isClientError(int code) {
-    return (code >= 400) && (code <= 499);
+    return static_cast<unsigned int>(code - 400) < 100u;
   }
 
   /**
@@ -613,7 +613,7 @@ class Status {
    * @return True if the status is a server error status.
    */
   static bool isConnectorError(int code) {
-    return (code >= 1000) && (code <= 1099);
+    return static_cast<unsigned int>(code - 1000) < 100u;
   }
 
   /**
@@ -634,9 +634,22 @@ class Status {
    * @return True if the status is an information status.
    */
   static bool isInformational(int code) {
-    return (code >= 100) && (code <= 199);
+    return static_cast<unsigned int>(code - 100) < 100u;
   }
 
+  /**
+   * Indicates if an error is recoverable, meaning that simply retrying after
+   * a delay could result in a success. Tests {@link #isConnectorError(int)}
+   * and if the status is {@link #CLIENT_ERROR_REQUEST_TIMEOUT} or
+   * {@link #SERVER_ERROR_GATEWAY_TIMEOUT} or
+   * {@link #SERVER_ERROR_SERVICE_UNAVAILABLE}.
+   * 
+   * @param code
+   *            The code of the status.
+   * @return True if the error is recoverable.
+   */
+  static bool isRecoverableError(int code);
+
   /**
    * Indicates if the status is a redirection status, meaning "Further action
    * must be taken in order to complete the request".
@@ -646,7 +659,7 @@ class Status {
    * @return True if the status is a redirection status.
    */
   static bool isRedirection(int code) {
-    return (code >= 300) && (code <= 399);
+    return static_cast<unsigned int>(code - 300) < 100u;
   }
 
   /**
@@ -658,7 +671,7 @@ class Status {
    * @return True if the status is a server error status.
    */
   static bool isServerError(int code) {
-    return (code >= 500) && (code <= 599);
+    return static_cast<unsigned int>(code - 500) < 100u;
   }
 
   /**
@@ -670,7 +683,7 @@ class Status {
    * @return True if the status is a success status.
    */
   static bool isSuccess(int code) {
-    return (code >= 200) && (code <= 299);
+    return static_cast<unsigned int>(code - 200) < 100u;
   }
 
   /**
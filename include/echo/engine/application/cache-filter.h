@@ -0,0 +1,171 @@
+#ifndef _ECHO_ENGINE_APPLICATION_CACHE_FILTER_H_
+#define _ECHO_ENGINE_APPLICATION_CACHE_FILTER_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include <echo/context.h>
+#include <echo/echo.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/engine/application/response-cache.h>
+#include <echo/routing/filter.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+/**
+ * Filter serving responses from a shared {@link ResponseCache}, as a shared
+ * HTTP cache would. Fresh hits are served without invoking the next Echo;
+ * conditional requests are answered from the cached tag and modification
+ * date.<br>
+ * <br>
+ * Responses to GET requests are stored when they have an explicit freshness
+ * lifetime given by the "s-maxage" or "max-age" directives or by the
+ * expiration date of their entity, and when neither the request nor the
+ * response carries a "no-store" directive. Responses marked "private" or
+ * "no-cache", responses setting cookies and responses to authenticated
+ * requests not explicitly marked "public" or "s-maxage" are never stored,
+ * and neither are transient entities, entities of unknown size and entities
+ * larger than {@link #getMaxEntitySize()}, which are passed through untouched.
+ * <br>
+ * <br>
+ * The variants of a resource are keyed by the resource reference plus the
+ * request values of the dimensions returned by
+ * {@link Response#getDimensions()}. Responses varying on the client address,
+ * the time, the authorization or unspecified dimensions can't be keyed and
+ * aren't stored. Successful unsafe requests invalidate the variants of their
+ * resource.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ *
+ * @see ResponseCache
+ */
+class CacheFilter : public echo::routing::Filter {
+
+ public:
+
+  /** The default maximum size of a stored entity in bytes. */
+  static const size_t DEFAULT_MAX_ENTITY_SIZE;
+
+  /**
+   * Constructor.
+   */
+  CacheFilter() {
+    CacheFilter(NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  CacheFilter(echo::Context context) {
+    CacheFilter(context, NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   * @param next
+   *            The next Echo.
+   */
+  CacheFilter(echo::Context context, Echo::Echo next);
+
+  /**
+   * Returns the response cache.
+   *
+   * @return The response cache.
+   */
+  ResponseCache* getCache() {
+    return cache;
+  }
+
+  /**
+   * Returns the maximum size of a stored entity in bytes.
+   *
+   * @return The maximum size of a stored entity in bytes.
+   */
+  size_t getMaxEntitySize() {
+    return maxEntitySize;
+  }
+
+  /**
+   * Sets the maximum size of a stored entity in bytes.
+   *
+   * @param maxEntitySize
+   *            The maximum size of a stored entity in bytes.
+   */
+  void setMaxEntitySize(size_t maxEntitySize) {
+    this->maxEntitySize = maxEntitySize;
+  }
+
+ protected:
+
+  /**
+   * Stores the response if it is cacheable, or invalidates the resource after
+   * a successful unsafe request.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  void afterHandle(echo::Request request, echo::Response response);
+
+  /**
+   * Serves the call from the cache if a fresh variant is found.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   * @return {@link #STOP} on a hit, {@link #CONTINUE} otherwise.
+   */
+  int beforeHandle(echo::Request request, echo::Response response);
+
+ private:
+
+  /**
+   * Returns the freshness lifetime of a response.
+   *
+   * @param request
+   *            The request.
+   * @param response
+   *            The response.
+   * @param now
+   *            The current time in seconds.
+   * @return The freshness lifetime in seconds, or zero if the response can't
+   *         be stored.
+   */
+  int getLifetime(echo::Request request, echo::Response response, time_t now);
+
+  /**
+   * Returns the bitmask of the dimensions on which a response varies.
+   *
+   * @param response
+   *            The response.
+   * @return The bitmask of the dimensions, or -1 if one of them can't be
+   *         keyed.
+   */
+  int getVariance(echo::Response response);
+
+  /** The response cache. */
+  ResponseCache* cache;
+
+  /** The maximum size of a stored entity in bytes. */
+  size_t maxEntitySize;
+
+};
+
+} // namespace application
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_APPLICATION_CACHE_FILTER_H_
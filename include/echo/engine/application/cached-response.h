@@ -0,0 +1,212 @@
+#ifndef _ECHO_ENGINE_APPLICATION_CACHED_RESPONSE_H_
+#define _ECHO_ENGINE_APPLICATION_CACHED_RESPONSE_H_
+
+#include <stddef.h>
+#include <time.h>
+
+#include <list>
+#include <set>
+#include <string>
+
+#include <echo/response.h>
+#include <echo/data/cache-directive.h>
+#include <echo/data/challenge-request.h>
+#include <echo/data/character-set.h>
+#include <echo/data/dimension.h>
+#include <echo/data/encoding.h>
+#include <echo/data/language.h>
+#include <echo/data/media-type.h>
+#include <echo/data/method.h>
+#include <echo/data/reference.h>
+#include <echo/data/status.h>
+#include <echo/data/tag.h>
+#include <echo/representation/representation.h>
+#include <echo/representation/shared-representation.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+/**
+ * Complete response kept by a {@link ResponseCache}: the status, the response
+ * metadata and the entity metadata, plus the entity content read once into
+ * memory. Instances are immutable once created, so a single instance can be
+ * shared by all the threads serving hits; their entities all reference the
+ * same shared content instead of copying it.
+ *
+ * @see CacheFilter
+ * @see CoalescingFilter
+ */
+class CachedResponse {
+
+ public:
+
+  /**
+   * Indicates if the content of an available entity can be read whole into
+   * memory. Transient and streamed entities can only be read once, and
+   * reading them whole would defeat the size limit.
+   *
+   * @param entity
+   *            The available entity.
+   * @param maxSize
+   *            The maximum size of the content in bytes.
+   * @return True if the content can be read whole.
+   */
+  static bool isCapturable(Representation entity, size_t maxSize);
+
+  /**
+   * Constructor copying a response whose entity was read.
+   *
+   * @param response
+   *            The response to copy.
+   * @param content
+   *            The content of the entity, empty if there is no entity.
+   * @param now
+   *            The current time in seconds.
+   * @param lifetime
+   *            The freshness lifetime in seconds.
+   */
+  CachedResponse(echo::Response response,
+                 echo::representation::SharedRepresentation::Content content,
+                 time_t now, int lifetime);
+
+  /**
+   * Updates a response with the cached status, metadata and a new entity
+   * referencing the cached content. The "Age" of the response is increased by
+   * the time spent in the cache.
+   *
+   * @param response
+   *            The response to update.
+   * @param now
+   *            The current time in seconds.
+   */
+  void apply(echo::Response response, time_t now) const;
+
+  /**
+   * Creates a new entity referencing the cached content.
+   *
+   * @return A new entity or null if the response had no entity.
+   */
+  Representation createEntity() const;
+
+  /**
+   * Returns the age of the response at a given time, in seconds.
+   *
+   * @param now
+   *            The current time in seconds.
+   * @return The age of the response.
+   */
+  int getAge(time_t now) const {
+    return age + static_cast<int>(now - storedAt);
+  }
+
+  /**
+   * Returns the time at which the response becomes stale, in seconds.
+   *
+   * @return The time at which the response becomes stale.
+   */
+  time_t getExpiration() const {
+    return expiration;
+  }
+
+  /**
+   * Returns the modification date of the entity.
+   *
+   * @return The modification date of the entity or null.
+   */
+  Date getModificationDate() const {
+    return modificationDate;
+  }
+
+  /**
+   * Returns the approximate memory used by the response, in bytes.
+   *
+   * @return The approximate memory used by the response.
+   */
+  size_t getSize() const {
+    return sizeof(CachedResponse) + content->size();
+  }
+
+  /**
+   * Returns the tag of the entity.
+   *
+   * @return The tag of the entity or null.
+   */
+  Tag getTag() const {
+    return tag;
+  }
+
+  /**
+   * Indicates if the response is still fresh.
+   *
+   * @param now
+   *            The current time in seconds.
+   * @return True if the response is still fresh.
+   */
+  bool isFresh(time_t now) const {
+    return now < expiration;
+  }
+
+ private:
+
+  /** The status. */
+  echo::data::Status status;
+
+  /** The age of the response when it was stored, in seconds. */
+  int age;
+
+  /** The time at which the response was stored, in seconds. */
+  time_t storedAt;
+
+  /** The time at which the response becomes stale, in seconds. */
+  time_t expiration;
+
+  /** The location reference. */
+  Reference locationRef;
+
+  /** The allowed methods. */
+  std::set<Method> allowedMethods;
+
+  /** The authentication challenges. */
+  std::list<ChallengeRequest> challengeRequests;
+
+  /** The dimensions on which the response varies. */
+  std::set<Dimension> dimensions;
+
+  /** The cache directives. */
+  std::list<CacheDirective> cacheDirectives;
+
+  /** Indicates if the response had an entity. */
+  bool entityAvailable;
+
+  /** The shared content of the entity. */
+  echo::representation::SharedRepresentation::Content content;
+
+  /** The media type of the entity. */
+  MediaType mediaType;
+
+  /** The character set of the entity. */
+  CharacterSet characterSet;
+
+  /** The encodings of the entity. */
+  std::list<Encoding> encodings;
+
+  /** The languages of the entity. */
+  std::list<Language> languages;
+
+  /** The tag of the entity. */
+  Tag tag;
+
+  /** The modification date of the entity. */
+  Date modificationDate;
+
+  /** The expiration date of the entity. */
+  Date expirationDate;
+
+};
+
+} // namespace application
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_APPLICATION_CACHED_RESPONSE_H_
@@ -0,0 +1,241 @@
+#ifndef _ECHO_ENGINE_APPLICATION_COALESCING_FILTER_H_
+#define _ECHO_ENGINE_APPLICATION_COALESCING_FILTER_H_
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include <string>
+#include <tr1/unordered_map>
+
+#include <echo/context.h>
+#include <echo/echo.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/engine/application/response-cache.h>
+#include <echo/routing/filter.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+/**
+ * Filter coalescing identical concurrent GET and HEAD requests. The first
+ * request for a given method, resource reference and set of negotiation
+ * preferences invokes the next Echo; the requests arriving while it is in
+ * flight wait for its response instead of invoking the next Echo
+ * themselves. The response is captured once as an immutable
+ * {@link CachedResponse} shared by all the waiters, each of them receiving a
+ * new entity wrapping the shared content.<br>
+ * <br>
+ * The behavior in the edge cases is the following:
+ * <ul>
+ * <li>A waiter still waiting after the timeout stops waiting and invokes the
+ * next Echo itself.</li>
+ * <li>If the first request fails with an exception, the waiters are released
+ * and invoke the next Echo themselves, the exception being propagated to the
+ * first caller only.</li>
+ * <li>Error statuses are shared like any other response.</li>
+ * <li>Responses setting cookies, varying on other dimensions than the
+ * negotiated ones or having a transient entity, an entity of unknown size or
+ * one larger than the maximum size aren't shared; the waiters invoke the
+ * next Echo themselves.</li>
+ * <li>Requests carrying credentials or cookies are never coalesced, as their
+ * responses may be private.</li>
+ * </ul>
+ * Placed after a {@link CacheFilter}, this filter prevents the stampede of
+ * requests reaching the origin when a popular cached response expires.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ *
+ * @see CacheFilter
+ */
+class CoalescingFilter : public echo::routing::Filter {
+
+ public:
+
+  /** The default maximum size of a shared entity in bytes. */
+  static const size_t DEFAULT_MAX_ENTITY_SIZE;
+
+  /** The default time to wait for the first request, in milliseconds. */
+  static const int DEFAULT_TIMEOUT;
+
+  /**
+   * Constructor.
+   */
+  CoalescingFilter() {
+    CoalescingFilter(NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  CoalescingFilter(echo::Context context) {
+    CoalescingFilter(context, NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   * @param next
+   *            The next Echo.
+   */
+  CoalescingFilter(echo::Context context, Echo::Echo next);
+
+  /**
+   * Destructor.
+   */
+  ~CoalescingFilter();
+
+  /**
+   * Returns the maximum size of a shared entity in bytes.
+   *
+   * @return The maximum size of a shared entity in bytes.
+   */
+  size_t getMaxEntitySize() {
+    return maxEntitySize;
+  }
+
+  /**
+   * Returns the time to wait for the first request, in milliseconds.
+   *
+   * @return The time to wait for the first request.
+   */
+  int getTimeout() {
+    return timeout;
+  }
+
+  /**
+   * Sets the maximum size of a shared entity in bytes.
+   *
+   * @param maxEntitySize
+   *            The maximum size of a shared entity in bytes.
+   */
+  void setMaxEntitySize(size_t maxEntitySize) {
+    this->maxEntitySize = maxEntitySize;
+  }
+
+  /**
+   * Sets the time to wait for the first request, in milliseconds.
+   *
+   * @param timeout
+   *            The time to wait for the first request.
+   */
+  void setTimeout(int timeout) {
+    this->timeout = timeout;
+  }
+
+ protected:
+
+  /**
+   * Handles the call by joining the identical call in flight, or by invoking
+   * the next Echo and sharing its response with the calls joining it.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   * @return {@link #CONTINUE}.
+   */
+  int doHandle(echo::Request request, echo::Response response);
+
+  /**
+   * Returns false as {@link #doHandle(echo::Request, echo::Response)} is
+   * overridden.
+   *
+   * @return False.
+   */
+  bool isLinearizable() {
+    return false;
+  }
+
+ private:
+
+  /**
+   * Call in flight, referenced by its caller and its waiters.
+   */
+  struct Flight {
+
+    /** The condition signaled when the call completes. */
+    pthread_cond_t completed;
+
+    /** Indicates if the call completed. */
+    bool done;
+
+    /** The shared response, empty if it can't be shared. */
+    ResponseCache::Entry result;
+
+    /** The number of threads referencing the flight. */
+    int references;
+
+  };
+
+  /** Map of the calls in flight. */
+  typedef std::tr1::unordered_map<std::string, Flight*> FlightMap;
+
+  /**
+   * Captures the response of a call and releases its waiters.
+   *
+   * @param key
+   *            The key of the call.
+   * @param flight
+   *            The call in flight.
+   * @param response
+   *            The response to share or null if the call failed.
+   */
+  void complete(const std::string& key, Flight* flight,
+                echo::Response response);
+
+  /**
+   * Returns the key of a call, or an empty key if the call can't be
+   * coalesced.
+   *
+   * @param request
+   *            The request.
+   * @return The key of the call.
+   */
+  std::string getKey(echo::Request request);
+
+  /**
+   * Releases a reference to a call in flight, deleting it with the last
+   * reference. The lock must be held.
+   *
+   * @param flight
+   *            The call in flight.
+   */
+  void release(Flight* flight);
+
+  /**
+   * Waits for the completion of a call in flight.
+   *
+   * @param flight
+   *            The call in flight.
+   * @return The shared response, empty if the call failed, couldn't be shared
+   *         or the wait timed out.
+   */
+  ResponseCache::Entry wait(Flight* flight);
+
+  /** The lock guarding the calls in flight. */
+  pthread_mutex_t lock;
+
+  /** The calls in flight by key. */
+  FlightMap flights;
+
+  /** The maximum size of a shared entity in bytes. */
+  size_t maxEntitySize;
+
+  /** The time to wait for the first request, in milliseconds. */
+  int timeout;
+
+};
+
+} // namespace application
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_APPLICATION_COALESCING_FILTER_H_
@@ -0,0 +1,215 @@
+#ifndef _ECHO_ENGINE_APPLICATION_ENCODED_CACHE_H_
+#define _ECHO_ENGINE_APPLICATION_ENCODED_CACHE_H_
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include <string>
+#include <tr1/memory>
+#include <tr1/unordered_map>
+
+#include <echo/context.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+/**
+ * Cache of encoded entity bodies, so that an entity served again and again is
+ * compressed once per coding and compression level instead of once per
+ * response. The bodies are keyed by a validator identifying the exact content
+ * of the original entity, such as its digest or its strong tag, plus the
+ * compression level.<br>
+ * <br>
+ * Each coding has its own byte budget and least recently used list, so that a
+ * burst of "deflate" bodies can't evict the "gzip" ones. The bodies are
+ * immutable and shared by reference counting.<br>
+ * <br>
+ * The cache is shared through the {@link #ATTRIBUTE} context attribute.<br>
+ * <br>
+ * Concurrency note: instances of this class are thread-safe.
+ *
+ * @see Encoder
+ */
+class EncodedCache {
+
+ public:
+
+  /** Shared reference to an immutable encoded body. */
+  typedef std::tr1::shared_ptr<const std::string> Body;
+
+  /** The name of the context attribute holding the cache. */
+  static const std::string ATTRIBUTE;
+
+  /** The default byte budget of each coding. */
+  static const size_t DEFAULT_CAPACITY;
+
+  /**
+   * Returns the cache shared through the attributes of a context.
+   *
+   * @param context
+   *            The context.
+   * @return The cache or null if none was registered.
+   */
+  static EncodedCache* getCache(Context context);
+
+  /**
+   * Shares a cache through the attributes of a context.
+   *
+   * @param context
+   *            The context.
+   * @param cache
+   *            The cache to share.
+   */
+  static void setCache(Context context, EncodedCache* cache);
+
+  /**
+   * Constructor with budgets for the "gzip" and "deflate" codings.
+   */
+  EncodedCache();
+
+  /**
+   * Destructor.
+   */
+  ~EncodedCache();
+
+  /**
+   * Returns a cached body.
+   *
+   * @param validator
+   *            The validator of the original content.
+   * @param encoding
+   *            The name of the coding.
+   * @param level
+   *            The compression level.
+   * @return The cached body, empty if it isn't cached.
+   */
+  Body get(const std::string& validator, const std::string& encoding,
+           int level);
+
+  /**
+   * Returns the total size of the cached bodies of a coding in bytes.
+   *
+   * @param encoding
+   *            The name of the coding.
+   * @return The total size of the cached bodies.
+   */
+  size_t getSize(const std::string& encoding);
+
+  /**
+   * Stores a body. Bodies of codings without a budget aren't stored.
+   *
+   * @param validator
+   *            The validator of the original content.
+   * @param encoding
+   *            The name of the coding.
+   * @param level
+   *            The compression level.
+   * @param body
+   *            The encoded body.
+   */
+  void put(const std::string& validator, const std::string& encoding,
+           int level, const Body& body);
+
+  /**
+   * Sets the byte budget of a coding, evicting bodies if needed.
+   *
+   * @param encoding
+   *            The name of the coding.
+   * @param capacity
+   *            The byte budget, zero to disable the caching of the coding.
+   */
+  void setCapacity(const std::string& encoding, size_t capacity);
+
+ private:
+
+  /**
+   * Cached body, linked in the least recently used list of its partition.
+   */
+  struct Node {
+
+    /** The key of the body. */
+    std::string key;
+
+    /** The encoded body. */
+    Body body;
+
+    /** The less recently used node. */
+    Node* older;
+
+    /** The more recently used node. */
+    Node* newer;
+
+  };
+
+  /** Map of the nodes of a partition. */
+  typedef std::tr1::unordered_map<std::string, Node*> NodeMap;
+
+  /**
+   * Bodies of a coding, with their own budget.
+   */
+  struct Partition {
+
+    /** The lock guarding the partition. */
+    pthread_mutex_t lock;
+
+    /** The bodies by key. */
+    NodeMap nodes;
+
+    /** The least recently used node. */
+    Node* oldest;
+
+    /** The most recently used node. */
+    Node* newest;
+
+    /** The total size of the bodies. */
+    size_t size;
+
+    /** The byte budget. */
+    size_t capacity;
+
+  };
+
+  /** Map of the partitions. */
+  typedef std::tr1::unordered_map<std::string, Partition*> PartitionMap;
+
+  /**
+   * Unlinks and deletes a node of a locked partition.
+   *
+   * @param partition
+   *            The locked partition.
+   * @param node
+   *            The node to delete.
+   */
+  static void erase(Partition& partition, Node* node);
+
+  /**
+   * Returns the partition of a coding.
+   *
+   * @param encoding
+   *            The name of the coding.
+   * @return The partition or null if the coding has no budget.
+   */
+  Partition* getPartition(const std::string& encoding);
+
+  /**
+   * Returns the key of a body.
+   *
+   * @param validator
+   *            The validator of the original content.
+   * @param level
+   *            The compression level.
+   * @return The key of the body.
+   */
+  static std::string getKey(const std::string& validator, int level);
+
+  /** The partitions by coding, fixed at construction. */
+  PartitionMap partitions;
+
+};
+
+} // namespace application
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_APPLICATION_ENCODED_CACHE_H_
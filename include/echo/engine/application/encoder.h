@@ -0,0 +1,242 @@
+#ifndef _ECHO_ENGINE_APPLICATION_ENCODER_H_
+#define _ECHO_ENGINE_APPLICATION_ENCODER_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include <echo/context.h>
+#include <echo/echo.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/encoding.h>
+#include <echo/engine/application/encoded-cache.h>
+#include <echo/representation/asset-representation.h>
+#include <echo/representation/file-representation.h>
+#include <echo/representation/representation.h>
+#include <echo/representation/shared-representation.h>
+#include <echo/routing/filter.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+/**
+ * Filter compressing the response entities with the "gzip" or "deflate"
+ * content coding, the counterpart of the decoder service. The coding is
+ * negotiated with {@link ClientInfo#getAcceptedEncodings()}, "gzip" being
+ * preferred when the client accepts both.<br>
+ * <br>
+ * When a {@link FileRepresentation} is encoded with "gzip", a precompressed
+ * sibling file with the ".gz" extension is served instead if it exists and
+ * isn't older than the original file, and an {@link AssetRepresentation} is
+ * replaced by the gzip variant precomputed in its pack. Other entities are
+ * compressed on the fly with the reusable zlib stream of the current thread,
+ * unless they are smaller than the minimum size, already encoded, transient
+ * or of unknown size, or of a media type which is already compressed such as
+ * images, audio, video or arbitrary "application/octet-stream" content. An
+ * entity that doesn't shrink is sent unchanged, and so are the partial
+ * contents of "206 Partial Content" responses.<br>
+ * <br>
+ * Streamed entities, whether read from a {@link SourceRepresentation}'s
+ * source or from a {@link ChunkStream}, are compressed chunk by chunk as they
+ * are produced, whatever their size, with a zlib stream taken from the pool
+ * of the current thread.<br>
+ * <br>
+ * Entities with a digest or a strong tag are compressed once per coding and
+ * level, the encoded bodies being kept in the {@link EncodedCache} shared
+ * through the context. The encoded entities are
+ * {@link SharedRepresentation}s referencing these bodies, so that a hit is
+ * sent without copying.<br>
+ * <br>
+ * The "Accept-Encoding" dimension is added to all the responses whose entity
+ * could be encoded, so that shared caches keep the variants apart. Strong
+ * tags get a suffix naming the coding, as the encoded variant isn't
+ * byte-for-byte identical to the original one.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ *
+ * @see echo::engine::util::Deflater
+ */
+class Encoder : public echo::routing::Filter {
+
+ public:
+
+  /** The default minimum size of the encoded entities in bytes. */
+  static const long long DEFAULT_MINIMUM_SIZE;
+
+  /**
+   * Constructor.
+   */
+  Encoder() {
+    Encoder(NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  Encoder(echo::Context context) {
+    Encoder(context, NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   * @param next
+   *            The next Echo.
+   */
+  Encoder(echo::Context context, Echo::Echo next);
+
+  /**
+   * Returns the cache of encoded bodies.
+   *
+   * @return The cache of encoded bodies.
+   */
+  EncodedCache* getCache() {
+    return cache;
+  }
+
+  /**
+   * Returns the compression level, from 1 to 9.
+   *
+   * @return The compression level.
+   */
+  int getLevel() {
+    return level;
+  }
+
+  /**
+   * Returns the minimum size of the encoded entities in bytes.
+   *
+   * @return The minimum size of the encoded entities.
+   */
+  long long getMinimumSize() {
+    return minimumSize;
+  }
+
+  /**
+   * Sets the compression level, from 1 to 9.
+   *
+   * @param level
+   *            The compression level.
+   */
+  void setLevel(int level) {
+    this->level = level;
+  }
+
+  /**
+   * Sets the minimum size of the encoded entities in bytes.
+   *
+   * @param minimumSize
+   *            The minimum size of the encoded entities.
+   */
+  void setMinimumSize(long long minimumSize) {
+    this->minimumSize = minimumSize;
+  }
+
+ protected:
+
+  /**
+   * Encodes the response entity if possible.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  void afterHandle(echo::Request request, echo::Response response);
+
+  /**
+   * Indicates if an entity can be encoded.
+   *
+   * @param entity
+   *            The entity.
+   * @return True if the entity can be encoded.
+   */
+  virtual bool canEncode(Representation entity);
+
+  /**
+   * Returns the coding preferred by the client.
+   *
+   * @param request
+   *            The request.
+   * @return The preferred coding, or null for the identity coding.
+   */
+  Encoding getEncoding(echo::Request request);
+
+ private:
+
+  /**
+   * Creates an entity with the metadata of another one and a new content,
+   * referencing the shared content without copying it.
+   *
+   * @param entity
+   *            The entity whose metadata are copied.
+   * @param content
+   *            The new content.
+   * @param encoding
+   *            The coding of the new content or null if not encoded.
+   * @return The new entity.
+   */
+  static Representation createEntity(Representation entity,
+                                     const EncodedCache::Body& content,
+                                     Encoding encoding);
+
+  /**
+   * Returns the precompressed sibling of a file entity.
+   *
+   * @param entity
+   *            The file entity.
+   * @return The precompressed sibling or null if none is usable.
+   */
+  static Representation getSibling(FileRepresentation entity);
+
+  /**
+   * Returns the validator identifying the exact content of an entity, based
+   * on its digest or else on its strong tag.
+   *
+   * @param request
+   *            The request.
+   * @param entity
+   *            The entity.
+   * @return The validator or an empty string if the content can't be
+   *         identified.
+   */
+  static std::string getValidator(echo::Request request,
+                                  Representation entity);
+
+  /**
+   * Copies the metadata of an entity to a new entity.
+   *
+   * @param entity
+   *            The original entity.
+   * @param result
+   *            The new entity to update.
+   * @param encoding
+   *            The coding of the new entity or null if not encoded.
+   */
+  static void setMetadata(Representation entity, Representation result,
+                          Encoding encoding);
+
+  /** The cache of encoded bodies. */
+  EncodedCache* cache;
+
+  /** The compression level. */
+  int level;
+
+  /** The minimum size of the encoded entities in bytes. */
+  long long minimumSize;
+
+};
+
+} // namespace application
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_APPLICATION_ENCODER_H_
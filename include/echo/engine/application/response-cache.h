@@ -0,0 +1,295 @@
+#ifndef _ECHO_ENGINE_APPLICATION_RESPONSE_CACHE_H_
+#define _ECHO_ENGINE_APPLICATION_RESPONSE_CACHE_H_
+
+#include <pthread.h>
+#include <stddef.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+#include <tr1/memory>
+#include <tr1/unordered_map>
+
+#include <echo/context.h>
+#include <echo/request.h>
+#include <echo/engine/application/cached-response.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+/**
+ * In-memory cache of complete responses, bounded in bytes. The responses are
+ * spread over independent shards, each one guarded by its own lock and aligned
+ * on a cache line, and the least recently used responses of a full shard are
+ * evicted.<br>
+ * <br>
+ * A resource may have several cached variants. The variants are all stored in
+ * the shard of their primary key, usually the resource reference, which also
+ * records the variance of the resource: the bitmask of the dimensions on
+ * which its responses vary. Callers first look up the variance, derive the
+ * variant key from the request, then look up the variant.<br>
+ * <br>
+ * The cached responses are immutable and shared by reference counting, so a
+ * hit only holds the lock of its shard to take a reference.<br>
+ * <br>
+ * The cache is shared through the {@link #ATTRIBUTE} context attribute.<br>
+ * <br>
+ * Concurrency note: instances of this class are thread-safe.
+ *
+ * @see CacheFilter
+ */
+class ResponseCache {
+
+ public:
+
+  /** Shared reference to an immutable cached response. */
+  typedef std::tr1::shared_ptr<const CachedResponse> Entry;
+
+  /** The name of the context attribute holding the cache. */
+  static const std::string ATTRIBUTE;
+
+  /** The default maximum size of the cache in bytes. */
+  static const size_t DEFAULT_CAPACITY;
+
+  /** The number of shards, a power of two. */
+  static const int SHARDS;
+
+  /**
+   * Returns the cache shared through the attributes of a context.
+   *
+   * @param context
+   *            The context.
+   * @return The cache or null if none was registered.
+   */
+  static ResponseCache* getCache(Context context);
+
+  /**
+   * Returns the key of the variant requested by a request, made of the
+   * primary key followed by the request values of the dimensions of a
+   * variance.
+   *
+   * @param request
+   *            The request.
+   * @param primaryKey
+   *            The primary key of the resource.
+   * @param variance
+   *            The bitmask of the dimensions on which the resource varies.
+   * @return The key of the variant.
+   */
+  static std::string getVariantKey(echo::Request request,
+                                   const std::string& primaryKey,
+                                   int variance);
+
+  /**
+   * Shares a cache through the attributes of a context.
+   *
+   * @param context
+   *            The context.
+   * @param cache
+   *            The cache to share.
+   */
+  static void setCache(Context context, ResponseCache* cache);
+
+  /**
+   * Constructor using the default capacity.
+   */
+  ResponseCache();
+
+  /**
+   * Constructor.
+   *
+   * @param capacity
+   *            The maximum size of the cache in bytes.
+   */
+  ResponseCache(size_t capacity);
+
+  /**
+   * Destructor.
+   */
+  ~ResponseCache();
+
+  /**
+   * Returns a fresh cached variant. A stale variant is removed.
+   *
+   * @param primaryKey
+   *            The primary key of the resource.
+   * @param key
+   *            The key of the variant.
+   * @param now
+   *            The current time in seconds.
+   * @return The cached variant, empty if there is no fresh variant.
+   */
+  Entry get(const std::string& primaryKey, const std::string& key,
+            time_t now);
+
+  /**
+   * Returns the maximum size of the cache in bytes.
+   *
+   * @return The maximum size of the cache in bytes.
+   */
+  size_t getCapacity() const {
+    return capacity;
+  }
+
+  /**
+   * Returns the total size of the cached responses in bytes.
+   *
+   * @return The total size of the cached responses in bytes.
+   */
+  size_t getSize();
+
+  /**
+   * Returns the variance of a resource.
+   *
+   * @param primaryKey
+   *            The primary key of the resource.
+   * @param variance
+   *            Set to the bitmask of the dimensions on which the cached
+   *            variants vary.
+   * @return True if the resource has cached variants.
+   */
+  bool getVariance(const std::string& primaryKey, int& variance);
+
+  /**
+   * Stores a variant. If the variance of the resource changed, the variants
+   * cached with the former variance are removed.
+   *
+   * @param primaryKey
+   *            The primary key of the resource.
+   * @param variance
+   *            The bitmask of the dimensions on which the variant varies.
+   * @param key
+   *            The key of the variant.
+   * @param entry
+   *            The response to store.
+   */
+  void put(const std::string& primaryKey, int variance,
+           const std::string& key, const Entry& entry);
+
+  /**
+   * Removes all the variants of a resource.
+   *
+   * @param primaryKey
+   *            The primary key of the resource.
+   */
+  void remove(const std::string& primaryKey);
+
+ private:
+
+  /**
+   * Cached variant, linked in the least recently used list of its shard.
+   */
+  struct Node {
+
+    /** The key of the variant. */
+    std::string key;
+
+    /** The primary key of the resource. */
+    std::string primaryKey;
+
+    /** The cached response. */
+    Entry entry;
+
+    /** The less recently used node. */
+    Node* older;
+
+    /** The more recently used node. */
+    Node* newer;
+
+  };
+
+  /**
+   * Cached variants of a resource.
+   */
+  struct Resource {
+
+    /** The bitmask of the dimensions on which the variants vary. */
+    int variance;
+
+    /** The keys of the cached variants. */
+    std::vector<std::string> keys;
+
+  };
+
+  /** Map of the nodes of a shard. */
+  typedef std::tr1::unordered_map<std::string, Node*> NodeMap;
+
+  /** Map of the resources of a shard. */
+  typedef std::tr1::unordered_map<std::string, Resource> ResourceMap;
+
+  /**
+   * Shard of the cache, aligned on a cache line.
+   */
+  struct Shard {
+
+    /** The lock guarding the shard. */
+    pthread_mutex_t lock;
+
+    /** The variants by key. */
+    NodeMap nodes;
+
+    /** The resources by primary key. */
+    ResourceMap resources;
+
+    /** The least recently used node. */
+    Node* oldest;
+
+    /** The most recently used node. */
+    Node* newest;
+
+    /** The total size of the cached responses. */
+    size_t size;
+
+  } __attribute__((aligned(64)));
+
+  /**
+   * Initializes the shards.
+   */
+  void initialize();
+
+  /**
+   * Unlinks and deletes a node of a locked shard.
+   *
+   * @param shard
+   *            The locked shard.
+   * @param node
+   *            The node to delete.
+   */
+  void erase(Shard& shard, Node* node);
+
+  /**
+   * Removes all the variants of a resource in a locked shard.
+   *
+   * @param shard
+   *            The locked shard.
+   * @param primaryKey
+   *            The primary key of the resource.
+   */
+  void erase(Shard& shard, const std::string& primaryKey);
+
+  /**
+   * Returns the shard of a resource.
+   *
+   * @param primaryKey
+   *            The primary key of the resource.
+   * @return The shard of the resource.
+   */
+  Shard& getShard(const std::string& primaryKey);
+
+  /** The shards. */
+  Shard* shards;
+
+  /** The maximum size of the cache in bytes. */
+  size_t capacity;
+
+  /** The maximum size of a shard in bytes. */
+  size_t shardCapacity;
+
+};
+
+} // namespace application
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_APPLICATION_RESPONSE_CACHE_H_
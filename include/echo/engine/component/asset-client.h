@@ -0,0 +1,72 @@
+#ifndef _ECHO_ENGINE_COMPONENT_ASSET_CLIENT_H_
+#define _ECHO_ENGINE_COMPONENT_ASSET_CLIENT_H_
+
+#include <list>
+
+#include <echo/connector.h>
+#include <echo/context.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/local-reference.h>
+#include <echo/data/protocol.h>
+#include <echo/representation/asset-representation.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+/**
+ * Client connector of the "clap", "zip" and "jar" protocols, serving the
+ * assets of the {@link AssetPack}s registered in the process. A GET or a
+ * HEAD call resolves its resource reference to an
+ * {@link AssetRepresentation}, a slice of the pack carrying the tag and the
+ * modification date of the asset, so a call copies nothing and never
+ * touches the filesystem once the pack is mapped. The other methods aren't
+ * allowed, the packs being read-only.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ *
+ * @see echo::engine::util::AssetPack#resolve(std::string, Asset)
+ */
+class AssetClient : public echo::Connector {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  AssetClient(echo::Context context);
+
+  /**
+   * Resolves the resource reference of a call to the asset it names.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  //@Override
+  void handle(echo::Request request, echo::Response response);
+
+  /**
+   * Indicates that the connector is available, as the packs are registered
+   * by the process itself.
+   *
+   * @return True.
+   */
+  //@Override
+  bool isAvailable() {
+    return true;
+  }
+
+};
+
+} // namespace component
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_COMPONENT_ASSET_CLIENT_H_
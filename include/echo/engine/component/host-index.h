@@ -0,0 +1,225 @@
+#ifndef _ECHO_ENGINE_COMPONENT_HOST_INDEX_H_
+#define _ECHO_ENGINE_COMPONENT_HOST_INDEX_H_
+
+#include <regex.h>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <tr1/unordered_map>
+
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/routing/route.h>
+#include <echo/routing/virtual-host.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+/**
+ * Index of the virtual hosts attached to a component, used to select the
+ * host of a call without scoring every attached host.<br>
+ * <br>
+ * Hosts are classified when they are added:
+ * <ul>
+ * <li>hosts whose domain, port and scheme patterns are literal values (or the
+ * match-all ".*" pattern for port and scheme) are stored in an exact-match hash
+ * table keyed by hostDomain, the scheme and port being checked on the few
+ * hosts sharing a domain;</li>
+ * <li>hosts whose domain pattern has the ".*\.example\.com" shape are stored in
+ * a trie of reversed domain labels;</li>
+ * <li>all the other hosts keep the regular expression matching of
+ * {@link VirtualHost} and are tested in order.</li>
+ * </ul>
+ * When several hosts match, the one added first wins, which is the behavior of
+ * a best-match router where all the host routes score 1.0.<br>
+ * <br>
+ * Concurrency note: lookups can be done concurrently, but the index must not
+ * be modified while calls are being routed.
+ *
+ * @see echo::routing::VirtualHost
+ */
+class HostIndex {
+
+ public:
+
+  /**
+   * Constructor.
+   */
+  HostIndex();
+
+  /**
+   * Destructor. Frees the compiled regular expressions.
+   */
+  ~HostIndex();
+
+  /**
+   * Adds a virtual host to the index.
+   *
+   * @param host
+   *            The virtual host to index.
+   * @param route
+   *            The route to return when the host matches.
+   */
+  void add(echo::routing::VirtualHost host, echo::routing::Route route);
+
+  /**
+   * Removes all the indexed hosts.
+   */
+  void clear();
+
+  /**
+   * Returns the route of the first added host matching the call.
+   *
+   * @param request
+   *            The request to route.
+   * @param response
+   *            The response to update.
+   * @return The matching route or null.
+   */
+  echo::routing::Route find(echo::Request request, echo::Response response);
+
+  /**
+   * Returns the number of indexed hosts.
+   *
+   * @return The number of indexed hosts.
+   */
+  int size() {
+    return count;
+  }
+
+  /**
+   * Indicates if a pattern only matches a single literal value and returns
+   * this value unescaped. An unescaped dot between two labels, as in
+   * "www.example.com", is taken as a literal dot, which is what a domain
+   * written this way means.
+   *
+   * @param pattern
+   *            The regular expression.
+   * @param value
+   *            The unescaped literal value.
+   * @return True if the pattern is a literal value.
+   */
+  static bool isLiteral(const std::string& pattern, std::string& value);
+
+  /**
+   * Indicates if a pattern matches any sub-domain of a literal domain, such
+   * as ".*\.example\.com", and returns the literal domain suffix.
+   *
+   * @param pattern
+   *            The regular expression.
+   * @param suffix
+   *            The literal domain, without the leading dot.
+   * @return True if the pattern is a wildcard suffix.
+   */
+  static bool isWildcardSuffix(const std::string& pattern,
+                               std::string& suffix);
+
+ private:
+
+  /** Indexed host. */
+  struct Entry {
+    /** The addition order, used to break ties. */
+    int order;
+
+    /** The scheme to match or empty for all. */
+    std::string scheme;
+
+    /** The port to match or empty for all. */
+    std::string port;
+
+    /** The route to return. */
+    echo::routing::Route route;
+  };
+
+  /** Host tested with its regular expressions. */
+  struct PatternEntry {
+    /** The addition order, used to break ties. */
+    int order;
+
+    /** The compiled hostRef domain, port and scheme patterns. */
+    regex_t host[3];
+
+    /** The compiled resourceRef domain, port and scheme patterns. */
+    regex_t resource[3];
+
+    /** The compiled server address and port patterns. */
+    regex_t server[2];
+
+    /** The route to return. */
+    echo::routing::Route route;
+  };
+
+  /** Node of the reversed domain labels trie. */
+  struct Node {
+    /** The child nodes, keyed by domain label. */
+    std::map<std::string, Node*> children;
+
+    /** The hosts matching any sub-domain of this node. */
+    std::vector<Entry> entries;
+  };
+
+  /**
+   * Compiles a pattern anchored on the whole value.
+   *
+   * @param regex
+   *            The compiled regular expression to initialize.
+   * @param pattern
+   *            The pattern to compile.
+   * @return True if the pattern could be compiled.
+   */
+  static bool compile(regex_t* regex, const std::string& pattern);
+
+  /**
+   * Indicates if a compiled pattern matches a value.
+   *
+   * @param regex
+   *            The compiled regular expression.
+   * @param value
+   *            The value to test.
+   * @return True if the value matches.
+   */
+  static bool matches(const regex_t* regex, const std::string& value);
+
+  /**
+   * Frees a trie node and its children.
+   *
+   * @param node
+   *            The node to free.
+   */
+  static void free(Node* node);
+
+  /**
+   * Indicates if an indexed entry matches the scheme and port of a call.
+   *
+   * @param entry
+   *            The indexed entry.
+   * @param scheme
+   *            The call scheme.
+   * @param port
+   *            The call port.
+   * @return True if the entry matches.
+   */
+  static bool matches(const Entry& entry, const std::string& scheme,
+                      const std::string& port);
+
+  /** The number of indexed hosts. */
+  int count;
+
+  /** The exact-match table, keyed by lower-cased host domain. */
+  std::tr1::unordered_map<std::string, std::vector<Entry> > exact;
+
+  /** The root of the reversed domain labels trie. */
+  Node* suffixes;
+
+  /** The hosts tested with regular expressions, in addition order. */
+  std::vector<PatternEntry*> patterns;
+
+};
+
+} // namespace component
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_COMPONENT_HOST_INDEX_H_
@@ -0,0 +1,194 @@
+#ifndef _ECHO_ENGINE_COMPONENT_RIAP_CLIENT_H_
+#define _ECHO_ENGINE_COMPONENT_RIAP_CLIENT_H_
+
+#include <list>
+
+#include <echo/application.h>
+#include <echo/connector.h>
+#include <echo/context.h>
+#include <echo/echo.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/local-reference.h>
+#include <echo/data/protocol.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+/**
+ * Client connector of the "riap" protocol, dispatching internal calls within
+ * the process. A call isn't serialized: the request is handed to the inbound
+ * root of its target as is, so its entity, its attributes and its parsed
+ * headers are shared with the callee, and the response entity comes back
+ * unchanged, possibly still streaming. An aggregating resource thus pays a
+ * method call per internal call instead of a connector round trip.<br>
+ * <br>
+ * The authority of the resource reference selects the target: the inbound
+ * root of the current application for "riap://application/", the internal
+ * router of the component for "riap://component/" and the router of its
+ * virtual hosts for "riap://host/". A call without target is answered with
+ * a 404 status. The thread-local current application, context and response
+ * are restored once the target returns, even if it throws, so the caller
+ * carries on with its own state.<br>
+ * <br>
+ * The connector is registered as a client of the component, along with its
+ * roots, so that the calls dispatched through
+ * {@link Context#getClientDispatcher()} reach it:<br>
+ * <br>
+ * <code>
+ * RiapClient client = new RiapClient(context);<br>
+ * client.setComponentRoot(internalRouter);<br>
+ * client.setHostRoot(serverRouter);<br>
+ * </code><br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe. The
+ * roots must be set before the connector is used.
+ *
+ * @see echo::data::LocalReference#createRiapReference(int, std::string)
+ */
+class RiapClient : public echo::Connector {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  RiapClient(echo::Context context);
+
+  /**
+   * Returns the root of the "riap://component/" calls.
+   *
+   * @return The internal router of the component.
+   */
+  echo::Echo getComponentRoot() {
+    return componentRoot;
+  }
+
+  /**
+   * Returns the root of the "riap://host/" calls.
+   *
+   * @return The router of the virtual hosts.
+   */
+  echo::Echo getHostRoot() {
+    return hostRoot;
+  }
+
+  /**
+   * Dispatches an internal call to its target without copying it.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  //@Override
+  void handle(echo::Request request, echo::Response response);
+
+  /**
+   * Indicates that the connector is available, as it only needs its roots.
+   *
+   * @return True.
+   */
+  //@Override
+  bool isAvailable() {
+    return true;
+  }
+
+  /**
+   * Sets the root of the "riap://component/" calls.
+   *
+   * @param componentRoot
+   *            The internal router of the component.
+   */
+  void setComponentRoot(echo::Echo componentRoot) {
+    this->componentRoot = componentRoot;
+  }
+
+  /**
+   * Sets the root of the "riap://host/" calls.
+   *
+   * @param hostRoot
+   *            The router of the virtual hosts, typically the
+   *            {@link ServerRouter} of the component.
+   */
+  void setHostRoot(echo::Echo hostRoot) {
+    this->hostRoot = hostRoot;
+  }
+
+ private:
+
+  /**
+   * Saves the thread-local current application, context and response for
+   * the scope of a block, so that every exit path restores them.
+   */
+  class CurrentState {
+
+   public:
+
+    /**
+     * Constructor saving the current state.
+     */
+    CurrentState() {
+      this->application = echo::Application::getCurrent();
+      this->context = echo::Context::getCurrent();
+      this->response = echo::Response::getCurrent();
+    }
+
+    /**
+     * Destructor restoring the saved state.
+     */
+    ~CurrentState() {
+      echo::Application::setCurrent(this->application);
+      echo::Context::setCurrent(this->context);
+      echo::Response::setCurrent(this->response);
+    }
+
+   private:
+
+    /**
+     * Non copyable.
+     */
+    CurrentState(const CurrentState&);
+
+    /**
+     * Non copyable.
+     */
+    CurrentState& operator=(const CurrentState&);
+
+    /** The saved current application. */
+    echo::Application application;
+
+    /** The saved current context. */
+    echo::Context context;
+
+    /** The saved current response. */
+    echo::Response response;
+
+  };
+
+  /**
+   * Returns the target of an internal call.
+   *
+   * @param authorityType
+   *            The type of the authority of the resource reference.
+   * @return The target or null.
+   */
+  echo::Echo getTarget(int authorityType);
+
+  /** The root of the "riap://component/" calls. */
+  echo::Echo componentRoot;
+
+  /** The root of the "riap://host/" calls. */
+  echo::Echo hostRoot;
+
+};
+
+} // namespace component
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_COMPONENT_RIAP_CLIENT_H_
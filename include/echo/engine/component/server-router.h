@@ -0,0 +1,106 @@
+#ifndef _ECHO_ENGINE_COMPONENT_SERVER_ROUTER_H_
+#define _ECHO_ENGINE_COMPONENT_SERVER_ROUTER_H_
+
+#include <list>
+
+#include <echo/context.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/engine/component/host-index.h>
+#include <echo/routing/route.h>
+#include <echo/routing/router.h>
+#include <echo/routing/virtual-host.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+/**
+ * Router that collects calls from all server connectors and dispatches them to
+ * the appropriate virtual host. Instead of scoring each host route, the
+ * virtual hosts are indexed by a {@link HostIndex} when the router starts, so
+ * that selecting a host doesn't depend on the number of attached hosts.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe. Hosts
+ * must be attached before the router is started.
+ *
+ * @see echo::engine::component::HostIndex
+ */
+class ServerRouter : public echo::routing::Router {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  ServerRouter(echo::Context context);
+
+  /**
+   * Attaches a virtual host. Its route is created without URI template, the
+   * host selection being done by the index.
+   *
+   * @param host
+   *            The virtual host to attach.
+   * @return The created route.
+   */
+  echo::routing::Route attach(echo::routing::VirtualHost host);
+
+  /**
+   * Returns the virtual hosts attached, in attachment order.
+   *
+   * @return The virtual hosts attached.
+   */
+  std::list<echo::routing::VirtualHost> getHosts() {
+    return hosts;
+  }
+
+  /**
+   * Starts the router and builds the host index.
+   */
+  //@Override
+  void start() throw (std::runtime_error);
+
+  /**
+   * Stops the router and clears the host index.
+   */
+  //@Override
+  void stop() throw (std::runtime_error);
+
+ protected:
+
+  /**
+   * Returns the route of the virtual host matching the call, looked up in the
+   * host index.
+   *
+   * @param request
+   *            The request to route.
+   * @param response
+   *            The response to update.
+   * @return The route of the matching host or null.
+   */
+  //@Override
+  echo::routing::Route getCustom(echo::Request request,
+                                 echo::Response response);
+
+ private:
+
+  /** The virtual hosts attached, in attachment order. */
+  std::list<echo::routing::VirtualHost> hosts;
+
+  /** The routes of the virtual hosts, in attachment order. */
+  std::list<echo::routing::Route> hostRoutes;
+
+  /** The index of the virtual hosts. */
+  HostIndex index;
+
+};
+
+} // namespace component
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_COMPONENT_SERVER_ROUTER_H_
@@ -0,0 +1,376 @@
+#ifndef _ECHO_ENGINE_HTTP_CLIENT_CONNECTION_H_
+#define _ECHO_ENGINE_HTTP_CLIENT_CONNECTION_H_
+
+#include <deque>
+#include <string>
+#include <tr1/memory>
+#include <vector>
+
+#include <echo/engine/http/client-exchange.h>
+#include <echo/engine/http/host-resolver.h>
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Persistent connection of the HTTP client connector to an origin server.
+ * The requests are written as soon as they are sent, so that idempotent ones
+ * are pipelined behind the requests in flight, and the responses are parsed
+ * in order from the same input buffer. A response body is handed to its
+ * exchange as it arrives; while the caller lags behind, the connection stops
+ * reading, so that the server is slowed down instead of the body being
+ * buffered.<br>
+ * <br>
+ * When the connection closes, the requests that didn't get any byte of their
+ * response are given back to the listener to be retried on another
+ * connection if they are idempotent; the others fail.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop.
+ */
+class ClientConnection : public echo::engine::io::EventLoop::Handler,
+                         public HostResolver::Listener {
+
+ public:
+
+  /** Exchange shared with the calling thread. */
+  typedef std::tr1::shared_ptr<ClientExchange> Exchange;
+
+  /**
+   * Listener of the connection, typically its pool.
+   */
+  class Listener {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Listener() {
+    }
+
+    /**
+     * Called once the connection is closed, from a task run after the
+     * closing call returned. The connection is then deleted by the listener.
+     *
+     * @param connection
+     *            The closed connection.
+     * @param retries
+     *            The exchanges to send again.
+     */
+    virtual void onClosed(ClientConnection* connection,
+                          std::deque<Exchange>& retries) = 0;
+
+    /**
+     * Called when the connection completes a response and can take another
+     * request.
+     *
+     * @param connection
+     *            The connection.
+     */
+    virtual void onReleased(ClientConnection* connection) = 0;
+
+  };
+
+  /** The maximum number of requests in flight on a connection. */
+  static const size_t MAX_PIPELINED;
+
+  /** The maximum number of times a request is sent. */
+  static const int MAX_ATTEMPTS;
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The client loop.
+   * @param resolver
+   *            The resolver of the host name.
+   * @param host
+   *            The host name of the origin.
+   * @param port
+   *            The port of the origin.
+   * @param timeout
+   *            The maximum inactivity of a connection with requests in flight
+   *            in milliseconds.
+   * @param idleTimeout
+   *            The maximum lifetime of an idle connection in milliseconds.
+   * @param listener
+   *            The listener.
+   */
+  ClientConnection(echo::engine::io::EventLoop& loop, HostResolver& resolver,
+                   const std::string& host, int port, int timeout,
+                   int idleTimeout, Listener* listener);
+
+  /**
+   * Destructor closing the socket. The listener isn't notified.
+   */
+  ~ClientConnection();
+
+  /**
+   * Indicates if an idempotent request can be pipelined behind the requests
+   * in flight.
+   *
+   * @return True if the connection is open or opening, reusable, and only
+   *         has idempotent requests in flight below the limit.
+   */
+  bool canPipeline() const;
+
+  /**
+   * Closes the connection and notifies the listener from a task.
+   *
+   * @param error
+   *            The errno value failing the exchanges which can't be retried.
+   */
+  void close(int error);
+
+  /**
+   * Returns the number of requests in flight.
+   *
+   * @return The number of requests in flight.
+   */
+  size_t getPending() const {
+    return exchanges.size();
+  }
+
+  /**
+   * Indicates if the connection isn't closed.
+   *
+   * @return True if the connection isn't closed.
+   */
+  bool isOpen() const {
+    return state != CLOSED;
+  }
+
+  /**
+   * Connects once the name is resolved, trying each address in turn.
+   *
+   * @param addresses
+   *            The addresses of the host.
+   * @param error
+   *            0 or the getaddrinfo() error code.
+   */
+  void onResolved(const std::vector<HostResolver::Address>& addresses,
+                  int error);
+
+  /**
+   * Completes the connection, writes the pending requests and reads the
+   * responses.
+   *
+   * @param file
+   *            The socket.
+   * @param events
+   *            The ready events.
+   */
+  void onReady(int file, int events);
+
+  /**
+   * Resolves the host name and connects.
+   */
+  void open();
+
+  /**
+   * Sends a request, pipelined behind the requests in flight.
+   *
+   * @param exchange
+   *            The exchange.
+   */
+  void send(const Exchange& exchange);
+
+ private:
+
+  /**
+   * Timeout of the connection, whose meaning depends on its state.
+   */
+  class Timer : public echo::engine::io::EventLoop::Timeout {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param connection
+     *            The connection.
+     */
+    Timer(ClientConnection* connection) : connection(connection) {
+    }
+
+    /**
+     * Notifies the connection.
+     */
+    void onTimeout() {
+      connection->onTimeout();
+    }
+
+   private:
+
+    /** The connection. */
+    ClientConnection* connection;
+
+  };
+
+  /**
+   * Task notifying the listener once the connection is closed.
+   */
+  class Disposal : public echo::engine::io::EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param connection
+     *            The closed connection.
+     */
+    Disposal(ClientConnection* connection) : connection(connection) {
+    }
+
+    /**
+     * Notifies the listener.
+     */
+    void run() {
+      connection->listener->onClosed(connection, connection->retries);
+    }
+
+   private:
+
+    /** The closed connection. */
+    ClientConnection* connection;
+
+  };
+
+  /** The state of a connection resolving the host name. */
+  static const int RESOLVING;
+
+  /** The state of a connection connecting to an address. */
+  static const int CONNECTING;
+
+  /** The state of a connected connection. */
+  static const int CONNECTED;
+
+  /** The state of a closed connection. */
+  static const int CLOSED;
+
+  /** The delay between the checks of a paused body in milliseconds. */
+  static const int PAUSE_CHECK;
+
+  /**
+   * Connects to the next address.
+   */
+  void connectNext();
+
+  /**
+   * Writes the pending requests without blocking.
+   *
+   * @return False if the connection was closed.
+   */
+  bool flush();
+
+  /**
+   * Called when the timer expires.
+   */
+  void onTimeout();
+
+  /**
+   * Parses the received responses.
+   *
+   * @return False if the connection was closed.
+   */
+  bool process();
+
+  /**
+   * Reads the socket and parses the responses.
+   */
+  void receive();
+
+  /**
+   * Updates the events of interest and the timer after a change.
+   */
+  void update();
+
+  /**
+   * Non copyable.
+   */
+  ClientConnection(const ClientConnection&);
+
+  /**
+   * Non copyable.
+   */
+  ClientConnection& operator=(const ClientConnection&);
+
+  /** The client loop. */
+  echo::engine::io::EventLoop& loop;
+
+  /** The resolver of the host name. */
+  HostResolver& resolver;
+
+  /** The host name of the origin. */
+  const std::string host;
+
+  /** The port of the origin. */
+  const int port;
+
+  /** The maximum inactivity with requests in flight. */
+  const int timeout;
+
+  /** The maximum lifetime of an idle connection. */
+  const int idleTimeout;
+
+  /** The listener. */
+  Listener* listener;
+
+  /** The state. */
+  int state;
+
+  /** The socket or -1. */
+  int file;
+
+  /** The addresses not tried yet. */
+  std::vector<HostResolver::Address> addresses;
+
+  /** The reference watched by the resolver, reset once closed. */
+  std::tr1::shared_ptr<HostResolver::Listener*> self;
+
+  /** The requests in flight, in sending order. */
+  std::deque<Exchange> exchanges;
+
+  /** The exchanges to retry, given to the listener. */
+  std::deque<Exchange> retries;
+
+  /** The bytes of the requests not written yet. */
+  echo::engine::util::ChunkBuffer output;
+
+  /** The bytes received and not parsed yet. */
+  std::string input;
+
+  /** The offset of the first byte not parsed yet in the input. */
+  size_t inputOffset;
+
+  /** The content of the body being received. */
+  echo::engine::util::ChunkBuffer content;
+
+  /** The parser of the responses. */
+  MessageParser parser;
+
+  /** Indicates if the head of the first exchange was received. */
+  bool headReceived;
+
+  /** Indicates if the server accepts more requests. */
+  bool keepAlive;
+
+  /** Indicates if the reading is paused until the caller drains the body. */
+  bool paused;
+
+  /** The timer of the connection. */
+  Timer timer;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_CLIENT_CONNECTION_H_
@@ -0,0 +1,241 @@
+#ifndef _ECHO_ENGINE_HTTP_CLIENT_EXCHANGE_H_
+#define _ECHO_ENGINE_HTTP_CLIENT_EXCHANGE_H_
+
+#include <pthread.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/util/chunk-stream.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Request sent by the HTTP client connector and its response. The calling
+ * thread waits for the response head with {@link #await(int)}, then reads
+ * the body from {@link #getBody()} while the connection receives it, so that
+ * a large upstream body streams through without being buffered whole.<br>
+ * <br>
+ * Concurrency note: instances of this class are shared by the calling thread
+ * and the thread of the client loop.
+ */
+class ClientExchange {
+
+ public:
+
+  /** The headers of a response, in reception order. */
+  typedef std::vector<std::pair<std::string, std::string> > Headers;
+
+  /**
+   * Constructor.
+   *
+   * @param message
+   *            The serialized request, head and body, swapped out.
+   * @param idempotent
+   *            True if the request can be sent twice, and thus pipelined
+   *            and retried on another connection.
+   * @param headRequest
+   *            True for a HEAD request, whose response has no body.
+   */
+  ClientExchange(std::string& message, bool idempotent, bool headRequest);
+
+  /**
+   * Destructor.
+   */
+  ~ClientExchange();
+
+  /**
+   * Increments the number of times the request was sent.
+   */
+  void addAttempt() {
+    attempts++;
+  }
+
+  /**
+   * Waits for the response head.
+   *
+   * @param timeout
+   *            The maximum waiting time in milliseconds.
+   * @return True if the head was received, false in case of failure or
+   *         timeout.
+   */
+  bool await(int timeout);
+
+  /**
+   * Gives up on the response. The connection receiving it is closed.
+   */
+  void cancel();
+
+  /**
+   * Fails the exchange, aborting the body if the head was received.
+   *
+   * @param error
+   *            The errno value of the failure.
+   */
+  void fail(int error);
+
+  /**
+   * Returns the number of times the request was sent.
+   *
+   * @return The number of times the request was sent.
+   */
+  int getAttempts() const {
+    return attempts;
+  }
+
+  /**
+   * Returns the body of the response, closed once fully received.
+   *
+   * @return The body of the response.
+   */
+  echo::engine::util::ChunkStream& getBody() {
+    return body;
+  }
+
+  /**
+   * Returns the errno value of the failure.
+   *
+   * @return The errno value of the failure or 0.
+   */
+  int getError();
+
+  /**
+   * Returns the headers of the response.
+   *
+   * @return The headers of the response.
+   */
+  const Headers& getHeaders() const {
+    return headers;
+  }
+
+  /**
+   * Returns the serialized request.
+   *
+   * @return The serialized request.
+   */
+  const std::string& getMessage() const {
+    return message;
+  }
+
+  /**
+   * Returns the reason phrase of the response.
+   *
+   * @return The reason phrase of the response.
+   */
+  const std::string& getReason() const {
+    return reason;
+  }
+
+  /**
+   * Returns the status code of the response.
+   *
+   * @return The status code of the response.
+   */
+  int getStatus() const {
+    return status;
+  }
+
+  /**
+   * Indicates if the caller gave up on the response.
+   *
+   * @return True if the caller gave up.
+   */
+  bool isCancelled();
+
+  /**
+   * Indicates if this is a HEAD request.
+   *
+   * @return True for a HEAD request.
+   */
+  bool isHeadRequest() const {
+    return headRequest;
+  }
+
+  /**
+   * Indicates if the request can be sent twice.
+   *
+   * @return True if the request is idempotent.
+   */
+  bool isIdempotent() const {
+    return idempotent;
+  }
+
+  /**
+   * Delivers the response head to the waiting caller.
+   *
+   * @param parser
+   *            The parser of the response head.
+   */
+  void setHead(const MessageParser& parser);
+
+ private:
+
+  /** The state of an exchange waiting for its head. */
+  static const int WAITING;
+
+  /** The state of an exchange whose head was received. */
+  static const int RECEIVED;
+
+  /** The state of a failed exchange. */
+  static const int FAILED;
+
+  /** The state of an exchange given up by its caller. */
+  static const int CANCELLED;
+
+  /**
+   * Non copyable.
+   */
+  ClientExchange(const ClientExchange&);
+
+  /**
+   * Non copyable.
+   */
+  ClientExchange& operator=(const ClientExchange&);
+
+  /** The lock guarding the state. */
+  pthread_mutex_t lock;
+
+  /** Signaled when the head is received or the exchange fails. */
+  pthread_cond_t changed;
+
+  /** The state. */
+  int state;
+
+  /** The errno value of the failure or 0. */
+  int error;
+
+  /** The serialized request. */
+  std::string message;
+
+  /** True if the request can be sent twice. */
+  const bool idempotent;
+
+  /** True for a HEAD request. */
+  const bool headRequest;
+
+  /** The number of times the request was sent. */
+  int attempts;
+
+  /** The status code of the response. */
+  int status;
+
+  /** The reason phrase of the response. */
+  std::string reason;
+
+  /** The headers of the response. */
+  Headers headers;
+
+  /** The body of the response. */
+  echo::engine::util::ChunkStream body;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_CLIENT_EXCHANGE_H_
@@ -0,0 +1,146 @@
+#ifndef _ECHO_ENGINE_HTTP_CONNECTION_POOL_H_
+#define _ECHO_ENGINE_HTTP_CONNECTION_POOL_H_
+
+#include <deque>
+#include <list>
+#include <string>
+
+#include <echo/engine/http/client-connection.h>
+#include <echo/engine/http/host-resolver.h>
+#include <echo/engine/io/event-loop.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Persistent connections of the HTTP client connector to an origin server.
+ * A request takes the most recently released idle connection, or else opens
+ * a new one below the limit; beyond it, an idempotent request is pipelined
+ * on the least loaded connection that allows it, and the other requests wait
+ * for a connection to be released.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop.
+ */
+class ConnectionPool : public ClientConnection::Listener {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The client loop.
+   * @param resolver
+   *            The resolver of the host name.
+   * @param host
+   *            The host name of the origin.
+   * @param port
+   *            The port of the origin.
+   * @param maxConnections
+   *            The maximum number of connections to the origin.
+   * @param timeout
+   *            The maximum inactivity of a connection with requests in flight
+   *            in milliseconds.
+   * @param idleTimeout
+   *            The maximum lifetime of an idle connection in milliseconds.
+   */
+  ConnectionPool(echo::engine::io::EventLoop& loop, HostResolver& resolver,
+                 const std::string& host, int port, int maxConnections,
+                 int timeout, int idleTimeout);
+
+  /**
+   * Destructor closing the connections and failing the waiting exchanges.
+   */
+  ~ConnectionPool();
+
+  /**
+   * Indicates if the pool has neither connections nor waiting exchanges.
+   *
+   * @return True if the pool is empty.
+   */
+  bool isEmpty() const {
+    return connections.empty() && waiting.empty();
+  }
+
+  /**
+   * Removes and deletes a closed connection, then sends the exchanges to
+   * retry.
+   *
+   * @param connection
+   *            The closed connection.
+   * @param retries
+   *            The exchanges to send again.
+   */
+  void onClosed(ClientConnection* connection,
+                std::deque<ClientConnection::Exchange>& retries);
+
+  /**
+   * Moves a connection to the front of the pool and sends it a waiting
+   * exchange.
+   *
+   * @param connection
+   *            The released connection.
+   */
+  void onReleased(ClientConnection* connection);
+
+  /**
+   * Sends an exchange or queues it until a connection is available.
+   *
+   * @param exchange
+   *            The exchange.
+   */
+  void submit(const ClientConnection::Exchange& exchange);
+
+ private:
+
+  /**
+   * Sends the waiting exchanges that can be sent.
+   */
+  void dispatch();
+
+  /**
+   * Non copyable.
+   */
+  ConnectionPool(const ConnectionPool&);
+
+  /**
+   * Non copyable.
+   */
+  ConnectionPool& operator=(const ConnectionPool&);
+
+  /** The client loop. */
+  echo::engine::io::EventLoop& loop;
+
+  /** The resolver of the host name. */
+  HostResolver& resolver;
+
+  /** The host name of the origin. */
+  const std::string host;
+
+  /** The port of the origin. */
+  const int port;
+
+  /** The maximum number of connections. */
+  const int maxConnections;
+
+  /** The maximum inactivity with requests in flight. */
+  const int timeout;
+
+  /** The maximum lifetime of an idle connection. */
+  const int idleTimeout;
+
+  /** The connections, the most recently released first. */
+  std::list<ClientConnection*> connections;
+
+  /** The exchanges waiting for a connection. */
+  std::deque<ClientConnection::Exchange> waiting;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_CONNECTION_POOL_H_
@@ -0,0 +1,300 @@
+#ifndef _ECHO_ENGINE_HTTP_HEADER_ENCODER_H_
+#define _ECHO_ENGINE_HTTP_HEADER_ENCODER_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/cache-directive.h>
+#include <echo/data/dimension.h>
+#include <echo/data/preference.h>
+#include <echo/data/server-info.h>
+#include <echo/data/status.h>
+#include <echo/data/tag.h>
+#include <echo/representation/representation.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Encoder of request and response header blocks. The header lines are
+ * written one after the other into a single contiguous buffer which is kept
+ * from one message to the next, so that after a warm-up no allocation
+ * happens. The "Vary" lines of all the sets of dimensions and the
+ * "Cache-Control" lines of the common directives are serialized once and
+ * shared by all the encoders; adding one is an index lookup followed by a
+ * copy. Each encoder also keeps the "Server" line of its connector, whose
+ * agent doesn't change, and the "Content-Type" lines of the last media types
+ * and character sets, compared by identity since they are mostly the
+ * well-known constants.<br>
+ * <br>
+ * The header block and the entity are then sent to the connector with a
+ * single writev() call, as long as the entity has at most
+ * {@link #MAX_CHUNKS} chunks.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, each
+ * connection or thread is expected to use its own encoder.
+ *
+ * @see StatusTable
+ */
+class HeaderEncoder {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param cgi
+   *            True to start the blocks with a CGI "Status" line rather than
+   *            an HTTP/1.1 status line.
+   */
+  HeaderEncoder(bool cgi);
+
+  /**
+   * Adds a header line.
+   *
+   * @param name
+   *            The header name.
+   * @param value
+   *            The header value.
+   */
+  void add(const char* name, const std::string& value);
+
+  /**
+   * Adds the "Cache-Control" header of a list of directives.
+   *
+   * @param directives
+   *            The cache directives.
+   */
+  void addCacheControl(std::list<CacheDirective> directives);
+
+  /**
+   * Adds the "Content-Type" header of a media type and a character set.
+   *
+   * @param mediaType
+   *            The media type.
+   * @param characterSet
+   *            The character set or null.
+   */
+  void addContentType(MediaType mediaType, CharacterSet characterSet);
+
+  /**
+   * Adds a date header, formatted as defined by RFC 1123.
+   *
+   * @param name
+   *            The header name.
+   * @param date
+   *            The date.
+   */
+  void addDate(const char* name, Date date);
+
+  /**
+   * Adds a header with a numeric value.
+   *
+   * @param name
+   *            The header name.
+   * @param value
+   *            The numeric value.
+   */
+  void addNumber(const char* name, long long value);
+
+  /**
+   * Adds the header lines of the preferences, the credentials, the cookies
+   * and the conditions of a request, as forwarded by a client connector.
+   * The credentials are only sent when their raw value is known, such as
+   * when they come from a server connector.
+   *
+   * @param request
+   *            The request to encode.
+   */
+  void addRequestHeaders(Request request);
+
+  /**
+   * Adds the header lines of a response and of its entity, starting with the
+   * status line, and ends the block.
+   *
+   * @param response
+   *            The response to encode.
+   */
+  void addResponse(Response response) {
+    addResponseHeaders(response);
+    end();
+  }
+
+  /**
+   * Adds the header lines of a response and of its entity, starting with the
+   * status line, without ending the block, so that a connector can add its
+   * framing headers such as "Transfer-Encoding" or "Connection".
+   *
+   * @param response
+   *            The response to encode.
+   */
+  void addResponseHeaders(Response response);
+
+  /**
+   * Adds the "Server" header of a server.
+   *
+   * @param serverInfo
+   *            The server information.
+   */
+  void addServer(ServerInfo serverInfo);
+
+  /**
+   * Adds the status line.
+   *
+   * @param status
+   *            The status.
+   */
+  void addStatus(echo::data::Status status);
+
+  /**
+   * Adds the "Vary" header of a set of dimensions.
+   *
+   * @param dimensions
+   *            The dimensions.
+   */
+  void addVary(std::set<Dimension> dimensions);
+
+  /**
+   * Clears the buffer, keeping its capacity for the next block.
+   */
+  void clear() {
+    buffer.clear();
+  }
+
+  /**
+   * Ends the header block with an empty line.
+   */
+  void end() {
+    buffer.append("\r\n", 2);
+  }
+
+  /**
+   * Returns the encoded header block.
+   *
+   * @return The encoded header block.
+   */
+  const std::string& getBuffer() const {
+    return buffer;
+  }
+
+  /**
+   * Writes the header block followed by entity chunks, resuming until
+   * everything is written. The header block and the first
+   * {@link #MAX_CHUNKS} chunks are given to a single writev() call, the
+   * next chunks to the following ones.
+   *
+   * @param file
+   *            The descriptor of the connection.
+   * @param chunks
+   *            The entity chunks.
+   * @param count
+   *            The number of entity chunks.
+   * @return The number of bytes written or -1 in case of error.
+   */
+  ssize_t write(int file, const struct iovec* chunks, int count);
+
+  /**
+   * The maximum number of entity chunks written with the header block in a
+   * single writev() call.
+   */
+  static const int MAX_CHUNKS;
+
+ private:
+
+  /**
+   * Adds a header listing preferences, with their quality when lower than
+   * 1.
+   *
+   * @param name
+   *            The header name.
+   * @param preferences
+   *            The preferences.
+   */
+  template<class T>
+  void addPreferences(const char* name, std::list<Preference<T> > preferences) {
+    value.clear();
+
+    for (typename std::list<Preference<T> >::iterator it = preferences.begin();
+         it != preferences.end(); ++it) {
+      if (!value.empty()) {
+        value.append(", ", 2);
+      }
+
+      value += it->getMetadata().getName();
+
+      if (it->getQuality() < 1) {
+        char quality[16];
+        snprintf(quality, sizeof(quality), ";q=%.3g", it->getQuality());
+        value += quality;
+      }
+    }
+
+    if (!value.empty()) {
+      add(name, value);
+    }
+  }
+
+  /**
+   * Adds a header listing entity tags.
+   *
+   * @param name
+   *            The header name.
+   * @param tags
+   *            The entity tags.
+   */
+  void addTags(const char* name, std::list<Tag> tags);
+
+  /**
+   * Serialized "Content-Type" line of a media type and a character set.
+   */
+  struct ContentTypeLine {
+
+    /** The media type, compared by identity. */
+    MediaType mediaType;
+
+    /** The character set, compared by identity. */
+    CharacterSet characterSet;
+
+    /** The serialized line. */
+    std::string line;
+
+  };
+
+  /** Indicates if the blocks start with a CGI "Status" line. */
+  const bool cgi;
+
+  /** The header block. */
+  std::string buffer;
+
+  /** The scratch buffer formatting the multi-valued headers. */
+  std::string value;
+
+  /** The agent of the last "Server" line. */
+  std::string serverAgent;
+
+  /** The serialized "Server" line of the agent. */
+  std::string serverLine;
+
+  /** The last serialized "Content-Type" lines. */
+  std::vector<ContentTypeLine> contentTypes;
+
+  /** The index of the next "Content-Type" line to replace. */
+  size_t nextContentType;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_HEADER_ENCODER_H_
@@ -0,0 +1,73 @@
+#ifndef _ECHO_ENGINE_HTTP_HEADER_READER_H_
+#define _ECHO_ENGINE_HTTP_HEADER_READER_H_
+
+#include <string>
+#include <vector>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Tokenizer of header values, shared by the connectors mapping headers onto
+ * requests and responses. A value such as "gzip;q=1.0, identity; q=0.5" is
+ * split into its elements, an element into its parameters, and a
+ * preference element into its metadata and its quality. Separators within
+ * quoted strings, such as the commas of an entity tag, are kept.<br>
+ * <br>
+ * Concurrency note: the methods of this class are stateless and can be
+ * invoked by several threads at the same time.
+ */
+class HeaderReader {
+
+ public:
+
+  /**
+   * Returns the quality of a preference element, removing its "q"
+   * parameter and the extension parameters following it.
+   *
+   * @param element
+   *            The element, such as "text/html;level=1;q=0.5".
+   * @param metadata
+   *            The element without its quality, such as "text/html;level=1".
+   * @return The quality, 1 if absent and 0 if invalid.
+   */
+  static float getQuality(const std::string& element, std::string& metadata);
+
+  /**
+   * Splits a header value into its elements, trimmed of white spaces, the
+   * empty ones being skipped.
+   *
+   * @param value
+   *            The header value.
+   * @param separator
+   *            The separator of the elements, ',' for a list and ';' for
+   *            parameters.
+   * @param elements
+   *            The vector receiving the elements.
+   */
+  static void split(const std::string& value, char separator,
+                    std::vector<std::string>& elements);
+
+  /**
+   * Splits a parameter such as "Max-Age=60" into its name and its value,
+   * unquoted.
+   *
+   * @param parameter
+   *            The trimmed parameter.
+   * @param name
+   *            The name of the parameter.
+   * @param value
+   *            The value of the parameter, empty if absent.
+   * @return True if the parameter has a value.
+   */
+  static bool splitParameter(const std::string& parameter, std::string& name,
+                             std::string& value);
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_HEADER_READER_H_
@@ -0,0 +1,264 @@
+#ifndef _ECHO_ENGINE_HTTP_HOST_RESOLVER_H_
+#define _ECHO_ENGINE_HTTP_HOST_RESOLVER_H_
+
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <tr1/memory>
+#include <vector>
+
+#include <echo/engine/io/event-loop.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Resolver of host names running getaddrinfo() on its own threads, so that
+ * a slow DNS server never stalls an event loop. The addresses and the
+ * failures are cached for their own time to live; concurrent lookups of a
+ * name share a single query, and an expired entry is still served while it
+ * is refreshed in the background. Numeric addresses are resolved without a
+ * query.<br>
+ * <br>
+ * Concurrency note: instances of this class are thread-safe. They must
+ * outlive the loops they notify.
+ */
+class HostResolver {
+
+ public:
+
+  /**
+   * Address of a host.
+   */
+  struct Address {
+
+    /** The socket address. */
+    struct sockaddr_storage address;
+
+    /** The length of the socket address. */
+    socklen_t length;
+
+  };
+
+  /**
+   * Listener notified of a resolution.
+   */
+  class Listener {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Listener() {
+    }
+
+    /**
+     * Called on the loop thread when a name is resolved.
+     *
+     * @param addresses
+     *            The addresses of the host, empty in case of error.
+     * @param error
+     *            0 or the getaddrinfo() error code.
+     */
+    virtual void onResolved(const std::vector<Address>& addresses,
+                            int error) = 0;
+
+  };
+
+  /** The default time to live of the cached addresses in milliseconds. */
+  static const long long DEFAULT_POSITIVE_TTL;
+
+  /** The default time to live of the cached failures in milliseconds. */
+  static const long long DEFAULT_NEGATIVE_TTL;
+
+  /** The maximum number of cached names. */
+  static const size_t MAX_ENTRIES;
+
+  /**
+   * Constructor starting the resolving threads.
+   *
+   * @param threads
+   *            The number of resolving threads.
+   * @param positiveTtl
+   *            The time to live of the cached addresses in milliseconds.
+   * @param negativeTtl
+   *            The time to live of the cached failures in milliseconds.
+   */
+  HostResolver(int threads, long long positiveTtl, long long negativeTtl);
+
+  /**
+   * Destructor stopping the resolving threads. The queued lookups are
+   * dropped.
+   */
+  virtual ~HostResolver();
+
+  /**
+   * Resolves a name, notifying the listener on the thread of a loop, right
+   * away if the name is cached.
+   *
+   * @param loop
+   *            The loop notifying the listener.
+   * @param host
+   *            The name or the numeric address of the host.
+   * @param port
+   *            The port of the addresses.
+   * @param listener
+   *            The listener to notify, ignored if expired by then.
+   */
+  void resolve(echo::engine::io::EventLoop& loop, const std::string& host,
+               int port, const std::tr1::weak_ptr<Listener*>& listener);
+
+ protected:
+
+  /**
+   * Queries the addresses of a name with getaddrinfo(), possibly blocking.
+   * Called by the resolving threads, without holding the lock.
+   *
+   * @param host
+   *            The name of the host.
+   * @param port
+   *            The port of the addresses.
+   * @param addresses
+   *            The addresses of the host.
+   * @return 0 or the getaddrinfo() error code.
+   */
+  virtual int query(const std::string& host, int port,
+                    std::vector<Address>& addresses);
+
+ private:
+
+  /**
+   * Listener waiting for a query.
+   */
+  struct Waiter {
+
+    /** The loop notifying the listener. */
+    echo::engine::io::EventLoop* loop;
+
+    /** The listener. */
+    std::tr1::weak_ptr<Listener*> listener;
+
+  };
+
+  /**
+   * Cached name.
+   */
+  struct Entry {
+
+    /** The addresses. */
+    std::vector<Address> addresses;
+
+    /** 0 or the getaddrinfo() error code. */
+    int error;
+
+    /** The expiration time. */
+    long long expiration;
+
+    /** Indicates if a query is queued or running. */
+    bool querying;
+
+    /** The listeners waiting for the query. */
+    std::vector<Waiter> waiters;
+
+  };
+
+  /**
+   * Task notifying a listener on the thread of its loop.
+   */
+  class Notification : public echo::engine::io::EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param listener
+     *            The listener.
+     * @param addresses
+     *            The addresses.
+     * @param error
+     *            0 or the getaddrinfo() error code.
+     */
+    Notification(const std::tr1::weak_ptr<Listener*>& listener,
+                 const std::vector<Address>& addresses, int error)
+        : listener(listener), addresses(addresses), error(error) {
+    }
+
+    /**
+     * Notifies the listener unless expired.
+     */
+    void run();
+
+   private:
+
+    /** The listener. */
+    std::tr1::weak_ptr<Listener*> listener;
+
+    /** The addresses. */
+    std::vector<Address> addresses;
+
+    /** 0 or the getaddrinfo() error code. */
+    int error;
+
+  };
+
+  /**
+   * Runs a resolving thread.
+   *
+   * @param resolver
+   *            The resolver.
+   * @return Null.
+   */
+  static void* run(void* resolver);
+
+  /**
+   * Runs the queries until the resolver is destroyed.
+   */
+  void runQueries();
+
+  /**
+   * Non copyable.
+   */
+  HostResolver(const HostResolver&);
+
+  /**
+   * Non copyable.
+   */
+  HostResolver& operator=(const HostResolver&);
+
+  /** The lock guarding the entries and the queue. */
+  pthread_mutex_t lock;
+
+  /** Signaled when a query is queued. */
+  pthread_cond_t queued;
+
+  /** The cached names, keyed by "host:port". */
+  std::map<std::string, Entry> entries;
+
+  /** The keys of the queued queries. */
+  std::deque<std::string> queries;
+
+  /** The resolving threads. */
+  std::vector<pthread_t> threads;
+
+  /** The time to live of the cached addresses. */
+  const long long positiveTtl;
+
+  /** The time to live of the cached failures. */
+  const long long negativeTtl;
+
+  /** Indicates if the resolver is being destroyed. */
+  bool stopped;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_HOST_RESOLVER_H_
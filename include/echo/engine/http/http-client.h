@@ -0,0 +1,233 @@
+#ifndef _ECHO_ENGINE_HTTP_HTTP_CLIENT_H_
+#define _ECHO_ENGINE_HTTP_HTTP_CLIENT_H_
+
+#include <pthread.h>
+
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include <echo/connector.h>
+#include <echo/context.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/protocol.h>
+#include <echo/engine/http/connection-pool.h>
+#include <echo/engine/http/host-resolver.h>
+#include <echo/engine/io/event-loop.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Client connector of the HTTP/1.1 protocol, typically the client dispatcher
+ * behind the reverse-proxy routes of a {@link Redirector}. The connections
+ * are kept alive in a pool per origin server, so that a proxied call doesn't
+ * pay a TCP handshake, and idempotent requests are pipelined when all the
+ * connections of an origin are busy. The host names are resolved by
+ * background threads and cached.<br>
+ * <br>
+ * All the connections are driven by a single event loop thread. The calling
+ * thread waits for the response head only; the response entity is a
+ * {@link ChunkStreamRepresentation} receiving the body while it is read, so
+ * that {@link Redirector#rewrite(Representation)} and the server connector
+ * stream it on without buffering it whole. The request entity is sent as a
+ * whole with a "Content-Length" header.<br>
+ * <br>
+ * The preferences, the credentials, the cookies and the conditions of the
+ * request are forwarded as their headers. The known response headers, such
+ * as "Cache-Control", "Set-Cookie", "Content-Encoding" or "ETag", are mapped
+ * onto the response and its entity; all of them stay available as the raw
+ * "org.restlet.http.headers" attribute.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ */
+class HttpClient : public echo::Connector {
+
+ public:
+
+  /** The default maximum number of connections per origin server. */
+  static const int DEFAULT_MAX_CONNECTIONS;
+
+  /** The default maximum waiting time for a response in milliseconds. */
+  static const int DEFAULT_TIMEOUT;
+
+  /** The default maximum lifetime of an idle connection in milliseconds. */
+  static const int DEFAULT_IDLE_TIMEOUT;
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  HttpClient(echo::Context context);
+
+  /**
+   * Sends a request to its origin server and waits for the response head.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  //@Override
+  void handle(echo::Request request, echo::Response response);
+
+  /**
+   * Indicates that the connector is available.
+   *
+   * @return True.
+   */
+  //@Override
+  bool isAvailable() {
+    return true;
+  }
+
+  /**
+   * Sets the maximum number of connections per origin server. Must be set
+   * before the connector is started.
+   *
+   * @param maxConnections
+   *            The maximum number of connections per origin server.
+   */
+  void setMaxConnections(int maxConnections) {
+    this->maxConnections = maxConnections;
+  }
+
+  /**
+   * Sets the maximum waiting time for a response, which is also the maximum
+   * inactivity of a connection with requests in flight. Must be set before
+   * the connector is started.
+   *
+   * @param timeout
+   *            The maximum waiting time in milliseconds.
+   */
+  void setTimeout(int timeout) {
+    this->timeout = timeout;
+  }
+
+  /**
+   * Sets the maximum lifetime of an idle connection. Must be set before the
+   * connector is started.
+   *
+   * @param idleTimeout
+   *            The maximum lifetime of an idle connection in milliseconds.
+   */
+  void setIdleTimeout(int idleTimeout) {
+    this->idleTimeout = idleTimeout;
+  }
+
+  /**
+   * Starts the resolver and the thread of the event loop.
+   */
+  //@Override
+  void start() throw (std::runtime_error);
+
+  /**
+   * Stops the thread of the event loop and closes the connections.
+   */
+  //@Override
+  void stop() throw (std::runtime_error);
+
+ private:
+
+  /**
+   * Task handing an exchange to the pool of its origin.
+   */
+  class Submission : public echo::engine::io::EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param client
+     *            The connector.
+     * @param host
+     *            The host name of the origin.
+     * @param port
+     *            The port of the origin.
+     * @param exchange
+     *            The exchange.
+     */
+    Submission(HttpClient* client, const std::string& host, int port,
+               const ClientConnection::Exchange& exchange)
+        : client(client), host(host), port(port), exchange(exchange) {
+    }
+
+    /**
+     * Submits the exchange to the pool of its origin.
+     */
+    void run() {
+      client->getPool(host, port)->submit(exchange);
+    }
+
+   private:
+
+    /** The connector. */
+    HttpClient* client;
+
+    /** The host name of the origin. */
+    const std::string host;
+
+    /** The port of the origin. */
+    const int port;
+
+    /** The exchange. */
+    const ClientConnection::Exchange exchange;
+
+  };
+
+  /**
+   * Runs the event loop.
+   *
+   * @param client
+   *            The connector.
+   * @return Null.
+   */
+  static void* run(void* client);
+
+  /**
+   * Returns the pool of an origin, created if needed. Called by the thread
+   * of the event loop.
+   *
+   * @param host
+   *            The host name of the origin.
+   * @param port
+   *            The port of the origin.
+   * @return The pool of the origin.
+   */
+  ConnectionPool* getPool(const std::string& host, int port);
+
+  /** The maximum number of connections per origin server. */
+  int maxConnections;
+
+  /** The maximum waiting time for a response. */
+  int timeout;
+
+  /** The maximum lifetime of an idle connection. */
+  int idleTimeout;
+
+  /** The event loop driving the connections, while started. */
+  echo::engine::io::EventLoop* loop;
+
+  /** The resolver of the host names, while started. */
+  HostResolver* resolver;
+
+  /** The thread of the event loop. */
+  pthread_t thread;
+
+  /** The pools indexed by origin, used by the thread of the event loop. */
+  std::map<std::string, ConnectionPool*> pools;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_HTTP_CLIENT_H_
@@ -0,0 +1,284 @@
+#ifndef _ECHO_ENGINE_HTTP_HTTP_SERVER_H_
+#define _ECHO_ENGINE_HTTP_HTTP_SERVER_H_
+
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <echo/application.h>
+#include <echo/connector.h>
+#include <echo/context.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/protocol.h>
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/http/server-connection.h>
+#include <echo/engine/http/server-shard.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Server connector of the HTTP/1.1 protocol, serving an application without
+ * a fronting web server. The connections are spread over
+ * {@link ServerShard}s, one per CPU by default, each listening on the port
+ * with SO_REUSEPORT and driving its connections with its own epoll event
+ * loop thread, with keep-alive and pipelining. Each request is handed
+ * directly to {@link Application#handle(Request, Response)} on the thread of
+ * its shard, so the application is expected not to block; a response entity
+ * still being generated is streamed instead.<br>
+ * <br>
+ * The response is written according to its entity: the chunks of an
+ * {@link AppendableRepresentation} and a text are written with the head in a
+ * single writev() call, a streamed {@link AppendableRepresentation} or a
+ * {@link ChunkStreamRepresentation} is framed with the chunked transfer
+ * coding as it is produced, and a {@link FileRepresentation} or a
+ * {@link SourceRepresentation} is moved by a {@link Transfer} without
+ * blocking the loop. The request entity is received whole before the
+ * request is handled.<br>
+ * <br>
+ * The "Cookie", "Authorization", "Accept*" and conditional headers are
+ * mapped onto the request before it is handled, the cookies being parsed
+ * only if the application asks for them. All the headers stay available as
+ * the raw "org.restlet.http.headers" attribute.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ */
+class HttpServer : public echo::Connector {
+
+ public:
+
+  /** The default maximum inactivity of a request in milliseconds. */
+  static const int DEFAULT_TIMEOUT;
+
+  /** The default maximum lifetime of an idle connection in milliseconds. */
+  static const int DEFAULT_IDLE_TIMEOUT;
+
+  /** The default maximum size of a request entity in bytes. */
+  static const size_t DEFAULT_MAX_ENTITY_SIZE;
+
+  /** The default name of the engine reading the files. */
+  static const std::string DEFAULT_IO_ENGINE;
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   * @param port
+   *            The listening port.
+   * @param application
+   *            The application handling the requests.
+   */
+  HttpServer(echo::Context context, int port,
+             echo::Application application);
+
+  /**
+   * Returns the maximum lifetime of an idle connection.
+   *
+   * @return The maximum lifetime of an idle connection in milliseconds.
+   */
+  int getIdleTimeout() const {
+    return idleTimeout;
+  }
+
+  /**
+   * Returns the name of the engine reading the files.
+   *
+   * @return The name of the engine reading the files.
+   */
+  const std::string& getIoEngine() const {
+    return ioEngine;
+  }
+
+  /**
+   * Returns the maximum size of a request entity.
+   *
+   * @return The maximum size of a request entity in bytes.
+   */
+  size_t getMaxEntitySize() const {
+    return maxEntitySize;
+  }
+
+  /**
+   * Returns the listening port, the one chosen by the system once started
+   * if the port was 0.
+   *
+   * @return The listening port.
+   */
+  int getPort() {
+    return port;
+  }
+
+  /**
+   * Returns the maximum inactivity of a request.
+   *
+   * @return The maximum inactivity of a request in milliseconds.
+   */
+  int getTimeout() const {
+    return timeout;
+  }
+
+  /**
+   * Hands a request to the application.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  //@Override
+  void handle(echo::Request request, echo::Response response) {
+    this->application.handle(request, response);
+  }
+
+  /**
+   * Indicates that the connector is available.
+   *
+   * @return True.
+   */
+  //@Override
+  bool isAvailable() {
+    return true;
+  }
+
+  /**
+   * Builds the request, hands it to the application and writes the response.
+   * Called by the thread of the shard.
+   *
+   * @param shard
+   *            The shard of the connection.
+   * @param connection
+   *            The connection.
+   * @param head
+   *            The parser holding the request head.
+   * @param body
+   *            The request body.
+   */
+  void onRequest(ServerShard& shard, ServerConnection* connection,
+                 const MessageParser& head,
+                 echo::engine::util::ChunkBuffer& body);
+
+  /**
+   * Sets the listening address. Must be set before the connector is started.
+   *
+   * @param address
+   *            The listening address, all the interfaces if empty.
+   */
+  void setAddress(std::string address) {
+    this->address = address;
+  }
+
+  /**
+   * Sets the maximum lifetime of an idle connection. Must be set before the
+   * connector is started.
+   *
+   * @param idleTimeout
+   *            The maximum lifetime of an idle connection in milliseconds.
+   */
+  void setIdleTimeout(int idleTimeout) {
+    this->idleTimeout = idleTimeout;
+  }
+
+  /**
+   * Sets the name of the engine reading the files. Must be set before the
+   * connector is started.
+   *
+   * @param ioEngine
+   *            The name of the engine, "io_uring", "epoll" or "auto".
+   */
+  void setIoEngine(const std::string& ioEngine) {
+    this->ioEngine = ioEngine;
+  }
+
+  /**
+   * Sets the maximum size of a request entity. Must be set before the
+   * connector is started.
+   *
+   * @param maxEntitySize
+   *            The maximum size of a request entity in bytes.
+   */
+  void setMaxEntitySize(size_t maxEntitySize) {
+    this->maxEntitySize = maxEntitySize;
+  }
+
+  /**
+   * Sets the number of shards. Must be set before the connector is started.
+   *
+   * @param shards
+   *            The number of shards, 0 for one per CPU the process may run
+   *            on.
+   */
+  void setShards(int shards) {
+    this->shardCount = shards;
+  }
+
+  /**
+   * Sets the maximum inactivity of a request. Must be set before the
+   * connector is started.
+   *
+   * @param timeout
+   *            The maximum inactivity of a request in milliseconds.
+   */
+  void setTimeout(int timeout) {
+    this->timeout = timeout;
+  }
+
+  /**
+   * Starts the shards, each pinned to one of the CPUs the process may run
+   * on.
+   */
+  //@Override
+  void start() throw (std::runtime_error);
+
+  /**
+   * Stops the shards and closes the connections.
+   */
+  //@Override
+  void stop() throw (std::runtime_error);
+
+ private:
+
+  /**
+   * Stops and deletes the started shards.
+   */
+  void stopShards();
+
+  /** The listening address, all the interfaces if empty. */
+  std::string address;
+
+  /** The listening port. */
+  int port;
+
+  /** The application handling the requests. */
+  echo::Application application;
+
+  /** The maximum inactivity of a request. */
+  int timeout;
+
+  /** The maximum lifetime of an idle connection. */
+  int idleTimeout;
+
+  /** The maximum size of a request entity. */
+  size_t maxEntitySize;
+
+  /** The name of the engine reading the files. */
+  std::string ioEngine;
+
+  /** The number of shards, 0 for one per CPU. */
+  int shardCount;
+
+  /** The shards, while started. */
+  std::vector<ServerShard*> shards;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_HTTP_SERVER_H_
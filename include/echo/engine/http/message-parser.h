@@ -0,0 +1,343 @@
+#ifndef _ECHO_ENGINE_HTTP_MESSAGE_PARSER_H_
+#define _ECHO_ENGINE_HTTP_MESSAGE_PARSER_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Incremental parser of HTTP/1.1 messages, requests or responses, read from a
+ * connection. The head is parsed in place once its terminating empty line is
+ * received, each call only scanning the bytes received since the previous
+ * one; the start line and the headers are slices of the input, nothing is
+ * copied. The body is then decoded according to its framing, a content
+ * length, the chunked coding or, for a response, the end of the
+ * connection.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, they belong
+ * to a connection.
+ */
+class MessageParser {
+
+ public:
+
+  /**
+   * Region of the input.
+   */
+  struct Slice {
+
+    /**
+     * Compares the slice with a string, ignoring the case.
+     *
+     * @param value
+     *            The string to compare.
+     * @return True if the slice equals the string.
+     */
+    bool equalsIgnoreCase(const char* value) const;
+
+    /**
+     * Copies the slice.
+     *
+     * @return A copy of the slice.
+     */
+    std::string toString() const {
+      return std::string(data, length);
+    }
+
+    /** The first byte. */
+    const char* data;
+
+    /** The length in bytes. */
+    size_t length;
+
+  };
+
+  /**
+   * Header of the head.
+   */
+  struct Header {
+
+    /** The name. */
+    Slice name;
+
+    /** The value, without the surrounding spaces. */
+    Slice value;
+
+  };
+
+  /** The type of the parsers of requests. */
+  static const int REQUEST;
+
+  /** The type of the parsers of responses. */
+  static const int RESPONSE;
+
+  /** The maximum size of a head. */
+  static const size_t MAX_HEAD_SIZE;
+
+  /** The maximum number of headers. */
+  static const size_t MAX_HEADERS;
+
+  /**
+   * Constructor.
+   *
+   * @param type
+   *            The type of the messages, {@link #REQUEST} or
+   *            {@link #RESPONSE}.
+   */
+  MessageParser(int type);
+
+  /**
+   * Completes a body delimited by the end of the connection.
+   *
+   * @return True if the body is complete, false if the connection ended
+   *         before the framing did.
+   */
+  bool finish();
+
+  /**
+   * Returns the value of the Content-Length header.
+   *
+   * @return The content length or -1 if not set.
+   */
+  long long getContentLength() const {
+    return contentLength;
+  }
+
+  /**
+   * Returns the first header with a given name.
+   *
+   * @param name
+   *            The name of the header.
+   * @return The header or null.
+   */
+  const Header* getHeader(const char* name) const;
+
+  /**
+   * Returns the headers in reception order.
+   *
+   * @return The headers.
+   */
+  const std::vector<Header>& getHeaders() const {
+    return headers;
+  }
+
+  /**
+   * Returns the method of a request.
+   *
+   * @return The method.
+   */
+  const Slice& getMethod() const {
+    return method;
+  }
+
+  /**
+   * Returns the minor version of the protocol, 0 for HTTP/1.0 and 1 for
+   * HTTP/1.1.
+   *
+   * @return The minor version.
+   */
+  int getMinorVersion() const {
+    return minorVersion;
+  }
+
+  /**
+   * Returns the reason phrase of a response.
+   *
+   * @return The reason phrase.
+   */
+  const Slice& getReason() const {
+    return reason;
+  }
+
+  /**
+   * Returns the status code of a response.
+   *
+   * @return The status code.
+   */
+  int getStatus() const {
+    return status;
+  }
+
+  /**
+   * Returns the target of a request.
+   *
+   * @return The target, usually an absolute path and a query.
+   */
+  const Slice& getTarget() const {
+    return target;
+  }
+
+  /**
+   * Indicates if the body is complete.
+   *
+   * @return True if the body is complete.
+   */
+  bool isBodyDone() const {
+    return bodyState == BODY_DONE;
+  }
+
+  /**
+   * Indicates if the body uses the chunked coding.
+   *
+   * @return True if the body uses the chunked coding.
+   */
+  bool isChunked() const {
+    return chunked;
+  }
+
+  /**
+   * Indicates if the connection can be reused after the message, according
+   * to its version and its Connection header.
+   *
+   * @return True if the connection can be reused.
+   */
+  bool isKeepAlive() const {
+    return keepAlive;
+  }
+
+  /**
+   * Decodes the next bytes of the body.
+   *
+   * @param data
+   *            The bytes received.
+   * @param length
+   *            The number of bytes received.
+   * @param output
+   *            The buffer receiving the content.
+   * @return The number of bytes consumed, possibly fewer than received when
+   *         the body ends, or -1 if the framing is malformed.
+   */
+  ssize_t parseBody(const char* data, size_t length,
+                    echo::engine::util::ChunkBuffer& output);
+
+  /**
+   * Parses the head once fully received. The slices of the head point into
+   * the given bytes, which must stay unchanged until the next reset.
+   *
+   * @param data
+   *            The bytes received since the start of the message.
+   * @param length
+   *            The number of bytes received.
+   * @return The size of the head, 0 if the head isn't fully received yet,
+   *         or -1 if it is malformed or too large.
+   */
+  ssize_t parseHead(const char* data, size_t length);
+
+  /**
+   * Prepares the parser for the next message of the connection.
+   */
+  void reset();
+
+  /**
+   * Starts the body after the head, according to its framing.
+   *
+   * @param empty
+   *            True if the message has no body whatever its headers, such
+   *            as the response to a HEAD request or a 204 or 304 response.
+   */
+  void startBody(bool empty);
+
+ private:
+
+  /** The state of a body waiting for its content length. */
+  static const int BODY_LENGTH;
+
+  /** The state of a body waiting for a chunk size line. */
+  static const int BODY_CHUNK_SIZE;
+
+  /** The state of a body waiting for the data of a chunk. */
+  static const int BODY_CHUNK_DATA;
+
+  /** The state of a body waiting for the line ending a chunk. */
+  static const int BODY_CHUNK_END;
+
+  /** The state of a body waiting for the trailers. */
+  static const int BODY_TRAILERS;
+
+  /** The state of a body delimited by the end of the connection. */
+  static const int BODY_UNTIL_CLOSE;
+
+  /** The state of a complete body. */
+  static const int BODY_DONE;
+
+  /**
+   * Parses the start line.
+   *
+   * @param data
+   *            The start line.
+   * @param length
+   *            The length of the start line, without its line break.
+   * @return True if the line is well formed.
+   */
+  bool parseStartLine(const char* data, size_t length);
+
+  /**
+   * Accumulates a line of the chunked framing.
+   *
+   * @param data
+   *            The bytes received.
+   * @param length
+   *            The number of bytes received.
+   * @param consumed
+   *            The number of bytes consumed, updated.
+   * @return True once the line is complete.
+   */
+  bool readLine(const char* data, size_t length, size_t& consumed);
+
+  /** The type of the messages. */
+  const int type;
+
+  /** The number of bytes already scanned for the end of the head. */
+  size_t scanned;
+
+  /** The method of a request. */
+  Slice method;
+
+  /** The target of a request. */
+  Slice target;
+
+  /** The reason phrase of a response. */
+  Slice reason;
+
+  /** The status code of a response. */
+  int status;
+
+  /** The minor version of the protocol. */
+  int minorVersion;
+
+  /** The headers. */
+  std::vector<Header> headers;
+
+  /** The content length or -1. */
+  long long contentLength;
+
+  /** Indicates if the body uses the chunked coding. */
+  bool chunked;
+
+  /** Indicates if the connection can be reused after the message. */
+  bool keepAlive;
+
+  /** The state of the body. */
+  int bodyState;
+
+  /** The number of bytes left in the body or the current chunk. */
+  unsigned long long remaining;
+
+  /** The line of the chunked framing being received. */
+  std::string line;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_MESSAGE_PARSER_H_
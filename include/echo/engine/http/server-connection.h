@@ -0,0 +1,448 @@
+#ifndef _ECHO_ENGINE_HTTP_SERVER_CONNECTION_H_
+#define _ECHO_ENGINE_HTTP_SERVER_CONNECTION_H_
+
+#include <sys/uio.h>
+
+#include <string>
+
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/http/stream-writer.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/readable-source.h>
+#include <echo/engine/io/transfer.h>
+#include <echo/engine/util/chunk-buffer.h>
+#include <echo/engine/util/chunk-stream.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Connection accepted by the HTTP server connector. The requests are parsed
+ * in place from the input buffer, so that the method, the target and the
+ * headers handed to the listener are slices of the received bytes; only the
+ * head of a request whose body spans several reads is copied aside. Pipelined
+ * requests are handled in order, each one once the response of the previous
+ * one was written or staged.<br>
+ * <br>
+ * A response is written with a single writev() call when the socket accepts
+ * it, and only the bytes it refused are copied to the output buffer. A
+ * streamed entity is framed with the chunked transfer coding as its chunks
+ * are produced, and a non-blocking source is moved by a {@link Transfer}.
+ * While the output buffer is above its high-water mark, the connection stops
+ * reading, so that a client pipelining requests without reading the
+ * responses is slowed down.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop.
+ */
+class ServerConnection : public echo::engine::io::EventLoop::Handler,
+                         public echo::engine::io::Transfer::Listener {
+
+ public:
+
+  /**
+   * Listener of the connection, typically the server connector.
+   */
+  class Listener {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Listener() {
+    }
+
+    /**
+     * Called once the connection is closed, from a task run after the
+     * closing call returned. The listener releases the entity of a response
+     * still being written, then deletes the connection.
+     *
+     * @param connection
+     *            The closed connection.
+     */
+    virtual void onClosed(ServerConnection* connection) = 0;
+
+    /**
+     * Called when a request is received. The listener must respond before
+     * returning, with one of the respond() methods.
+     *
+     * @param connection
+     *            The connection.
+     * @param head
+     *            The parser holding the request head, valid until the
+     *            listener returns.
+     * @param body
+     *            The request body.
+     */
+    virtual void onRequest(ServerConnection* connection,
+                           const MessageParser& head,
+                           echo::engine::util::ChunkBuffer& body) = 0;
+
+    /**
+     * Called once the streamed or transferred entity of a response was
+     * entirely written, so that the listener can release it.
+     *
+     * @param connection
+     *            The connection.
+     */
+    virtual void onResponded(ServerConnection* connection) = 0;
+
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The server loop.
+   * @param file
+   *            The accepted socket, non-blocking, owned by the connection.
+   * @param timeout
+   *            The maximum inactivity of a connection with a request in
+   *            progress in milliseconds.
+   * @param idleTimeout
+   *            The maximum lifetime of an idle connection in milliseconds.
+   * @param maxEntitySize
+   *            The maximum size of a request body in bytes.
+   * @param listener
+   *            The listener.
+   */
+  ServerConnection(echo::engine::io::EventLoop& loop, int file, int timeout,
+                   int idleTimeout, size_t maxEntitySize, Listener* listener);
+
+  /**
+   * Destructor closing the socket. The listener isn't notified.
+   */
+  ~ServerConnection();
+
+  /**
+   * Closes the connection and notifies the listener from a task. A streamed
+   * entity is aborted.
+   */
+  void close();
+
+  /**
+   * Indicates if the connection isn't closed.
+   *
+   * @return True if the connection isn't closed.
+   */
+  bool isOpen() const {
+    return state != CLOSED;
+  }
+
+  /**
+   * Resumes the handling of the requests once a transfer is complete.
+   *
+   * @param transfer
+   *            The transfer, deleted by this call.
+   * @param success
+   *            True if the whole source was written.
+   */
+  void onComplete(echo::engine::io::Transfer* transfer, bool success);
+
+  /**
+   * Reads the requests and writes the responses.
+   *
+   * @param file
+   *            The socket.
+   * @param events
+   *            The ready events.
+   */
+  void onReady(int file, int events);
+
+  /**
+   * Registers the connection with its loop.
+   */
+  void open();
+
+  /**
+   * Responds with an entity held in memory.
+   *
+   * @param head
+   *            The response head, header block included.
+   * @param vectors
+   *            The entity vectors, valid until this call returns.
+   * @param count
+   *            The number of entity vectors.
+   * @param close
+   *            True to close the connection after the response.
+   */
+  void respond(const std::string& head, const struct iovec* vectors,
+               int count, bool close);
+
+  /**
+   * Responds with an entity streamed as it is produced. The stream must
+   * stay alive until the listener is notified.
+   *
+   * @param head
+   *            The response head, header block included.
+   * @param stream
+   *            The stream of the entity.
+   * @param chunked
+   *            True to frame the chunks with the chunked transfer coding,
+   *            false to write them as is.
+   * @param close
+   *            True to close the connection after the response.
+   */
+  void respond(const std::string& head,
+               echo::engine::util::ChunkStream& stream, bool chunked,
+               bool close);
+
+  /**
+   * Responds with an entity read from a non-blocking source. The source must
+   * stay alive until the listener is notified.
+   *
+   * @param head
+   *            The response head, header block included.
+   * @param source
+   *            The source of the entity.
+   * @param close
+   *            True to close the connection after the response.
+   */
+  void respond(const std::string& head,
+               echo::engine::io::ReadableSource* source, bool close);
+
+ private:
+
+  /**
+   * Timeout of the connection, whose meaning depends on its state.
+   */
+  class Timer : public echo::engine::io::EventLoop::Timeout {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param connection
+     *            The connection.
+     */
+    Timer(ServerConnection* connection) : connection(connection) {
+    }
+
+    /**
+     * Notifies the connection.
+     */
+    void onTimeout() {
+      connection->onTimeout();
+    }
+
+   private:
+
+    /** The connection. */
+    ServerConnection* connection;
+
+  };
+
+  /**
+   * Task notifying the listener once the connection is closed.
+   */
+  class Disposal : public echo::engine::io::EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param connection
+     *            The closed connection.
+     */
+    Disposal(ServerConnection* connection) : connection(connection) {
+    }
+
+    /**
+     * Notifies the listener.
+     */
+    void run() {
+      connection->listener->onClosed(connection);
+    }
+
+   private:
+
+    /** The closed connection. */
+    ServerConnection* connection;
+
+  };
+
+  /** The state of a connection reading requests. */
+  static const int READING;
+
+  /** The state of a connection writing a streamed entity. */
+  static const int STREAMING;
+
+  /** The state of a connection transferring a source. */
+  static const int TRANSFERRING;
+
+  /** The state of a closed connection. */
+  static const int CLOSED;
+
+  /** The delay between the checks of a stream waiting for chunks. */
+  static const int STREAM_CHECK;
+
+  /**
+   * Handles the end of a response, closing the connection if requested.
+   *
+   * @return False if the connection was closed.
+   */
+  bool complete();
+
+  /**
+   * Writes the staged output without blocking.
+   *
+   * @return False if the connection was closed.
+   */
+  bool flush();
+
+  /**
+   * Called when the timer expires.
+   */
+  void onTimeout();
+
+  /**
+   * Parses the received requests and hands the complete ones to the
+   * listener.
+   *
+   * @return False if the connection was closed.
+   */
+  bool process();
+
+  /**
+   * Writes the produced chunks of the streamed entity, then the end of the
+   * stream once it is closed.
+   *
+   * @return False if the connection was closed.
+   */
+  bool pump();
+
+  /**
+   * Reads the socket and handles the requests.
+   */
+  void receive();
+
+  /**
+   * Responds to an invalid request with an empty error response and closes
+   * the connection once it is written.
+   *
+   * @param status
+   *            The status code.
+   */
+  void reject(int status);
+
+  /**
+   * Starts the transfer of the source once the head was written.
+   */
+  void startTransfer();
+
+  /**
+   * Updates the events of interest and the timer after a change.
+   */
+  void update();
+
+  /**
+   * Writes vectors directly when nothing is staged, then stages what the
+   * socket didn't accept.
+   *
+   * @param vectors
+   *            The vectors, modified.
+   * @param count
+   *            The number of vectors.
+   * @return False if the connection was closed.
+   */
+  bool write(struct iovec* vectors, int count);
+
+  /**
+   * Non copyable.
+   */
+  ServerConnection(const ServerConnection&);
+
+  /**
+   * Non copyable.
+   */
+  ServerConnection& operator=(const ServerConnection&);
+
+  /** The server loop. */
+  echo::engine::io::EventLoop& loop;
+
+  /** The socket. */
+  const int file;
+
+  /** The maximum inactivity with a request in progress. */
+  const int timeout;
+
+  /** The maximum lifetime of an idle connection. */
+  const int idleTimeout;
+
+  /** The maximum size of a request body. */
+  const size_t maxEntitySize;
+
+  /** The listener. */
+  Listener* listener;
+
+  /** The state. */
+  int state;
+
+  /** The events of interest registered with the loop, or -1. */
+  int events;
+
+  /** The input buffer, received bytes followed by free space. */
+  std::string input;
+
+  /** The offset of the first byte not parsed yet in the input. */
+  size_t inputOffset;
+
+  /** The number of bytes received in the input. */
+  size_t inputLength;
+
+  /** The copy of the head of a request whose body spans several reads. */
+  std::string headCopy;
+
+  /** The parser of the requests. */
+  MessageParser parser;
+
+  /** Indicates if the head of the current request was received. */
+  bool headReceived;
+
+  /** Indicates if the listener is handling a request. */
+  bool dispatching;
+
+  /** The body of the current request. */
+  echo::engine::util::ChunkBuffer body;
+
+  /** The bytes of the responses not written yet. */
+  echo::engine::util::ChunkBuffer output;
+
+  /** Indicates if the connection closes once the output is written. */
+  bool closing;
+
+  /** The writer framing the streamed entities. */
+  StreamWriter writer;
+
+  /** The streamed entity or null. */
+  echo::engine::util::ChunkStream* stream;
+
+  /** Indicates if the streamed entity is framed. */
+  bool chunked;
+
+  /** The time of the last bytes written. */
+  long long activity;
+
+  /** The transferred source or null. */
+  echo::engine::io::ReadableSource* source;
+
+  /** The transfer of the source or null. */
+  echo::engine::io::Transfer* transfer;
+
+  /** The number of bytes transferred at the last timeout. */
+  long long transferred;
+
+  /** The timer of the connection. */
+  Timer timer;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_SERVER_CONNECTION_H_
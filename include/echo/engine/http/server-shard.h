@@ -0,0 +1,310 @@
+#ifndef _ECHO_ENGINE_HTTP_SERVER_SHARD_H_
+#define _ECHO_ENGINE_HTTP_SERVER_SHARD_H_
+
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include <map>
+#include <stdexcept>
+
+#include <echo/response.h>
+#include <echo/engine/http/header-encoder.h>
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/http/server-connection.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/io-engine.h>
+#include <echo/engine/io/readable-source.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+class HttpServer;
+
+/**
+ * Shard of the HTTP server connector, owning a listening socket bound with
+ * SO_REUSEPORT to the address shared by all the shards, an event loop with
+ * its timer wheel, and a thread pinned to a CPU. The kernel spreads the
+ * incoming connections over the listening sockets, and a connection is
+ * handled from accept() to close() by the shard that accepted it, so its
+ * buffers and timers never leave the cache of that CPU and the shards share
+ * no lock.<br>
+ * <br>
+ * When the process runs out of descriptors, the pending connections can't be
+ * accepted and the listening socket would stay readable, spinning the loop:
+ * the shard stops watching it and watches it again after a pause, once
+ * connections had a chance to close.<br>
+ * <br>
+ * Concurrency note: instances of this class are started and stopped by the
+ * connector, then used by the thread running their loop.
+ */
+class ServerShard : public ServerConnection::Listener {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param server
+   *            The connector handling the requests.
+   * @param cpu
+   *            The CPU running the thread of the shard, or -1 to leave it
+   *            to the scheduler.
+   */
+  ServerShard(HttpServer* server, int cpu);
+
+  /**
+   * Destructor stopping the shard.
+   */
+  ~ServerShard();
+
+  /**
+   * Returns the encoder of the response heads.
+   *
+   * @return The encoder of the response heads.
+   */
+  HeaderEncoder& getEncoder() {
+    return encoder;
+  }
+
+  /**
+   * Returns the engine reading the files.
+   *
+   * @return The engine reading the files.
+   */
+  echo::engine::io::IoEngine& getEngine() {
+    return *engine;
+  }
+
+  /**
+   * Returns the listening socket.
+   *
+   * @return The listening socket or -1.
+   */
+  int getListenFile() const {
+    return listenFile;
+  }
+
+  /**
+   * Keeps the response whose entity is being written until the connection
+   * is done with it.
+   *
+   * @param connection
+   *            The connection writing the entity.
+   * @param response
+   *            The response.
+   * @param source
+   *            The source created for the entity, deleted once written, or
+   *            null.
+   */
+  void hold(ServerConnection* connection, echo::Response response,
+            echo::engine::io::ReadableSource* source);
+
+  /**
+   * Releases the entity of a response still being written, then deletes the
+   * connection.
+   *
+   * @param connection
+   *            The closed connection.
+   */
+  void onClosed(ServerConnection* connection);
+
+  /**
+   * Hands the request to the connector.
+   *
+   * @param connection
+   *            The connection.
+   * @param head
+   *            The parser holding the request head.
+   * @param body
+   *            The request body.
+   */
+  void onRequest(ServerConnection* connection, const MessageParser& head,
+                 echo::engine::util::ChunkBuffer& body);
+
+  /**
+   * Releases the entity of a response once written.
+   *
+   * @param connection
+   *            The connection.
+   */
+  void onResponded(ServerConnection* connection);
+
+  /**
+   * Binds the listening socket and starts the thread of the event loop.
+   *
+   * @param address
+   *            The listening address.
+   * @param length
+   *            The length of the address.
+   */
+  void start(const struct sockaddr* address, socklen_t length)
+      throw (std::runtime_error);
+
+  /**
+   * Stops the thread of the event loop, closes the connections and the
+   * listening socket.
+   */
+  void stop();
+
+ private:
+
+  /**
+   * Handler accepting the connections of the listening socket.
+   */
+  class Acceptor : public echo::engine::io::EventLoop::Handler {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param shard
+     *            The shard.
+     */
+    Acceptor(ServerShard* shard) : shard(shard) {
+    }
+
+    /**
+     * Accepts the pending connections.
+     *
+     * @param file
+     *            The listening socket.
+     * @param events
+     *            The ready events.
+     */
+    void onReady(int file, int events) {
+      shard->accept();
+    }
+
+   private:
+
+    /** The shard. */
+    ServerShard* shard;
+
+  };
+
+  /**
+   * Timeout watching the listening socket again after a pause.
+   */
+  class Resumer : public echo::engine::io::EventLoop::Timeout {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param shard
+     *            The shard.
+     */
+    Resumer(ServerShard* shard) : shard(shard) {
+    }
+
+    /**
+     * Watches the listening socket again.
+     */
+    void onTimeout() {
+      shard->resume();
+    }
+
+   private:
+
+    /** The shard. */
+    ServerShard* shard;
+
+  };
+
+  /**
+   * Response whose entity is being written.
+   */
+  struct Pending {
+
+    /** The response. */
+    echo::Response response;
+
+    /** The source created for the entity, deleted once written, or null. */
+    echo::engine::io::ReadableSource* source;
+
+  };
+
+  /**
+   * Runs the event loop.
+   *
+   * @param shard
+   *            The shard.
+   * @return Null.
+   */
+  static void* run(void* shard);
+
+  /**
+   * Accepts the pending connections without blocking.
+   */
+  void accept();
+
+  /**
+   * Stops watching the listening socket for a pause, the process being out
+   * of descriptors.
+   */
+  void pause();
+
+  /**
+   * Releases the entity of a response once written or abandoned.
+   *
+   * @param connection
+   *            The connection.
+   */
+  void release(ServerConnection* connection);
+
+  /**
+   * Watches the listening socket again after a pause.
+   */
+  void resume();
+
+  /**
+   * Non copyable.
+   */
+  ServerShard(const ServerShard&);
+
+  /**
+   * Non copyable.
+   */
+  ServerShard& operator=(const ServerShard&);
+
+  /** The connector handling the requests. */
+  HttpServer* server;
+
+  /** The CPU running the thread or -1. */
+  const int cpu;
+
+  /** The listening socket or -1. */
+  int listenFile;
+
+  /** The event loop driving the connections, while started. */
+  echo::engine::io::EventLoop* loop;
+
+  /** The engine reading the files, while started. */
+  echo::engine::io::IoEngine* engine;
+
+  /** The thread of the event loop. */
+  pthread_t thread;
+
+  /** The handler of the listening socket. */
+  Acceptor acceptor;
+
+  /** The timeout ending the pauses of the listening socket. */
+  Resumer resumer;
+
+  /** The encoder of the response heads, used by the loop thread. */
+  HeaderEncoder encoder;
+
+  /** The open connections, used by the loop thread. */
+  std::map<ServerConnection*, Pending> connections;
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_SERVER_SHARD_H_
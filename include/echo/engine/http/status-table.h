@@ -0,0 +1,112 @@
+#ifndef _ECHO_ENGINE_HTTP_STATUS_TABLE_H_
+#define _ECHO_ENGINE_HTTP_STATUS_TABLE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Table of the well-known statuses, indexed by code. Each entry holds the
+ * reason phrase and the status lines preformatted at compile time, both the
+ * "Status: NNN Reason" line of the CGI and FastCGI response headers and the
+ * "HTTP/1.1 NNN Reason" line of HTTP responses. The table is plain static data,
+ * so it needs no initialization, and writing a status line is a lookup
+ * followed by a copy.
+ *
+ * @see echo::data::Status
+ */
+class StatusTable {
+
+ public:
+
+  /**
+   * Entry of the table.
+   */
+  struct Entry {
+
+    /** The status code. */
+    int code;
+
+    /** The reason phrase. */
+    const char* reason;
+
+    /** The CGI status line, terminated by CRLF. */
+    const char* cgiLine;
+
+    /** The length of the CGI status line. */
+    size_t cgiLength;
+
+    /** The HTTP/1.1 status line, terminated by CRLF. */
+    const char* httpLine;
+
+    /** The length of the HTTP/1.1 status line. */
+    size_t httpLength;
+
+  };
+
+  /**
+   * Appends the CGI status line of a status to a buffer. The preformatted
+   * line is copied for well-known statuses with their standard reason.
+   *
+   * @param buffer
+   *            The buffer to update.
+   * @param code
+   *            The status code.
+   * @param reason
+   *            The reason phrase, or empty for the standard one.
+   */
+  static void appendCgiLine(std::string& buffer, int code,
+                            const std::string& reason);
+
+  /**
+   * Appends the HTTP/1.1 status line of a status to a buffer. The
+   * preformatted line is copied for well-known statuses with their standard
+   * reason.
+   *
+   * @param buffer
+   *            The buffer to update.
+   * @param code
+   *            The status code.
+   * @param reason
+   *            The reason phrase, or empty for the standard one.
+   */
+  static void appendHttpLine(std::string& buffer, int code,
+                             const std::string& reason);
+
+  /**
+   * Returns the entry of a status code.
+   *
+   * @param code
+   *            The status code.
+   * @return The entry or null if the code isn't well-known.
+   */
+  static const Entry* find(int code);
+
+ private:
+
+  /**
+   * Appends a status line formatted on the fly.
+   *
+   * @param buffer
+   *            The buffer to update.
+   * @param prefix
+   *            The prefix of the line.
+   * @param code
+   *            The status code.
+   * @param reason
+   *            The reason phrase.
+   */
+  static void appendLine(std::string& buffer, const char* prefix, int code,
+                         const std::string& reason);
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_STATUS_TABLE_H_
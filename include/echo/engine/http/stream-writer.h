@@ -0,0 +1,144 @@
+#ifndef _ECHO_ENGINE_HTTP_STREAM_WRITER_H_
+#define _ECHO_ENGINE_HTTP_STREAM_WRITER_H_
+
+#include <sys/types.h>
+
+#include <echo/engine/util/chunk-stream.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Writes the chunks of a {@link ChunkStream} to a connection as they are
+ * produced, framed either with the HTTP/1.1 chunked transfer coding or as
+ * FastCGI "FCGI_STDOUT" records. Each frame covers as many queued chunks as
+ * a single writev() call can take, the frame header and trailer included.<br>
+ * <br>
+ * Written chunks are consumed from the stream, which lets a producer held back
+ * by the high-water mark resume. A write error aborts the stream so that the
+ * producer stops generating an entity nobody will read.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, each
+ * connection has its own writer.
+ */
+class StreamWriter {
+
+ public:
+
+  /** Frames with the HTTP/1.1 chunked transfer coding. */
+  static const int CHUNKED;
+
+  /** Frames as FastCGI "FCGI_STDOUT" records. */
+  static const int FASTCGI;
+
+  /**
+   * Constructor.
+   *
+   * @param format
+   *            The framing, {@link #CHUNKED} or {@link #FASTCGI}.
+   * @param requestId
+   *            The FastCGI request identifier, ignored for chunked framing.
+   */
+  StreamWriter(int format, int requestId);
+
+  /**
+   * Writes the end of the stream: the last empty chunk or the empty
+   * "FCGI_STDOUT" record.
+   *
+   * @param file
+   *            The descriptor of the connection.
+   * @return The number of bytes written or -1 in case of error.
+   */
+  ssize_t finish(int file);
+
+  /**
+   * Writes the queued chunks of a stream without waiting for more.
+   *
+   * @param file
+   *            The descriptor of the connection.
+   * @param stream
+   *            The stream.
+   * @return The number of entity bytes written or -1 in case of error, in
+   *         which case the stream is aborted.
+   */
+  ssize_t flush(int file, echo::engine::util::ChunkStream& stream);
+
+  /**
+   * Returns the vectors of a frame covering the first queued chunks of a
+   * stream, for the connectors writing without blocking. The chunks are
+   * consumed by the caller once written, and the frame stays valid until the
+   * next call.
+   *
+   * @param stream
+   *            The stream.
+   * @param vectors
+   *            The vectors to fill.
+   * @param count
+   *            The number of vectors, at least four.
+   * @param length
+   *            Receives the number of entity bytes of the frame.
+   * @return The number of vectors filled, 0 if no chunk is queued.
+   */
+  int getFrame(echo::engine::util::ChunkStream& stream,
+               struct iovec* vectors, int count, size_t& length);
+
+  /**
+   * Returns the vectors of the end of the stream: the last empty chunk or the
+   * empty "FCGI_STDOUT" record.
+   *
+   * @param vectors
+   *            The vectors to fill, at least two.
+   * @return The number of vectors filled.
+   */
+  int getLastFrame(struct iovec* vectors);
+
+  /**
+   * Writes the chunks of a stream as they are produced, then the end of the
+   * stream once it is closed.
+   *
+   * @param file
+   *            The descriptor of the connection.
+   * @param stream
+   *            The stream.
+   * @param timeout
+   *            The maximum time to wait for the next chunk in milliseconds.
+   * @return True if the whole stream was written, false in case of error or
+   *         timeout, in which case the stream is aborted.
+   */
+  bool transfer(int file, echo::engine::util::ChunkStream& stream,
+                int timeout);
+
+ private:
+
+  /**
+   * Sets a frame header and its trailer around a sequence of vectors.
+   *
+   * @param vectors
+   *            The vectors, the first one being reserved for the header and
+   *            the last one for the trailer.
+   * @param count
+   *            The number of vectors with the content, header and trailer
+   *            excluded.
+   * @param length
+   *            The length of the content.
+   * @return The number of vectors of the frame.
+   */
+  int setFrame(struct iovec* vectors, int count, size_t length);
+
+  /** The framing. */
+  const int format;
+
+  /** The FastCGI request identifier. */
+  const int requestId;
+
+  /** The scratch buffer of the frame headers. */
+  char header[24];
+
+};
+
+} // namespace http
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_HTTP_STREAM_WRITER_H_
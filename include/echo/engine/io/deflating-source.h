@@ -0,0 +1,130 @@
+#ifndef _ECHO_ENGINE_IO_DEFLATING_SOURCE_H_
+#define _ECHO_ENGINE_IO_DEFLATING_SOURCE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <string>
+
+#include <echo/engine/io/readable-source.h>
+#include <echo/engine/util/deflater.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Source compressing the bytes of another source as they are read, so that
+ * a streamed entity is encoded without being read whole. Each read takes
+ * the available bytes of the wrapped source through the {@link Deflater}
+ * taken from the pool of the current thread; when the wrapped source has
+ * nothing more for now, the compressed data is flushed so that the client
+ * can decode what was sent.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * the loop of the wrapped source.
+ */
+class DeflatingSource : public ReadableSource,
+                        public ReadableSource::Listener {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param source
+   *            The source to compress, closed but not deleted with this
+   *            source.
+   * @param gzip
+   *            True for the "gzip" format, false for the "deflate" format.
+   * @param level
+   *            The compression level, from 1 to 9.
+   */
+  DeflatingSource(ReadableSource* source, bool gzip, int level);
+
+  /**
+   * Destructor closing the source.
+   */
+  ~DeflatingSource();
+
+  /**
+   * Closes the wrapped source and gives the compression stream back.
+   */
+  void close();
+
+  /**
+   * Forwards the notifications of the wrapped source.
+   *
+   * @param source
+   *            The wrapped source.
+   */
+  void onReadable(ReadableSource* source);
+
+  /**
+   * Reads compressed bytes without blocking.
+   *
+   * @param buffer
+   *            The buffer receiving the bytes.
+   * @param length
+   *            The size of the buffer.
+   * @return The number of bytes read, 0 at the end, or -1 with errno set.
+   */
+  ssize_t read(char* buffer, size_t length);
+
+  /**
+   * Requests the notifications of the wrapped source.
+   *
+   * @param listener
+   *            The listener to notify.
+   */
+  void resume(ReadableSource::Listener* listener);
+
+  /**
+   * Stops the notifications of the wrapped source.
+   */
+  void suspend();
+
+ private:
+
+  /**
+   * Compresses the next bytes of the wrapped source into the emptied
+   * output, until some compressed bytes or the end are available.
+   *
+   * @return False with errno set if nothing is available.
+   */
+  bool fill();
+
+  /** Non copyable. */
+  DeflatingSource(const DeflatingSource&);
+
+  /** Non copyable. */
+  DeflatingSource& operator=(const DeflatingSource&);
+
+  /** The wrapped source, null once closed. */
+  ReadableSource* source;
+
+  /** The compression stream, null once the end is compressed. */
+  echo::engine::util::Deflater* deflater;
+
+  /** The listener to notify, null while suspended. */
+  ReadableSource::Listener* listener;
+
+  /** The compressed bytes not read yet. */
+  std::string output;
+
+  /** The offset of the first byte of the output not read yet. */
+  size_t offset;
+
+  /** Indicates if bytes were compressed since the last flush. */
+  bool pending;
+
+  /** Indicates if the end of the wrapped source was compressed. */
+  bool ended;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_DEFLATING_SOURCE_H_
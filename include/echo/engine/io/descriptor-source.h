@@ -0,0 +1,110 @@
+#ifndef _ECHO_ENGINE_IO_DESCRIPTOR_SOURCE_H_
+#define _ECHO_ENGINE_IO_DESCRIPTOR_SOURCE_H_
+
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/readable-source.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Source reading a descriptor such as the socket of an upstream server or a
+ * pipe, made non-blocking and registered with an event loop.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop.
+ */
+class DescriptorSource : public ReadableSource, public EventLoop::Handler {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The event loop.
+   * @param file
+   *            The descriptor to read, switched to non-blocking mode.
+   * @param owned
+   *            True if the descriptor is closed with the source.
+   */
+  DescriptorSource(EventLoop& loop, int file, bool owned);
+
+  /**
+   * Destructor closing the source.
+   */
+  ~DescriptorSource();
+
+  /**
+   * Unregisters the descriptor and closes it if owned.
+   */
+  void close();
+
+  /**
+   * Returns the descriptor.
+   *
+   * @return The descriptor or -1 once closed.
+   */
+  int getFile() const {
+    return file;
+  }
+
+  /**
+   * Notifies the listener of the readiness of the descriptor.
+   *
+   * @param file
+   *            The descriptor.
+   * @param events
+   *            The ready events.
+   */
+  void onReady(int file, int events);
+
+  /**
+   * Reads available bytes from the descriptor without blocking.
+   *
+   * @param buffer
+   *            The buffer receiving the bytes.
+   * @param length
+   *            The size of the buffer.
+   * @return The number of bytes read, 0 at the end, or -1 with errno set.
+   */
+  ssize_t read(char* buffer, size_t length);
+
+  /**
+   * Registers the descriptor for readability.
+   *
+   * @param listener
+   *            The listener to notify.
+   */
+  void resume(Listener* listener);
+
+  /**
+   * Clears the interest of the descriptor, keeping it registered.
+   */
+  void suspend();
+
+ private:
+
+  /** The event loop. */
+  EventLoop& loop;
+
+  /** The descriptor. */
+  int file;
+
+  /** Indicates if the descriptor is closed with the source. */
+  const bool owned;
+
+  /** Indicates if the descriptor is registered with the loop. */
+  bool registered;
+
+  /** The listener to notify, null while suspended. */
+  Listener* listener;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_DESCRIPTOR_SOURCE_H_
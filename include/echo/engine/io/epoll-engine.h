@@ -0,0 +1,310 @@
+#ifndef _ECHO_ENGINE_IO_EPOLL_ENGINE_H_
+#define _ECHO_ENGINE_IO_EPOLL_ENGINE_H_
+
+#include <pthread.h>
+#include <sys/types.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/io-engine.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Portable engine based on the readiness notifications of the loop. Socket
+ * writes wait for writability without blocking, but as epoll can't wait for
+ * regular files, the reads are handed to a few reading threads of the engine
+ * which perform them with pread(), then post their completions to the loop;
+ * a cold file thus never stalls the loop thread on the disk.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop, and must be destroyed once the loop stopped. The reading
+ * threads only touch the queue of the reads and the buffers of the reads
+ * they perform.
+ */
+class EpollEngine : public IoEngine, public EventLoop::Handler {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The event loop delivering the completions.
+   */
+  EpollEngine(EventLoop& loop);
+
+  /**
+   * Destructor stopping the reading threads. The pending operations aren't
+   * notified.
+   */
+  ~EpollEngine();
+
+  /**
+   * Returns the event loop delivering the completions.
+   *
+   * @return The event loop.
+   */
+  EventLoop& getLoop() {
+    return loop;
+  }
+
+  /**
+   * Returns "epoll".
+   *
+   * @return The name of the engine.
+   */
+  std::string getName() const {
+    return "epoll";
+  }
+
+  /**
+   * Retries the write waiting for a socket to be writable.
+   *
+   * @param file
+   *            The socket.
+   * @param events
+   *            The ready events.
+   */
+  void onReady(int file, int events);
+
+  /**
+   * Queues the read of a file region, handed to the reading threads by the
+   * next submission.
+   *
+   * @param handle
+   *            The descriptor of the file.
+   * @param offset
+   *            The offset of the region.
+   * @param length
+   *            The length of the region, at most {@link #BUFFER_SIZE}.
+   * @param completion
+   *            The completion to notify.
+   * @return False if no buffer is free.
+   */
+  bool read(int handle, long long offset, size_t length,
+            Completion* completion);
+
+  /**
+   * Returns the descriptor itself, which is the handle.
+   *
+   * @param file
+   *            The descriptor of the file.
+   * @return The handle of the file.
+   */
+  int registerFile(int file) {
+    return file;
+  }
+
+  /**
+   * Hands the queued reads to the reading threads and posts a batch
+   * performing the queued writes on the loop thread.
+   */
+  void submit();
+
+  /**
+   * Does nothing, the handle being the descriptor.
+   *
+   * @param handle
+   *            The handle of the file.
+   */
+  void unregisterFile(int handle) {
+  }
+
+  /**
+   * Queues a write to a socket. A write that would block waits for the socket
+   * to be writable, unless the socket is registered with the loop by another
+   * handler: the write then completes with -EAGAIN, to be retried by that
+   * handler.
+   *
+   * @param file
+   *            The descriptor of the socket.
+   * @param vectors
+   *            The vectors to write.
+   * @param count
+   *            The number of vectors.
+   * @param completion
+   *            The completion to notify.
+   * @return True, the write being always queued.
+   */
+  bool write(int file, const struct iovec* vectors, int count,
+             Completion* completion);
+
+ private:
+
+  /**
+   * Queued read or write.
+   */
+  struct Operation {
+
+    /** The completion to notify. */
+    Completion* completion;
+
+    /** The descriptor. */
+    int file;
+
+    /** The offset of a read. */
+    long long offset;
+
+    /** The length of a read. */
+    size_t length;
+
+    /** The buffer index of a read, -1 for a write. */
+    int buffer;
+
+    /** The result of a read performed by a reading thread. */
+    ssize_t result;
+
+    /** The vectors of a write. */
+    std::vector<struct iovec> vectors;
+
+  };
+
+  /**
+   * Task performing the queued operations on the loop thread.
+   */
+  class Batch : public EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param engine
+     *            The engine.
+     */
+    Batch(EpollEngine* engine) : engine(engine) {
+    }
+
+    /**
+     * Performs the queued operations.
+     */
+    void run();
+
+   private:
+
+    /** The engine. */
+    EpollEngine* engine;
+
+  };
+
+  /**
+   * Task notifying the completion of a read on the loop thread.
+   */
+  class ReadCompletion : public EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param engine
+     *            The engine.
+     * @param operation
+     *            The performed read, owned by the task.
+     */
+    ReadCompletion(EpollEngine* engine, Operation* operation)
+        : engine(engine), operation(operation) {
+    }
+
+    /**
+     * Destructor deleting the read if not notified, when the loop is
+     * destroyed with its tasks.
+     */
+    ~ReadCompletion() {
+      delete operation;
+    }
+
+    /**
+     * Notifies the completion and frees the buffer of the read.
+     */
+    void run();
+
+   private:
+
+    /** The engine. */
+    EpollEngine* engine;
+
+    /** The performed read. */
+    Operation* operation;
+
+  };
+
+  /**
+   * Performs a write and notifies its completion, unless it has to wait for
+   * the socket to be writable and nobody else watches the socket.
+   *
+   * @param operation
+   *            The operation, deleted once notified.
+   */
+  void perform(Operation* operation);
+
+  /**
+   * Runs a reading thread.
+   *
+   * @param engine
+   *            The engine.
+   * @return Null.
+   */
+  static void* run(void* engine);
+
+  /**
+   * Performs the queued reads until the engine is destroyed.
+   */
+  void runReads();
+
+  /**
+   * Non copyable.
+   */
+  EpollEngine(const EpollEngine&);
+
+  /**
+   * Non copyable.
+   */
+  EpollEngine& operator=(const EpollEngine&);
+
+  /** The event loop. */
+  EventLoop& loop;
+
+  /** The read buffers. */
+  char* buffers;
+
+  /** The indexes of the free read buffers. */
+  std::vector<int> available;
+
+  /** The queued operations. */
+  std::vector<Operation*> queued;
+
+  /** The operations of the batch task to run. */
+  std::vector<Operation*> submitted;
+
+  /** The writes waiting for their socket to be writable. */
+  std::map<int, Operation*> waiting;
+
+  /** The lock guarding the reads handed to the reading threads. */
+  pthread_mutex_t lock;
+
+  /** Signaled when a read is handed to the reading threads. */
+  pthread_cond_t queuedReads;
+
+  /** The reads handed to the reading threads. */
+  std::deque<Operation*> reads;
+
+  /** The reading threads. */
+  std::vector<pthread_t> threads;
+
+  /** Indicates if the engine is being destroyed. */
+  bool stopped;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_EPOLL_ENGINE_H_
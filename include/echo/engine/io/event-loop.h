@@ -0,0 +1,248 @@
+#ifndef _ECHO_ENGINE_IO_EVENT_LOOP_H_
+#define _ECHO_ENGINE_IO_EVENT_LOOP_H_
+
+#include <pthread.h>
+
+#include <vector>
+
+#include <echo/engine/util/timer-wheel.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Single-threaded loop dispatching the readiness of descriptors to handlers,
+ * based on epoll. Besides the readiness notifications, the loop runs the
+ * tasks posted by other threads and fires the timeouts scheduled in its timer
+ * wheel, so that a connection, an upstream body or a long-polling stream is
+ * served without a thread of its own.<br>
+ * <br>
+ * The readiness is level-triggered: a handler is notified again as long as
+ * the descriptor is ready and its interest isn't changed.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, they are used
+ * by the thread running the loop, except {@link #post(Task*)} and
+ * {@link #stop()} which can be called by any thread.
+ */
+class EventLoop {
+
+ public:
+
+  /**
+   * Handler notified of the readiness of a descriptor.
+   */
+  class Handler {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Handler() {
+    }
+
+    /**
+     * Called when a descriptor is ready.
+     *
+     * @param file
+     *            The descriptor.
+     * @param events
+     *            The ready events, a combination of {@link #READABLE},
+     *            {@link #WRITABLE} and {@link #CLOSED}.
+     */
+    virtual void onReady(int file, int events) = 0;
+
+  };
+
+  /**
+   * Task run by the loop thread, deleted once run.
+   */
+  class Task {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Task() {
+    }
+
+    /**
+     * Runs the task.
+     */
+    virtual void run() = 0;
+
+  };
+
+  /**
+   * Timeout fired by the loop thread.
+   */
+  class Timeout : public echo::engine::util::TimerWheel::Timer {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Timeout() {
+    }
+
+    /**
+     * Called when the timeout expires.
+     */
+    virtual void onTimeout() = 0;
+
+  };
+
+  /** The event of a readable descriptor. */
+  static const int READABLE;
+
+  /** The event of a writable descriptor. */
+  static const int WRITABLE;
+
+  /** The event of a descriptor in error or hung up, always notified. */
+  static const int CLOSED;
+
+  /**
+   * Constructor.
+   */
+  EventLoop();
+
+  /**
+   * Destructor. The tasks not run yet are deleted.
+   */
+  ~EventLoop();
+
+  /**
+   * Returns the loop run by the current thread.
+   *
+   * @return The loop run by the current thread or null.
+   */
+  static EventLoop* getCurrent();
+
+  /**
+   * Registers a descriptor.
+   *
+   * @param file
+   *            The descriptor, which should be non-blocking.
+   * @param events
+   *            The events of interest, possibly none.
+   * @param handler
+   *            The handler to notify.
+   * @return True if the descriptor was registered.
+   */
+  bool add(int file, int events, Handler* handler);
+
+  /**
+   * Unschedules a timeout. Does nothing if the timeout isn't scheduled.
+   *
+   * @param timeout
+   *            The timeout to unschedule.
+   */
+  void cancel(Timeout* timeout);
+
+  /**
+   * Changes the events of interest of a registered descriptor.
+   *
+   * @param file
+   *            The descriptor.
+   * @param events
+   *            The events of interest, possibly none.
+   * @return True if the interest was changed.
+   */
+  bool modify(int file, int events);
+
+  /**
+   * Waits for events once and dispatches them, then runs the posted tasks and
+   * fires the expired timeouts.
+   *
+   * @param timeout
+   *            The maximum waiting time in milliseconds, -1 to wait until an
+   *            event occurs.
+   * @return The number of dispatched events or -1 in case of error.
+   */
+  int poll(int timeout);
+
+  /**
+   * Posts a task to be run by the loop thread, waking the loop up.
+   *
+   * @param task
+   *            The task, deleted once run.
+   */
+  void post(Task* task);
+
+  /**
+   * Unregisters a descriptor. Must be called before closing it.
+   *
+   * @param file
+   *            The descriptor.
+   */
+  void remove(int file);
+
+  /**
+   * Runs the loop until {@link #stop()} is called.
+   */
+  void run();
+
+  /**
+   * Schedules or reschedules a timeout.
+   *
+   * @param timeout
+   *            The timeout.
+   * @param delay
+   *            The delay in milliseconds.
+   */
+  void schedule(Timeout* timeout, long long delay);
+
+  /**
+   * Stops the loop at the end of the current iteration.
+   */
+  void stop();
+
+ private:
+
+  /**
+   * Runs the posted tasks.
+   */
+  void runTasks();
+
+  /**
+   * Wakes the loop up from another thread.
+   */
+  void wake();
+
+  /** Not copyable, the descriptors are owned. */
+  EventLoop(const EventLoop&);
+
+  /** Not assignable, the descriptors are owned. */
+  EventLoop& operator=(const EventLoop&);
+
+  /** The epoll descriptor. */
+  int file;
+
+  /** The eventfd waking the loop up. */
+  int wakeup;
+
+  /** The handlers indexed by descriptor. */
+  std::vector<Handler*> handlers;
+
+  /** The wheel of the timeouts. */
+  echo::engine::util::TimerWheel wheel;
+
+  /** The lock guarding the posted tasks and the stop flag. */
+  pthread_mutex_t lock;
+
+  /** The posted tasks. */
+  std::vector<Task*> tasks;
+
+  /** Indicates if the loop was asked to stop. */
+  bool stopped;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_EVENT_LOOP_H_
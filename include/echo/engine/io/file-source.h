@@ -0,0 +1,239 @@
+#ifndef _ECHO_ENGINE_IO_FILE_SOURCE_H_
+#define _ECHO_ENGINE_IO_FILE_SOURCE_H_
+
+#include <deque>
+#include <string>
+#include <tr1/memory>
+
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/io-engine.h>
+#include <echo/engine/io/readable-source.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Source reading a file through an {@link IoEngine}, so that a cold file is
+ * read without stalling the loop thread on disk latency. A few reads ahead
+ * of the reader are kept in flight and submitted together; their
+ * completions, possibly out of order, are staged in order and resume the
+ * listener, typically a {@link Transfer}.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * the loop of their engine.
+ */
+class FileSource : public ReadableSource {
+
+ public:
+
+  /** The maximum number of reads in flight. */
+  static const size_t READ_AHEAD;
+
+  /**
+   * Constructor opening the file.
+   *
+   * @param engine
+   *            The engine reading the file.
+   * @param path
+   *            The path of the file.
+   */
+  FileSource(IoEngine& engine, const std::string& path);
+
+  /**
+   * Destructor closing the source.
+   */
+  ~FileSource();
+
+  /**
+   * Closes the file. The reads in flight are discarded on completion.
+   */
+  void close();
+
+  /**
+   * Returns the size of the file.
+   *
+   * @return The size of the file or -1 if it couldn't be opened.
+   */
+  long long getSize() const {
+    return size;
+  }
+
+  /**
+   * Reads staged bytes without blocking, reading ahead as they are consumed.
+   *
+   * @param buffer
+   *            The buffer receiving the bytes.
+   * @param length
+   *            The size of the buffer.
+   * @return The number of bytes read, 0 at the end of the file, or -1 with
+   *         errno set to EAGAIN if the next bytes are still being read, or to
+   *         the error of a read.
+   */
+  ssize_t read(char* buffer, size_t length);
+
+  /**
+   * Starts reading ahead and requests notifications, posting one right away
+   * if bytes are staged.
+   *
+   * @param listener
+   *            The listener to notify.
+   */
+  void resume(Listener* listener);
+
+  /**
+   * Stops the notifications. The reads in flight still complete.
+   */
+  void suspend();
+
+ private:
+
+  /**
+   * Read in flight, which outlives a closed source until its completion.
+   */
+  class Read : public IoEngine::Completion {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param source
+     *            The source.
+     * @param offset
+     *            The offset of the region.
+     * @param length
+     *            The length of the region.
+     */
+    Read(FileSource* source, long long offset, size_t length)
+        : source(source), offset(offset), length(length), done(false),
+          result(0) {
+    }
+
+    /**
+     * Copies the bytes read and hands the read to its source, or deletes
+     * the read if the source was closed.
+     *
+     * @param data
+     *            The engine buffer holding the bytes read.
+     * @param result
+     *            The number of bytes read or a negated errno value.
+     */
+    void onComplete(const char* data, ssize_t result);
+
+    /** The source, null once closed. */
+    FileSource* source;
+
+    /** The offset of the region. */
+    const long long offset;
+
+    /** The length of the region. */
+    const size_t length;
+
+    /** Indicates if the read completed. */
+    bool done;
+
+    /** The number of bytes read or a negated errno value. */
+    ssize_t result;
+
+    /** The bytes read. */
+    std::string content;
+
+  };
+
+  /**
+   * Task notifying the listener on the loop thread, ignored once the source
+   * is closed.
+   */
+  class Notification : public EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param source
+     *            The source.
+     */
+    Notification(const std::tr1::shared_ptr<FileSource*>& source)
+        : source(source) {
+    }
+
+    /**
+     * Reads ahead and notifies the listener if the source is still open.
+     */
+    void run();
+
+   private:
+
+    /** The source, expired once closed. */
+    std::tr1::weak_ptr<FileSource*> source;
+
+  };
+
+  /**
+   * Queues and submits the reads ahead of the reader.
+   */
+  void fill();
+
+  /**
+   * Indicates if the listener has something to read.
+   *
+   * @return True if bytes are staged, or the end or an error was reached.
+   */
+  bool isReadable() const;
+
+  /**
+   * Posts a notification unless one is pending.
+   */
+  void notify();
+
+  /**
+   * Stages the leading completed reads in order and notifies the listener.
+   *
+   * @param read
+   *            The completed read.
+   */
+  void onRead(Read* read);
+
+  /** The engine reading the file. */
+  IoEngine& engine;
+
+  /** The descriptor of the file. */
+  int file;
+
+  /** The handle of the file in the engine. */
+  int handle;
+
+  /** The size of the file. */
+  long long size;
+
+  /** The offset of the next read to queue. */
+  long long next;
+
+  /** The reads in flight or not staged yet, in offset order. */
+  std::deque<Read*> reads;
+
+  /** The bytes read and not consumed yet. */
+  echo::engine::util::ChunkBuffer staged;
+
+  /** The listener to notify, null while suspended. */
+  Listener* listener;
+
+  /** The errno value of a failed read or open, 0 otherwise. */
+  int error;
+
+  /** Indicates if a notification is posted and not run yet. */
+  bool pending;
+
+  /** The reference watched by the notifications, reset once closed. */
+  std::tr1::shared_ptr<FileSource*> self;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_FILE_SOURCE_H_
@@ -0,0 +1,163 @@
+#ifndef _ECHO_ENGINE_IO_IO_ENGINE_H_
+#define _ECHO_ENGINE_IO_IO_ENGINE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <string>
+
+#include <echo/engine/io/event-loop.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Asynchronous engine reading files and writing sockets on behalf of an
+ * event loop, so that a cold file doesn't stall a thread on disk latency.
+ * Operations are queued, then submitted in batches with {@link #submit()};
+ * their completions are delivered on the loop thread.<br>
+ * <br>
+ * Reads go to buffers owned by the engine, which are registered with the
+ * kernel when the engine supports it, and files are referred to by the
+ * handles returned by {@link #registerFile(int)}. The engine is selected at
+ * runtime by {@link #create(EventLoop&, const std::string&)}: "io_uring" when
+ * compiled with ECHO_HAVE_LIBURING and supported by the kernel, "epoll"
+ * otherwise.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop. They must outlive the operations they were given.
+ */
+class IoEngine {
+
+ public:
+
+  /**
+   * Completion of an operation, which must stay alive until notified.
+   */
+  class Completion {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Completion() {
+    }
+
+    /**
+     * Called on the loop thread when the operation completes.
+     *
+     * @param data
+     *            For a read, the engine buffer holding the bytes read, only
+     *            valid during the call. Null for a write.
+     * @param result
+     *            The number of bytes transferred, possibly fewer than
+     *            requested, or a negated errno value.
+     */
+    virtual void onComplete(const char* data, ssize_t result) = 0;
+
+  };
+
+  /** The size of the read buffers, the maximum length of a read. */
+  static const size_t BUFFER_SIZE;
+
+  /** The number of read buffers. */
+  static const int BUFFER_COUNT;
+
+  /**
+   * Creates an engine.
+   *
+   * @param loop
+   *            The event loop delivering the completions.
+   * @param name
+   *            The name of the engine, "io_uring", "epoll" or "auto". An
+   *            unavailable "io_uring" engine falls back to "epoll".
+   * @return The new engine.
+   */
+  static IoEngine* create(EventLoop& loop, const std::string& name);
+
+  /**
+   * Destructor.
+   */
+  virtual ~IoEngine() {
+  }
+
+  /**
+   * Returns the event loop delivering the completions.
+   *
+   * @return The event loop.
+   */
+  virtual EventLoop& getLoop() = 0;
+
+  /**
+   * Returns the name of the engine.
+   *
+   * @return The name of the engine.
+   */
+  virtual std::string getName() const = 0;
+
+  /**
+   * Queues the read of a file region into an engine buffer.
+   *
+   * @param handle
+   *            The handle of the file.
+   * @param offset
+   *            The offset of the region.
+   * @param length
+   *            The length of the region, at most {@link #BUFFER_SIZE}.
+   * @param completion
+   *            The completion to notify.
+   * @return False if no buffer is free, in which case the read should be
+   *         retried after a completion.
+   */
+  virtual bool read(int handle, long long offset, size_t length,
+                    Completion* completion) = 0;
+
+  /**
+   * Registers a file to be read.
+   *
+   * @param file
+   *            The descriptor of the file.
+   * @return The handle of the file or -1 if the engine can't read it.
+   */
+  virtual int registerFile(int file) = 0;
+
+  /**
+   * Submits the queued operations.
+   */
+  virtual void submit() = 0;
+
+  /**
+   * Unregisters a file.
+   *
+   * @param handle
+   *            The handle of the file.
+   */
+  virtual void unregisterFile(int handle) = 0;
+
+  /**
+   * Queues a write to a socket.
+   *
+   * @param file
+   *            The descriptor of the socket.
+   * @param vectors
+   *            The vectors to write, copied; the data must stay valid until
+   *            the completion.
+   * @param count
+   *            The number of vectors.
+   * @param completion
+   *            The completion to notify.
+   * @return False if the operation couldn't be queued.
+   */
+  virtual bool write(int file, const struct iovec* vectors, int count,
+                     Completion* completion) = 0;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_IO_ENGINE_H_
@@ -0,0 +1,183 @@
+#ifndef _ECHO_ENGINE_IO_PUSH_SOURCE_H_
+#define _ECHO_ENGINE_IO_PUSH_SOURCE_H_
+
+#include <pthread.h>
+
+#include <tr1/memory>
+
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/readable-source.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Source fed by other threads, such as the messages of a long-polling or
+ * server-sent events stream published as they occur. Pushing bytes posts a
+ * notification to the loop, which then moves them to the client without a
+ * thread waiting for the next message.<br>
+ * <br>
+ * Concurrency note: {@link #offer(const char*, size_t)} and {@link #end()}
+ * can be called by any thread, the other methods by the thread running the
+ * loop, which also destroys the source.
+ */
+class PushSource : public ReadableSource {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The event loop.
+   */
+  PushSource(EventLoop& loop);
+
+  /**
+   * Destructor closing the source.
+   */
+  ~PushSource();
+
+  /**
+   * Drops the pushed bytes and ignores the next ones.
+   */
+  void close();
+
+  /**
+   * Marks the end of the source once the pushed bytes are read.
+   */
+  void end();
+
+  /**
+   * Returns the number of pushed bytes not read yet.
+   *
+   * @return The number of pushed bytes not read yet.
+   */
+  size_t getSize();
+
+  /**
+   * Pushes bytes.
+   *
+   * @param data
+   *            The bytes to push.
+   * @param length
+   *            The number of bytes.
+   * @return False if the source was ended or closed.
+   */
+  bool offer(const char* data, size_t length);
+
+  /**
+   * Reads pushed bytes without blocking.
+   *
+   * @param buffer
+   *            The buffer receiving the bytes.
+   * @param length
+   *            The size of the buffer.
+   * @return The number of bytes read, 0 at the end, or -1 with errno set to
+   *         EAGAIN if nothing was pushed.
+   */
+  ssize_t read(char* buffer, size_t length);
+
+  /**
+   * Requests notifications, posting one right away if bytes are pending.
+   *
+   * @param listener
+   *            The listener to notify.
+   */
+  void resume(Listener* listener);
+
+  /**
+   * Stops the notifications.
+   */
+  void suspend();
+
+ private:
+
+  /**
+   * State shared with the posted notifications, which can outlive the
+   * source.
+   */
+  struct State {
+
+    /**
+     * Constructor.
+     */
+    State() : source(NULL), listener(NULL), ended(false), pending(false) {
+      pthread_mutex_init(&lock, NULL);
+    }
+
+    /**
+     * Destructor.
+     */
+    ~State() {
+      pthread_mutex_destroy(&lock);
+    }
+
+    /** The lock guarding the state. */
+    pthread_mutex_t lock;
+
+    /** The pushed bytes not read yet. */
+    echo::engine::util::ChunkBuffer buffer;
+
+    /** The source, null once closed. */
+    PushSource* source;
+
+    /** The listener to notify, null while suspended. */
+    Listener* listener;
+
+    /** Indicates if the end was marked. */
+    bool ended;
+
+    /** Indicates if a notification is posted and not run yet. */
+    bool pending;
+
+  };
+
+  /**
+   * Task notifying the listener on the loop thread.
+   */
+  class Notification : public EventLoop::Task {
+
+   public:
+
+    /**
+     * Constructor.
+     *
+     * @param state
+     *            The state of the source.
+     */
+    Notification(const std::tr1::shared_ptr<State>& state) : state(state) {
+    }
+
+    /**
+     * Notifies the listener if the source is still open and readable.
+     */
+    void run();
+
+   private:
+
+    /** The state of the source. */
+    std::tr1::shared_ptr<State> state;
+
+  };
+
+  /**
+   * Posts a notification unless one is pending. The state must be locked.
+   */
+  void notify();
+
+  /** The event loop. */
+  EventLoop& loop;
+
+  /** The state shared with the notifications. */
+  std::tr1::shared_ptr<State> state;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_PUSH_SOURCE_H_
@@ -0,0 +1,90 @@
+#ifndef _ECHO_ENGINE_IO_READABLE_SOURCE_H_
+#define _ECHO_ENGINE_IO_READABLE_SOURCE_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Non-blocking source of bytes notifying a listener when it becomes readable,
+ * the counterpart of a blocking channel for the entities moved by an
+ * {@link EventLoop}. A listener reads until the source reports that nothing
+ * is available, then waits for the next notification.<br>
+ * <br>
+ * Concurrency note: sources are used by the thread running their loop.
+ */
+class ReadableSource {
+
+ public:
+
+  /**
+   * Listener notified when a source becomes readable.
+   */
+  class Listener {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Listener() {
+    }
+
+    /**
+     * Called when bytes, the end or an error can be read from the source.
+     *
+     * @param source
+     *            The readable source.
+     */
+    virtual void onReadable(ReadableSource* source) = 0;
+
+  };
+
+  /**
+   * Destructor.
+   */
+  virtual ~ReadableSource() {
+  }
+
+  /**
+   * Closes the source. No notification follows.
+   */
+  virtual void close() = 0;
+
+  /**
+   * Reads available bytes without blocking.
+   *
+   * @param buffer
+   *            The buffer receiving the bytes.
+   * @param length
+   *            The size of the buffer.
+   * @return The number of bytes read, 0 at the end of the source, or -1 with
+   *         errno set to EAGAIN if nothing is available yet, or to another
+   *         value in case of error.
+   */
+  virtual ssize_t read(char* buffer, size_t length) = 0;
+
+  /**
+   * Requests readiness notifications until {@link #suspend()} is called.
+   *
+   * @param listener
+   *            The listener to notify.
+   */
+  virtual void resume(Listener* listener) = 0;
+
+  /**
+   * Stops the readiness notifications, for example while the reader is held
+   * back by a slow destination.
+   */
+  virtual void suspend() = 0;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_READABLE_SOURCE_H_
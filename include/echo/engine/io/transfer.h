@@ -0,0 +1,175 @@
+#ifndef _ECHO_ENGINE_IO_TRANSFER_H_
+#define _ECHO_ENGINE_IO_TRANSFER_H_
+
+#include <stddef.h>
+
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/readable-source.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Moves the bytes of a readable source to a non-blocking descriptor as both
+ * sides become ready, for example an upstream body proxied to a client,
+ * without dedicating a thread to the transfer. The bytes read are staged in
+ * pooled chunks and written with writev(). Once the staged bytes reach the
+ * high-water mark, the source is suspended until the destination drains
+ * them, so that a slow client doesn't make a fast upstream fill the
+ * memory.<br>
+ * <br>
+ * The destination is registered with the loop by the transfer while it waits
+ * for writability, so the connector must not register it meanwhile.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop.
+ */
+class Transfer : public ReadableSource::Listener, public EventLoop::Handler {
+
+ public:
+
+  /**
+   * Listener notified of the completion of a transfer.
+   */
+  class Listener {
+
+   public:
+
+    /**
+     * Destructor.
+     */
+    virtual ~Listener() {
+    }
+
+    /**
+     * Called once the transfer is complete or failed. The transfer can be
+     * deleted by the listener.
+     *
+     * @param transfer
+     *            The transfer.
+     * @param success
+     *            True if all the bytes of the source were written.
+     */
+    virtual void onComplete(Transfer* transfer, bool success) = 0;
+
+  };
+
+  /** The default high-water mark in bytes. */
+  static const size_t DEFAULT_HIGH_WATER_MARK;
+
+  /**
+   * Constructor.
+   *
+   * @param loop
+   *            The event loop.
+   * @param source
+   *            The source to read.
+   * @param target
+   *            The non-blocking descriptor to write.
+   * @param highWaterMark
+   *            The number of staged bytes above which the source is
+   *            suspended.
+   */
+  Transfer(EventLoop& loop, ReadableSource* source, int target,
+           size_t highWaterMark);
+
+  /**
+   * Destructor, stopping the notifications of an incomplete transfer.
+   */
+  ~Transfer();
+
+  /**
+   * Returns the number of bytes written to the destination.
+   *
+   * @return The number of bytes written.
+   */
+  long long getTransferred() const {
+    return transferred;
+  }
+
+  /**
+   * Reads the source into the staged chunks, then writes them.
+   *
+   * @param source
+   *            The readable source.
+   */
+  void onReadable(ReadableSource* source);
+
+  /**
+   * Writes the staged chunks once the destination is writable.
+   *
+   * @param file
+   *            The destination.
+   * @param events
+   *            The ready events.
+   */
+  void onReady(int file, int events);
+
+  /**
+   * Starts the transfer.
+   *
+   * @param listener
+   *            The listener notified of the completion.
+   */
+  void start(Listener* listener);
+
+ private:
+
+  /**
+   * Ends the transfer and notifies the listener.
+   *
+   * @param success
+   *            True if all the bytes were written.
+   */
+  void complete(bool success);
+
+  /**
+   * Writes the staged chunks without blocking, waiting for writability if
+   * the destination is full, and resumes the source below the mark.
+   */
+  void flush();
+
+  /**
+   * Stops waiting for the writability of the destination.
+   */
+  void unregister();
+
+  /** The event loop. */
+  EventLoop& loop;
+
+  /** The source. */
+  ReadableSource* source;
+
+  /** The destination. */
+  const int target;
+
+  /** The number of staged bytes above which the source is suspended. */
+  const size_t highWaterMark;
+
+  /** The staged bytes. */
+  echo::engine::util::ChunkBuffer staged;
+
+  /** The listener notified of the completion, null once complete. */
+  Listener* listener;
+
+  /** Indicates if the end of the source was read. */
+  bool ended;
+
+  /** Indicates if the source is suspended. */
+  bool suspended;
+
+  /** Indicates if the destination is registered with the loop. */
+  bool registered;
+
+  /** The number of bytes written to the destination. */
+  long long transferred;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_IO_TRANSFER_H_
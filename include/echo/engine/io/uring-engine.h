@@ -0,0 +1,205 @@
+#ifndef _ECHO_ENGINE_IO_URING_ENGINE_H_
+#define _ECHO_ENGINE_IO_URING_ENGINE_H_
+
+#ifdef ECHO_HAVE_LIBURING
+
+#include <liburing.h>
+
+#include <vector>
+
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/io-engine.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/**
+ * Engine based on io_uring, only compiled with ECHO_HAVE_LIBURING. Reads use
+ * buffers and files registered with the ring, so that the kernel neither maps
+ * the buffers nor looks the descriptors up for each operation, and a batch of
+ * operations costs a single io_uring_submit() call. Once the file table is
+ * full, files are read through their plain descriptors. The ring signals its
+ * completions through an eventfd watched by the loop.<br>
+ * <br>
+ * Concurrency note: instances of this class are used by the thread running
+ * their loop.
+ */
+class UringEngine : public IoEngine, public EventLoop::Handler {
+
+ public:
+
+  /** The number of entries of the submission queue. */
+  static const unsigned QUEUE_DEPTH;
+
+  /** The number of slots of the registered file table. */
+  static const int FILE_COUNT;
+
+  /**
+   * Constructor. The engine is unusable if the kernel doesn't support
+   * io_uring, which {@link #isAvailable()} tells.
+   *
+   * @param loop
+   *            The event loop delivering the completions.
+   */
+  UringEngine(EventLoop& loop);
+
+  /**
+   * Destructor. The pending operations aren't notified.
+   */
+  ~UringEngine();
+
+  /**
+   * Returns the event loop delivering the completions.
+   *
+   * @return The event loop.
+   */
+  EventLoop& getLoop() {
+    return loop;
+  }
+
+  /**
+   * Returns "io_uring".
+   *
+   * @return The name of the engine.
+   */
+  std::string getName() const {
+    return "io_uring";
+  }
+
+  /**
+   * Indicates if the ring and its registrations were set up.
+   *
+   * @return True if the engine is usable.
+   */
+  bool isAvailable() const {
+    return available;
+  }
+
+  /**
+   * Reaps the completions once the eventfd of the ring is readable.
+   *
+   * @param file
+   *            The eventfd.
+   * @param events
+   *            The ready events.
+   */
+  void onReady(int file, int events);
+
+  /**
+   * Queues the read of a file region into a registered buffer.
+   *
+   * @param handle
+   *            The slot of the file in the registered file table, or the
+   *            descriptor of an unregistered file offset by
+   *            {@link #FILE_COUNT}.
+   * @param offset
+   *            The offset of the region.
+   * @param length
+   *            The length of the region, at most {@link #BUFFER_SIZE}.
+   * @param completion
+   *            The completion to notify.
+   * @return False if no buffer is free.
+   */
+  bool read(int handle, long long offset, size_t length,
+            Completion* completion);
+
+  /**
+   * Registers a file in a free slot of the registered file table. When no
+   * slot is free, the file is read through its descriptor instead.
+   *
+   * @param file
+   *            The descriptor of the file.
+   * @return The slot of the file, or its descriptor offset by
+   *         {@link #FILE_COUNT} if it couldn't be registered.
+   */
+  int registerFile(int file);
+
+  /**
+   * Submits the queued operations with a single system call.
+   */
+  void submit();
+
+  /**
+   * Frees the slot of a file in the registered file table, if it has one.
+   *
+   * @param handle
+   *            The handle of the file.
+   */
+  void unregisterFile(int handle);
+
+  /**
+   * Queues a write to a socket.
+   *
+   * @param file
+   *            The descriptor of the socket.
+   * @param vectors
+   *            The vectors to write.
+   * @param count
+   *            The number of vectors.
+   * @param completion
+   *            The completion to notify.
+   * @return False if the submission queue is full.
+   */
+  bool write(int file, const struct iovec* vectors, int count,
+             Completion* completion);
+
+ private:
+
+  /**
+   * Operation in flight, the user data of its submission.
+   */
+  struct Operation {
+
+    /** The completion to notify. */
+    Completion* completion;
+
+    /** The buffer index of a read, -1 for a write. */
+    int buffer;
+
+    /** The vectors of a write, kept until the completion. */
+    std::vector<struct iovec> vectors;
+
+  };
+
+  /**
+   * Returns a free submission entry, submitting the queued ones if the queue
+   * is full.
+   *
+   * @return A free submission entry or null.
+   */
+  struct io_uring_sqe* getEntry();
+
+  /** The event loop. */
+  EventLoop& loop;
+
+  /** The ring. */
+  struct io_uring ring;
+
+  /** The eventfd signaling the completions. */
+  int wakeup;
+
+  /** Indicates if the ring and its registrations were set up. */
+  bool available;
+
+  /** The registered read buffers. */
+  char* buffers;
+
+  /** The indexes of the free read buffers. */
+  std::vector<int> freeBuffers;
+
+  /** The registered file table, -1 for free slots. */
+  std::vector<int> files;
+
+  /** The number of queued entries not submitted yet. */
+  unsigned queued;
+
+};
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // ECHO_HAVE_LIBURING
+
+#endif // _ECHO_ENGINE_IO_URING_ENGINE_H_
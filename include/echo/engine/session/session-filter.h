@@ -0,0 +1,216 @@
+#ifndef _ECHO_ENGINE_SESSION_SESSION_FILTER_H_
+#define _ECHO_ENGINE_SESSION_SESSION_FILTER_H_
+
+#include <string>
+
+#include <echo/context.h>
+#include <echo/echo.h>
+#include <echo/request.h>
+#include <echo/response.h>
+#include <echo/data/challenge-response.h>
+#include <echo/data/challenge-scheme.h>
+#include <echo/data/cookie-setting.h>
+#include <echo/engine/session/session-store.h>
+#include <echo/routing/filter.h>
+
+namespace echo {
+namespace engine {
+namespace session {
+
+/**
+ * Filter resolving the session of a call from its session cookie. The session
+ * identifier is looked up in the raw "Cookie" header, without materializing
+ * the other cookies, then in the {@link SessionStore} shared through the
+ * context attributes. A store is created and registered if the context doesn't
+ * provide one yet; it then lives as long as the context, shared by the other
+ * filters, or is deleted with the filter without a context.<br>
+ * <br>
+ * When a session is found, its identifier and data are set as the
+ * {@link #ATTRIBUTE_ID} and {@link #ATTRIBUTE_DATA} request attributes. If
+ * the session belongs to an authenticated user and the request doesn't carry
+ * other credentials, a {@link ChallengeScheme#HTTP_COOKIE} challenge response
+ * is set with the user identifier and the client is marked as authenticated.
+ * <br>
+ * <br>
+ * When a snapshot path is set, the sessions are reloaded from it when the
+ * filter starts and saved to it when the filter stops, so that they survive
+ * a restart of the process.<br>
+ * <br>
+ * Concurrency note: instances of this class or its subclasses can be invoked by
+ * several threads at the same time and therefore must be thread-safe.
+ *
+ * @see SessionStore
+ */
+class SessionFilter : public echo::routing::Filter {
+
+ public:
+
+  /** The name of the request attribute holding the session identifier. */
+  static const std::string ATTRIBUTE_ID;
+
+  /** The name of the request attribute holding the session data. */
+  static const std::string ATTRIBUTE_DATA;
+
+  /** The default name of the session cookie. */
+  static const std::string DEFAULT_COOKIE_NAME;
+
+  /**
+   * Constructor.
+   */
+  SessionFilter() {
+    SessionFilter(NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   */
+  SessionFilter(echo::Context context) {
+    SessionFilter(context, NULL);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param context
+   *            The context.
+   * @param next
+   *            The next Echo.
+   */
+  SessionFilter(echo::Context context, Echo::Echo next);
+
+  /**
+   * Destructor deleting the store created without a context.
+   */
+  ~SessionFilter();
+
+  /**
+   * Ends the session of a call, removing it from the store and discarding
+   * the session cookie on the client.
+   *
+   * @param request
+   *            The request.
+   * @param response
+   *            The response to update.
+   */
+  void close(echo::Request request, echo::Response response);
+
+  /**
+   * Returns the cookie setting whose attributes are used for all the session
+   * cookies. Its "Set-Cookie" attributes are formatted once and reused.
+   *
+   * @return The session cookie setting template.
+   */
+  CookieSetting getCookieTemplate() {
+    return cookieTemplate;
+  }
+
+  /**
+   * Returns the path of the snapshot file of the sessions.
+   *
+   * @return The path of the snapshot file or empty.
+   */
+  const std::string& getSnapshotPath() {
+    return snapshotPath;
+  }
+
+  /**
+   * Returns the session store.
+   *
+   * @return The session store.
+   */
+  SessionStore* getStore() {
+    return store;
+  }
+
+  /**
+   * Starts a session for a call and sets the session cookie on the client.
+   *
+   * @param request
+   *            The request.
+   * @param response
+   *            The response to update.
+   * @param identifier
+   *            The identifier of the authenticated user or empty.
+   * @param data
+   *            The application data.
+   * @return The identifier of the session.
+   */
+  std::string open(echo::Request request, echo::Response response,
+                   const std::string& identifier, const std::string& data);
+
+  /**
+   * Sets the path of the snapshot file of the sessions. Must be set before
+   * the filter is started.
+   *
+   * @param snapshotPath
+   *            The path of the snapshot file, or empty to keep the sessions
+   *            in memory only.
+   */
+  void setSnapshotPath(const std::string& snapshotPath) {
+    this->snapshotPath = snapshotPath;
+  }
+
+  /**
+   * Reloads the sessions of the snapshot file, if any, then starts the
+   * filter.
+   */
+  //@Override
+  void start() throw (std::runtime_error);
+
+  /**
+   * Stops the filter, then saves the sessions to the snapshot file, if any.
+   */
+  //@Override
+  void stop() throw (std::runtime_error);
+
+ protected:
+
+  /**
+   * Resolves the session of the call.
+   *
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   * @return {@link #CONTINUE}.
+   */
+  int beforeHandle(echo::Request request, echo::Response response);
+
+ private:
+
+  /**
+   * Adds a session cookie setting to a response, using the attributes of the
+   * template.
+   *
+   * @param response
+   *            The response to update.
+   * @param value
+   *            The value of the cookie.
+   * @param maxAge
+   *            The maximum age of the cookie.
+   */
+  void addCookieSetting(echo::Response response, const std::string& value,
+                        int maxAge);
+
+  /** The session cookie setting template. */
+  CookieSetting cookieTemplate;
+
+  /** The session store. */
+  SessionStore* store;
+
+  /** Indicates if the store is owned by the filter. */
+  bool ownedStore;
+
+  /** The path of the snapshot file or empty. */
+  std::string snapshotPath;
+
+};
+
+} // namespace session
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_SESSION_SESSION_FILTER_H_
@@ -0,0 +1,323 @@
+#ifndef _ECHO_ENGINE_SESSION_SESSION_STORE_H_
+#define _ECHO_ENGINE_SESSION_SESSION_STORE_H_
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include <stdexcept>
+#include <string>
+#include <tr1/unordered_map>
+
+#include <echo/context.h>
+#include <echo/engine/util/timer-wheel.h>
+
+namespace echo {
+namespace engine {
+namespace session {
+
+/**
+ * In-process store of sessions keyed by their identifier, as sent in a
+ * cookie. The sessions are spread over independent shards, each one guarded by
+ * its own lock and aligned on a cache line so that threads working on
+ * different shards never contend, even for the same cache line.<br>
+ * <br>
+ * Each session expires after a time to live of inactivity, tracked by a timing
+ * wheel per shard. The memory is bounded by a maximum number of sessions, the
+ * least recently used session of a full shard being evicted. The store can be
+ * saved to a memory-mapped snapshot file and reloaded on startup, so that the
+ * sessions survive a restart.<br>
+ * <br>
+ * The store is shared through the {@link #ATTRIBUTE} context attribute.<br>
+ * <br>
+ * Concurrency note: instances of this class are thread-safe.
+ *
+ * @see SessionFilter
+ */
+class SessionStore {
+
+ public:
+
+  /** The name of the context attribute holding the store. */
+  static const std::string ATTRIBUTE;
+
+  /** The default maximum number of sessions. */
+  static const int DEFAULT_MAX_SESSIONS;
+
+  /** The default time to live of an inactive session, in seconds. */
+  static const int DEFAULT_TIME_TO_LIVE;
+
+  /** The number of shards, a power of two. */
+  static const int SHARDS;
+
+  /**
+   * Returns the store shared through the attributes of a context.
+   *
+   * @param context
+   *            The context.
+   * @return The store or null if none was registered.
+   */
+  static SessionStore* getStore(Context context);
+
+  /**
+   * Shares a store through the attributes of a context.
+   *
+   * @param context
+   *            The context.
+   * @param store
+   *            The store to share.
+   */
+  static void setStore(Context context, SessionStore* store);
+
+  /**
+   * Constructor using the default limits.
+   */
+  SessionStore();
+
+  /**
+   * Constructor.
+   *
+   * @param maxSessions
+   *            The maximum number of sessions.
+   * @param timeToLive
+   *            The time to live of an inactive session, in seconds.
+   */
+  SessionStore(int maxSessions, int timeToLive);
+
+  /**
+   * Destructor.
+   */
+  ~SessionStore();
+
+  /**
+   * Creates a session with a new random identifier.
+   *
+   * @param identifier
+   *            The identifier of the authenticated user or empty.
+   * @param data
+   *            The application data.
+   * @return The identifier of the session.
+   * @throws std::runtime_error
+   *            If no random identifier can be generated.
+   */
+  std::string create(const std::string& identifier, const std::string& data)
+      throw (std::runtime_error);
+
+  /**
+   * Looks up a live session and extends its time to live.
+   *
+   * @param id
+   *            The identifier of the session.
+   * @param identifier
+   *            Set to the identifier of the authenticated user.
+   * @param data
+   *            Set to the application data.
+   * @return True if the session was found.
+   */
+  bool get(const std::string& id, std::string& identifier, std::string& data);
+
+  /**
+   * Returns the maximum number of sessions.
+   *
+   * @return The maximum number of sessions.
+   */
+  int getMaxSessions() const {
+    return maxSessions;
+  }
+
+  /**
+   * Returns the number of live sessions.
+   *
+   * @return The number of live sessions.
+   */
+  int getSize();
+
+  /**
+   * Returns the time to live of an inactive session.
+   *
+   * @return The time to live of an inactive session, in seconds.
+   */
+  int getTimeToLive() const {
+    return timeToLive;
+  }
+
+  /**
+   * Loads the sessions of a snapshot file, keeping their remaining time to
+   * live. The file is memory-mapped and the sessions are copied from the
+   * mapping, replacing the live sessions with the same identifier.
+   *
+   * @param path
+   *            The path of the snapshot file.
+   * @return True if the snapshot was loaded.
+   */
+  bool load(const std::string& path);
+
+  /**
+   * Removes a session.
+   *
+   * @param id
+   *            The identifier of the session.
+   * @return True if the session was found.
+   */
+  bool remove(const std::string& id);
+
+  /**
+   * Saves the live sessions to a snapshot file. The snapshot is written to a
+   * temporary file through a memory mapping, then atomically renamed.
+   *
+   * @param path
+   *            The path of the snapshot file.
+   * @return True if the snapshot was saved.
+   */
+  bool save(const std::string& path);
+
+  /**
+   * Updates the data of a live session and extends its time to live.
+   *
+   * @param id
+   *            The identifier of the session.
+   * @param data
+   *            The new application data.
+   * @return True if the session was found.
+   */
+  bool update(const std::string& id, const std::string& data);
+
+ private:
+
+  /**
+   * Session entry, scheduled in the timing wheel of its shard and linked in
+   * its least recently used list.
+   */
+  class Entry : public echo::engine::util::TimerWheel::Timer {
+
+   public:
+
+    /** The identifier of the session. */
+    std::string id;
+
+    /** The identifier of the authenticated user. */
+    std::string identifier;
+
+    /** The application data. */
+    std::string data;
+
+    /** The less recently used entry. */
+    Entry* older;
+
+    /** The more recently used entry. */
+    Entry* newer;
+
+  };
+
+  /** Map of the entries of a shard. */
+  typedef std::tr1::unordered_map<std::string, Entry*> EntryMap;
+
+  /**
+   * Shard of the store, aligned on a cache line.
+   */
+  struct Shard {
+
+    /** The lock guarding the shard. */
+    pthread_mutex_t lock;
+
+    /** The entries by session identifier. */
+    EntryMap entries;
+
+    /** The expiry wheel. */
+    echo::engine::util::TimerWheel* wheel;
+
+    /** The least recently used entry. */
+    Entry* oldest;
+
+    /** The most recently used entry. */
+    Entry* newest;
+
+  } __attribute__((aligned(64)));
+
+  /**
+   * Initializes the shards.
+   */
+  void initialize();
+
+  /**
+   * Inserts an entry in a locked shard, evicting the least recently used
+   * entry if the shard is full.
+   *
+   * @param shard
+   *            The locked shard.
+   * @param id
+   *            The identifier of the session.
+   * @param identifier
+   *            The identifier of the authenticated user.
+   * @param data
+   *            The application data.
+   * @param timeToLive
+   *            The time to live in milliseconds.
+   */
+  void insert(Shard& shard, const std::string& id,
+              const std::string& identifier, const std::string& data,
+              long long timeToLive);
+
+  /**
+   * Removes the expired entries of a locked shard.
+   *
+   * @param shard
+   *            The locked shard.
+   * @param now
+   *            The current time in milliseconds.
+   */
+  void expire(Shard& shard, long long now);
+
+  /**
+   * Unlinks and deletes an entry of a locked shard.
+   *
+   * @param shard
+   *            The locked shard.
+   * @param entry
+   *            The entry to delete.
+   */
+  void erase(Shard& shard, Entry* entry);
+
+  /**
+   * Marks an entry of a locked shard as the most recently used and extends
+   * its time to live.
+   *
+   * @param shard
+   *            The locked shard.
+   * @param entry
+   *            The entry to touch.
+   * @param now
+   *            The current time in milliseconds.
+   */
+  void touch(Shard& shard, Entry* entry, long long now);
+
+  /**
+   * Returns the shard of a session identifier.
+   *
+   * @param id
+   *            The identifier of the session.
+   * @return The shard of the session.
+   */
+  Shard& getShard(const std::string& id);
+
+  /** The shards. */
+  Shard* shards;
+
+  /** The maximum number of sessions. */
+  int maxSessions;
+
+  /** The descriptor of the random source of the session identifiers. */
+  int random;
+
+  /** The maximum number of sessions per shard. */
+  size_t maxShardSessions;
+
+  /** The time to live of an inactive session, in seconds. */
+  int timeToLive;
+
+};
+
+} // namespace session
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_SESSION_SESSION_STORE_H_
@@ -0,0 +1,139 @@
+#ifndef _ECHO_ENGINE_UTIL_ASSET_PACK_WRITER_H_
+#define _ECHO_ENGINE_UTIL_ASSET_PACK_WRITER_H_
+
+#include <time.h>
+
+#include <map>
+#include <string>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Builds the packs read by {@link AssetPack}, either as a pack file to map at
+ * runtime, or as a C++ source file embedding the pack into the binary and
+ * registering it from a static initializer. The tags and the gzip variants
+ * are computed here, at build time, so that serving an asset costs a lookup.
+ * The "echo-pack" tool of the "tools" directory drives this class from the
+ * build.
+ */
+class AssetPackWriter {
+
+ public:
+
+  /**
+   * Returns the media type of a path, guessed from its extension.
+   *
+   * @param path
+   *            The path.
+   * @return The name of the media type.
+   */
+  static std::string getMediaType(const std::string& path);
+
+  /**
+   * Constructor.
+   */
+  AssetPackWriter() {
+  }
+
+  /**
+   * Adds an asset, replacing any asset with the same path.
+   *
+   * @param path
+   *            The absolute path of the asset, such as "/css/site.css".
+   * @param content
+   *            The content.
+   * @param mediaType
+   *            The name of the media type.
+   * @param modified
+   *            The modification date.
+   */
+  void add(const std::string& path, const std::string& content,
+           const std::string& mediaType, time_t modified);
+
+  /**
+   * Adds the regular files of a directory tree, their paths being relative
+   * to the directory.
+   *
+   * @param directory
+   *            The root of the tree.
+   * @return False if a file couldn't be read.
+   */
+  bool addDirectory(const std::string& directory);
+
+  /**
+   * Serializes the pack.
+   *
+   * @param output
+   *            The buffer receiving the pack.
+   */
+  void write(std::string& output) const;
+
+  /**
+   * Serializes the pack as a C++ source file defining it and registering it.
+   *
+   * @param name
+   *            The name to register the pack under, empty for the pack of
+   *            the "clap" references.
+   * @param output
+   *            The buffer receiving the source file.
+   */
+  void writeSource(const std::string& name, std::string& output) const;
+
+ private:
+
+  /**
+   * Asset to write.
+   */
+  struct Entry {
+
+    /** The content. */
+    std::string content;
+
+    /** The gzip variant, empty if not smaller. */
+    std::string gzip;
+
+    /** The name of the media type. */
+    std::string mediaType;
+
+    /** The name of the strong tag. */
+    std::string tag;
+
+    /** The modification date. */
+    time_t modified;
+
+  };
+
+  /**
+   * Non copyable.
+   */
+  AssetPackWriter(const AssetPackWriter&);
+
+  /**
+   * Non copyable.
+   */
+  AssetPackWriter& operator=(const AssetPackWriter&);
+
+  /**
+   * Adds the regular files below a directory.
+   *
+   * @param directory
+   *            The root of the tree.
+   * @param path
+   *            The path of the directory relative to the root, empty for the
+   *            root itself.
+   * @return False if a file couldn't be read.
+   */
+  bool addFiles(const std::string& directory, const std::string& path);
+
+  /** The assets sorted by path. */
+  std::map<std::string, Entry> entries;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_ASSET_PACK_WRITER_H_
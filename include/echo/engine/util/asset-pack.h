@@ -0,0 +1,245 @@
+#ifndef _ECHO_ENGINE_UTIL_ASSET_PACK_H_
+#define _ECHO_ENGINE_UTIL_ASSET_PACK_H_
+
+#include <stddef.h>
+#include <time.h>
+
+#include <string>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Read-only bundle of static assets, either compiled into the binary or
+ * mapped from a pack file, backing the "clap" and "zip" local references
+ * without filesystem access. A pack is produced by {@link AssetPackWriter}:
+ * its index is sorted by path and each entry carries a precomputed strong
+ * tag, a media type, a modification date and, when it pays off, a gzip
+ * variant of the content. Lookups are binary searches returning slices of
+ * the pack itself, so serving an asset copies nothing.<br>
+ * <br>
+ * The pack registered under the empty name backs the "clap" references,
+ * whatever their authority. A "zip:&lt;pack&gt;!/&lt;path&gt;" reference is
+ * resolved against the pack registered under "&lt;pack&gt;", or else against
+ * the pack file of a "file" URI, mapped on first use and registered for the
+ * life of the process.<br>
+ * <br>
+ * Concurrency note: instances of this class are immutable once opened and
+ * the registry is thread-safe.
+ */
+class AssetPack {
+
+ public:
+
+  /**
+   * Region of a pack.
+   */
+  struct Slice {
+
+    /** The first byte, null for an empty slice. */
+    const char* data;
+
+    /** The length in bytes. */
+    size_t length;
+
+  };
+
+  /**
+   * Entry of a pack, made of slices of the pack.
+   */
+  struct Asset {
+
+    /** The content. */
+    Slice content;
+
+    /** The gzip variant of the content, empty if not worth it. */
+    Slice gzip;
+
+    /** The name of the media type. */
+    Slice mediaType;
+
+    /** The name of the strong tag. */
+    Slice tag;
+
+    /** The modification date. */
+    time_t modified;
+
+  };
+
+  /** The size of the pack header. */
+  static const size_t HEADER_SIZE;
+
+  /** The size of an index entry. */
+  static const size_t ENTRY_SIZE;
+
+  /**
+   * Returns a registered pack.
+   *
+   * @param name
+   *            The name of the pack, empty for the pack of the "clap"
+   *            references.
+   * @return The pack or null.
+   */
+  static AssetPack* getPack(const std::string& name);
+
+  /**
+   * Maps a pack file.
+   *
+   * @param path
+   *            The path of the pack file.
+   * @return The pack or null if the file couldn't be mapped or isn't a valid
+   *         pack.
+   */
+  static AssetPack* open(const std::string& path);
+
+  /**
+   * Registers a pack, typically from the static initializer generated for an
+   * embedded pack. A pack already registered under the name is kept.
+   *
+   * @param name
+   *            The name of the pack, empty for the pack of the "clap"
+   *            references.
+   * @param pack
+   *            The pack, which must stay alive.
+   * @return True if the pack was registered.
+   */
+  static bool registerPack(const std::string& name, AssetPack* pack);
+
+  /**
+   * Resolves a "clap", "zip" or "jar" reference to an asset.
+   *
+   * @param reference
+   *            The URI of the reference.
+   * @param result
+   *            The asset found.
+   * @return True if the asset was found.
+   */
+  static bool resolve(const std::string& reference, Asset& result);
+
+  /**
+   * Constructor over an embedded pack.
+   *
+   * @param data
+   *            The pack, which must stay alive.
+   * @param size
+   *            The size of the pack.
+   */
+  AssetPack(const char* data, size_t size);
+
+  /**
+   * Destructor, unmapping a pack file.
+   */
+  ~AssetPack();
+
+  /**
+   * Finds an asset with a binary search of the index.
+   *
+   * @param path
+   *            The absolute path of the asset, such as "/css/site.css".
+   * @param result
+   *            The asset found.
+   * @return True if the asset was found.
+   */
+  bool find(const std::string& path, Asset& result) const;
+
+  /**
+   * Returns the number of assets.
+   *
+   * @return The number of assets, 0 for an invalid pack.
+   */
+  size_t getCount() const {
+    return count;
+  }
+
+  /**
+   * Returns the path of an asset.
+   *
+   * @param index
+   *            The position of the asset in the index.
+   * @return The path of the asset.
+   */
+  std::string getPath(size_t index) const;
+
+  /**
+   * Indicates if the header and the index are consistent with the size of
+   * the pack.
+   *
+   * @return True if the pack is valid.
+   */
+  bool isValid() const {
+    return valid;
+  }
+
+ private:
+
+  /**
+   * Constructor.
+   *
+   * @param data
+   *            The pack.
+   * @param size
+   *            The size of the pack.
+   * @param mapped
+   *            True if the pack was mapped by {@link #open(std::string)}.
+   */
+  AssetPack(const char* data, size_t size, bool mapped);
+
+  /**
+   * Non copyable.
+   */
+  AssetPack(const AssetPack&);
+
+  /**
+   * Non copyable.
+   */
+  AssetPack& operator=(const AssetPack&);
+
+  /**
+   * Reads an index entry.
+   *
+   * @param index
+   *            The position of the entry.
+   * @param result
+   *            The asset.
+   */
+  void getAsset(size_t index, Asset& result) const;
+
+  /**
+   * Returns the path of an index entry.
+   *
+   * @param index
+   *            The position of the entry.
+   * @return The path, a slice of the pack.
+   */
+  Slice getSlice(size_t index) const;
+
+  /**
+   * Checks the header and that every entry lies within the pack.
+   *
+   * @return True if the pack is valid.
+   */
+  bool validate();
+
+  /** The pack. */
+  const unsigned char* data;
+
+  /** The size of the pack. */
+  size_t size;
+
+  /** Indicates if the pack is mapped. */
+  bool mapped;
+
+  /** Indicates if the pack is valid. */
+  bool valid;
+
+  /** The number of entries. */
+  size_t count;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_ASSET_PACK_H_
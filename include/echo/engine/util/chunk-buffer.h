@@ -0,0 +1,315 @@
+#ifndef _ECHO_ENGINE_UTIL_CHUNK_BUFFER_H_
+#define _ECHO_ENGINE_UTIL_CHUNK_BUFFER_H_
+
+#include <pthread.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <string>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Append-only chain of fixed-size chunks, growing without ever reallocating or
+ * copying what was already appended. The chunks come from pools of recycled
+ * chunks, so that generating a large page doesn't go through the allocator
+ * for every chunk. Each thread recycles its chunks in a pool of its own,
+ * without locking; the chunks it can't hold, such as those produced by one
+ * thread and released by another, overflow to a process-wide pool, which
+ * also takes back the pool of an exiting thread.<br>
+ * <br>
+ * The content is meant to be flushed with writev(), either with
+ * {@link #write(int, size_t)} or by giving the vectors returned by
+ * {@link #getVectors(struct iovec*, int)} to another writer, without ever
+ * building one contiguous string.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, but the
+ * pools of chunks are.
+ */
+class ChunkBuffer {
+
+ public:
+
+  /** The size of the chunks in bytes. */
+  static const size_t CHUNK_SIZE;
+
+  /** The maximum number of idle chunks kept in the process-wide pool. */
+  static const size_t POOL_SIZE;
+
+  /** The maximum number of idle chunks kept in the pool of a thread. */
+  static const size_t THREAD_POOL_SIZE;
+
+  /**
+   * Constructor.
+   */
+  ChunkBuffer();
+
+  /**
+   * Destructor returning the chunks to the pool.
+   */
+  ~ChunkBuffer();
+
+  /**
+   * Appends a character.
+   *
+   * @param c
+   *            The character to append.
+   */
+  void append(char c) {
+    if ((last != NULL) && (last->length < CHUNK_SIZE)) {
+      last->data[last->length++] = c;
+      size++;
+    } else {
+      append(&c, 1);
+    }
+  }
+
+  /**
+   * Appends a sequence of characters.
+   *
+   * @param data
+   *            The characters to append.
+   * @param length
+   *            The number of characters.
+   */
+  void append(const char* data, size_t length);
+
+  /**
+   * Appends a string.
+   *
+   * @param text
+   *            The string to append.
+   */
+  void append(const std::string& text) {
+    append(text.data(), text.size());
+  }
+
+  /**
+   * Removes the content, returning the chunks to the pool.
+   */
+  void clear();
+
+  /**
+   * Removes leading bytes, typically once written, returning the emptied
+   * chunks to the pool.
+   *
+   * @param count
+   *            The number of bytes to remove, at most the size of the content.
+   */
+  void consume(size_t count);
+
+  /**
+   * Returns the size of the content in bytes.
+   *
+   * @return The size of the content.
+   */
+  size_t getSize() const {
+    return size;
+  }
+
+  /**
+   * Returns the vectors of the first chunks, as expected by writev().
+   *
+   * @param vectors
+   *            The vectors to fill.
+   * @param count
+   *            The maximum number of vectors.
+   * @return The number of vectors filled.
+   */
+  int getVectors(struct iovec* vectors, int count) const;
+
+  /**
+   * Indicates if the content fills at least one chunk, which can be
+   * transferred without a partially filled chunk.
+   *
+   * @return True if the content fills at least one chunk.
+   */
+  bool hasFullChunk() const {
+    return (first != NULL) && (first->length == CHUNK_SIZE);
+  }
+
+  /**
+   * Copies leading bytes to a buffer and removes them.
+   *
+   * @param buffer
+   *            The buffer receiving the bytes.
+   * @param length
+   *            The size of the buffer.
+   * @return The number of bytes copied.
+   */
+  size_t read(char* buffer, size_t length);
+
+  /**
+   * Moves chunks to the end of another buffer without copying them. Unless
+   * all the chunks are moved, the last partially filled chunk stays here to
+   * receive the next appended bytes. No leading byte of this buffer must have
+   * been consumed.
+   *
+   * @param target
+   *            The buffer receiving the chunks.
+   * @param all
+   *            True to move the partially filled chunk as well.
+   */
+  void transfer(ChunkBuffer& target, bool all);
+
+  /**
+   * Copies the content to a string. Only meant for the callers needing a
+   * contiguous copy, such as getText().
+   *
+   * @param result
+   *            The string receiving the content.
+   */
+  void toString(std::string& result) const;
+
+  /**
+   * Writes the content with writev(), resuming until everything is written.
+   *
+   * @param file
+   *            The descriptor to write to.
+   * @param offset
+   *            The number of leading bytes to skip, for example those already
+   *            written with the vectors of {@link #getVectors(struct iovec*,
+   *            int)}.
+   * @return The number of bytes written or -1 in case of error.
+   */
+  ssize_t write(int file, size_t offset) const;
+
+  /**
+   * Writes vectors with writev(), resuming after partial writes and
+   * interruptions until everything is written.
+   *
+   * @param file
+   *            The descriptor to write to.
+   * @param vectors
+   *            The vectors to write, updated as they are written.
+   * @param count
+   *            The number of vectors.
+   * @return The number of bytes written or -1 in case of error.
+   */
+  static ssize_t writeVectors(int file, struct iovec* vectors, int count);
+
+  /**
+   * Writes vectors with writev() to a non-blocking descriptor, resuming
+   * after partial writes and interruptions until everything is written or
+   * the descriptor would block.
+   *
+   * @param file
+   *            The descriptor to write to.
+   * @param vectors
+   *            The vectors to write, updated as they are written.
+   * @param count
+   *            The number of vectors.
+   * @param index
+   *            The position of the first vector not fully written, updated;
+   *            lower than count if the descriptor would block.
+   * @return The number of bytes written or -1 in case of error.
+   */
+  static ssize_t writeVectors(int file, struct iovec* vectors, int count,
+                              int& index);
+
+ private:
+
+  /**
+   * Chunk of the chain, allocated with its data.
+   */
+  struct Chunk {
+
+    /** The next chunk of the chain or of the pool. */
+    Chunk* next;
+
+    /** The number of bytes used. */
+    size_t length;
+
+    /** The data, CHUNK_SIZE bytes long. */
+    char data[1];
+
+  };
+
+  /**
+   * Takes a chunk from the pool of the thread, else from the process-wide
+   * pool, else allocates a new one.
+   *
+   * @return An empty chunk.
+   */
+  static Chunk* acquire();
+
+  /**
+   * Creates the key whose destructor empties the pool of an exiting thread.
+   */
+  static void createThreadKey();
+
+  /**
+   * Returns the pool of an exiting thread to the process-wide pool.
+   *
+   * @param marker
+   *            The value of the key, unused.
+   */
+  static void releaseThreadPool(void* marker);
+
+  /**
+   * Returns a chain of chunks to the pool of the thread, the chunks it can't
+   * hold going to the process-wide pool.
+   *
+   * @param chunk
+   *            The first chunk of the chain.
+   */
+  static void release(Chunk* chunk);
+
+  /**
+   * Returns a chain of chunks to the process-wide pool, freeing the chunks
+   * exceeding its size.
+   *
+   * @param chunk
+   *            The first chunk of the chain.
+   */
+  static void releaseShared(Chunk* chunk);
+
+  /** The idle chunks of the process. */
+  static Chunk* pool;
+
+  /** The number of idle chunks of the process. */
+  static size_t pooled;
+
+  /** The lock guarding the process-wide pool. */
+  static pthread_mutex_t poolLock;
+
+  /** The idle chunks of the current thread. */
+  static __thread Chunk* threadPool;
+
+  /** The number of idle chunks of the current thread. */
+  static __thread size_t threadPooled;
+
+  /** The key emptying the pool of an exiting thread. */
+  static pthread_key_t threadKey;
+
+  /** The creation of the key, done once. */
+  static pthread_once_t threadKeyOnce;
+
+  /** Not copyable, the chunks are owned. */
+  ChunkBuffer(const ChunkBuffer&);
+
+  /** Not assignable, the chunks are owned. */
+  ChunkBuffer& operator=(const ChunkBuffer&);
+
+  /** The first chunk. */
+  Chunk* first;
+
+  /** The last chunk, receiving the appended data. */
+  Chunk* last;
+
+  /** The number of bytes consumed from the first chunk. */
+  size_t offset;
+
+  /** The size of the content in bytes. */
+  size_t size;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_CHUNK_BUFFER_H_
@@ -0,0 +1,234 @@
+#ifndef _ECHO_ENGINE_UTIL_CHUNK_STREAM_H_
+#define _ECHO_ENGINE_UTIL_CHUNK_STREAM_H_
+
+#include <pthread.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#include <string>
+
+#include <echo/engine/util/chunk-buffer.h>
+#include <echo/engine/util/deflater.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Queue of chunks between a producer generating an entity and a connector
+ * writing it to a client, so that the first chunks go out while the rest is
+ * still being generated. Chunks are moved from the producer's buffer into the
+ * queue without copying.<br>
+ * <br>
+ * The queue is bounded by a high-water mark. When a slow client lets more
+ * bytes than the mark pile up, a blocking stream suspends the producer until
+ * the connector drains the queue below the mark, while a non-blocking stream
+ * only reports it so that the producer can yield.<br>
+ * <br>
+ * A stream can also compress its chunks as they are offered, so that a
+ * streamed entity is encoded without being read whole.<br>
+ * <br>
+ * Concurrency note: instances of this class are thread-safe, with one
+ * producer thread and one connector thread.
+ */
+class ChunkStream {
+
+ public:
+
+  /** The default high-water mark in bytes. */
+  static const size_t DEFAULT_HIGH_WATER_MARK;
+
+  /**
+   * Constructor of a blocking stream with the default high-water mark.
+   */
+  ChunkStream();
+
+  /**
+   * Constructor.
+   *
+   * @param highWaterMark
+   *            The number of queued bytes above which the producer is held
+   *            back.
+   * @param blocking
+   *            True to suspend the producer above the mark, false to only
+   *            report it.
+   */
+  ChunkStream(size_t highWaterMark, bool blocking);
+
+  /**
+   * Destructor.
+   */
+  ~ChunkStream();
+
+  /**
+   * Aborts the stream, typically when the client connection is lost. The
+   * queued chunks are dropped, a suspended producer is woken up and the chunks
+   * offered later are discarded.
+   */
+  void abort();
+
+  /**
+   * Indicates the end of the entity. Called by the producer once all the
+   * chunks were offered.
+   */
+  void close();
+
+  /**
+   * Removes bytes written by the connector, waking up the producer if the
+   * queue went back below the high-water mark.
+   *
+   * @param count
+   *            The number of bytes written.
+   */
+  void consume(size_t count);
+
+  /**
+   * Compresses the queued chunks and the ones offered from now on, with a
+   * stream taken from the pool of the calling thread. The chunks offered
+   * with the partially filled last chunk are flushed, so that the client
+   * can decode them without waiting for the next ones.
+   *
+   * @param gzip
+   *            True for the "gzip" format, false for the "deflate" format.
+   * @param level
+   *            The compression level, from 1 to 9.
+   * @return True if the chunks are compressed.
+   */
+  bool deflate(bool gzip, int level);
+
+  /**
+   * Returns the high-water mark in bytes.
+   *
+   * @return The high-water mark.
+   */
+  size_t getHighWaterMark() const {
+    return highWaterMark;
+  }
+
+  /**
+   * Returns the number of queued bytes.
+   *
+   * @return The number of queued bytes.
+   */
+  size_t getSize();
+
+  /**
+   * Returns the vectors of the first queued chunks, which stay valid until
+   * they are consumed.
+   *
+   * @param vectors
+   *            The vectors to fill.
+   * @param count
+   *            The maximum number of vectors.
+   * @return The number of vectors filled.
+   */
+  int getVectors(struct iovec* vectors, int count);
+
+  /**
+   * Indicates if the stream was aborted.
+   *
+   * @return True if the stream was aborted.
+   */
+  bool isAborted();
+
+  /**
+   * Indicates if the stream is closed and all its chunks were consumed.
+   *
+   * @return True if the stream is done.
+   */
+  bool isDone();
+
+  /**
+   * Indicates if the producer can offer chunks without exceeding the
+   * high-water mark.
+   *
+   * @return True if the queue is below the high-water mark.
+   */
+  bool isWritable();
+
+  /**
+   * Moves the chunks of a producer buffer into the queue. A blocking stream
+   * then waits while the queue is above the high-water mark.
+   *
+   * @param chunks
+   *            The producer buffer.
+   * @param all
+   *            True to move the partially filled last chunk as well, false to
+   *            only move the full chunks.
+   * @return False if the stream was aborted or, for a non-blocking stream, if
+   *         the queue is above the high-water mark.
+   */
+  bool offer(ChunkBuffer& chunks, bool all);
+
+  /**
+   * Waits until chunks are queued, the stream is closed or aborted.
+   *
+   * @param timeout
+   *            The maximum waiting time in milliseconds.
+   * @return True if chunks are queued or the stream is closed or aborted.
+   */
+  bool await(int timeout);
+
+ private:
+
+  /**
+   * Compresses the chunks of a producer buffer into the queue. The stream
+   * must be locked.
+   *
+   * @param chunks
+   *            The producer buffer.
+   * @param all
+   *            True to compress and flush the partially filled last chunk
+   *            as well, false to only compress the full chunks.
+   * @return True if the chunks were compressed.
+   */
+  bool compress(ChunkBuffer& chunks, bool all);
+
+  /**
+   * Initializes the lock and the conditions.
+   */
+  void initialize();
+
+  /** Not copyable, the chunks are owned. */
+  ChunkStream(const ChunkStream&);
+
+  /** Not assignable, the chunks are owned. */
+  ChunkStream& operator=(const ChunkStream&);
+
+  /** The lock guarding the queue. */
+  pthread_mutex_t lock;
+
+  /** The condition signaled when the queue goes below the mark. */
+  pthread_cond_t writable;
+
+  /** The condition signaled when chunks are queued. */
+  pthread_cond_t readable;
+
+  /** The queued chunks. */
+  ChunkBuffer queue;
+
+  /** The high-water mark in bytes. */
+  const size_t highWaterMark;
+
+  /** Indicates if the producer is suspended above the mark. */
+  const bool blocking;
+
+  /** Indicates if the producer closed the stream. */
+  bool closed;
+
+  /** Indicates if the stream was aborted. */
+  bool aborted;
+
+  /** The compression stream, null if the chunks aren't compressed. */
+  Deflater* deflater;
+
+  /** The scratch buffer receiving the compressed chunks. */
+  std::string compressed;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_CHUNK_STREAM_H_
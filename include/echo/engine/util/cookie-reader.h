@@ -0,0 +1,134 @@
+#ifndef _ECHO_ENGINE_UTIL_COOKIE_READER_H_
+#define _ECHO_ENGINE_UTIL_COOKIE_READER_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include <echo/data/cookie.h>
+#include <echo/util/series.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Tokenizer of "Cookie" header values. The cookies are exposed as views on the
+ * header value, without copying or allocating, which keeps the common lookup
+ * of a single cookie, such as a session identifier, independent of the number
+ * of cookies sent by the client. Quoted values are exposed without their
+ * quotes.<br>
+ * <br>
+ * The "$Version", "$Path" and "$Domain" attributes of version 1 cookies are
+ * recognized; they aren't returned as cookies but update the version, path
+ * and domain of the cookies materialized by {@link #readNextCookie()}.
+ *
+ * @see echo::Request#getCookies()
+ */
+class CookieReader {
+
+ public:
+
+  /**
+   * Finds the value of the first cookie with a given name, without
+   * materializing the other cookies.
+   *
+   * @param header
+   *            The "Cookie" header value.
+   * @param name
+   *            The name of the cookie.
+   * @param value
+   *            The view on the value of the cookie.
+   * @param valueLength
+   *            The length of the value.
+   * @return True if the cookie was found.
+   */
+  static bool find(const std::string& header, const std::string& name,
+                   const char*& value, size_t& valueLength);
+
+  /**
+   * Returns the value of the first cookie with a given name.
+   *
+   * @param header
+   *            The "Cookie" header value.
+   * @param name
+   *            The name of the cookie.
+   * @return The value of the cookie or null if not found.
+   */
+  static std::string getFirstValue(const std::string& header,
+                                   const std::string& name);
+
+  /**
+   * Constructor. The header value must outlive the reader and the views it
+   * returns.
+   *
+   * @param header
+   *            The "Cookie" header value.
+   */
+  CookieReader(const std::string& header);
+
+  /**
+   * Adds the remaining cookies to a given series.
+   *
+   * @param cookies
+   *            The series to update.
+   */
+  void addCookies(Series<Cookie> cookies);
+
+  /**
+   * Reads the next cookie as views on the header value.
+   *
+   * @param name
+   *            The name of the cookie.
+   * @param nameLength
+   *            The length of the name.
+   * @param value
+   *            The value of the cookie.
+   * @param valueLength
+   *            The length of the value.
+   * @return False if there are no more cookies.
+   */
+  bool readNext(const char*& name, size_t& nameLength, const char*& value,
+                size_t& valueLength);
+
+  /**
+   * Reads the next cookie, including its version 1 attributes.
+   *
+   * @return The next cookie or null if there are no more cookies.
+   */
+  Cookie readNextCookie();
+
+ private:
+
+  /**
+   * Reads the next name and value pair, attributes included.
+   *
+   * @param name
+   *            The name of the pair.
+   * @param nameLength
+   *            The length of the name.
+   * @param value
+   *            The value of the pair.
+   * @param valueLength
+   *            The length of the value.
+   * @return False if the end of the header is reached.
+   */
+  bool readPair(const char*& name, size_t& nameLength, const char*& value,
+                size_t& valueLength);
+
+  /** The current position in the header value. */
+  const char* position;
+
+  /** The end of the header value. */
+  const char* end;
+
+  /** The version of the cookies, set by the "$Version" attribute. */
+  int version;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_COOKIE_READER_H_
@@ -0,0 +1,119 @@
+#ifndef _ECHO_ENGINE_UTIL_DATE_UTILS_H_
+#define _ECHO_ENGINE_UTIL_DATE_UTILS_H_
+
+#include <stddef.h>
+#include <time.h>
+
+#include <string>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Date manipulation utilities for HTTP headers. Dates are formatted as
+ * IMF-fixdate, the fixed-length RFC 1123 layout, with plain table lookups and
+ * digit arithmetic instead of strftime() or the C library time zone handling.
+ * The current date, written in the "Date" header of every response, is
+ * formatted at most once per second and per thread.<br>
+ * <br>
+ * Parsing first tries the fixed IMF-fixdate layout, then falls back to the
+ * obsolete RFC 850 and asctime() layouts that recipients are still required to
+ * accept. As clients tend to send the same "If-Modified-Since" and
+ * "If-Unmodified-Since" values again and again, the last parsed strings are
+ * remembered in a small direct-mapped cache.<br>
+ * <br>
+ * Concurrency note: the methods of this class are thread-safe. The caches are
+ * kept per thread so that no lock is needed.
+ */
+class DateUtils {
+
+ public:
+
+  /**
+   * Appends a date formatted as IMF-fixdate, for example
+   * "Sun, 06 Nov 1994 08:49:37 GMT".
+   *
+   * @param buffer
+   *            The buffer to update.
+   * @param seconds
+   *            The date in seconds since the epoch.
+   */
+  static void append(std::string& buffer, time_t seconds);
+
+  /**
+   * Appends the current date formatted as IMF-fixdate. The formatted string is
+   * reused until the next second.
+   *
+   * @param buffer
+   *            The buffer to update.
+   */
+  static void appendNow(std::string& buffer);
+
+  /**
+   * Formats a date as IMF-fixdate.
+   *
+   * @param seconds
+   *            The date in seconds since the epoch.
+   * @param result
+   *            The array receiving the {@link #LENGTH} characters, not
+   *            terminated.
+   */
+  static void format(time_t seconds, char* result);
+
+  /**
+   * Parses an HTTP date in the IMF-fixdate, RFC 850 or asctime() layout.
+   *
+   * @param value
+   *            The characters to parse.
+   * @param length
+   *            The number of characters.
+   * @param seconds
+   *            Set to the date in seconds since the epoch.
+   * @return True if the value is a valid date.
+   */
+  static bool parse(const char* value, size_t length, time_t& seconds);
+
+  /**
+   * Parses an HTTP date in the IMF-fixdate, RFC 850 or asctime() layout.
+   *
+   * @param value
+   *            The string to parse.
+   * @param seconds
+   *            Set to the date in seconds since the epoch.
+   * @return True if the value is a valid date.
+   */
+  static bool parse(const std::string& value, time_t& seconds) {
+    return parse(value.data(), value.size(), seconds);
+  }
+
+  /** The length of a date formatted as IMF-fixdate. */
+  static const size_t LENGTH;
+
+ private:
+
+  /**
+   * Parses a date in the asctime() layout, for example
+   * "Sun Nov  6 08:49:37 1994".
+   */
+  static bool parseAsctime(const char* value, size_t length, time_t& seconds);
+
+  /**
+   * Parses a date in the IMF-fixdate layout, for example
+   * "Sun, 06 Nov 1994 08:49:37 GMT".
+   */
+  static bool parseFixdate(const char* value, size_t length, time_t& seconds);
+
+  /**
+   * Parses a date in the RFC 850 layout, for example
+   * "Sunday, 06-Nov-94 08:49:37 GMT".
+   */
+  static bool parseRfc850(const char* value, size_t length, time_t& seconds);
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_DATE_UTILS_H_
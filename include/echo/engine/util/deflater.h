@@ -0,0 +1,156 @@
+#ifndef _ECHO_ENGINE_UTIL_DEFLATER_H_
+#define _ECHO_ENGINE_UTIL_DEFLATER_H_
+
+#include <stddef.h>
+#include <zlib.h>
+
+#include <string>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Reusable zlib compression stream producing either the "gzip" or the
+ * "deflate" content coding. Setting up a zlib stream allocates about 256 KB
+ * of internal state, so instead of creating one per response, each thread
+ * keeps one stream per format and resets it between entities. Streamed
+ * entities, which are compressed chunk by chunk while other entities go out
+ * on the same thread, each take a stream from a pool of the current thread
+ * and give it back once complete.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, use
+ * {@link #getCurrent(bool)} to get the instance of the current thread or
+ * {@link #acquire(bool, int)} to get one for a streamed entity.
+ */
+class Deflater {
+
+ public:
+
+  /** The default compression level. */
+  static const int DEFAULT_LEVEL;
+
+  /**
+   * Takes a stream from the pool of the current thread, or creates one if
+   * the pool is empty, ready to compress a new entity.
+   *
+   * @param gzip
+   *            True for the "gzip" format, false for the "deflate" format.
+   * @param level
+   *            The compression level, from 1 to 9.
+   * @return The stream or null if it couldn't be initialized.
+   */
+  static Deflater* acquire(bool gzip, int level);
+
+  /**
+   * Compresses a buffer with the stream of the current thread.
+   *
+   * @param gzip
+   *            True for the "gzip" format, false for the "deflate" format.
+   * @param level
+   *            The compression level, from 1 to 9.
+   * @param data
+   *            The data to compress.
+   * @param length
+   *            The length of the data.
+   * @param output
+   *            The buffer receiving the compressed data.
+   * @return True if the data was compressed.
+   */
+  static bool encode(bool gzip, int level, const char* data, size_t length,
+                     std::string& output);
+
+  /**
+   * Returns the stream of the current thread for a given format, created on
+   * first use and released when the thread exits.
+   *
+   * @param gzip
+   *            True for the "gzip" format, false for the "deflate" format.
+   * @return The stream of the current thread.
+   */
+  static Deflater& getCurrent(bool gzip);
+
+  /**
+   * Gives a stream taken by {@link #acquire(bool, int)} back to the pool of
+   * the current thread, or deletes it if the pool is full.
+   *
+   * @param deflater
+   *            The stream to give back.
+   */
+  static void release(Deflater* deflater);
+
+  /**
+   * Constructor.
+   *
+   * @param gzip
+   *            True for the "gzip" format, false for the "deflate" format.
+   */
+  Deflater(bool gzip);
+
+  /**
+   * Destructor.
+   */
+  ~Deflater();
+
+  /**
+   * Flushes the compressed data of the chunks given so far, so that the
+   * client can decode them without waiting for the next ones.
+   *
+   * @param output
+   *            The buffer receiving the compressed data.
+   * @return True if the data was flushed.
+   */
+  bool flush(std::string& output);
+
+  /**
+   * Starts a new entity with a given compression level.
+   *
+   * @param level
+   *            The compression level, from 1 to 9.
+   * @return True if the stream is ready.
+   */
+  bool reset(int level);
+
+  /**
+   * Compresses the next chunk of the current entity.
+   *
+   * @param data
+   *            The chunk to compress.
+   * @param length
+   *            The length of the chunk.
+   * @param finish
+   *            True if this is the last chunk of the entity.
+   * @param output
+   *            The buffer receiving the compressed data.
+   * @return True if the chunk was compressed.
+   */
+  bool update(const char* data, size_t length, bool finish,
+              std::string& output);
+
+ private:
+
+  /** Not copyable, the zlib stream is owned. */
+  Deflater(const Deflater&);
+
+  /** Not assignable, the zlib stream is owned. */
+  Deflater& operator=(const Deflater&);
+
+  /** The zlib stream. */
+  z_stream stream;
+
+  /** Indicates if the stream produces the "gzip" format. */
+  const bool gzip;
+
+  /** Indicates if the stream was initialized. */
+  bool initialized;
+
+  /** The compression level of the stream. */
+  int level;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_DEFLATER_H_
@@ -0,0 +1,183 @@
+#ifndef _ECHO_ENGINE_UTIL_FORM_READER_H_
+#define _ECHO_ENGINE_UTIL_FORM_READER_H_
+
+#include <stddef.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <echo/data/parameter.h>
+#include <echo/representation/representation.h>
+#include <echo/util/series.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Incremental reader of "application/x-www-form-urlencoded" entities. The
+ * entity stream is consumed chunk by chunk and only the parameter being read
+ * is buffered, so the memory used doesn't depend on the entity size. Names and
+ * values are URL-decoded in place and exposed as views on the internal buffer,
+ * which are valid until the next parameter is read.<br>
+ * <br>
+ * Limits on the number of parameters and on the size of a single parameter
+ * reject abusive entities as soon as they are exceeded, before the rest of the
+ * entity is read.
+ *
+ * @see echo::data::Form
+ */
+class FormReader {
+
+ public:
+
+  /** The default maximum number of parameters. */
+  static const int DEFAULT_MAX_PARAMETERS;
+
+  /** The default maximum size of an encoded parameter, in bytes. */
+  static const int DEFAULT_MAX_PARAMETER_SIZE;
+
+  /** The size of the chunks read from the entity stream. */
+  static const int BUFFER_SIZE;
+
+  /**
+   * Constructor using the default limits.
+   *
+   * @param representation
+   *            The web form entity.
+   */
+  FormReader(Representation representation);
+
+  /**
+   * Constructor.
+   *
+   * @param representation
+   *            The web form entity.
+   * @param maxParameters
+   *            The maximum number of parameters, or -1 for no limit.
+   * @param maxParameterSize
+   *            The maximum size of an encoded parameter, or -1 for no limit.
+   */
+  FormReader(Representation representation, int maxParameters,
+             int maxParameterSize);
+
+  /**
+   * Destructor. Closes the entity stream.
+   */
+  ~FormReader();
+
+  /**
+   * Adds the remaining parameters to a given series.
+   *
+   * @param parameters
+   *            The series to update.
+   * @throws std::runtime_error
+   *            If the entity can't be read or exceeds the limits.
+   */
+  void addParameters(Series<Parameter> parameters) throw (std::runtime_error);
+
+  /**
+   * Returns the number of parameters read so far.
+   *
+   * @return The number of parameters read so far.
+   */
+  int getCount() {
+    return count;
+  }
+
+  /**
+   * Reads the next parameter as views on the internal buffer. The views are
+   * valid until the next call. A parameter without "=" has a null value.
+   *
+   * @param name
+   *            The decoded name.
+   * @param nameLength
+   *            The length of the decoded name.
+   * @param value
+   *            The decoded value or null.
+   * @param valueLength
+   *            The length of the decoded value.
+   * @return False if there are no more parameters.
+   * @throws std::runtime_error
+   *            If the entity can't be read or exceeds the limits.
+   */
+  bool readNext(const char*& name, size_t& nameLength, const char*& value,
+                size_t& valueLength) throw (std::runtime_error);
+
+  /**
+   * Reads the next parameter.
+   *
+   * @return The next parameter or null if there are no more parameters.
+   * @throws std::runtime_error
+   *            If the entity can't be read or exceeds the limits.
+   */
+  Parameter readNextParameter() throw (std::runtime_error);
+
+  /**
+   * URL-decodes a buffer in place, "+" being decoded as a space.
+   *
+   * @param data
+   *            The buffer to decode.
+   * @param length
+   *            The length of the encoded data.
+   * @return The length of the decoded data.
+   */
+  static size_t decode(char* data, size_t length);
+
+ private:
+
+  /**
+   * Fills the chunk buffer from the entity stream.
+   *
+   * @return False if the end of the stream is reached.
+   */
+  bool fill() throw (std::runtime_error);
+
+  /**
+   * Initializes the reader, shared by the constructors.
+   *
+   * @param representation
+   *            The web form entity.
+   * @param maxParameters
+   *            The maximum number of parameters, or -1 for no limit.
+   * @param maxParameterSize
+   *            The maximum size of an encoded parameter, or -1 for no limit.
+   */
+  void initialize(Representation representation, int maxParameters,
+                  int maxParameterSize);
+
+  /** The entity stream. */
+  InputStream stream;
+
+  /** The maximum number of parameters. */
+  int maxParameters;
+
+  /** The maximum size of an encoded parameter. */
+  int maxParameterSize;
+
+  /** The number of parameters read. */
+  int count;
+
+  /** Indicates if the end of the stream was reached. */
+  bool finished;
+
+  /** The chunk read from the stream. */
+  std::vector<char> chunk;
+
+  /** The position of the next byte to consume in the chunk. */
+  size_t chunkPosition;
+
+  /** The number of bytes available in the chunk. */
+  size_t chunkLength;
+
+  /** The parameter being read. */
+  std::vector<char> parameter;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_FORM_READER_H_
@@ -0,0 +1,116 @@
+#ifndef _ECHO_ENGINE_UTIL_INTERN_TABLE_H_
+#define _ECHO_ENGINE_UTIL_INTERN_TABLE_H_
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include <string>
+#include <tr1/unordered_map>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Bounded table interning values by name, so that values created for unknown
+ * names, such as custom methods or languages, are reused instead of being
+ * created again on every lookup. Once the table is full, new names are no
+ * longer interned, which bounds the memory a client can make the table use by
+ * sending random names.<br>
+ * <br>
+ * Concurrency note: instances of this class are thread-safe. Lookups of
+ * interned names only take a shared lock.
+ *
+ * @param <T>
+ *            The type of the values.
+ */
+template <typename T>
+class InternTable {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param capacity
+   *            The maximum number of interned values.
+   */
+  InternTable(size_t capacity) : capacity(capacity) {
+    pthread_rwlock_init(&lock, NULL);
+  }
+
+  /**
+   * Destructor.
+   */
+  ~InternTable() {
+    pthread_rwlock_destroy(&lock);
+  }
+
+  /**
+   * Returns the interned value of a name.
+   *
+   * @param name
+   *            The name, compared exactly.
+   * @param value
+   *            Set to the interned value.
+   * @return True if the name is interned.
+   */
+  bool get(const std::string& name, T& value) {
+    pthread_rwlock_rdlock(&lock);
+    const typename ValueMap::const_iterator it = values.find(name);
+    const bool result = (it != values.end());
+
+    if (result) {
+      value = it->second;
+    }
+
+    pthread_rwlock_unlock(&lock);
+    return result;
+  }
+
+  /**
+   * Interns a value unless the name is already interned or the table is full.
+   *
+   * @param name
+   *            The name, compared exactly.
+   * @param value
+   *            The value to intern.
+   * @return The interned value, which is the given value unless another
+   *         thread interned the name first.
+   */
+  T put(const std::string& name, const T& value) {
+    T result = value;
+    pthread_rwlock_wrlock(&lock);
+    const typename ValueMap::const_iterator it = values.find(name);
+
+    if (it != values.end()) {
+      result = it->second;
+    } else if (values.size() < capacity) {
+      values.insert(std::make_pair(name, value));
+    }
+
+    pthread_rwlock_unlock(&lock);
+    return result;
+  }
+
+ private:
+
+  /** Map of the interned values. */
+  typedef std::tr1::unordered_map<std::string, T> ValueMap;
+
+  /** The lock guarding the values. */
+  pthread_rwlock_t lock;
+
+  /** The interned values by name. */
+  ValueMap values;
+
+  /** The maximum number of interned values. */
+  const size_t capacity;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_INTERN_TABLE_H_
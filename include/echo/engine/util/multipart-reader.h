@@ -0,0 +1,362 @@
+#ifndef _ECHO_ENGINE_UTIL_MULTIPART_READER_H_
+#define _ECHO_ENGINE_UTIL_MULTIPART_READER_H_
+
+#include <stddef.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <echo/data/media-type.h>
+#include <echo/representation/file-representation.h>
+#include <echo/representation/representation.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Incremental reader of "multipart/form-data" entities. The entity stream is
+ * read in chunks and scanned for the boundary delimiters, using memchr() to
+ * skip to the candidate positions. The memory used is bounded by the chunk
+ * size and the in-memory threshold, whatever the size of the upload:
+ * <ul>
+ * <li>parts smaller than the threshold are kept in memory and exposed as
+ * views on the reader buffer, valid until the next part is read;</li>
+ * <li>larger parts are written to a temporary file as they are read and
+ * exposed as an auto-deleting {@link FileRepresentation}. The file is
+ * deleted with the part or when the next part is read, unless it was handed
+ * over.</li>
+ * </ul>
+ *
+ * @see echo::data::MediaType#MULTIPART_FORM_DATA
+ */
+class MultipartReader {
+
+ public:
+
+  /**
+   * Part of a multipart entity.
+   */
+  class Part {
+
+   public:
+
+    /**
+     * Constructor.
+     */
+    Part() : data(NULL), size(0), released(false) {
+    }
+
+    /**
+     * Destructor. Deletes the temporary file unless it was handed over.
+     */
+    ~Part() {
+      clear();
+    }
+
+    /**
+     * Returns the in-memory content, or null if the content was written to a
+     * file. The view is valid until the next part is read.
+     *
+     * @return The in-memory content.
+     */
+    const char* getData() const {
+      return data;
+    }
+
+    /**
+     * Returns the content as a representation. In-memory parts are copied in
+     * a new representation, file parts hand their temporary file over to an
+     * auto-deleting file representation.
+     *
+     * @return The content as a representation.
+     */
+    Representation getEntity() const;
+
+    /**
+     * Returns the file name of the "Content-Disposition" header.
+     *
+     * @return The file name or empty if the part isn't a file upload.
+     */
+    const std::string& getFileName() const {
+      return fileName;
+    }
+
+    /**
+     * Returns the path of the temporary file holding the content. The file
+     * is owned by the part, unless handed over with {@link #getEntity()} or
+     * {@link #releaseFile()}.
+     *
+     * @return The path of the temporary file or empty for in-memory parts.
+     */
+    const std::string& getFilePath() const {
+      return filePath;
+    }
+
+    /**
+     * Returns the value of the "Content-Type" header.
+     *
+     * @return The media type name or empty if not specified.
+     */
+    const std::string& getMediaType() const {
+      return mediaType;
+    }
+
+    /**
+     * Returns the name of the form field.
+     *
+     * @return The name of the form field.
+     */
+    const std::string& getName() const {
+      return name;
+    }
+
+    /**
+     * Returns the size of the content.
+     *
+     * @return The size of the content.
+     */
+    size_t getSize() const {
+      return size;
+    }
+
+    /**
+     * Indicates if the content is held in memory.
+     *
+     * @return True if the content is held in memory.
+     */
+    bool isInMemory() const {
+      return filePath.empty();
+    }
+
+    /**
+     * Hands the temporary file over to the caller, who becomes responsible
+     * for deleting it.
+     *
+     * @return The path of the temporary file or empty for in-memory parts.
+     */
+    const std::string& releaseFile() {
+      released = true;
+      return filePath;
+    }
+
+   private:
+
+    friend class MultipartReader;
+
+    /**
+     * Resets the part, deleting the temporary file unless it was handed
+     * over.
+     */
+    void clear();
+
+    /**
+     * Non copyable.
+     */
+    Part(const Part&);
+
+    /**
+     * Non copyable.
+     */
+    Part& operator=(const Part&);
+
+    /** The in-memory content. */
+    const char* data;
+
+    /** The size of the content. */
+    size_t size;
+
+    /** The name of the form field. */
+    std::string name;
+
+    /** The file name of the upload. */
+    std::string fileName;
+
+    /** The media type name. */
+    std::string mediaType;
+
+    /** The path of the temporary file. */
+    std::string filePath;
+
+    /** Indicates if the temporary file was handed over. */
+    mutable bool released;
+
+  };
+
+  /** The default size above which parts are written to a file. */
+  static const int DEFAULT_MEMORY_THRESHOLD;
+
+  /** The default maximum number of parts. */
+  static const int DEFAULT_MAX_PARTS;
+
+  /** The maximum size of the headers of a part. */
+  static const int MAX_HEADERS_SIZE;
+
+  /** The size of the chunks read from the entity stream. */
+  static const int BUFFER_SIZE;
+
+  /**
+   * Returns the boundary parameter of a multipart media type.
+   *
+   * @param mediaType
+   *            The multipart media type.
+   * @return The boundary or empty if not found.
+   */
+  static std::string getBoundary(MediaType mediaType);
+
+  /**
+   * Constructor using the default limits and the "/tmp" directory. The
+   * boundary is read from the media type of the entity.
+   *
+   * @param entity
+   *            The multipart entity.
+   */
+  MultipartReader(Representation entity);
+
+  /**
+   * Constructor.
+   *
+   * @param entity
+   *            The multipart entity.
+   * @param boundary
+   *            The boundary separating the parts.
+   * @param memoryThreshold
+   *            The size above which parts are written to a file.
+   * @param maxParts
+   *            The maximum number of parts, or -1 for no limit.
+   * @param directory
+   *            The directory of the temporary files.
+   */
+  MultipartReader(Representation entity, std::string boundary,
+                  int memoryThreshold, int maxParts, std::string directory);
+
+  /**
+   * Destructor. Closes the entity stream.
+   */
+  ~MultipartReader();
+
+  /**
+   * Reads the next part.
+   *
+   * @param part
+   *            The part to update.
+   * @return False if there are no more parts.
+   * @throws std::runtime_error
+   *            If the entity is malformed, exceeds the limits or a temporary
+   *            file can't be written.
+   */
+  bool readNextPart(Part& part) throw (std::runtime_error);
+
+ private:
+
+  /**
+   * Finds the next delimiter in the buffered data.
+   *
+   * @param partial
+   *            Set to the position of a delimiter prefix ending the buffered
+   *            data, when no complete delimiter is found.
+   * @return The position of the delimiter or -1.
+   */
+  long findDelimiter(size_t& partial);
+
+  /**
+   * Reads more data from the stream, keeping the unconsumed data.
+   *
+   * @return False if the end of the stream is reached.
+   */
+  bool fill() throw (std::runtime_error);
+
+  /**
+   * Initializes the reader, shared by the constructors.
+   *
+   * @param entity
+   *            The multipart entity.
+   * @param boundary
+   *            The boundary separating the parts.
+   * @param memoryThreshold
+   *            The size above which parts are written to a file.
+   * @param maxParts
+   *            The maximum number of parts, or -1 for no limit.
+   * @param directory
+   *            The directory of the temporary files.
+   */
+  void initialize(Representation entity, std::string boundary,
+                  int memoryThreshold, int maxParts, std::string directory);
+
+  /**
+   * Ensures a number of bytes are buffered.
+   *
+   * @param count
+   *            The number of bytes needed.
+   * @return False if the stream ends before.
+   */
+  bool require(size_t count) throw (std::runtime_error);
+
+  /**
+   * Appends content to the current part, in memory or in its file.
+   *
+   * @param part
+   *            The current part.
+   * @param data
+   *            The content to append.
+   * @param length
+   *            The length of the content.
+   */
+  void append(Part& part, const char* data, size_t length)
+      throw (std::runtime_error);
+
+  /**
+   * Reads and parses the headers of a part.
+   *
+   * @param part
+   *            The part to update.
+   */
+  void readHeaders(Part& part) throw (std::runtime_error);
+
+  /** The entity stream. */
+  InputStream stream;
+
+  /** The delimiter, CRLF followed by two dashes and the boundary. */
+  std::string delimiter;
+
+  /** The size above which parts are written to a file. */
+  size_t memoryThreshold;
+
+  /** The maximum number of parts. */
+  int maxParts;
+
+  /** The directory of the temporary files. */
+  std::string directory;
+
+  /** The number of parts read. */
+  int count;
+
+  /** Indicates if the closing delimiter was read. */
+  bool closed;
+
+  /** Indicates if the end of the stream was reached. */
+  bool finished;
+
+  /** The buffered data. */
+  std::vector<char> buffer;
+
+  /** The position of the first unconsumed byte. */
+  size_t start;
+
+  /** The position after the last buffered byte. */
+  size_t end;
+
+  /** The content of the current in-memory part. */
+  std::vector<char> memory;
+
+  /** The descriptor of the file of the current part, or -1. */
+  int file;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_MULTIPART_READER_H_
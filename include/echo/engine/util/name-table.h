@@ -0,0 +1,200 @@
+#ifndef _ECHO_ENGINE_UTIL_NAME_TABLE_H_
+#define _ECHO_ENGINE_UTIL_NAME_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <strings.h>
+
+#include <string>
+#include <vector>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Case-insensitive perfect hash table of well-known names. The names are
+ * added once, then {@link #build()} searches a hash seed mapping each of them
+ * to a distinct slot. A lookup then costs one hash of the name and at most one
+ * case-insensitive comparison, whatever the number of names, instead of a
+ * chain of comparisons.<br>
+ * <br>
+ * Concurrency note: a built table is immutable and can be shared by several
+ * threads.
+ *
+ * @param <T>
+ *            The type of the values, referenced and not copied.
+ */
+template <typename T>
+class NameTable {
+
+ public:
+
+  /**
+   * Constructor.
+   */
+  NameTable() : seed(0), mask(0) {
+  }
+
+  /**
+   * Adds a name, before the table is built. A name already added, ignoring
+   * case, is rejected since no seed could ever separate the two.
+   *
+   * @param name
+   *            The name.
+   * @param value
+   *            The value, which must outlive the table.
+   * @return True if the name was added, false if it was a duplicate.
+   */
+  bool add(const std::string& name, const T* value) {
+    for (size_t i = 0; i < names.size(); i++) {
+      if ((names[i].size() == name.size())
+          && (strncasecmp(names[i].data(), name.data(), name.size()) == 0)) {
+        return false;
+      }
+    }
+
+    names.push_back(name);
+    values.push_back(value);
+    return true;
+  }
+
+  /**
+   * Builds the table, searching a seed without collisions. The table grows
+   * until such a seed is found, which always happens since the names are
+   * distinct ignoring case.
+   */
+  void build() {
+    size_t size = 1;
+
+    while (size < 2 * names.size()) {
+      size <<= 1;
+    }
+
+    for (;; size <<= 1) {
+      for (uint32_t candidate = 1; candidate <= MAX_SEEDS; candidate++) {
+        if (tryBuild(candidate, size)) {
+          return;
+        }
+      }
+    }
+  }
+
+  /**
+   * Finds the value of a name, ignoring case.
+   *
+   * @param name
+   *            The name to look up.
+   * @return The value or null if the name isn't known.
+   */
+  const T* find(const std::string& name) const {
+    if (slots.empty()) {
+      return NULL;
+    }
+
+    const Slot& slot = slots[hash(name.data(), name.size(), seed) & mask];
+
+    if ((slot.value != NULL) && (slot.name.size() == name.size())
+        && (strncasecmp(slot.name.data(), name.data(), name.size()) == 0)) {
+      return slot.value;
+    }
+
+    return NULL;
+  }
+
+  /**
+   * Hashes a name, ignoring the case of ASCII letters.
+   *
+   * @param name
+   *            The name to hash.
+   * @param length
+   *            The length of the name.
+   * @param seed
+   *            The seed of the hash.
+   * @return The hash code.
+   */
+  static uint32_t hash(const char* name, size_t length, uint32_t seed) {
+    uint32_t result = 2166136261u ^ (seed * 0x9e3779b9u);
+
+    for (size_t i = 0; i < length; i++) {
+      const unsigned char c = name[i];
+      result = (result ^ (((c >= 'A') && (c <= 'Z')) ? c + 32 : c))
+               * 16777619u;
+    }
+
+    return result ^ (result >> 15);
+  }
+
+ private:
+
+  /** The maximum number of seeds tried for a given size. */
+  static const uint32_t MAX_SEEDS = 4096;
+
+  /**
+   * Slot of the table.
+   */
+  struct Slot {
+
+    Slot() : value(NULL) {
+    }
+
+    /** The name. */
+    std::string name;
+
+    /** The value, null for empty slots. */
+    const T* value;
+
+  };
+
+  /**
+   * Tries to place all the names with a given seed and size.
+   *
+   * @param candidate
+   *            The seed to try.
+   * @param size
+   *            The number of slots, a power of two.
+   * @return True if there was no collision.
+   */
+  bool tryBuild(uint32_t candidate, size_t size) {
+    std::vector<Slot> result(size);
+
+    for (size_t i = 0; i < names.size(); i++) {
+      Slot& slot = result[hash(names[i].data(), names[i].size(), candidate)
+                          & (size - 1)];
+
+      if (slot.value != NULL) {
+        return false;
+      }
+
+      slot.name = names[i];
+      slot.value = values[i];
+    }
+
+    slots.swap(result);
+    seed = candidate;
+    mask = size - 1;
+    return true;
+  }
+
+  /** The names added. */
+  std::vector<std::string> names;
+
+  /** The values added. */
+  std::vector<const T*> values;
+
+  /** The slots of the built table. */
+  std::vector<Slot> slots;
+
+  /** The seed of the built table. */
+  uint32_t seed;
+
+  /** The mask turning a hash code into a slot index. */
+  size_t mask;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_NAME_TABLE_H_
@@ -0,0 +1,193 @@
+#ifndef _ECHO_ENGINE_UTIL_PATTERN_H_
+#define _ECHO_ENGINE_UTIL_PATTERN_H_
+
+#include <regex.h>
+
+#include <bitset>
+#include <string>
+#include <vector>
+#include <tr1/memory>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Regular expression compiled once and matched against whole values, like the
+ * Java Pattern.matches() method used by the validation of attributes.<br>
+ * <br>
+ * Compiling a pattern selects the cheapest matcher able to run it:
+ * <ul>
+ * <li>a table-driven scanner for sequences of character classes where only
+ * the last one has a variable length, which covers the common formats such as
+ * digits ("\d+"), identifiers ("[a-zA-Z0-9]{1,32}"), UUIDs or length bounds
+ * (".{0,255}");</li>
+ * <li>a Thompson automaton running in time linear with the value length for
+ * the other patterns using literals, classes, groups, alternations and
+ * quantifiers;</li>
+ * <li>the POSIX extended regular expressions of the C library for the
+ * supported syntax whose automaton would be too large, such as long bounded
+ * repetitions.</li>
+ * </ul>
+ * The other syntax, such as possessive quantifiers, POSIX bracket classes
+ * ("[[:alpha:]]"), "{,n}" bounds or escapes of a letter or a digit handed to
+ * POSIX ("\b", "\x41", "\Q"), is invalid rather than misread.
+ * Concurrency note: a compiled pattern is immutable and can be shared by
+ * several threads. Copies share the compiled program.
+ */
+class Pattern {
+
+ public:
+
+  /** Kind of matcher selected for a pattern that couldn't be compiled. */
+  static const int KIND_INVALID;
+
+  /** Kind of matcher selected for table-driven scanning. */
+  static const int KIND_SCANNER;
+
+  /** Kind of matcher selected for the linear-time automaton. */
+  static const int KIND_AUTOMATON;
+
+  /** Kind of matcher selected for POSIX regular expressions. */
+  static const int KIND_POSIX;
+
+  /**
+   * Compiles a regular expression.
+   *
+   * @param regex
+   *            The regular expression to compile.
+   * @return The compiled pattern.
+   */
+  static Pattern compile(const std::string& regex) {
+    return Pattern(regex);
+  }
+
+  /**
+   * Constructor. Creates an invalid pattern matching nothing.
+   */
+  Pattern();
+
+  /**
+   * Constructor.
+   *
+   * @param regex
+   *            The regular expression to compile.
+   */
+  explicit Pattern(const std::string& regex);
+
+  /**
+   * Returns the kind of matcher selected when compiling.
+   *
+   * @return The kind of matcher selected when compiling.
+   */
+  int getKind() const;
+
+  /**
+   * Returns the source regular expression.
+   *
+   * @return The source regular expression.
+   */
+  std::string getPattern() const;
+
+  /**
+   * Indicates if the regular expression could be compiled.
+   *
+   * @return True if the regular expression could be compiled.
+   */
+  bool isValid() const {
+    return getKind() != KIND_INVALID;
+  }
+
+  /**
+   * Indicates if a whole value matches the pattern. An invalid pattern
+   * matches nothing.
+   *
+   * @param value
+   *            The value to test.
+   * @return True if the whole value matches.
+   */
+  bool matches(const std::string& value) const;
+
+ private:
+
+  /** Set of bytes. */
+  typedef std::bitset<256> CharSet;
+
+  /** Fixed or variable length run of bytes of the same set. */
+  struct Segment {
+    /** Index of the set of accepted bytes. */
+    int set;
+
+    /** The minimum number of bytes. */
+    int min;
+
+    /** The maximum number of bytes, or -1 for no bound. */
+    int max;
+  };
+
+  /** Automaton instruction. */
+  struct Instruction {
+    /** The operation code. */
+    int op;
+
+    /** The set index or the first branch. */
+    int x;
+
+    /** The second branch. */
+    int y;
+  };
+
+  /** Compiled program shared by the copies of a pattern. */
+  struct Program {
+    /** Destructor. */
+    ~Program();
+
+    /** The source regular expression. */
+    std::string source;
+
+    /** The kind of matcher. */
+    int kind;
+
+    /** The byte sets referenced by the segments and instructions. */
+    std::vector<CharSet> sets;
+
+    /** The segments of the scanner. */
+    std::vector<Segment> segments;
+
+    /** The instructions of the automaton. */
+    std::vector<Instruction> instructions;
+
+    /** The POSIX regular expression. */
+    regex_t posix;
+  };
+
+  class Parser;
+
+  /**
+   * Runs the table-driven scanner.
+   *
+   * @param value
+   *            The value to test.
+   * @return True if the whole value matches.
+   */
+  bool scan(const std::string& value) const;
+
+  /**
+   * Runs the automaton.
+   *
+   * @param value
+   *            The value to test.
+   * @return True if the whole value matches.
+   */
+  bool run(const std::string& value) const;
+
+  /** The compiled program. */
+  std::tr1::shared_ptr<const Program> program;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_PATTERN_H_
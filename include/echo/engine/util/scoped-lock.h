@@ -0,0 +1,46 @@
+#ifndef _ECHO_ENGINE_UTIL_SCOPED_LOCK_H_
+#define _ECHO_ENGINE_UTIL_SCOPED_LOCK_H_
+
+#include <pthread.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Locks a mutex for the scope of a block, so that every return path releases
+ * it.
+ */
+class ScopedLock {
+
+ public:
+
+  /**
+   * Constructor locking the mutex.
+   *
+   * @param lock
+   *            The mutex to lock.
+   */
+  ScopedLock(pthread_mutex_t* lock) : lock(lock) {
+    pthread_mutex_lock(lock);
+  }
+
+  /**
+   * Destructor unlocking the mutex.
+   */
+  ~ScopedLock() {
+    pthread_mutex_unlock(lock);
+  }
+
+ private:
+
+  /** The locked mutex. */
+  pthread_mutex_t* lock;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_SCOPED_LOCK_H_
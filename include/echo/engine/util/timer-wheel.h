@@ -0,0 +1,152 @@
+#ifndef _ECHO_ENGINE_UTIL_TIMER_WHEEL_H_
+#define _ECHO_ENGINE_UTIL_TIMER_WHEEL_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Hashed timing wheel scheduling deadlines with a constant cost, whatever the
+ * number of timers. Timers are intrusive nodes hashed by their deadline tick
+ * into a ring of slots; advancing the wheel only visits the slots of the
+ * elapsed ticks. Timers scheduled more than one revolution ahead stay in their
+ * slot until their deadline is actually reached.<br>
+ * <br>
+ * Concurrency note: instances of this class aren't thread-safe, the owner is
+ * expected to guard them.
+ */
+class TimerWheel {
+
+ public:
+
+  /**
+   * Timer scheduled in a wheel. Classes needing deadlines extend it.
+   */
+  class Timer {
+
+   public:
+
+    /**
+     * Constructor.
+     */
+    Timer() : previous(NULL), next(NULL), deadline(0) {
+    }
+
+    /**
+     * Returns the deadline in milliseconds.
+     *
+     * @return The deadline in milliseconds.
+     */
+    long long getDeadline() const {
+      return deadline;
+    }
+
+    /**
+     * Indicates if the timer is scheduled.
+     *
+     * @return True if the timer is scheduled.
+     */
+    bool isScheduled() const {
+      return previous != NULL;
+    }
+
+   private:
+
+    friend class TimerWheel;
+
+    /** The previous timer in the slot. */
+    Timer* previous;
+
+    /** The next timer in the slot. */
+    Timer* next;
+
+    /** The deadline in milliseconds. */
+    long long deadline;
+
+  };
+
+  /**
+   * Returns the current time of the monotonic clock in milliseconds.
+   *
+   * @return The current time in milliseconds.
+   */
+  static long long currentTimeMillis();
+
+  /**
+   * Constructor.
+   *
+   * @param slots
+   *            The number of slots, rounded up to a power of two.
+   * @param tick
+   *            The duration of a tick in milliseconds.
+   * @param now
+   *            The current time in milliseconds.
+   */
+  TimerWheel(int slots, long long tick, long long now);
+
+  /**
+   * Advances the wheel, collecting the expired timers. They are unscheduled
+   * before being returned.
+   *
+   * @param now
+   *            The current time in milliseconds.
+   * @param expired
+   *            The list to update with the expired timers.
+   */
+  void advance(long long now, std::vector<Timer*>& expired);
+
+  /**
+   * Unschedules a timer. Does nothing if the timer isn't scheduled.
+   *
+   * @param timer
+   *            The timer to unschedule.
+   */
+  void cancel(Timer* timer);
+
+  /**
+   * Returns the number of scheduled timers.
+   *
+   * @return The number of scheduled timers.
+   */
+  size_t getSize() const {
+    return size;
+  }
+
+  /**
+   * Schedules or reschedules a timer.
+   *
+   * @param timer
+   *            The timer to schedule.
+   * @param deadline
+   *            The deadline in milliseconds.
+   */
+  void schedule(Timer* timer, long long deadline);
+
+ private:
+
+  /** The slot heads, each one the sentinel of a circular list. */
+  std::vector<Timer> slots;
+
+  /** The mask turning a tick into a slot index. */
+  long long mask;
+
+  /** The duration of a tick in milliseconds. */
+  long long tick;
+
+  /** The last tick processed. */
+  long long current;
+
+  /** The number of scheduled timers. */
+  size_t size;
+
+};
+
+} // namespace util
+} // namespace engine
+} // namespace echo
+
+#endif // _ECHO_ENGINE_UTIL_TIMER_WHEEL_H_
@@ -57,6 +57,7 @@ namespace echo {
 	  date = NULL;
 	  this->entity = entity;
 	  entityForm = NULL;
+	  entityFormInvalid = false;
 	  entityText = NULL;
 	  onContinue = NULL;
 	  onSent = NULL;
@@ -139,10 +140,16 @@ namespace echo {
 
 	/**
 	 * Returns the entity as a form. This method can be called several times and
-	 * will always return the same form instance. Note that if the entity is
-	 * large this method can result in important memory consumption.
+	 * will always return the same form instance, until the entity is replaced.
+	 * Note that if the entity is large this method can result in important
+	 * memory consumption.<br>
+	 * <br>
+	 * An entity which can't be read or exceeds the limits of the
+	 * {@link FormReader} is only read once: this method then keeps returning
+	 * null until the entity is replaced, so that the caller can reject the
+	 * request instead of handling an empty form.
 	 * 
-	 * @return The entity as a form.
+	 * @return The entity as a form, or null if it isn't a valid form.
 	 */
 	Form getEntityAsForm();
 
@@ -248,6 +255,11 @@ namespace echo {
 	 */
 	void setEntity(Representation entity) {
 	  this->entity = entity;
+
+	  // The cached form and text belong to the previous entity
+	  this->entityForm = NULL;
+	  this->entityFormInvalid = false;
+	  this->entityText = NULL;
 	}
 
 	/**
@@ -306,6 +318,9 @@ namespace echo {
 	/** The optional cached Form. */
 	volatile Form entityForm;
 
+	/** Indicates if the entity failed to be parsed as a form. */
+	volatile bool entityFormInvalid;
+
 	/** The optional cached text. */
 	volatile std::string entityText;
 
@@ -4,15 +4,32 @@
 //import java.io.IOException;
 
 #include <string>
+#include <tr1/memory>
 #include <echo/data/character-set.h>
 #include <echo/data/language.h>
 #include <echo/data/media-type.h>
+#include <echo/engine/util/chunk-buffer.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/util/chunk-stream.h>
 
 namespace echo {
 namespace representation {
 
 /**
- * Represents an appendable sequence of characters.
+ * Represents an appendable sequence of characters. The text is kept in a chain
+ * of pooled chunks, so that large generated pages are never reallocated while
+ * growing, and connectors can write the chunks with writev() without building
+ * a contiguous copy.<br>
+ * <br>
+ * In streaming mode, enabled by {@link #startStreaming(size_t, bool)} before
+ * the page is generated, each chunk is handed to the connector through a
+ * {@link ChunkStream} owned by the representation as soon as it is filled,
+ * so that the client receives the beginning of the page while the rest is
+ * generated; {@link #finish()} then hands the last chunk and ends the
+ * entity. The stream's high-water mark holds back the appending thread when
+ * the client is slow, except on the thread of an event loop which can't
+ * wait for itself to drain the stream: there, the producer checks
+ * {@link #isWritable()} to yield instead.
  * 
  * @author Jerome Louvel
  */
@@ -28,7 +45,8 @@ class AppendableRepresentation : public StringRepresentation {
    * 
    */
   AppendableRepresentation() {
-    AppendableRepresentation(NULL);
+    StringRepresentation(NULL);
+    initialize(NULL);
   }
 
   /**
@@ -40,6 +58,7 @@ class AppendableRepresentation : public StringRepresentation {
    */
   AppendableRepresentation(CharSequence text) {
     StringRepresentation(text);
+    initialize(text);
   }
 
   /**
@@ -53,6 +72,7 @@ class AppendableRepresentation : public StringRepresentation {
    */
   AppendableRepresentation(CharSequence text, Language language) {
     StringRepresentation(text, language);
+    initialize(text);
   }
 
   /**
@@ -66,6 +86,7 @@ class AppendableRepresentation : public StringRepresentation {
    */
   AppendableRepresentation(CharSequence text, MediaType mediaType) {
     StringRepresentation(text, mediaType);
+    initialize(text);
   }
 
   /**
@@ -82,6 +103,7 @@ class AppendableRepresentation : public StringRepresentation {
   AppendableRepresentation(CharSequence text, MediaType mediaType,
                            Language language) {
     StringRepresentation(text, mediaType, language);
+    initialize(text);
   }
 
   /**
@@ -99,6 +121,7 @@ class AppendableRepresentation : public StringRepresentation {
   AppendableRepresentation(CharSequence text, MediaType mediaType,
                            Language language, CharacterSet characterSet) {
     StringRepresentation(text, mediaType, language, characterSet);
+    initialize(text);
   }
 
   Appendable append(char c) throws IOException;
@@ -108,12 +131,92 @@ class AppendableRepresentation : public StringRepresentation {
   Appendable append(CharSequence csq, int start, int end)
       throws IOException ;
 
+  /**
+   * Hands the partially filled chunk to the connector in streaming mode, for
+   * example before a long computation.
+   */
+  void flush() throws IOException;
+
+  /**
+   * Ends the streamed entity, handing the partially filled chunk to the
+   * connector and closing the stream. Does nothing if not streaming.
+   */
+  void finish() throws IOException;
+
+  /**
+   * Returns the chunks of the appended text, to be written without copying.
+   * 
+   * @return The chunks of the appended text.
+   */
+  const echo::engine::util::ChunkBuffer& getChunks() {
+    return this->appendableText;
+  }
+
   //@Override
-  std::string getText() {
-    return (this->appendableText == NULL) ? NULL : this->appendableText
-        .toString();
+  long getSize() {
+    // The size of a streamed text is only known once it is complete
+    return (this->textAvailable && !this->stream)
+        ? this->appendableText.getSize() : UNKNOWN_SIZE;
+  }
+
+  /**
+   * Returns the stream receiving the filled chunks in streaming mode.
+   * 
+   * @return The stream or null if not streaming.
+   */
+  echo::engine::util::ChunkStream* getStream() {
+    return this->stream.get();
   }
 
+  /**
+   * Returns a copy of the text appended so far.
+   * 
+   * @return The text, or an empty string if none was set or appended.
+   */
+  //@Override
+  std::string getText();
+
+  /**
+   * Indicates if text can be appended without exceeding the high-water mark
+   * of the stream. Producers of a non-blocking stream check it to yield.
+   * 
+   * @return True if text can be appended without exceeding the mark.
+   */
+  bool isWritable() {
+    return !this->stream || this->stream->isWritable();
+  }
+
+  /**
+   * Aborts the stream of an unfinished entity, so that a producer held back
+   * by the high-water mark stops generating it.
+   */
+  //@Override
+  void release();
+
+  /**
+   * Enables the streaming mode with the default high-water mark, blocking
+   * unless called on the thread of an event loop.
+   */
+  void startStreaming() throws IOException {
+    startStreaming(echo::engine::util::ChunkStream::DEFAULT_HIGH_WATER_MARK,
+                   true);
+  }
+
+  /**
+   * Enables the streaming mode, creating the stream receiving the filled
+   * chunks. To be called before the page is generated; the text appended so
+   * far is handed to the stream as well, and {@link #getText()} then only
+   * returns the text not yet handed.
+   * 
+   * @param highWaterMark
+   *            The number of queued bytes above which the producer is held
+   *            back.
+   * @param blocking
+   *            True to suspend the producer above the mark, ignored on the
+   *            thread of an event loop where the stream never blocks.
+   */
+  void startStreaming(size_t highWaterMark, bool blocking) throws IOException;
+
   //@Override
   void setText(CharSequence text);
 
@@ -121,7 +224,33 @@ class AppendableRepresentation : public StringRepresentation {
  private:
 
   /** The appendable text. */
-  volatile StringBuilder appendableText;
+  echo::engine::util::ChunkBuffer appendableText;
+
+  /**
+   * Initializes the state of the representation. Called by all the
+   * constructors.
+   * 
+   * @param text
+   *            The initial text or null.
+   */
+  void initialize(CharSequence text);
+
+  /**
+   * Hands the filled chunks to the stream in streaming mode.
+   * 
+   * @param all
+   *            True to hand the partially filled chunk as well.
+   */
+  void offer(bool all) throws IOException;
+
+  /** Indicates if a text was set or appended. */
+  bool textAvailable;
+
+  /**
+   * The stream receiving the filled chunks in streaming mode, shared with
+   * the copies of the representation.
+   */
+  std::tr1::shared_ptr<echo::engine::util::ChunkStream> stream;
 
 };
 
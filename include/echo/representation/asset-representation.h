@@ -0,0 +1,131 @@
+#ifndef _ECHO_REPRESENTATION_ASSET_REPRESENTATION_H_
+#define _ECHO_REPRESENTATION_ASSET_REPRESENTATION_H_
+
+/*
+  import java.io.ByteArrayInputStream;
+  import java.io.IOException;
+  import java.io.InputStream;
+  import java.io.OutputStream;
+  import java.nio.channels.Channels;
+  import java.nio.channels.ReadableByteChannel;
+  import java.nio.channels.WritableByteChannel;
+  import java.util.Date;
+*/
+
+#include <echo/data/local-reference.h>
+#include <echo/data/media-type.h>
+#include <echo/data/tag.h>
+#include <echo/engine/util/asset-pack.h>
+
+namespace echo {
+namespace representation {
+
+/**
+ * Representation of an asset of an {@link AssetPack}, as resolved from a
+ * "clap" or "zip" local reference. Its content is a slice of the pack, so
+ * writing it copies nothing, and its tag and modification date come from the
+ * pack index. The gzip variant precomputed in the pack is available through
+ * {@link #getGzipVariant()}.
+ */
+class AssetRepresentation : public Representation {
+
+ public:
+
+  /**
+   * Resolves a local reference to the representation of an asset.
+   *
+   * @param reference
+   *            The "clap", "zip" or "jar" reference.
+   * @return The representation or null if no asset matches.
+   */
+  static AssetRepresentation create(LocalReference reference) {
+    echo::engine::util::AssetPack::Asset asset;
+
+    if (!echo::engine::util::AssetPack::resolve(reference.toString(),
+                                                asset)) {
+      return NULL;
+    }
+
+    return new AssetRepresentation(asset, asset.content);
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param asset
+   *            The asset.
+   * @param content
+   *            The slice sent, either the content of the asset or its gzip
+   *            variant.
+   */
+  AssetRepresentation(echo::engine::util::AssetPack::Asset asset,
+                      echo::engine::util::AssetPack::Slice content) {
+    Representation(MediaType.valueOf(std::string(asset.mediaType.data,
+                                                 asset.mediaType.length)));
+    this->asset = asset;
+    this->content = content;
+    setSize(content.length);
+    setTag(new Tag(std::string(asset.tag.data, asset.tag.length), false));
+    setModificationDate(new Date(asset.modified * 1000L));
+  }
+
+  //@Override
+  ReadableByteChannel getChannel() throws IOException {
+    return Channels.newChannel(getStream());
+  }
+
+  /**
+   * Returns the slice of the pack sent.
+   *
+   * @return The slice of the pack sent.
+   */
+  echo::engine::util::AssetPack::Slice getContent() {
+    return this->content;
+  }
+
+  /**
+   * Returns the representation of the gzip variant precomputed in the pack.
+   * Its metadata, such as its encodings, are left to the caller.
+   *
+   * @return The representation of the gzip variant or null.
+   */
+  AssetRepresentation getGzipVariant() {
+    return (this->asset.gzip.length == 0) ? NULL
+           : new AssetRepresentation(this->asset, this->asset.gzip);
+  }
+
+  //@Override
+  InputStream getStream() throws IOException {
+    return new ByteArrayInputStream(this->content.data, 0,
+                                    this->content.length);
+  }
+
+  //@Override
+  String getText() throws IOException {
+    return std::string(this->content.data, this->content.length);
+  }
+
+  //@Override
+  void write(OutputStream outputStream) throws IOException {
+    outputStream.write(this->content.data, 0, this->content.length);
+  }
+
+  //@Override
+  void write(WritableByteChannel writableChannel) throws IOException {
+    write(Channels.newOutputStream(writableChannel));
+  }
+
+ private:
+
+  /** The asset. */
+  echo::engine::util::AssetPack::Asset asset;
+
+  /** The slice of the pack sent. */
+  echo::engine::util::AssetPack::Slice content;
+
+};
+
+} // namespace representation
+} // namespace echo
+
+#endif // _ECHO_REPRESENTATION_ASSET_REPRESENTATION_H_
@@ -11,6 +11,7 @@ import java.io.Writer;
 
 #include <echo/data/media-type.h>
 #include <echo/engine/io/byte-utils.h>
+#include <echo/engine/io/readable-source.h>
 
 namespace echo {
 namespace representation {
@@ -40,6 +41,17 @@ class ChannelRepresentation : public Representation {
     return ByteUtils.getReader(getStream(), getCharacterSet());
   }
 
+  /**
+   * Returns the non-blocking source of the content, which lets a connector
+   * move it with a transfer driven by its event loop instead of blocking
+   * copies. Returns null by default.
+   * 
+   * @return The non-blocking source or null.
+   */
+  virtual echo::engine::io::ReadableSource* getSource() {
+    return NULL;
+  }
+
   //@Override
   InputStream getStream() throws IOException {
     return ByteUtils.getStream(getChannel());
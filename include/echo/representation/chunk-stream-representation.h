@@ -0,0 +1,141 @@
+#ifndef _ECHO_REPRESENTATION_CHUNK_STREAM_REPRESENTATION_H_
+#define _ECHO_REPRESENTATION_CHUNK_STREAM_REPRESENTATION_H_
+
+/*
+  import java.io.IOException;
+  import java.io.OutputStream;
+  import java.nio.channels.Channels;
+  import java.nio.channels.ReadableByteChannel;
+  import java.nio.channels.WritableByteChannel;
+*/
+
+#include <sys/uio.h>
+
+#include <tr1/memory>
+
+#include <echo/data/media-type.h>
+#include <echo/engine/http/client-exchange.h>
+#include <echo/engine/util/chunk-stream.h>
+
+namespace echo {
+namespace representation {
+
+/**
+ * Transient representation of a response body received by the HTTP client
+ * connector. The content is read from the {@link ChunkStream} of the exchange
+ * while the connection receives it, so that a proxied body flows through
+ * without being buffered whole; the connection stops reading while the
+ * stream is above its high-water mark.
+ */
+class ChunkStreamRepresentation : public Representation {
+
+ public:
+
+  /**
+   * Constructor.
+   *
+   * @param mediaType
+   *            The media type.
+   * @param exchange
+   *            The exchange receiving the body.
+   */
+  ChunkStreamRepresentation(
+      MediaType mediaType,
+      std::tr1::shared_ptr<echo::engine::http::ClientExchange> exchange) {
+    Representation(mediaType);
+    setTransient(true);
+    this->exchange = exchange;
+  }
+
+  //@Override
+  ReadableByteChannel getChannel() throws IOException {
+    throw IOException("The content is only available as a chunk stream");
+  }
+
+  /**
+   * Returns the stream of the received chunks, to be written without
+   * copying.
+   *
+   * @return The stream of the received chunks.
+   */
+  echo::engine::util::ChunkStream& getChunkStream() {
+    return this->exchange->getBody();
+  }
+
+  //@Override
+  String getText() throws IOException {
+    std::string result;
+    echo::engine::util::ChunkStream& stream = getChunkStream();
+    struct iovec vectors[16];
+
+    while (!stream.isDone()) {
+      if (!stream.await(RECEIVE_TIMEOUT) || stream.isAborted()) {
+        throw IOException("The response body was interrupted");
+      }
+
+      const int count = stream.getVectors(vectors, 16);
+      size_t size = 0;
+
+      for (int i = 0; i < count; i++) {
+        result.append((const char*) vectors[i].iov_base, vectors[i].iov_len);
+        size += vectors[i].iov_len;
+      }
+
+      stream.consume(size);
+    }
+
+    return result;
+  }
+
+  //@Override
+  void release() {
+    // The connection can't be reused without the rest of the body
+    if (!getChunkStream().isDone()) {
+      getChunkStream().abort();
+    }
+
+    super.release();
+  }
+
+  //@Override
+  void write(OutputStream outputStream) throws IOException {
+    echo::engine::util::ChunkStream& stream = getChunkStream();
+    struct iovec vectors[16];
+
+    while (!stream.isDone()) {
+      if (!stream.await(RECEIVE_TIMEOUT) || stream.isAborted()) {
+        throw IOException("The response body was interrupted");
+      }
+
+      const int count = stream.getVectors(vectors, 16);
+      size_t size = 0;
+
+      for (int i = 0; i < count; i++) {
+        outputStream.write((const char*) vectors[i].iov_base, 0,
+                           vectors[i].iov_len);
+        size += vectors[i].iov_len;
+      }
+
+      stream.consume(size);
+    }
+  }
+
+  //@Override
+  void write(WritableByteChannel writableChannel) throws IOException {
+    write(Channels.newOutputStream(writableChannel));
+  }
+
+ private:
+
+  /** The maximum waiting time for the next chunk in milliseconds. */
+  static const int RECEIVE_TIMEOUT = 60000;
+
+  /** The exchange receiving the body. */
+  std::tr1::shared_ptr<echo::engine::http::ClientExchange> exchange;
+
+};
+
+} // namespace representation
+} // namespace echo
+
+#endif // _ECHO_REPRESENTATION_CHUNK_STREAM_REPRESENTATION_H_
@@ -18,6 +18,8 @@
 #include <echo/data/local-reference.h>
 #include <echo/data/media-type.h>
 #include <echo/engine/io/byte-utils.h>
+#include <echo/engine/io/file-source.h>
+#include <echo/engine/io/io-engine.h>
 
 namespace echo {
 namespace representation {
@@ -118,6 +120,19 @@ class FileRepresentation : public Representation {
   //@Override
   long getSize();
 
+  /**
+   * Returns a non-blocking source reading the file through an I/O engine, so
+   * that a cold file doesn't stall the calling thread on disk latency.
+   * 
+   * @param engine
+   *            The engine reading the file.
+   * @return A new non-blocking source.
+   */
+  echo::engine::io::ReadableSource* getSource(
+      echo::engine::io::IoEngine& engine) {
+    return new echo::engine::io::FileSource(engine, getFile().getPath());
+  }
+
   //@Override
   FileInputStream getStream() throws IOException;
 
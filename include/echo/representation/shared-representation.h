@@ -0,0 +1,95 @@
+#ifndef _ECHO_REPRESENTATION_SHARED_REPRESENTATION_H_
+#define _ECHO_REPRESENTATION_SHARED_REPRESENTATION_H_
+
+/*
+  import java.io.ByteArrayInputStream;
+  import java.io.IOException;
+  import java.io.InputStream;
+  import java.io.OutputStream;
+  import java.nio.channels.Channels;
+  import java.nio.channels.ReadableByteChannel;
+  import java.nio.channels.WritableByteChannel;
+*/
+
+#include <string>
+#include <tr1/memory>
+
+#include <echo/data/media-type.h>
+
+namespace echo {
+namespace representation {
+
+/**
+ * Representation whose content is an immutable buffer shared by reference
+ * counting, such as a body kept by the {@link EncodedCache}. Any number of
+ * responses can send the same buffer at the same time; the connectors write
+ * it from {@link #getContent()} without copying, and the buffer is freed
+ * once the cache and the last response let it go.
+ */
+class SharedRepresentation : public Representation {
+
+ public:
+
+  /** Shared reference to an immutable content. */
+  typedef std::tr1::shared_ptr<const std::string> Content;
+
+  /**
+   * Constructor.
+   *
+   * @param content
+   *            The shared content.
+   * @param mediaType
+   *            The media type.
+   */
+  SharedRepresentation(Content content, MediaType mediaType) {
+    Representation(mediaType);
+    this->content = content;
+    setSize(content->size());
+  }
+
+  //@Override
+  ReadableByteChannel getChannel() throws IOException {
+    return Channels.newChannel(getStream());
+  }
+
+  /**
+   * Returns the shared content, to be written without copying.
+   *
+   * @return The shared content.
+   */
+  const std::string& getContent() {
+    return *this->content;
+  }
+
+  //@Override
+  InputStream getStream() throws IOException {
+    return new ByteArrayInputStream(this->content->data(), 0,
+                                    this->content->size());
+  }
+
+  //@Override
+  String getText() throws IOException {
+    return *this->content;
+  }
+
+  //@Override
+  void write(OutputStream outputStream) throws IOException {
+    outputStream.write(this->content->data(), 0, this->content->size());
+  }
+
+  //@Override
+  void write(WritableByteChannel writableChannel) throws IOException {
+    write(Channels.newOutputStream(writableChannel));
+  }
+
+ private:
+
+  /** The shared content. */
+  Content content;
+
+};
+
+} // namespace representation
+} // namespace echo
+
+#endif // _ECHO_REPRESENTATION_SHARED_REPRESENTATION_H_
@@ -0,0 +1,98 @@
+#ifndef _ECHO_REPRESENTATION_SOURCE_REPRESENTATION_H_
+#define _ECHO_REPRESENTATION_SOURCE_REPRESENTATION_H_
+
+/*
+  import java.io.IOException;
+*/
+
+#include <echo/data/media-type.h>
+#include <echo/engine/io/readable-source.h>
+
+namespace echo {
+namespace representation {
+
+/**
+ * Transient representation whose content comes from a non-blocking
+ * {@link ReadableSource}, such as a proxied upstream body or a long-polling
+ * stream. Connectors move it with a transfer driven by their event loop;
+ * reading it as a blocking channel isn't supported.
+ */
+class SourceRepresentation : public ChannelRepresentation {
+
+ public:
+
+  /**
+   * Constructor.
+   * 
+   * @param mediaType
+   *            The media type.
+   * @param source
+   *            The non-blocking source of the content.
+   */
+  SourceRepresentation(MediaType mediaType,
+                       echo::engine::io::ReadableSource* source) {
+    SourceRepresentation(mediaType, source, false);
+  }
+
+  /**
+   * Constructor.
+   * 
+   * @param mediaType
+   *            The media type.
+   * @param source
+   *            The non-blocking source of the content.
+   * @param owned
+   *            True if the source is deleted once released.
+   */
+  SourceRepresentation(MediaType mediaType,
+                       echo::engine::io::ReadableSource* source, bool owned) {
+    ChannelRepresentation(mediaType);
+    setTransient(true);
+    this->source = source;
+    this->owned = owned;
+  }
+
+  //@Override
+  java.nio.channels.ReadableByteChannel getChannel() throws IOException {
+    throw IOException("The content is only available without blocking");
+  }
+
+  //@Override
+  echo::engine::io::ReadableSource* getSource() {
+    return this->source;
+  }
+
+  //@Override
+  void release() {
+    if (this->source != NULL) {
+      this->source->close();
+
+      if (this->owned) {
+        delete this->source;
+        this->source = NULL;
+      }
+    }
+
+    super.release();
+  }
+
+  //@Override
+  void write(java.nio.channels.WritableByteChannel writableChannel)
+      throws IOException {
+    throw IOException("The content is only available without blocking");
+  }
+
+ private:
+
+  /** The non-blocking source of the content. */
+  echo::engine::io::ReadableSource* source;
+
+  /** Indicates if the source is deleted once released. */
+  bool owned;
+
+};
+
+} // namespace representation
+} // namespace echo
+
+#endif // _ECHO_REPRESENTATION_SOURCE_REPRESENTATION_H_
@@ -8,10 +8,12 @@
 #include <echo/data/client-info.h>
 #include <echo/data/conditions.h>
 #include <echo/data/cookie.h>
+#include <echo/data/form.h>
 #include <echo/data/method.h>
 #include <echo/data/protocol.h>
 #include <echo/data/range.h>
 #include <echo/data/reference.h>
+#include <echo/engine/util/cookie-reader.h>
 #include <echo/engine/util/cookie-series.h>
 #include <echo/representation/representation.h>
 #include <echo/util/series.h>
@@ -123,15 +125,37 @@ namespace echo {
 
     /**
      * Returns the modifiable series of cookies provided by the client. Creates
-     * a new instance if no one has been set.<br>
+     * a new instance if no one has been set, filled from the raw "Cookie"
+     * header if available.<br>
      * <br>
      * Note that when used with HTTP connectors, this property maps to the
      * "Cookie" header.
      * 
      * @return The cookies provided by the client.
+     * @see #getCookieValue(std::string)
      */
     Series<Cookie> getCookies();
 
+    /**
+     * Returns the raw "Cookie" header value set by the server connector.
+     * 
+     * @return The raw "Cookie" header value or null.
+     */
+    std::string getCookieHeader() {
+	  return cookieHeader;
+    }
+
+    /**
+     * Returns the value of the first cookie with a given name. As long as the
+     * series of cookies isn't materialized, the raw "Cookie" header is scanned
+     * in place, which avoids creating the cookies that aren't needed.
+     * 
+     * @param name
+     *            The name of the cookie.
+     * @return The value of the cookie or null if not found.
+     */
+    std::string getCookieValue(std::string name);
+
     /**
      * Returns the host reference. This may be different from the resourceRef's
      * host, for example for URNs and other URIs that don't contain host
@@ -175,6 +199,16 @@ namespace echo {
      */
     Protocol getProtocol();
 
+    /**
+     * Returns the query component of the resource reference as a form. The
+     * form is parsed once and shared by all the routing layers extracting
+     * query parameters, until the query of the resource reference changes.
+     * 
+     * @return The query component of the resource reference as a form.
+     * @see Reference#getQueryAsForm()
+     */
+    Form getQueryAsForm();
+
     /**
      * Returns the authentication response sent by a client to a proxy. Note
      * that when used with HTTP connectors, this property maps to the
@@ -299,6 +333,16 @@ namespace echo {
      */
     void setCookies(Series<Cookie> cookies);
 
+    /**
+     * Sets the raw "Cookie" header value. The cookies are only parsed on
+     * demand, when requested by {@link #getCookies()} or
+     * {@link #getCookieValue(std::string)}.
+     * 
+     * @param cookieHeader
+     *            The raw "Cookie" header value.
+     */
+    void setCookieHeader(std::string cookieHeader);
+
     /**
      * Sets the host reference. Note that when used with HTTP connectors, this
      * property maps to the "Host" header.
@@ -416,6 +460,9 @@ namespace echo {
     /** The condition data. */
     volatile Conditions conditions;
 
+    /** The raw "Cookie" header value, parsed on demand. */
+    volatile std::string cookieHeader;
+
     /** The cookies provided by the client. */
     volatile Series<Cookie> cookies;
 
@@ -428,6 +475,12 @@ namespace echo {
     /** The original reference. */
     volatile Reference originalRef;
 
+    /** The optional cached query form. */
+    volatile Form queryForm;
+
+    /** The query string the cached query form was parsed from. */
+    volatile std::string queryFormSource;
+
     /** The ranges to return from the target resource's representation. */
     volatile std::list<Range> ranges;
 
@@ -1,6 +1,8 @@
 #ifndef _ECHO_ROUTING_FILTER_H_
 #define _ECHO_ROUTING_FILTER_H_
 
+#include <vector>
+
 #include <echo/context.h>
 #include <echo/request.h>
 #include <echo/response.h>
@@ -59,6 +61,7 @@ class Filter : public echo::Echo {
   Filter(Context context, echo::Echo next) {
     echo::Echo(context);
     this->next = next;
+    this->pipelined = false;
   }
 
   /**
@@ -93,6 +96,23 @@ class Filter : public echo::Echo {
     return getNext() != null;
   }
 
+  /**
+   * Indicates if the compiled pipeline mode is enabled. In this mode, the
+   * chain of filters starting at this filter is linearised when the filter is
+   * started, and calls run the beforeHandle() and afterHandle() methods of the
+   * chained filters in a loop instead of recursing through their handle()
+   * methods. The thread-local context is only updated when it actually
+   * changes from one filter to the next.<br>
+   * <br>
+   * Note that the chain is captured at start time, changing the next Echo of
+   * a chained filter requires the filter to be restarted.
+   * 
+   * @return True if the compiled pipeline mode is enabled.
+   */
+  bool isPipelined() {
+    return pipelined;
+  }
+
   /**
    * Sets the next Echo as a Finder for a given
    * {@link org.restlet.resource.Handler} or {@link ServerResource} class.
@@ -115,6 +135,17 @@ class Filter : public echo::Echo {
    */
   void setNext(echo::Echo next);
 
+  /**
+   * Enables or disables the compiled pipeline mode.
+   * 
+   * @param pipelined
+   *            True if the compiled pipeline mode is enabled.
+   * @see #isPipelined()
+   */
+  void setPipelined(bool pipelined) {
+    this->pipelined = pipelined;
+  }
+
   /**
    * Starts the filter and the next Echo if attached.
    */
@@ -172,6 +203,19 @@ class Filter : public echo::Echo {
    *         {@link #STOP}.
    */
   int doHandle(echo::Request request, echo::Response response);
+
+  /**
+   * Indicates if this filter can be linearised in a compiled pipeline. This
+   * is the case when the filter only customizes the beforeHandle() and
+   * afterHandle() methods. Subclasses overriding handle() or doHandle() must
+   * return false so that the pipeline stops before them and calls them
+   * normally.
+   * 
+   * @return True if the filter can be linearised.
+   */
+  virtual bool isLinearizable() {
+    return true;
+  }
   
 
  public:
@@ -199,9 +243,34 @@ class Filter : public echo::Echo {
   static const int STOP;
 
  private:
+  /**
+   * Linearises the chain of filters starting at this filter, up to the first
+   * Echo which isn't a linearizable filter.
+   */
+  void compilePipeline();
+
+  /**
+   * Handles a call by running the compiled pipeline.
+   * 
+   * @param request
+   *            The request to handle.
+   * @param response
+   *            The response to update.
+   */
+  void handlePipeline(echo::Request request, echo::Response response);
+
   /** The next Echo. */
   volatile echo::Echo next;
 
+  /** Indicates if the compiled pipeline mode is enabled. */
+  volatile bool pipelined;
+
+  /** The linearised chain of filters, starting with this filter. */
+  std::vector<Filter> pipeline;
+
+  /** The Echo invoked after the last filter of the pipeline. */
+  echo::Echo pipelineTail;
+
 };
 
 } // namespace routing
@@ -17,6 +17,7 @@
 #include <echo/data/form.h>
 #include <echo/data/reference.h>
 #include <echo/data/status.h>
+#include <echo/engine/util/pattern.h>
 #include <echo/util/series.h>
 #include <echo/util/logging/level.h>
 
@@ -262,6 +263,10 @@ class Route : public echo::routing::TemplateRoute {
       this->attribute = attribute;
       this->required = required;
       this->format = format;
+
+      if (format != null) {
+        this->pattern = echo::engine::util::Pattern::compile(format);
+      }
     }
     
    protected:
@@ -271,6 +276,9 @@ class Route : public echo::routing::TemplateRoute {
     /** Format of the attribute value, using Regex pattern syntax. */
     volatile std::string format;
 
+    /** The format compiled once, when the validation is declared. */
+    echo::engine::util::Pattern pattern;
+
     /** Indicates if the attribute presence is required. */
     volatile bool required;
 
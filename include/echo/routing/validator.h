@@ -15,6 +15,7 @@
 #include <echo/response.h>
 #include <echo/echo.h>
 #include <echo/data/status.h>
+#include <echo/engine/util/pattern.h>
 
 namespace echo {
 namespace routing {
@@ -112,6 +113,10 @@ class Validator : public echo::routing::Filter {
       this->attribute = attribute;
       this->required = required;
       this->format = format;
+
+      if (format != null) {
+        this->pattern = echo::engine::util::Pattern::compile(format);
+      }
     }
 
    protected:
@@ -121,6 +126,9 @@ class Validator : public echo::routing::Filter {
     /** Format of the attribute value, using Regex pattern syntax. */
     std::string format;
 
+    /** The format compiled once, when the validation is declared. */
+    echo::engine::util::Pattern pattern;
+
     /** Indicates if the attribute presence is required. */
     bool required;
 
@@ -1,39 +1,65 @@
 #include <echo/data/challenge-scheme.h>
 
+#include <echo/engine/util/intern-table.h>
+#include <echo/engine/util/name-table.h>
+
 namespace echo {
 namespace data {
 
+using echo::engine::util::InternTable;
+using echo::engine::util::NameTable;
+
+/** The maximum number of custom challenge schemes interned by valueOf(). */
+static const size_t MAX_CUSTOM_CHALLENGE_SCHEMES = 256;
+
+/**
+ * Creates the perfect hash table of the well-known challenge schemes.
+ */
+static NameTable<ChallengeScheme>* createKnownChallengeSchemes() {
+  NameTable<ChallengeScheme>* result = new NameTable<ChallengeScheme>();
+  result->add(ChallengeScheme::CUSTOM.getName(), &ChallengeScheme::CUSTOM);
+  result->add(ChallengeScheme::HTTP_AWS_S3.getName(),
+              &ChallengeScheme::HTTP_AWS_S3);
+  result->add(ChallengeScheme::HTTP_BASIC.getName(),
+              &ChallengeScheme::HTTP_BASIC);
+  result->add(ChallengeScheme::HTTP_COOKIE.getName(),
+              &ChallengeScheme::HTTP_COOKIE);
+  result->add(ChallengeScheme::HTTP_DIGEST.getName(),
+              &ChallengeScheme::HTTP_DIGEST);
+  result->add(ChallengeScheme::HTTP_AZURE_SHAREDKEY.getName(),
+              &ChallengeScheme::HTTP_AZURE_SHAREDKEY);
+  result->add(ChallengeScheme::HTTP_AZURE_SHAREDKEY_LITE.getName(),
+              &ChallengeScheme::HTTP_AZURE_SHAREDKEY_LITE);
+  result->add(ChallengeScheme::HTTP_NTLM.getName(),
+              &ChallengeScheme::HTTP_NTLM);
+  result->add(ChallengeScheme::HTTP_OAUTH.getName(),
+              &ChallengeScheme::HTTP_OAUTH);
+  result->add(ChallengeScheme::POP_BASIC.getName(),
+              &ChallengeScheme::POP_BASIC);
+  result->add(ChallengeScheme::POP_DIGEST.getName(),
+              &ChallengeScheme::POP_DIGEST);
+  result->add(ChallengeScheme::SMTP_PLAIN.getName(),
+              &ChallengeScheme::SMTP_PLAIN);
+  result->build();
+  return result;
+}
+
 static ChallengeScheme ChallengeScheme::valueOf(const std::string name) {
+  // Built on first use, once the constants are initialized
+  static const NameTable<ChallengeScheme>* knownChallengeSchemes =
+      createKnownChallengeSchemes();
+  static InternTable<ChallengeScheme> customChallengeSchemes(
+      MAX_CUSTOM_CHALLENGE_SCHEMES);
   ChallengeScheme result = null;
 
   if ((name != null) && !name.equals("")) {
-    if (name.equalsIgnoreCase(CUSTOM.getName())) {
-      result = CUSTOM;
-    } else if (name.equalsIgnoreCase(HTTP_AWS_S3.getName())) {
-      result = HTTP_AWS_S3;
-    } else if (name.equalsIgnoreCase(HTTP_BASIC.getName())) {
-      result = HTTP_BASIC;
-    } else if (name.equalsIgnoreCase(HTTP_COOKIE.getName())) {
-      result = HTTP_COOKIE;
-    } else if (name.equalsIgnoreCase(HTTP_DIGEST.getName())) {
-      result = HTTP_DIGEST;
-    } else if (name.equalsIgnoreCase(HTTP_AZURE_SHAREDKEY.getName())) {
-      result = HTTP_AZURE_SHAREDKEY;
-    } else if (name.equalsIgnoreCase(HTTP_AZURE_SHAREDKEY_LITE
-                                     .getName())) {
-      result = HTTP_AZURE_SHAREDKEY_LITE;
-    } else if (name.equalsIgnoreCase(HTTP_NTLM.getName())) {
-      result = HTTP_NTLM;
-    } else if (name.equalsIgnoreCase(HTTP_OAUTH.getName())) {
-      result = HTTP_OAUTH;
-    } else if (name.equalsIgnoreCase(POP_BASIC.getName())) {
-      result = POP_BASIC;
-    } else if (name.equalsIgnoreCase(POP_DIGEST.getName())) {
-      result = POP_DIGEST;
-    } else if (name.equalsIgnoreCase(SMTP_PLAIN.getName())) {
-      result = SMTP_PLAIN;
-    } else {
-      result = new ChallengeScheme(name, null, null);
+    const ChallengeScheme* known = knownChallengeSchemes->find(name);
+
+    if (known != null) {
+      result = *known;
+    } else if (!customChallengeSchemes.get(name, result)) {
+      result = customChallengeSchemes.put(
+          name, new ChallengeScheme(name, null, null));
     }
   }
 
@@ -1,8 +1,14 @@
 #include <echo/data/character-set.h>
 
+#include <echo/engine/util/intern-table.h>
+#include <echo/engine/util/name-table.h>
+
 namespace echo {
 namespace data {
 
+using echo::engine::util::InternTable;
+using echo::engine::util::NameTable;
+
 
 /** All character sets acceptable. */
 static const CharacterSet CharacterSet::ALL("*","All character sets");
@@ -138,27 +144,42 @@ CharacterSet::WINDOWS_1252("windows-1252", "Windows 1232 character set");
 static const CharacterSet
 CharacterSet::DEFAULT(java.nio.charset.Charset.defaultCharset());
 
+/** The maximum number of custom character sets interned by valueOf(). */
+static const size_t MAX_CUSTOM_CHARACTER_SETS = 256;
+
+/**
+ * Creates the perfect hash table of the well-known character sets.
+ */
+static NameTable<CharacterSet>* createKnownCharacterSets() {
+  NameTable<CharacterSet>* result = new NameTable<CharacterSet>();
+  result->add(CharacterSet::ALL.getName(), &CharacterSet::ALL);
+  result->add(CharacterSet::ISO_8859_1.getName(), &CharacterSet::ISO_8859_1);
+  result->add(CharacterSet::US_ASCII.getName(), &CharacterSet::US_ASCII);
+  result->add(CharacterSet::UTF_8.getName(), &CharacterSet::UTF_8);
+  result->add(CharacterSet::UTF_16.getName(), &CharacterSet::UTF_16);
+  result->add(CharacterSet::WINDOWS_1252.getName(),
+              &CharacterSet::WINDOWS_1252);
+  result->add(CharacterSet::MACINTOSH.getName(), &CharacterSet::MACINTOSH);
+  result->build();
+  return result;
+}
+
 static CharacterSet::CharacterSet CharacterSet::valueOf(std::string name) {
+  // Built on first use, once the constants are initialized
+  static const NameTable<CharacterSet>* knownCharacterSets =
+      createKnownCharacterSets();
+  static InternTable<CharacterSet> customCharacterSets(
+      MAX_CUSTOM_CHARACTER_SETS);
   CharacterSet result = null;
   name = getIanaName(name);
 
   if ((name != null) && !name.equals("")) {
-    if (name.equalsIgnoreCase(ALL.getName())) {
-      result = ALL;
-    } else if (name.equalsIgnoreCase(ISO_8859_1.getName())) {
-      result = ISO_8859_1;
-    } else if (name.equalsIgnoreCase(US_ASCII.getName())) {
-      result = US_ASCII;
-    } else if (name.equalsIgnoreCase(UTF_8.getName())) {
-      result = UTF_8;
-    } else if (name.equalsIgnoreCase(UTF_16.getName())) {
-      result = UTF_16;
-    } else if (name.equalsIgnoreCase(WINDOWS_1252.getName())) {
-      result = WINDOWS_1252;
-    } else if (name.equalsIgnoreCase(MACINTOSH.getName())) {
-      result = MACINTOSH;
-    } else {
-      result = new CharacterSet(name);
+    const CharacterSet* known = knownCharacterSets->find(name);
+
+    if (known != null) {
+      result = *known;
+    } else if (!customCharacterSets.get(name, result)) {
+      result = customCharacterSets.put(name, new CharacterSet(name));
     }
   }
 
@@ -1,5 +1,7 @@
 #include <echo/data/cookie-setting.h>
 
+#include <sstream>
+
 namespace echo {
 namespace data {
 
@@ -11,6 +13,32 @@ CookieSetting::CookieSetting(int version, std::string name, std::string value, s
   this->maxAge = maxAge;
   this->secure = secure;
   this->accessRestricted = accessRestricted;
+  this->headerAttributes = NULL;
+}
+
+CookieSetting::CookieSetting(CookieSetting prototype, std::string value) {
+  CookieSetting(prototype.getVersion(), prototype.getName(), value,
+                prototype.getPath(), prototype.getDomain(),
+                prototype.getComment(), prototype.getMaxAge(),
+                prototype.isSecure(), prototype.isAccessRestricted());
+  this->headerAttributes = prototype.getHeaderAttributes();
+}
+
+/**
+ * Appends a version 1 attribute value, quoted and escaped.
+ */
+static void appendQuoted(std::ostringstream& out, const std::string& value) {
+  out << '"';
+
+  for (std::string::size_type i = 0; i < value.size(); i++) {
+    if ((value[i] == '"') || (value[i] == '\\')) {
+      out << '\\';
+    }
+
+    out << value[i];
+  }
+
+  out << '"';
 }
 
 bool CookieSetting::equals(Object obj) {
@@ -45,6 +73,88 @@ bool CookieSetting::equals(Object obj) {
   return result;
 }
 
+std::string CookieSetting::getHeaderAttributes() {
+  // Lazy initialization with double-check.
+  std::string result = this->headerAttributes;
+
+  if (result == NULL) {
+    synchronized (this) {
+      result = this->headerAttributes;
+
+      if (result == NULL) {
+        std::ostringstream out;
+        const bool quoted = (getVersion() > 0);
+
+        if (quoted) {
+          out << "; Version=\"" << getVersion() << '"';
+
+          if ((getComment() != NULL) && !getComment().empty()) {
+            out << "; Comment=";
+            appendQuoted(out, getComment());
+          }
+        }
+
+        if (getMaxAge() >= 0) {
+          out << "; Max-Age=" << getMaxAge();
+
+          // Older clients ignore "Max-Age" and need an expired date
+          if (!quoted && (getMaxAge() == 0)) {
+            out << "; Expires=Thu, 01 Jan 1970 00:00:00 GMT";
+          }
+        }
+
+        if ((getPath() != NULL) && !getPath().empty()) {
+          out << "; Path=";
+
+          if (quoted) {
+            appendQuoted(out, getPath());
+          } else {
+            out << getPath();
+          }
+        }
+
+        if ((getDomain() != NULL) && !getDomain().empty()) {
+          out << "; Domain=";
+
+          if (quoted) {
+            appendQuoted(out, getDomain());
+          } else {
+            out << getDomain();
+          }
+        }
+
+        if (isSecure()) {
+          out << "; Secure";
+        }
+
+        if (isAccessRestricted()) {
+          out << "; HttpOnly";
+        }
+
+        this->headerAttributes = result = out.str();
+      }
+    }
+  }
+
+  return result;
+}
+
+std::string CookieSetting::getHeaderValue() {
+  std::string result = getName();
+  result += '=';
+
+  if (getVersion() > 0) {
+    std::ostringstream out;
+    appendQuoted(out, (getValue() == NULL) ? "" : getValue());
+    result += out.str();
+  } else if (getValue() != NULL) {
+    result += getValue();
+  }
+
+  result += getHeaderAttributes();
+  return result;
+}
+
 int CookieSetting::hashCode() {
   return SystemUtils.hashCode(super.hashCode(), getComment(),
                               getMaxAge(), isSecure());
@@ -1,8 +1,14 @@
 #include <echo/data/encoding.h>
 
+#include <echo/engine/util/intern-table.h>
+#include <echo/engine/util/name-table.h>
+
 namespace echo {
 namespace data {
 
+using echo::engine::util::InternTable;
+using echo::engine::util::NameTable;
+
 
 const Encoding Encoding::ALL("*", "All encodings");
 
@@ -25,28 +31,39 @@ const Encoding Encoding::VELOCITY("velocity",
 
 const Encoding Encoding::ZIP("zip", "Zip compression");
 
+/** The maximum number of custom encodings interned by valueOf(). */
+static const size_t MAX_CUSTOM_ENCODINGS = 256;
+
+/**
+ * Creates the perfect hash table of the well-known encodings.
+ */
+static NameTable<Encoding>* createKnownEncodings() {
+  NameTable<Encoding>* result = new NameTable<Encoding>();
+  result->add(Encoding::ALL.getName(), &Encoding::ALL);
+  result->add(Encoding::GZIP.getName(), &Encoding::GZIP);
+  result->add(Encoding::ZIP.getName(), &Encoding::ZIP);
+  result->add(Encoding::COMPRESS.getName(), &Encoding::COMPRESS);
+  result->add(Encoding::DEFLATE.getName(), &Encoding::DEFLATE);
+  result->add(Encoding::IDENTITY.getName(), &Encoding::IDENTITY);
+  result->add(Encoding::FREEMARKER.getName(), &Encoding::FREEMARKER);
+  result->add(Encoding::VELOCITY.getName(), &Encoding::VELOCITY);
+  result->build();
+  return result;
+}
+
 static Encoding Encoding::valueOf(const std::string name) {
+  // Built on first use, once the constants are initialized
+  static const NameTable<Encoding>* knownEncodings = createKnownEncodings();
+  static InternTable<Encoding> customEncodings(MAX_CUSTOM_ENCODINGS);
   Encoding result = NULL;
 
   if ((name != NULL) && !name.equals("")) {
-    if (name.equalsIgnoreCase(ALL.getName())) {
-      result = ALL;
-    } else if (name.equalsIgnoreCase(GZIP.getName())) {
-      result = GZIP;
-    } else if (name.equalsIgnoreCase(ZIP.getName())) {
-      result = ZIP;
-    } else if (name.equalsIgnoreCase(COMPRESS.getName())) {
-      result = COMPRESS;
-    } else if (name.equalsIgnoreCase(DEFLATE.getName())) {
-      result = DEFLATE;
-    } else if (name.equalsIgnoreCase(IDENTITY.getName())) {
-      result = IDENTITY;
-    } else if (name.equalsIgnoreCase(FREEMARKER.getName())) {
-      result = FREEMARKER;
-    } else if (name.equalsIgnoreCase(VELOCITY.getName())) {
-      result = VELOCITY;
-    } else {
-      result = new Encoding(name);
+    const Encoding* known = knownEncodings->find(name);
+
+    if (known != NULL) {
+      result = *known;
+    } else if (!customEncodings.get(name, result)) {
+      result = customEncodings.put(name, new Encoding(name));
     }
   }
 
@@ -1,8 +1,14 @@
 #include <echo/data/language.h>
 
+#include <echo/engine/util/intern-table.h>
+#include <echo/engine/util/name-table.h>
+
 namespace echo {
 namespace data {
 
+using echo::engine::util::InternTable;
+using echo::engine::util::NameTable;
+
 const Language Language::ALL("*", "All languages");
 const Language Language::DEFAULT(java.util.Locale.getDefault().getLanguage());
 const Language Language::ENGLISH("en", "English language");
@@ -11,24 +17,37 @@ const Language Language::FRENCH("fr", "French language");
 const Language Language::FRENCH_FRANCE("fr-fr", "French language in France");
 const Language Language::SPANISH("es", "Spanish language");
 
+/** The maximum number of custom languages interned by valueOf(). */
+static const size_t MAX_CUSTOM_LANGUAGES = 256;
+
+/**
+ * Creates the perfect hash table of the well-known languages.
+ */
+static NameTable<Language>* createKnownLanguages() {
+  NameTable<Language>* result = new NameTable<Language>();
+  result->add(Language::ALL.getName(), &Language::ALL);
+  result->add(Language::ENGLISH.getName(), &Language::ENGLISH);
+  result->add(Language::ENGLISH_US.getName(), &Language::ENGLISH_US);
+  result->add(Language::FRENCH.getName(), &Language::FRENCH);
+  result->add(Language::FRENCH_FRANCE.getName(), &Language::FRENCH_FRANCE);
+  result->add(Language::SPANISH.getName(), &Language::SPANISH);
+  result->build();
+  return result;
+}
+
 static Language Language::valueOf(const std::string name) {
+  // Built on first use, once the constants are initialized
+  static const NameTable<Language>* knownLanguages = createKnownLanguages();
+  static InternTable<Language> customLanguages(MAX_CUSTOM_LANGUAGES);
   Language result = NULL;
 
   if ((name != NULL) && !name.equals("")) {
-    if (name.equalsIgnoreCase(ALL.getName())) {
-      result = ALL;
-    } else if (name.equalsIgnoreCase(ENGLISH.getName())) {
-      result = ENGLISH;
-    } else if (name.equalsIgnoreCase(ENGLISH_US.getName())) {
-      result = ENGLISH_US;
-    } else if (name.equalsIgnoreCase(FRENCH.getName())) {
-      result = FRENCH;
-    } else if (name.equalsIgnoreCase(FRENCH_FRANCE.getName())) {
-      result = FRENCH_FRANCE;
-    } else if (name.equalsIgnoreCase(SPANISH.getName())) {
-      result = SPANISH;
-    } else {
-      result = new Language(name);
+    const Language* known = knownLanguages->find(name);
+
+    if (known != NULL) {
+      result = *known;
+    } else if (!customLanguages.get(name, result)) {
+      result = customLanguages.put(name, new Language(name));
     }
   }
 
@@ -1,8 +1,14 @@
 #include <echo/data/method.h>
 
+#include <echo/engine/util/intern-table.h>
+#include <echo/engine/util/name-table.h>
+
 namespace echo {
 namespace data {
 
+using echo::engine::util::InternTable;
+using echo::engine::util::NameTable;
+
 const Method Method::ALL("*",
                          "Pseudo-method use to match all methods.");
 
@@ -86,42 +92,46 @@ Method::BASE_HTTP = "http://www.w3.org/Protocols/rfc2616/rfc2616-sec9.html";
 
 const std::string Method::BASE_WEBDAV = "http://www.webdav.org/specs/rfc2518.html";
 
+/** The maximum number of custom methods interned by valueOf(). */
+static const size_t MAX_CUSTOM_METHODS = 256;
+
+/**
+ * Creates the perfect hash table of the well-known methods.
+ */
+static NameTable<Method>* createKnownMethods() {
+  NameTable<Method>* result = new NameTable<Method>();
+  result->add(Method::GET.getName(), &Method::GET);
+  result->add(Method::POST.getName(), &Method::POST);
+  result->add(Method::HEAD.getName(), &Method::HEAD);
+  result->add(Method::OPTIONS.getName(), &Method::OPTIONS);
+  result->add(Method::PUT.getName(), &Method::PUT);
+  result->add(Method::DELETE.getName(), &Method::DELETE);
+  result->add(Method::CONNECT.getName(), &Method::CONNECT);
+  result->add(Method::COPY.getName(), &Method::COPY);
+  result->add(Method::LOCK.getName(), &Method::LOCK);
+  result->add(Method::MKCOL.getName(), &Method::MKCOL);
+  result->add(Method::MOVE.getName(), &Method::MOVE);
+  result->add(Method::PROPFIND.getName(), &Method::PROPFIND);
+  result->add(Method::PROPPATCH.getName(), &Method::PROPPATCH);
+  result->add(Method::TRACE.getName(), &Method::TRACE);
+  result->add(Method::UNLOCK.getName(), &Method::UNLOCK);
+  result->build();
+  return result;
+}
+
 Method Method::valueOf(const std::string name) {
+  // Built on first use, once the constants are initialized
+  static const NameTable<Method>* knownMethods = createKnownMethods();
+  static InternTable<Method> customMethods(MAX_CUSTOM_METHODS);
   Method result = NULL;
 
   if ((name != NULL) && !name.equals("")) {
-    if (name.equalsIgnoreCase(GET.getName())) {
-      result = GET;
-    } else if (name.equalsIgnoreCase(POST.getName())) {
-      result = POST;
-    } else if (name.equalsIgnoreCase(HEAD.getName())) {
-      result = HEAD;
-    } else if (name.equalsIgnoreCase(OPTIONS.getName())) {
-      result = OPTIONS;
-    } else if (name.equalsIgnoreCase(PUT.getName())) {
-      result = PUT;
-    } else if (name.equalsIgnoreCase(DELETE.getName())) {
-      result = DELETE;
-    } else if (name.equalsIgnoreCase(CONNECT.getName())) {
-      result = CONNECT;
-    } else if (name.equalsIgnoreCase(COPY.getName())) {
-      result = COPY;
-    } else if (name.equalsIgnoreCase(LOCK.getName())) {
-      result = LOCK;
-    } else if (name.equalsIgnoreCase(MKCOL.getName())) {
-      result = MKCOL;
-    } else if (name.equalsIgnoreCase(MOVE.getName())) {
-      result = MOVE;
-    } else if (name.equalsIgnoreCase(PROPFIND.getName())) {
-      result = PROPFIND;
-    } else if (name.equalsIgnoreCase(PROPPATCH.getName())) {
-      result = PROPPATCH;
-    } else if (name.equalsIgnoreCase(TRACE.getName())) {
-      result = TRACE;
-    } else if (name.equalsIgnoreCase(UNLOCK.getName())) {
-      result = UNLOCK;
-    } else {
-      result = new Method(name);
+    const Method* known = knownMethods->find(name);
+
+    if (known != NULL) {
+      result = *known;
+    } else if (!customMethods.get(name, result)) {
+      result = customMethods.put(name, new Method(name));
     }
   }
 
@@ -1,5 +1,7 @@
 #include <echo/data/status.h>
 
+#include <echo/engine/http/status-table.h>
+
 namespace echo {
 namespace data {
 
@@ -117,8 +119,12 @@ const Status Status::SUCCESS_PARTIAL_CONTENT(206);
 const Status Status::SUCCESS_RESET_CONTENT(205);
 
 bool Status::isError(int code) {
-  return isClientError(code) || isServerError(code)
-      || isConnectorError(code);
+  return isClientError(code) | isServerError(code) | isConnectorError(code);
+}
+
+bool Status::isRecoverableError(int code) {
+  return isConnectorError(code) | (code == 408) | (code == 503)
+      | (code == 504);
 }
 
 
@@ -526,180 +532,11 @@ std::string Status::getName() {
   std::string result = this->name;
 
   if (result == NULL) {
-    switch (this->code) {
-      case 100:
-        result = "Continue";
-        break;
-      case 101:
-        result = "Switching Protocols";
-        break;
-      case 102:
-        result = "Processing";
-        break;
-      case 110:
-        result = "Response is stale";
-        break;
-      case 111:
-        result = "Revalidation failed";
-        break;
-      case 112:
-        result = "Disconnected operation";
-        break;
-      case 113:
-        result = "Heuristic expiration";
-        break;
-      case 199:
-        result = "Miscellaneous warning";
-        break;
-
-      case 200:
-        result = "OK";
-        break;
-      case 201:
-        result = "Created";
-        break;
-      case 202:
-        result = "Accepted";
-        break;
-      case 203:
-        result = "Non-Authoritative Information";
-        break;
-      case 204:
-        result = "No Content";
-        break;
-      case 205:
-        result = "Reset Content";
-        break;
-      case 206:
-        result = "Partial Content";
-        break;
-      case 207:
-        result = "Multi-Status";
-        break;
-      case 214:
-        result = "Transformation applied";
-        break;
-      case 299:
-        result = "Miscellaneous persistent warning";
-        break;
-
-      case 300:
-        result = "Multiple Choices";
-        break;
-      case 301:
-        result = "Moved Permanently";
-        break;
-      case 302:
-        result = "Found";
-        break;
-      case 303:
-        result = "See Other";
-        break;
-      case 304:
-        result = "Not Modified";
-        break;
-      case 305:
-        result = "Use Proxy";
-        break;
-      case 307:
-        result = "Temporary Redirect";
-        break;
-
-      case 400:
-        result = "Bad Request";
-        break;
-      case 401:
-        result = "Unauthorized";
-        break;
-      case 402:
-        result = "Payment Required";
-        break;
-      case 403:
-        result = "Forbidden";
-        break;
-      case 404:
-        result = "Not Found";
-        break;
-      case 405:
-        result = "Method Not Allowed";
-        break;
-      case 406:
-        result = "Not Acceptable";
-        break;
-      case 407:
-        result = "Proxy Authentication Required";
-        break;
-      case 408:
-        result = "Request Timeout";
-        break;
-      case 409:
-        result = "Conflict";
-        break;
-      case 410:
-        result = "Gone";
-        break;
-      case 411:
-        result = "Length Required";
-        break;
-      case 412:
-        result = "Precondition Failed";
-        break;
-      case 413:
-        result = "Request Entity Too Large";
-        break;
-      case 414:
-        result = "Request URI Too Long";
-        break;
-      case 415:
-        result = "Unsupported Media Type";
-        break;
-      case 416:
-        result = "Requested Range Not Satisfiable";
-        break;
-      case 417:
-        result = "Expectation Failed";
-        break;
-      case 422:
-        result = "Unprocessable Entity";
-        break;
-      case 423:
-        result = "Locked";
-        break;
-      case 424:
-        result = "Failed Dependency";
-        break;
-
-      case 500:
-        result = "Internal Server Error";
-        break;
-      case 501:
-        result = "Not Implemented";
-        break;
-      case 502:
-        result = "Bad Gateway";
-        break;
-      case 503:
-        result = "Service Unavailable";
-        break;
-      case 504:
-        result = "Gateway Timeout";
-        break;
-      case 505:
-        result = "Version Not Supported";
-        break;
-      case 507:
-        result = "Insufficient Storage";
-        break;
+    const engine::http::StatusTable::Entry* entry =
+        engine::http::StatusTable::find(this->code);
 
-      case 1000:
-        result = "Connection Error";
-        break;
-      case 1001:
-        result = "Communication Error";
-        break;
-      case 1002:
-        result = "Internal Connector Error";
-        break;
+    if (entry != NULL) {
+      result = entry->reason;
     }
   }
 
@@ -903,10 +740,7 @@ bool Status::isInformational() {
 }
 
 bool Status::isRecoverableError() {
-  return isConnectorError()
-      || equals(Status.CLIENT_ERROR_REQUEST_TIMEOUT)
-      || equals(Status.SERVER_ERROR_GATEWAY_TIMEOUT)
-      || equals(Status.SERVER_ERROR_SERVICE_UNAVAILABLE);
+  return isRecoverableError(getCode());
 }
 
 bool Status::isRedirection() {
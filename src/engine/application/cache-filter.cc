@@ -0,0 +1,221 @@
+#include <echo/engine/application/cache-filter.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <list>
+#include <set>
+
+#include <echo/data/cache-directive.h>
+#include <echo/data/dimension.h>
+#include <echo/data/method.h>
+#include <echo/data/status.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+using echo::representation::SharedRepresentation;
+
+/** The bitmask of the dimensions which can't be keyed. */
+static const int UNKEYED_DIMENSIONS = (1 << AUTHORIZATION)
+                                      | (1 << CLIENT_ADDRESS) | (1 << TIME)
+                                      | (1 << UNSPECIFIED);
+
+/**
+ * Indicates if a status is cacheable by default, as defined by RFC 7231.
+ */
+static bool isCacheable(int code) {
+  return (code == 200) || (code == 203) || (code == 204) || (code == 300)
+         || (code == 301) || (code == 404) || (code == 405) || (code == 410)
+         || (code == 414) || (code == 501);
+}
+
+CacheFilter::CacheFilter(echo::Context context, Echo::Echo next) {
+  Filter(context, next);
+  this->cache = ResponseCache::getCache(context);
+  this->maxEntitySize = DEFAULT_MAX_ENTITY_SIZE;
+
+  if (this->cache == NULL) {
+    this->cache = new ResponseCache();
+
+    if (context != NULL) {
+      ResponseCache::setCache(context, this->cache);
+    }
+  }
+}
+
+void CacheFilter::afterHandle(echo::Request request,
+                              echo::Response response) {
+  const Method method = request.getMethod();
+
+  if (!Method::GET.equals(method)) {
+    // Successful unsafe requests invalidate the stored variants
+    if (!Method::HEAD.equals(method) && !Method::OPTIONS.equals(method)
+        && !Method::TRACE.equals(method)
+        && (response.getStatus().isSuccess()
+            || response.getStatus().isRedirection())) {
+      cache->remove(request.getResourceRef().toString());
+    }
+
+    return;
+  }
+
+  const time_t now = time(NULL);
+  const int lifetime = getLifetime(request, response, now);
+  const int variance = getVariance(response);
+
+  if ((lifetime <= 0) || (variance == -1)) {
+    return;
+  }
+
+  const Representation entity = response.getEntity();
+  const bool available = (entity != NULL) && entity.isAvailable();
+
+  if (available && !CachedResponse::isCapturable(entity, maxEntitySize)) {
+    return;
+  }
+
+  std::string* content = new std::string();
+
+  if (available) {
+    *content = entity.getText();
+  }
+
+  const ResponseCache::Entry entry(new CachedResponse(
+      response, SharedRepresentation::Content(content), now, lifetime));
+
+  // The entity was consumed, the response shares the cached content
+  response.setEntity(entry->createEntity());
+
+  const std::string primaryKey = request.getResourceRef().toString();
+  cache->put(primaryKey, variance,
+             ResponseCache::getVariantKey(request, primaryKey, variance),
+             entry);
+}
+
+int CacheFilter::beforeHandle(echo::Request request,
+                              echo::Response response) {
+  if (!Method::GET.equals(request.getMethod())
+      && !Method::HEAD.equals(request.getMethod())) {
+    return CONTINUE;
+  }
+
+  int maxAge = -1;
+
+  for (CacheDirective directive : request.getCacheDirectives()) {
+    if ((directive.getName() == "no-store")
+        || (directive.getName() == "no-cache")) {
+      return CONTINUE;
+    } else if ((directive.getName() == "max-age")
+               && (directive.getValue() != NULL)) {
+      maxAge = atoi(directive.getValue().c_str());
+    }
+  }
+
+  const std::string primaryKey = request.getResourceRef().toString();
+  int variance = 0;
+
+  if (!cache->getVariance(primaryKey, variance)) {
+    return CONTINUE;
+  }
+
+  const time_t now = time(NULL);
+  const ResponseCache::Entry entry = cache->get(
+      primaryKey, ResponseCache::getVariantKey(request, primaryKey, variance),
+      now);
+
+  if (!entry || ((maxAge >= 0) && (entry->getAge(now) > maxAge))) {
+    return CONTINUE;
+  }
+
+  entry->apply(response, now);
+
+  if (request.getConditions().hasSome()) {
+    const echo::data::Status status = request.getConditions().getStatus(
+        request.getMethod(), true, entry->getTag(),
+        entry->getModificationDate());
+
+    // A "304 Not Modified" response keeps the entity metadata, which the
+    // connectors send without the content
+    if (status != NULL) {
+      response.setStatus(status);
+
+      if (status.getCode() != 304) {
+        response.setEntity(NULL);
+      }
+    }
+  }
+
+  return STOP;
+}
+
+int CacheFilter::getLifetime(echo::Request request, echo::Response response,
+                             time_t now) {
+  if (!isCacheable(response.getStatus().getCode())
+      || !response.getCookieSettings().isEmpty()) {
+    return 0;
+  }
+
+  for (CacheDirective directive : request.getCacheDirectives()) {
+    if (directive.getName() == "no-store") {
+      return 0;
+    }
+  }
+
+  bool shared = false;
+  int maxAge = -1;
+  int sharedMaxAge = -1;
+
+  for (CacheDirective directive : response.getCacheDirectives()) {
+    const std::string name = directive.getName();
+
+    if ((name == "no-store") || (name == "no-cache")
+        || (name == "private")) {
+      return 0;
+    } else if ((name == "public") || (name == "must-revalidate")) {
+      shared = true;
+    } else if ((name == "s-maxage") && (directive.getValue() != NULL)) {
+      sharedMaxAge = atoi(directive.getValue().c_str());
+      shared = true;
+    } else if ((name == "max-age") && (directive.getValue() != NULL)) {
+      maxAge = atoi(directive.getValue().c_str());
+    }
+  }
+
+  // Responses to authenticated requests are private unless stated otherwise
+  if ((request.getChallengeResponse() != NULL) && !shared) {
+    return 0;
+  }
+
+  if (sharedMaxAge >= 0) {
+    return sharedMaxAge;
+  } else if (maxAge >= 0) {
+    return maxAge;
+  }
+
+  const Representation entity = response.getEntity();
+
+  if ((entity != NULL) && (entity.getExpirationDate() != NULL)) {
+    const long long expiration = entity.getExpirationDate().getTime() / 1000;
+    return (expiration > now) ? static_cast<int>(expiration - now) : 0;
+  }
+
+  return 0;
+}
+
+int CacheFilter::getVariance(echo::Response response) {
+  int result = 0;
+
+  for (Dimension dimension : response.getDimensions()) {
+    result |= 1 << dimension;
+  }
+
+  return (result & UNKEYED_DIMENSIONS) ? -1 : result;
+}
+
+const size_t CacheFilter::DEFAULT_MAX_ENTITY_SIZE(1024 * 1024);
+
+} // namespace application
+} // namespace engine
+} // namespace echo
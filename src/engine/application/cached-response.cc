@@ -0,0 +1,74 @@
+#include <echo/engine/application/cached-response.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+using echo::representation::SharedRepresentation;
+
+bool CachedResponse::isCapturable(Representation entity, size_t maxSize) {
+  return !entity.isTransient()
+         && (entity.getSize() != Representation::UNKNOWN_SIZE)
+         && (static_cast<unsigned long long>(entity.getSize()) <= maxSize);
+}
+
+CachedResponse::CachedResponse(echo::Response response,
+                               SharedRepresentation::Content content,
+                               time_t now, int lifetime) : content(content) {
+  this->status = response.getStatus();
+  this->age = response.getAge();
+  this->storedAt = now;
+  this->expiration = now + lifetime - this->age;
+  this->locationRef = response.getLocationRef();
+  this->allowedMethods = response.getAllowedMethods();
+  this->challengeRequests = response.getChallengeRequests();
+  this->dimensions = response.getDimensions();
+  this->cacheDirectives = response.getCacheDirectives();
+
+  const Representation entity = response.getEntity();
+  this->entityAvailable = (entity != NULL) && entity.isAvailable();
+
+  if (this->entityAvailable) {
+    this->mediaType = entity.getMediaType();
+    this->characterSet = entity.getCharacterSet();
+    this->encodings = entity.getEncodings();
+    this->languages = entity.getLanguages();
+    this->tag = entity.getTag();
+    this->modificationDate = entity.getModificationDate();
+    this->expirationDate = entity.getExpirationDate();
+  }
+}
+
+void CachedResponse::apply(echo::Response response, time_t now) const {
+  response.setStatus(status);
+  response.setAge(getAge(now));
+  response.setDimensions(dimensions);
+  response.setCacheDirectives(cacheDirectives);
+  response.setAllowedMethods(allowedMethods);
+  response.setChallengeRequests(challengeRequests);
+
+  if (locationRef != NULL) {
+    response.setLocationRef(locationRef);
+  }
+
+  response.setEntity(createEntity());
+}
+
+Representation CachedResponse::createEntity() const {
+  if (!entityAvailable) {
+    return NULL;
+  }
+
+  Representation result = new SharedRepresentation(content, mediaType);
+  result.setCharacterSet(characterSet);
+  result.setEncodings(encodings);
+  result.setLanguages(languages);
+  result.setTag(tag);
+  result.setModificationDate(modificationDate);
+  result.setExpirationDate(expirationDate);
+  return result;
+}
+
+} // namespace application
+} // namespace engine
+} // namespace echo
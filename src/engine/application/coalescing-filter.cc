@@ -0,0 +1,184 @@
+#include <echo/engine/application/coalescing-filter.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <echo/data/dimension.h>
+#include <echo/data/method.h>
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+using echo::engine::util::ScopedLock;
+using echo::representation::SharedRepresentation;
+
+/** The bitmask of the dimensions negotiated from the request preferences. */
+static const int NEGOTIATED_DIMENSIONS = (1 << MEDIA_TYPE)
+                                         | (1 << CHARACTER_SET)
+                                         | (1 << ENCODING) | (1 << LANGUAGE);
+
+CoalescingFilter::CoalescingFilter(echo::Context context, Echo::Echo next) {
+  Filter(context, next);
+  pthread_mutex_init(&this->lock, NULL);
+  this->maxEntitySize = DEFAULT_MAX_ENTITY_SIZE;
+  this->timeout = DEFAULT_TIMEOUT;
+}
+
+CoalescingFilter::~CoalescingFilter() {
+  pthread_mutex_destroy(&lock);
+}
+
+int CoalescingFilter::doHandle(echo::Request request,
+                               echo::Response response) {
+  const std::string key = getKey(request);
+
+  if (key.empty()) {
+    return super.doHandle(request, response);
+  }
+
+  Flight* flight = NULL;
+  bool first = false;
+
+  {
+    ScopedLock guard(&lock);
+    const FlightMap::iterator it = flights.find(key);
+
+    if (it != flights.end()) {
+      flight = it->second;
+    } else {
+      // The waits are measured on the monotonic clock
+      pthread_condattr_t attributes;
+      pthread_condattr_init(&attributes);
+      pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+
+      flight = new Flight();
+      pthread_cond_init(&flight->completed, &attributes);
+      pthread_condattr_destroy(&attributes);
+      flight->done = false;
+      flight->references = 0;
+      flights[key] = flight;
+      first = true;
+    }
+
+    flight->references++;
+  }
+
+  if (!first) {
+    const ResponseCache::Entry result = wait(flight);
+
+    if (result) {
+      result->apply(response, time(NULL));
+      return CONTINUE;
+    }
+
+    return super.doHandle(request, response);
+  }
+
+  try {
+    super.doHandle(request, response);
+  } catch (...) {
+    complete(key, flight, NULL);
+    throw;
+  }
+
+  complete(key, flight, response);
+  return CONTINUE;
+}
+
+void CoalescingFilter::complete(const std::string& key, Flight* flight,
+                                echo::Response response) {
+  ResponseCache::Entry result;
+  bool shareable = (response != NULL)
+                   && response.getCookieSettings().isEmpty();
+
+  if (shareable) {
+    for (Dimension dimension : response.getDimensions()) {
+      if (((1 << dimension) & NEGOTIATED_DIMENSIONS) == 0) {
+        shareable = false;
+      }
+    }
+  }
+
+  const Representation entity = shareable ? response.getEntity() : NULL;
+
+  if ((entity != NULL) && entity.isAvailable()
+      && !CachedResponse::isCapturable(entity, maxEntitySize)) {
+    shareable = false;
+  }
+
+  if (shareable) {
+    std::string* content = new std::string();
+
+    if ((entity != NULL) && entity.isAvailable()) {
+      *content = entity.getText();
+    }
+
+    result = ResponseCache::Entry(new CachedResponse(
+        response, SharedRepresentation::Content(content), time(NULL), 0));
+
+    // The entity was consumed, the response shares the captured content
+    response.setEntity(result->createEntity());
+  }
+
+  ScopedLock guard(&lock);
+  flights.erase(key);
+  flight->result = result;
+  flight->done = true;
+  pthread_cond_broadcast(&flight->completed);
+  release(flight);
+}
+
+std::string CoalescingFilter::getKey(echo::Request request) {
+  const Method method = request.getMethod();
+
+  if ((!Method::GET.equals(method) && !Method::HEAD.equals(method))
+      || (request.getChallengeResponse() != NULL)
+      || (request.getCookieHeader() != NULL)
+      || !request.getCookies().isEmpty()) {
+    return std::string();
+  }
+
+  return ResponseCache::getVariantKey(
+      request, method.getName() + " " + request.getResourceRef().toString(),
+      NEGOTIATED_DIMENSIONS);
+}
+
+void CoalescingFilter::release(Flight* flight) {
+  if (--flight->references == 0) {
+    pthread_cond_destroy(&flight->completed);
+    delete flight;
+  }
+}
+
+ResponseCache::Entry CoalescingFilter::wait(Flight* flight) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += timeout / 1000;
+  deadline.tv_nsec += (timeout % 1000) * 1000000L;
+
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  ScopedLock guard(&lock);
+  int status = 0;
+
+  while (!flight->done && (status != ETIMEDOUT)) {
+    status = pthread_cond_timedwait(&flight->completed, &lock, &deadline);
+  }
+
+  const ResponseCache::Entry result = flight->done ? flight->result
+                                      : ResponseCache::Entry();
+  release(flight);
+  return result;
+}
+
+const size_t CoalescingFilter::DEFAULT_MAX_ENTITY_SIZE(1024 * 1024);
+const int CoalescingFilter::DEFAULT_TIMEOUT(10000);
+
+} // namespace application
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,201 @@
+#include <echo/engine/application/encoded-cache.h>
+
+#include <stdio.h>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+using echo::engine::util::ScopedLock;
+
+/** The names of the codings with a budget. */
+static const char* ENCODINGS[] = { "gzip", "deflate" };
+
+/** The approximate memory used by a node besides its body. */
+static const size_t NODE_OVERHEAD = 128;
+
+EncodedCache* EncodedCache::getCache(Context context) {
+  return (context == NULL) ? NULL
+         : (EncodedCache*) context.getAttributes().get(ATTRIBUTE);
+}
+
+void EncodedCache::setCache(Context context, EncodedCache* cache) {
+  context.getAttributes().put(ATTRIBUTE, cache);
+}
+
+EncodedCache::EncodedCache() {
+  for (size_t i = 0; i < sizeof(ENCODINGS) / sizeof(ENCODINGS[0]); i++) {
+    Partition* partition = new Partition();
+    pthread_mutex_init(&partition->lock, NULL);
+    partition->oldest = NULL;
+    partition->newest = NULL;
+    partition->size = 0;
+    partition->capacity = DEFAULT_CAPACITY;
+    partitions[ENCODINGS[i]] = partition;
+  }
+}
+
+EncodedCache::~EncodedCache() {
+  for (PartitionMap::iterator it = partitions.begin();
+       it != partitions.end(); ++it) {
+    Partition* partition = it->second;
+
+    for (NodeMap::iterator node = partition->nodes.begin();
+         node != partition->nodes.end(); ++node) {
+      delete node->second;
+    }
+
+    pthread_mutex_destroy(&partition->lock);
+    delete partition;
+  }
+}
+
+EncodedCache::Body EncodedCache::get(const std::string& validator,
+                                     const std::string& encoding,
+                                     int level) {
+  Partition* partition = getPartition(encoding);
+
+  if (partition == NULL) {
+    return Body();
+  }
+
+  const std::string key = getKey(validator, level);
+  ScopedLock lock(&partition->lock);
+  const NodeMap::iterator it = partition->nodes.find(key);
+
+  if (it == partition->nodes.end()) {
+    return Body();
+  }
+
+  Node* node = it->second;
+
+  // Move the node to the most recently used end
+  if (node != partition->newest) {
+    if (node->older != NULL) {
+      node->older->newer = node->newer;
+    } else {
+      partition->oldest = node->newer;
+    }
+
+    node->newer->older = node->older;
+    node->older = partition->newest;
+    node->newer = NULL;
+    partition->newest->newer = node;
+    partition->newest = node;
+  }
+
+  return node->body;
+}
+
+size_t EncodedCache::getSize(const std::string& encoding) {
+  Partition* partition = getPartition(encoding);
+
+  if (partition == NULL) {
+    return 0;
+  }
+
+  ScopedLock lock(&partition->lock);
+  return partition->size;
+}
+
+void EncodedCache::put(const std::string& validator,
+                       const std::string& encoding, int level,
+                       const Body& body) {
+  Partition* partition = getPartition(encoding);
+
+  if (partition == NULL) {
+    return;
+  }
+
+  const std::string key = getKey(validator, level);
+  const size_t size = body->size() + key.size() + NODE_OVERHEAD;
+  ScopedLock lock(&partition->lock);
+
+  if (size > partition->capacity) {
+    return;
+  }
+
+  const NodeMap::iterator it = partition->nodes.find(key);
+
+  if (it != partition->nodes.end()) {
+    erase(*partition, it->second);
+  }
+
+  while ((partition->size + size > partition->capacity)
+         && (partition->oldest != NULL)) {
+    erase(*partition, partition->oldest);
+  }
+
+  Node* node = new Node();
+  node->key = key;
+  node->body = body;
+  node->older = partition->newest;
+  node->newer = NULL;
+
+  if (partition->newest != NULL) {
+    partition->newest->newer = node;
+  } else {
+    partition->oldest = node;
+  }
+
+  partition->newest = node;
+  partition->nodes[key] = node;
+  partition->size += size;
+}
+
+void EncodedCache::setCapacity(const std::string& encoding,
+                               size_t capacity) {
+  Partition* partition = getPartition(encoding);
+
+  if (partition == NULL) {
+    return;
+  }
+
+  ScopedLock lock(&partition->lock);
+  partition->capacity = capacity;
+
+  while ((partition->size > capacity) && (partition->oldest != NULL)) {
+    erase(*partition, partition->oldest);
+  }
+}
+
+void EncodedCache::erase(Partition& partition, Node* node) {
+  if (node->older != NULL) {
+    node->older->newer = node->newer;
+  } else {
+    partition.oldest = node->newer;
+  }
+
+  if (node->newer != NULL) {
+    node->newer->older = node->older;
+  } else {
+    partition.newest = node->older;
+  }
+
+  partition.size -= node->body->size() + node->key.size() + NODE_OVERHEAD;
+  partition.nodes.erase(node->key);
+  delete node;
+}
+
+EncodedCache::Partition* EncodedCache::getPartition(
+    const std::string& encoding) {
+  // The map is never modified after construction
+  const PartitionMap::const_iterator it = partitions.find(encoding);
+  return (it == partitions.end()) ? NULL : it->second;
+}
+
+std::string EncodedCache::getKey(const std::string& validator, int level) {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), "\n%d", level);
+  return validator + suffix;
+}
+
+const std::string EncodedCache::ATTRIBUTE(
+    "echo.engine.application.EncodedCache");
+const size_t EncodedCache::DEFAULT_CAPACITY(16 * 1024 * 1024);
+
+} // namespace application
+} // namespace engine
+} // namespace echo
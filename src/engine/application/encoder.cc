@@ -0,0 +1,300 @@
+#include <echo/engine/application/encoder.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <list>
+
+#include <echo/data/digest.h>
+#include <echo/data/dimension.h>
+#include <echo/data/tag.h>
+#include <echo/engine/application/cached-response.h>
+#include <echo/engine/io/deflating-source.h>
+#include <echo/engine/util/chunk-stream.h>
+#include <echo/engine/util/deflater.h>
+#include <echo/representation/appendable-representation.h>
+#include <echo/representation/chunk-stream-representation.h>
+#include <echo/representation/source-representation.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+using echo::engine::io::DeflatingSource;
+using echo::engine::util::ChunkStream;
+using echo::engine::util::Deflater;
+using echo::representation::AppendableRepresentation;
+using echo::representation::ChunkStreamRepresentation;
+using echo::representation::SharedRepresentation;
+using echo::representation::SourceRepresentation;
+
+/**
+ * Indicates if the content of a media type is worth compressing.
+ */
+static bool isCompressible(const std::string& mediaType) {
+  if (mediaType.compare(0, 6, "image/") == 0) {
+    return mediaType == "image/svg+xml";
+  }
+
+  // Arbitrary binary content is most often already compressed
+  return (mediaType.compare(0, 6, "audio/") != 0)
+         && (mediaType.compare(0, 6, "video/") != 0)
+         && (mediaType != "application/octet-stream")
+         && (mediaType != "application/zip")
+         && (mediaType != "application/gzip")
+         && (mediaType != "application/x-gzip");
+}
+
+/**
+ * Returns the chunk stream of a streamed entity.
+ */
+static ChunkStream* getChunkStream(Representation entity) {
+  if (entity instanceof ChunkStreamRepresentation) {
+    return &((ChunkStreamRepresentation) entity).getChunkStream();
+  } else if (entity instanceof AppendableRepresentation) {
+    return ((AppendableRepresentation) entity).getStream();
+  }
+
+  return NULL;
+}
+
+Encoder::Encoder(echo::Context context, Echo::Echo next) {
+  Filter(context, next);
+  this->cache = EncodedCache::getCache(context);
+  this->level = Deflater::DEFAULT_LEVEL;
+  this->minimumSize = DEFAULT_MINIMUM_SIZE;
+
+  if (this->cache == NULL) {
+    this->cache = new EncodedCache();
+
+    if (context != NULL) {
+      EncodedCache::setCache(context, this->cache);
+    }
+  }
+}
+
+void Encoder::afterHandle(echo::Request request, echo::Response response) {
+  const Representation entity = response.getEntity();
+
+  // A range of the identity content can't be re-encoded as a whole
+  if ((response.getStatus().getCode() == 206) || !canEncode(entity)) {
+    return;
+  }
+
+  // Whether encoded or not, the entity depends on "Accept-Encoding"
+  response.getDimensions().add(ENCODING);
+  const Encoding encoding = getEncoding(request);
+
+  if (encoding == NULL) {
+    return;
+  }
+
+  if (Encoding::GZIP.equals(encoding)
+      && (entity instanceof FileRepresentation)) {
+    const Representation sibling = getSibling((FileRepresentation) entity);
+
+    if (sibling != NULL) {
+      response.setEntity(sibling);
+      return;
+    }
+  }
+
+  if (Encoding::GZIP.equals(encoding)
+      && (entity instanceof AssetRepresentation)) {
+    const Representation variant =
+        ((AssetRepresentation) entity).getGzipVariant();
+
+    if (variant != NULL) {
+      setMetadata(entity, variant, Encoding::GZIP);
+      response.setEntity(variant);
+      return;
+    }
+  }
+
+  const bool gzip = Encoding::GZIP.equals(encoding);
+
+  // Streamed entities are compressed as they are produced
+  if (entity instanceof SourceRepresentation) {
+    const Representation result = new SourceRepresentation(
+        entity.getMediaType(),
+        new DeflatingSource(((SourceRepresentation) entity).getSource(), gzip,
+                            level),
+        true);
+    setMetadata(entity, result, encoding);
+    response.setEntity(result);
+    return;
+  }
+
+  ChunkStream* stream = getChunkStream(entity);
+
+  if (stream != NULL) {
+    // The stream is compressed in place, the entity keeps its other metadata
+    if (stream->deflate(gzip, level)) {
+      setMetadata(entity, entity, encoding);
+      entity.setSize(Representation::UNKNOWN_SIZE);
+    }
+
+    return;
+  }
+
+  // The same content is encoded once per coding and level
+  const std::string validator = getValidator(request, entity);
+
+  if (!validator.empty()) {
+    const EncodedCache::Body body = cache->get(validator, encoding.getName(),
+                                               level);
+
+    if (body) {
+      entity.release();
+      response.setEntity(createEntity(entity, body, encoding));
+      return;
+    }
+  }
+
+  std::string content = entity.getText();
+  std::string* output = new std::string();
+
+  // The bodies are moved into shared buffers, which the cache and the
+  // responses reference without copying
+  if ((static_cast<long long>(content.size()) >= minimumSize)
+      && Deflater::encode(gzip, level,
+                          content.data(), content.size(), *output)
+      && (output->size() < content.size())) {
+    const EncodedCache::Body body(output);
+    response.setEntity(createEntity(entity, body, encoding));
+
+    if (!validator.empty()) {
+      cache->put(validator, encoding.getName(), level, body);
+    }
+  } else {
+    // The entity was consumed, send its content instead
+    output->swap(content);
+    response.setEntity(createEntity(entity, EncodedCache::Body(output),
+                                    NULL));
+  }
+}
+
+bool Encoder::canEncode(Representation entity) {
+  if ((entity == NULL) || !entity.isAvailable()
+      || (entity.getMediaType() == NULL)
+      || !isCompressible(entity.getMediaType().getName())) {
+    return false;
+  }
+
+  for (Encoding encoding : entity.getEncodings()) {
+    if (!Encoding::IDENTITY.equals(encoding)) {
+      return false;
+    }
+  }
+
+  // Streamed entities are compressed chunk by chunk, whatever their size,
+  // the others are read whole
+  if ((entity instanceof SourceRepresentation)
+      || (getChunkStream(entity) != NULL)) {
+    return true;
+  }
+
+  return CachedResponse::isCapturable(entity, SIZE_MAX)
+         && (entity.getSize() >= minimumSize);
+}
+
+Encoding Encoder::getEncoding(echo::Request request) {
+  std::list<Encoding> supported;
+  supported.push_back(Encoding::GZIP);
+  supported.push_back(Encoding::DEFLATE);
+  supported.push_back(Encoding::IDENTITY);
+
+  const Encoding result = request.getClientInfo().getPreferredEncoding(
+      supported);
+  return ((result == NULL) || Encoding::IDENTITY.equals(result)) ? NULL
+         : result;
+}
+
+Representation Encoder::createEntity(Representation entity,
+                                     const EncodedCache::Body& content,
+                                     Encoding encoding) {
+  Representation result = new SharedRepresentation(content,
+                                                   entity.getMediaType());
+  setMetadata(entity, result, encoding);
+  return result;
+}
+
+std::string Encoder::getValidator(echo::Request request,
+                                  Representation entity) {
+  const Digest digest = entity.getDigest();
+
+  if (digest != NULL) {
+    // A digest identifies the content wherever it comes from
+    std::string result = digest.getAlgorithm() + ":";
+    const byte[] value = digest.getValue();
+    char hex[3];
+
+    for (int i = 0; i < value.length; i++) {
+      snprintf(hex, sizeof(hex), "%02x", value[i] & 0xff);
+      result.append(hex, 2);
+    }
+
+    return result;
+  }
+
+  // A strong tag only identifies the content of its own resource
+  const Tag tag = entity.getTag();
+
+  if ((tag != NULL) && !tag.isWeak()) {
+    return "tag:" + request.getResourceRef().toString() + "\n"
+           + tag.getName();
+  }
+
+  return "";
+}
+
+Representation Encoder::getSibling(FileRepresentation entity) {
+  const std::string path = entity.getFile().getPath();
+  const std::string siblingPath = path + ".gz";
+  struct stat original;
+  struct stat sibling;
+
+  if ((stat(path.c_str(), &original) != 0)
+      || (stat(siblingPath.c_str(), &sibling) != 0)
+      || !S_ISREG(sibling.st_mode) || (sibling.st_mtime < original.st_mtime)) {
+    return NULL;
+  }
+
+  FileRepresentation result = new FileRepresentation(siblingPath,
+                                                     entity.getMediaType());
+  setMetadata(entity, result, Encoding::GZIP);
+  return result;
+}
+
+void Encoder::setMetadata(Representation entity, Representation result,
+                          Encoding encoding) {
+  result.setCharacterSet(entity.getCharacterSet());
+  result.setLanguages(entity.getLanguages());
+  result.setModificationDate(entity.getModificationDate());
+  result.setExpirationDate(entity.getExpirationDate());
+
+  if (encoding == NULL) {
+    result.setEncodings(entity.getEncodings());
+    result.setTag(entity.getTag());
+    return;
+  }
+
+  std::list<Encoding> encodings;
+  encodings.push_back(encoding);
+  result.setEncodings(encodings);
+
+  // The encoded variant isn't byte-for-byte identical to the original one
+  const Tag tag = entity.getTag();
+
+  if (tag != NULL) {
+    result.setTag(tag.isWeak() ? tag
+                  : new Tag(tag.getName() + "-" + encoding.getName(), false));
+  }
+}
+
+const long long Encoder::DEFAULT_MINIMUM_SIZE(1024);
+
+} // namespace application
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,325 @@
+#include <echo/engine/application/response-cache.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <list>
+#include <new>
+
+#include <echo/data/client-info.h>
+#include <echo/data/dimension.h>
+#include <echo/data/preference.h>
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace application {
+
+using echo::engine::util::ScopedLock;
+
+/**
+ * Appends the preferences of a dimension to a variant key.
+ */
+template <typename T>
+static void appendPreferences(std::string& key,
+                              std::list<Preference<T> > preferences) {
+  key += '\n';
+
+  for (typename std::list<Preference<T> >::iterator it = preferences.begin();
+       it != preferences.end(); ++it) {
+    key += it->toString();
+    key += ',';
+  }
+}
+
+ResponseCache* ResponseCache::getCache(Context context) {
+  return (context == NULL) ? NULL
+         : (ResponseCache*) context.getAttributes().get(ATTRIBUTE);
+}
+
+void ResponseCache::setCache(Context context, ResponseCache* cache) {
+  context.getAttributes().put(ATTRIBUTE, cache);
+}
+
+std::string ResponseCache::getVariantKey(echo::Request request,
+                                         const std::string& primaryKey,
+                                         int variance) {
+  std::string result = primaryKey;
+
+  if (variance == 0) {
+    return result;
+  }
+
+  ClientInfo clientInfo = request.getClientInfo();
+
+  if (variance & (1 << MEDIA_TYPE)) {
+    appendPreferences(result, clientInfo.getAcceptedMediaTypes());
+  }
+
+  if (variance & (1 << CHARACTER_SET)) {
+    appendPreferences(result, clientInfo.getAcceptedCharacterSets());
+  }
+
+  if (variance & (1 << ENCODING)) {
+    appendPreferences(result, clientInfo.getAcceptedEncodings());
+  }
+
+  if (variance & (1 << LANGUAGE)) {
+    appendPreferences(result, clientInfo.getAcceptedLanguages());
+  }
+
+  if (variance & (1 << CLIENT_AGENT)) {
+    result += '\n';
+
+    if (clientInfo.getAgent() != NULL) {
+      result += clientInfo.getAgent();
+    }
+  }
+
+  return result;
+}
+
+ResponseCache::ResponseCache() {
+  this->capacity = DEFAULT_CAPACITY;
+  initialize();
+}
+
+ResponseCache::ResponseCache(size_t capacity) {
+  this->capacity = capacity;
+  initialize();
+}
+
+ResponseCache::~ResponseCache() {
+  for (int i = 0; i < SHARDS; i++) {
+    Shard& shard = shards[i];
+
+    for (NodeMap::iterator it = shard.nodes.begin(); it != shard.nodes.end();
+         ++it) {
+      delete it->second;
+    }
+
+    pthread_mutex_destroy(&shard.lock);
+    shard.~Shard();
+  }
+
+  free(shards);
+}
+
+void ResponseCache::initialize() {
+  void* memory = NULL;
+
+  // The shards must not share cache lines, which operator new[] doesn't
+  // guarantee for over-aligned types
+  if (posix_memalign(&memory, __alignof__(Shard), SHARDS * sizeof(Shard))
+      != 0) {
+    throw std::bad_alloc();
+  }
+
+  this->shards = static_cast<Shard*>(memory);
+  this->shardCapacity = capacity / SHARDS;
+
+  for (int i = 0; i < SHARDS; i++) {
+    Shard* shard = new (&shards[i]) Shard();
+    pthread_mutex_init(&shard->lock, NULL);
+    shard->oldest = NULL;
+    shard->newest = NULL;
+    shard->size = 0;
+  }
+}
+
+ResponseCache::Entry ResponseCache::get(const std::string& primaryKey,
+                                        const std::string& key, time_t now) {
+  Shard& shard = getShard(primaryKey);
+  ScopedLock lock(&shard.lock);
+  const NodeMap::iterator it = shard.nodes.find(key);
+
+  if (it == shard.nodes.end()) {
+    return Entry();
+  }
+
+  Node* node = it->second;
+
+  if (!node->entry->isFresh(now)) {
+    erase(shard, node);
+    return Entry();
+  }
+
+  // Move the node to the most recently used end
+  if (node != shard.newest) {
+    if (node->older != NULL) {
+      node->older->newer = node->newer;
+    } else {
+      shard.oldest = node->newer;
+    }
+
+    node->newer->older = node->older;
+    node->older = shard.newest;
+    node->newer = NULL;
+    shard.newest->newer = node;
+    shard.newest = node;
+  }
+
+  return node->entry;
+}
+
+size_t ResponseCache::getSize() {
+  size_t result = 0;
+
+  for (int i = 0; i < SHARDS; i++) {
+    ScopedLock lock(&shards[i].lock);
+    result += shards[i].size;
+  }
+
+  return result;
+}
+
+bool ResponseCache::getVariance(const std::string& primaryKey,
+                                int& variance) {
+  Shard& shard = getShard(primaryKey);
+  ScopedLock lock(&shard.lock);
+  const ResourceMap::const_iterator it = shard.resources.find(primaryKey);
+
+  if (it == shard.resources.end()) {
+    return false;
+  }
+
+  variance = it->second.variance;
+  return true;
+}
+
+void ResponseCache::put(const std::string& primaryKey, int variance,
+                        const std::string& key, const Entry& entry) {
+  if (entry->getSize() > shardCapacity) {
+    return;
+  }
+
+  Shard& shard = getShard(primaryKey);
+  ScopedLock lock(&shard.lock);
+  ResourceMap::iterator resource = shard.resources.find(primaryKey);
+
+  // Variants cached with a former variance are no longer reachable
+  if ((resource != shard.resources.end())
+      && (resource->second.variance != variance)) {
+    erase(shard, primaryKey);
+    resource = shard.resources.end();
+  }
+
+  const NodeMap::iterator it = shard.nodes.find(key);
+
+  if (it != shard.nodes.end()) {
+    erase(shard, it->second);
+    resource = shard.resources.find(primaryKey);
+  }
+
+  while ((shard.size + entry->getSize() > shardCapacity)
+         && (shard.oldest != NULL)) {
+    const bool sameResource = (shard.oldest->primaryKey == primaryKey);
+    erase(shard, shard.oldest);
+
+    if (sameResource) {
+      resource = shard.resources.find(primaryKey);
+    }
+  }
+
+  if (resource == shard.resources.end()) {
+    resource = shard.resources.insert(
+        std::make_pair(primaryKey, Resource())).first;
+    resource->second.variance = variance;
+  }
+
+  resource->second.keys.push_back(key);
+
+  Node* node = new Node();
+  node->key = key;
+  node->primaryKey = primaryKey;
+  node->entry = entry;
+  node->older = shard.newest;
+  node->newer = NULL;
+
+  if (shard.newest != NULL) {
+    shard.newest->newer = node;
+  } else {
+    shard.oldest = node;
+  }
+
+  shard.newest = node;
+  shard.nodes[key] = node;
+  shard.size += entry->getSize();
+}
+
+void ResponseCache::remove(const std::string& primaryKey) {
+  Shard& shard = getShard(primaryKey);
+  ScopedLock lock(&shard.lock);
+  erase(shard, primaryKey);
+}
+
+void ResponseCache::erase(Shard& shard, Node* node) {
+  if (node->older != NULL) {
+    node->older->newer = node->newer;
+  } else {
+    shard.oldest = node->newer;
+  }
+
+  if (node->newer != NULL) {
+    node->newer->older = node->older;
+  } else {
+    shard.newest = node->older;
+  }
+
+  const ResourceMap::iterator resource = shard.resources.find(
+      node->primaryKey);
+
+  if (resource != shard.resources.end()) {
+    std::vector<std::string>& keys = resource->second.keys;
+    keys.erase(std::find(keys.begin(), keys.end(), node->key));
+
+    if (keys.empty()) {
+      shard.resources.erase(resource);
+    }
+  }
+
+  shard.size -= node->entry->getSize();
+  shard.nodes.erase(node->key);
+  delete node;
+}
+
+void ResponseCache::erase(Shard& shard, const std::string& primaryKey) {
+  const ResourceMap::iterator resource = shard.resources.find(primaryKey);
+
+  if (resource == shard.resources.end()) {
+    return;
+  }
+
+  // Erasing the last variant also erases the resource
+  const std::vector<std::string> keys = resource->second.keys;
+
+  for (std::vector<std::string>::const_iterator it = keys.begin();
+       it != keys.end(); ++it) {
+    const NodeMap::iterator node = shard.nodes.find(*it);
+
+    if (node != shard.nodes.end()) {
+      erase(shard, node->second);
+    }
+  }
+}
+
+ResponseCache::Shard& ResponseCache::getShard(const std::string& primaryKey) {
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+
+  for (std::string::size_type i = 0; i < primaryKey.size(); i++) {
+    hash = (hash ^ static_cast<unsigned char>(primaryKey[i])) * 16777619u;
+  }
+
+  return shards[(hash ^ (hash >> 16)) & (SHARDS - 1)];
+}
+
+const std::string ResponseCache::ATTRIBUTE(
+    "echo.engine.application.ResponseCache");
+const size_t ResponseCache::DEFAULT_CAPACITY(64 * 1024 * 1024);
+const int ResponseCache::SHARDS(16);
+
+} // namespace application
+} // namespace engine
+} // namespace echo
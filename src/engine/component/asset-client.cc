@@ -0,0 +1,44 @@
+#include <echo/engine/component/asset-client.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+using echo::data::LocalReference;
+using echo::data::Method;
+using echo::data::Protocol;
+using echo::representation::AssetRepresentation;
+
+AssetClient::AssetClient(echo::Context context) {
+  std::list<Protocol> protocols;
+  protocols.push_back(Protocol::CLAP);
+  protocols.push_back(Protocol::JAR);
+  protocols.push_back(Protocol::ZIP);
+  Connector(context, protocols);
+}
+
+void AssetClient::handle(echo::Request request, echo::Response response) {
+  const Method method = request.getMethod();
+
+  if (!Method::GET.equals(method) && !Method::HEAD.equals(method)) {
+    response.getAllowedMethods().insert(Method::GET);
+    response.getAllowedMethods().insert(Method::HEAD);
+    response.setStatus(Status.CLIENT_ERROR_METHOD_NOT_ALLOWED);
+    return;
+  }
+
+  const AssetRepresentation entity = AssetRepresentation::create(
+      new LocalReference(request.getResourceRef()));
+
+  if (entity == NULL) {
+    response.setStatus(Status.CLIENT_ERROR_NOT_FOUND);
+    return;
+  }
+
+  response.setEntity(entity);
+  response.setStatus(Status.SUCCESS_OK);
+}
+
+} // namespace component
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,301 @@
+#include <echo/engine/component/host-index.h>
+
+#include <limits.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+/** The pattern matching all the values. */
+static const std::string MATCH_ALL(".*");
+
+/**
+ * Returns a lower-cased copy of a value.
+ */
+static std::string toLowerCase(const std::string& value) {
+  std::string result(value);
+  std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+  return result;
+}
+
+/**
+ * Indicates if a character can end or start a label of a domain name.
+ */
+static bool isLabelCharacter(char c) {
+  return std::isalnum((unsigned char) c) || (c == '-');
+}
+
+/**
+ * Formats a port number.
+ */
+static std::string toString(int port) {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%d", port);
+  return std::string(buffer);
+}
+
+HostIndex::HostIndex() {
+  count = 0;
+  suffixes = new Node();
+}
+
+HostIndex::~HostIndex() {
+  clear();
+  delete suffixes;
+}
+
+void HostIndex::add(echo::routing::VirtualHost host,
+                    echo::routing::Route route) {
+  const int order = count++;
+  std::string domain;
+  std::string scheme;
+  std::string port;
+
+  // Only the hosts constraining nothing but the hostRef can be indexed
+  const bool indexable = (host.getResourceDomain() == MATCH_ALL)
+                         && (host.getResourcePort() == MATCH_ALL)
+                         && (host.getResourceScheme() == MATCH_ALL)
+                         && (host.getServerAddress() == MATCH_ALL)
+                         && (host.getServerPort() == MATCH_ALL)
+                         && ((host.getHostScheme() == MATCH_ALL)
+                             || isLiteral(host.getHostScheme(), scheme))
+                         && ((host.getHostPort() == MATCH_ALL)
+                             || isLiteral(host.getHostPort(), port));
+
+  if (indexable) {
+    Entry entry;
+    entry.order = order;
+    entry.scheme = toLowerCase(scheme);
+    entry.port = port;
+    entry.route = route;
+
+    if (isLiteral(host.getHostDomain(), domain)) {
+      exact[toLowerCase(domain)].push_back(entry);
+      return;
+    }
+
+    if (isWildcardSuffix(host.getHostDomain(), domain)) {
+      Node* node = suffixes;
+      std::string labels = toLowerCase(domain);
+      std::string::size_type end = labels.size();
+
+      // Walk the labels from the top-level domain down
+      while (end != std::string::npos) {
+        const std::string::size_type dot = labels.rfind('.', end - 1);
+        const std::string::size_type start = (dot == std::string::npos) ? 0
+                                             : dot + 1;
+        const std::string label = labels.substr(start, end - start);
+        Node*& child = node->children[label];
+
+        if (child == NULL) {
+          child = new Node();
+        }
+
+        node = child;
+        end = (dot == std::string::npos) ? std::string::npos : dot;
+      }
+
+      node->entries.push_back(entry);
+      return;
+    }
+  }
+
+  // Fallback on the regular expressions of the virtual host
+  PatternEntry* entry = new PatternEntry();
+  entry->order = order;
+  entry->route = route;
+
+  if (compile(&entry->host[0], host.getHostDomain())
+      && compile(&entry->host[1], host.getHostPort())
+      && compile(&entry->host[2], host.getHostScheme())
+      && compile(&entry->resource[0], host.getResourceDomain())
+      && compile(&entry->resource[1], host.getResourcePort())
+      && compile(&entry->resource[2], host.getResourceScheme())
+      && compile(&entry->server[0], host.getServerAddress())
+      && compile(&entry->server[1], host.getServerPort())) {
+    patterns.push_back(entry);
+  } else {
+    echo::Context::getCurrentLogger().warning(
+        "Unable to compile the patterns of the virtual host "
+        + host.getName() + ". The host will never be selected.");
+    delete entry;
+  }
+}
+
+void HostIndex::clear() {
+  for (std::vector<PatternEntry*>::iterator it = patterns.begin();
+       it != patterns.end(); ++it) {
+    for (int i = 0; i < 3; i++) {
+      regfree(&(*it)->host[i]);
+      regfree(&(*it)->resource[i]);
+    }
+
+    regfree(&(*it)->server[0]);
+    regfree(&(*it)->server[1]);
+    delete *it;
+  }
+
+  patterns.clear();
+  exact.clear();
+  free(suffixes);
+  suffixes = new Node();
+  count = 0;
+}
+
+echo::routing::Route HostIndex::find(echo::Request request,
+                                     echo::Response response) {
+  echo::routing::Route result = null;
+  int bestOrder = INT_MAX;
+
+  // Without a Host header, the host values are empty as for VirtualHost,
+  // so that only the patterns accepting empty values match
+  const Reference hostRef = request.getHostRef();
+  const std::string rawDomain = (hostRef == null) ? ""
+                                : hostRef.getHostDomain();
+  const std::string rawScheme = (hostRef == null) ? "" : hostRef.getScheme();
+  const std::string domain = toLowerCase(rawDomain);
+  const std::string scheme = toLowerCase(rawScheme);
+  int hostPort = (hostRef == null) ? -1 : hostRef.getHostPort();
+
+  if ((hostPort == -1) && (hostRef != null)
+      && (hostRef.getSchemeProtocol() != null)) {
+    hostPort = hostRef.getSchemeProtocol().getDefaultPort();
+  }
+
+  const std::string port = (hostRef == null) ? "" : toString(hostPort);
+
+  // 1 - Exact domains
+  std::tr1::unordered_map<std::string, std::vector<Entry> >::const_iterator
+      literal = exact.find(domain);
+
+  if (literal != exact.end()) {
+    for (std::vector<Entry>::const_iterator it = literal->second.begin();
+         it != literal->second.end(); ++it) {
+      if (matches(*it, scheme, port)) {
+        result = it->route;
+        bestOrder = it->order;
+        break;
+      }
+    }
+  }
+
+  // 2 - Wildcard domain suffixes, a label must remain for the sub-domain
+  const Node* node = suffixes;
+  std::string::size_type end = domain.size();
+
+  while ((node != NULL) && (end != std::string::npos) && (end > 0)) {
+    const std::string::size_type dot = domain.rfind('.', end - 1);
+    const std::string::size_type start = (dot == std::string::npos) ? 0
+                                         : dot + 1;
+    std::map<std::string, Node*>::const_iterator child =
+        node->children.find(domain.substr(start, end - start));
+
+    node = (child == node->children.end()) ? NULL : child->second;
+    end = (dot == std::string::npos) ? std::string::npos : dot;
+
+    if ((node != NULL) && (end != std::string::npos)) {
+      for (std::vector<Entry>::const_iterator it = node->entries.begin();
+           (it != node->entries.end()) && (it->order < bestOrder); ++it) {
+        if (matches(*it, scheme, port)) {
+          result = it->route;
+          bestOrder = it->order;
+          break;
+        }
+      }
+    }
+  }
+
+  // 3 - Regular expressions, only those added before the current best
+  for (std::vector<PatternEntry*>::const_iterator it = patterns.begin();
+       (it != patterns.end()) && ((*it)->order < bestOrder); ++it) {
+    const PatternEntry* entry = *it;
+
+    if (matches(&entry->host[0], rawDomain)
+        && matches(&entry->host[1], port)
+        && matches(&entry->host[2], rawScheme)
+        && matches(&entry->resource[0],
+                   request.getResourceRef().getHostDomain())
+        && matches(&entry->resource[1],
+                   toString(request.getResourceRef().getHostPort()))
+        && matches(&entry->resource[2], request.getResourceRef().getScheme())
+        && matches(&entry->server[0], response.getServerInfo().getAddress())
+        && matches(&entry->server[1],
+                   toString(response.getServerInfo().getPort()))) {
+      result = entry->route;
+      break;
+    }
+  }
+
+  return result;
+}
+
+bool HostIndex::isLiteral(const std::string& pattern, std::string& value) {
+  value.clear();
+
+  for (std::string::size_type i = 0; i < pattern.size(); i++) {
+    const char c = pattern[i];
+
+    if (c == '\\') {
+      // Only escaped punctuation is a literal character
+      if ((i + 1 < pattern.size()) && std::ispunct(pattern[i + 1])) {
+        value += pattern[++i];
+      } else {
+        return false;
+      }
+    } else if ((c == '.') && (i > 0) && (i + 1 < pattern.size())
+               && isLabelCharacter(pattern[i - 1])
+               && isLabelCharacter(pattern[i + 1])) {
+      // A dot between labels is meant as the dot of a domain name
+      value += c;
+    } else if (std::strchr(".^$|?*+()[]{}", c) != NULL) {
+      return false;
+    } else {
+      value += c;
+    }
+  }
+
+  return !value.empty();
+}
+
+bool HostIndex::isWildcardSuffix(const std::string& pattern,
+                                 std::string& suffix) {
+  static const std::string PREFIX(".*\\.");
+
+  return (pattern.compare(0, PREFIX.size(), PREFIX) == 0)
+      && isLiteral(pattern.substr(PREFIX.size()), suffix);
+}
+
+bool HostIndex::compile(regex_t* regex, const std::string& pattern) {
+  // Host names are case insensitive, as in the literal tiers
+  const std::string anchored = "^(" + pattern + ")$";
+  return regcomp(regex, anchored.c_str(),
+                 REG_EXTENDED | REG_ICASE | REG_NOSUB) == 0;
+}
+
+bool HostIndex::matches(const regex_t* regex, const std::string& value) {
+  return regexec(regex, value.c_str(), 0, NULL, 0) == 0;
+}
+
+void HostIndex::free(Node* node) {
+  for (std::map<std::string, Node*>::iterator it = node->children.begin();
+       it != node->children.end(); ++it) {
+    free(it->second);
+  }
+
+  delete node;
+}
+
+bool HostIndex::matches(const Entry& entry, const std::string& scheme,
+                        const std::string& port) {
+  return (entry.scheme.empty() || (entry.scheme == scheme))
+      && (entry.port.empty() || (entry.port == port));
+}
+
+} // namespace component
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,69 @@
+#include <echo/engine/component/riap-client.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+using echo::data::LocalReference;
+using echo::data::Protocol;
+
+RiapClient::RiapClient(echo::Context context) {
+  std::list<Protocol> protocols;
+  protocols.push_back(Protocol::RIAP);
+  Connector(context, protocols);
+  this->componentRoot = NULL;
+  this->hostRoot = NULL;
+}
+
+void RiapClient::handle(echo::Request request, echo::Response response) {
+  const LocalReference resourceRef = new LocalReference(
+      request.getResourceRef());
+  const echo::Echo target = getTarget(resourceRef.getRiapAuthorityType());
+
+  if (target == NULL) {
+    getLogger().warning("No target for the internal call to "
+                        + resourceRef.toString());
+    response.setStatus(Status.CLIENT_ERROR_NOT_FOUND);
+    return;
+  }
+
+  // The routers of the target match the path after the authority
+  request.getResourceRef().setBaseRef(
+      "riap://" + resourceRef.getAuthority() + "/");
+  request.setProtocol(Protocol::RIAP);
+
+  // The callee updates the thread-local state of the caller, restored even
+  // if it throws
+  const CurrentState state;
+  target.handle(request, response);
+}
+
+echo::Echo RiapClient::getTarget(int authorityType) {
+  echo::Echo result = NULL;
+
+  switch (authorityType) {
+    case LocalReference::RIAP_APPLICATION: {
+      const echo::Application application = echo::Application::getCurrent();
+
+      if (application != NULL) {
+        result = application.getInboundRoot();
+      }
+
+      break;
+    }
+
+    case LocalReference::RIAP_COMPONENT:
+      result = componentRoot;
+      break;
+
+    case LocalReference::RIAP_HOST:
+      result = hostRoot;
+      break;
+  }
+
+  return result;
+}
+
+} // namespace component
+} // namespace engine
+} // namespace echo
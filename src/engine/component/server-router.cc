@@ -0,0 +1,57 @@
+#include <echo/engine/component/server-router.h>
+
+#include <stdio.h>
+
+namespace echo {
+namespace engine {
+namespace component {
+
+ServerRouter::ServerRouter(echo::Context context) {
+  Router(context);
+  setRoutingMode(MODE_CUSTOM);
+}
+
+echo::routing::Route ServerRouter::attach(echo::routing::VirtualHost host) {
+  echo::routing::Route result = createRoute("", host);
+  result.setMatchingMode(Template.MODE_STARTS_WITH);
+  getRoutes().add(result);
+  hosts.push_back(host);
+  hostRoutes.push_back(result);
+  return result;
+}
+
+void ServerRouter::start() throw (std::runtime_error) {
+  if (isStopped()) {
+    index.clear();
+
+    std::list<echo::routing::Route>::iterator route = hostRoutes.begin();
+    for (std::list<echo::routing::VirtualHost>::iterator host = hosts.begin();
+         host != hosts.end(); ++host, ++route) {
+      index.add(*host, *route);
+    }
+
+    if (getLogger().isLoggable(Level.FINE)) {
+      char count[16];
+      snprintf(count, sizeof(count), "%d", index.size());
+      getLogger().fine(std::string("Indexed ") + count + " virtual hosts.");
+    }
+
+    super.start();
+  }
+}
+
+void ServerRouter::stop() throw (std::runtime_error) {
+  if (isStarted()) {
+    super.stop();
+    index.clear();
+  }
+}
+
+echo::routing::Route ServerRouter::getCustom(echo::Request request,
+                                             echo::Response response) {
+  return index.find(request, response);
+}
+
+} // namespace component
+} // namespace engine
+} // namespace echo
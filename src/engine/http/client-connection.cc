@@ -0,0 +1,413 @@
+#include <echo/engine/http/client-connection.h>
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::io::EventLoop;
+
+/** The size of each read from the socket. */
+static const size_t READ_SIZE = 65536;
+
+/** The number of vectors given to each writev() call. */
+static const int VECTOR_SIZE = 16;
+
+ClientConnection::ClientConnection(EventLoop& loop, HostResolver& resolver,
+                                   const std::string& host, int port,
+                                   int timeout, int idleTimeout,
+                                   Listener* listener)
+    : loop(loop), resolver(resolver), host(host), port(port),
+      timeout(timeout), idleTimeout(idleTimeout), listener(listener),
+      state(RESOLVING), file(-1), inputOffset(0),
+      parser(MessageParser::RESPONSE), headReceived(false), keepAlive(true),
+      paused(false), timer(this) {
+}
+
+ClientConnection::~ClientConnection() {
+  loop.cancel(&timer);
+
+  if (file != -1) {
+    loop.remove(file);
+    ::close(file);
+  }
+
+  for (size_t i = 0; i < exchanges.size(); i++) {
+    exchanges[i]->fail(ECONNABORTED);
+  }
+}
+
+bool ClientConnection::canPipeline() const {
+  if ((state == CLOSED) || !keepAlive
+      || (exchanges.size() >= MAX_PIPELINED)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < exchanges.size(); i++) {
+    if (!exchanges[i]->isIdempotent()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ClientConnection::close(int error) {
+  if (state == CLOSED) {
+    return;
+  }
+
+  state = CLOSED;
+  self.reset();
+  loop.cancel(&timer);
+
+  if (file != -1) {
+    loop.remove(file);
+    ::close(file);
+    file = -1;
+  }
+
+  // A timed out server is likely to time out again
+  const bool retry = (error != ETIMEDOUT);
+
+  for (size_t i = 0; i < exchanges.size(); i++) {
+    const Exchange& exchange = exchanges[i];
+    const bool started = (i == 0)
+                         && (headReceived || (inputOffset < input.size()));
+
+    if (retry && !started && exchange->isIdempotent()
+        && (exchange->getAttempts() < MAX_ATTEMPTS)
+        && !exchange->isCancelled()) {
+      retries.push_back(exchange);
+    } else {
+      exchange->fail((error != 0) ? error : ECONNRESET);
+    }
+  }
+
+  exchanges.clear();
+  output.clear();
+  content.clear();
+  loop.post(new Disposal(this));
+}
+
+void ClientConnection::onResolved(
+    const std::vector<HostResolver::Address>& addresses, int error) {
+  if (state != RESOLVING) {
+    return;
+  }
+
+  if ((error != 0) || addresses.empty()) {
+    close(EHOSTUNREACH);
+    return;
+  }
+
+  this->addresses = addresses;
+  state = CONNECTING;
+  connectNext();
+}
+
+void ClientConnection::onReady(int file, int events) {
+  if (state == CONNECTING) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+
+    if ((getsockopt(file, SOL_SOCKET, SO_ERROR, &error, &length) != 0)
+        || (error != 0)) {
+      loop.remove(file);
+      ::close(file);
+      this->file = -1;
+      connectNext();
+      return;
+    }
+
+    state = CONNECTED;
+  }
+
+  if (((events & EventLoop::WRITABLE) != 0) && !flush()) {
+    return;
+  }
+
+  if ((events & (EventLoop::READABLE | EventLoop::CLOSED)) != 0) {
+    receive();
+  }
+
+  update();
+}
+
+void ClientConnection::open() {
+  self.reset(new HostResolver::Listener*(this));
+  resolver.resolve(loop, host, port, self);
+  update();
+}
+
+void ClientConnection::send(const Exchange& exchange) {
+  exchange->addAttempt();
+  exchanges.push_back(exchange);
+  output.append(exchange->getMessage());
+
+  if ((state == CONNECTED) && !flush()) {
+    return;
+  }
+
+  update();
+}
+
+void ClientConnection::connectNext() {
+  int error = ECONNREFUSED;
+
+  while (!addresses.empty()) {
+    const HostResolver::Address address = addresses.front();
+    addresses.erase(addresses.begin());
+
+    file = socket(address.address.ss_family,
+                  SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (file == -1) {
+      error = errno;
+      continue;
+    }
+
+    // The requests are written whole, don't delay the last segment
+    const int enabled = 1;
+    setsockopt(file, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+
+    if ((connect(file, (const struct sockaddr*) &address.address,
+                 address.length) == 0) || (errno == EINPROGRESS)) {
+      if (loop.add(file, EventLoop::WRITABLE, this)) {
+        state = CONNECTING;
+        update();
+        return;
+      }
+    }
+
+    error = errno;
+    ::close(file);
+    file = -1;
+  }
+
+  close(error);
+}
+
+bool ClientConnection::flush() {
+  while (output.getSize() > 0) {
+    struct iovec vectors[VECTOR_SIZE];
+    const int count = output.getVectors(vectors, VECTOR_SIZE);
+    const ssize_t written = writev(file, vectors, count);
+
+    if (written > 0) {
+      output.consume(written);
+    } else if ((written == -1) && (errno == EINTR)) {
+      continue;
+    } else if ((written == -1) && (errno == EAGAIN)) {
+      break;
+    } else {
+      close(errno);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ClientConnection::onTimeout() {
+  if (!paused) {
+    close(exchanges.empty() ? 0 : ETIMEDOUT);
+    return;
+  }
+
+  echo::engine::util::ChunkStream& body = exchanges.front()->getBody();
+
+  if (body.isAborted()) {
+    close(ECONNABORTED);
+    return;
+  }
+
+  if (body.isWritable()) {
+    paused = false;
+
+    if (!process()) {
+      return;
+    }
+  }
+
+  update();
+}
+
+bool ClientConnection::process() {
+  while (!exchanges.empty() && !paused) {
+    const Exchange exchange = exchanges.front();
+    const char* data = input.data() + inputOffset;
+    const size_t length = input.size() - inputOffset;
+
+    if (!headReceived) {
+      if (length == 0) {
+        break;
+      }
+
+      const ssize_t size = parser.parseHead(data, length);
+
+      if (size == 0) {
+        break;
+      }
+
+      if (size < 0) {
+        close(EPROTO);
+        return false;
+      }
+
+      inputOffset += size;
+      const int status = parser.getStatus();
+
+      // Interim responses precede the final one
+      if (status < 200) {
+        parser.reset();
+        continue;
+      }
+
+      exchange->setHead(parser);
+      parser.startBody(exchange->isHeadRequest() || (status == 204)
+                       || (status == 304));
+      keepAlive = keepAlive && parser.isKeepAlive();
+      headReceived = true;
+    }
+
+    if ((length > 0) && !parser.isBodyDone()) {
+      const ssize_t count = parser.parseBody(input.data() + inputOffset,
+                                             input.size() - inputOffset,
+                                             content);
+
+      if (count < 0) {
+        close(EPROTO);
+        return false;
+      }
+
+      inputOffset += count;
+    }
+
+    const bool done = parser.isBodyDone();
+
+    if ((content.getSize() > 0) || done) {
+      echo::engine::util::ChunkStream& body = exchange->getBody();
+
+      // The full chunks are handed over as they fill, the last one at the end
+      if (!body.offer(content, done)) {
+        if (body.isAborted()) {
+          close(ECONNABORTED);
+          return false;
+        }
+
+        paused = !done;
+      }
+    }
+
+    if (!done) {
+      break;
+    }
+
+    exchange->getBody().close();
+    exchanges.pop_front();
+    parser.reset();
+    headReceived = false;
+
+    if (!keepAlive) {
+      close(0);
+      return false;
+    }
+
+    listener->onReleased(this);
+
+    if (state == CLOSED) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ClientConnection::receive() {
+  // Drop the parsed bytes before they pile up
+  if (inputOffset == input.size()) {
+    input.clear();
+    inputOffset = 0;
+  } else if (inputOffset > READ_SIZE) {
+    input.erase(0, inputOffset);
+    inputOffset = 0;
+  }
+
+  const size_t size = input.size();
+  input.resize(size + READ_SIZE);
+  ssize_t count;
+
+  do {
+    count = ::read(file, &input[size], READ_SIZE);
+  } while ((count == -1) && (errno == EINTR));
+
+  input.resize(size + ((count > 0) ? count : 0));
+
+  if (count > 0) {
+    if (exchanges.empty()) {
+      // Nothing was requested
+      close(EPROTO);
+    } else {
+      process();
+    }
+  } else if (count == 0) {
+    // The end of the connection may delimit the body
+    if (headReceived && parser.finish()) {
+      exchanges.front()->getBody().offer(content, true);
+      exchanges.front()->getBody().close();
+      exchanges.pop_front();
+      headReceived = false;
+    }
+
+    close(ECONNRESET);
+  } else if (errno != EAGAIN) {
+    close(errno);
+  }
+}
+
+void ClientConnection::update() {
+  if (state == CLOSED) {
+    return;
+  }
+
+  if (state == CONNECTED) {
+    int events = paused ? 0 : EventLoop::READABLE;
+
+    if (output.getSize() > 0) {
+      events |= EventLoop::WRITABLE;
+    }
+
+    loop.modify(file, events);
+  }
+
+  if (paused) {
+    loop.schedule(&timer, PAUSE_CHECK);
+  } else {
+    loop.schedule(&timer, exchanges.empty() ? idleTimeout : timeout);
+  }
+}
+
+const size_t ClientConnection::MAX_PIPELINED(8);
+
+const int ClientConnection::MAX_ATTEMPTS(2);
+
+const int ClientConnection::RESOLVING(0);
+
+const int ClientConnection::CONNECTING(1);
+
+const int ClientConnection::CONNECTED(2);
+
+const int ClientConnection::CLOSED(3);
+
+const int ClientConnection::PAUSE_CHECK(10);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,129 @@
+#include <echo/engine/http/client-exchange.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::util::ChunkStream;
+using echo::engine::util::ScopedLock;
+
+ClientExchange::ClientExchange(std::string& message, bool idempotent,
+                               bool headRequest)
+    : state(WAITING), error(0), idempotent(idempotent),
+      headRequest(headRequest), attempts(0), status(0),
+      body(ChunkStream::DEFAULT_HIGH_WATER_MARK, false) {
+  // The waits are measured on the monotonic clock
+  pthread_condattr_t attributes;
+  pthread_condattr_init(&attributes);
+  pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&changed, &attributes);
+  pthread_condattr_destroy(&attributes);
+  this->message.swap(message);
+}
+
+ClientExchange::~ClientExchange() {
+  pthread_cond_destroy(&changed);
+  pthread_mutex_destroy(&lock);
+}
+
+bool ClientExchange::await(int timeout) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += timeout / 1000;
+  deadline.tv_nsec += (timeout % 1000) * 1000000L;
+
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  ScopedLock guard(&lock);
+  int result = 0;
+
+  while ((state == WAITING) && (result != ETIMEDOUT)) {
+    result = pthread_cond_timedwait(&changed, &lock, &deadline);
+  }
+
+  if (state == WAITING) {
+    error = ETIMEDOUT;
+  }
+
+  return state == RECEIVED;
+}
+
+void ClientExchange::cancel() {
+  {
+    ScopedLock guard(&lock);
+
+    if (state == WAITING) {
+      state = CANCELLED;
+    }
+  }
+
+  body.abort();
+}
+
+void ClientExchange::fail(int error) {
+  {
+    ScopedLock guard(&lock);
+
+    if (state == WAITING) {
+      this->state = FAILED;
+      this->error = error;
+      pthread_cond_broadcast(&changed);
+    }
+  }
+
+  body.abort();
+}
+
+int ClientExchange::getError() {
+  ScopedLock guard(&lock);
+  return error;
+}
+
+bool ClientExchange::isCancelled() {
+  ScopedLock guard(&lock);
+  return state == CANCELLED;
+}
+
+void ClientExchange::setHead(const MessageParser& parser) {
+  ScopedLock guard(&lock);
+
+  if (state != WAITING) {
+    return;
+  }
+
+  // The head is copied, the input buffer of the connection being reused
+  status = parser.getStatus();
+  reason = parser.getReason().toString();
+
+  const std::vector<MessageParser::Header>& received = parser.getHeaders();
+  headers.reserve(received.size());
+
+  for (size_t i = 0; i < received.size(); i++) {
+    headers.push_back(std::make_pair(received[i].name.toString(),
+                                     received[i].value.toString()));
+  }
+
+  state = RECEIVED;
+  pthread_cond_broadcast(&changed);
+}
+
+const int ClientExchange::WAITING(0);
+
+const int ClientExchange::RECEIVED(1);
+
+const int ClientExchange::FAILED(2);
+
+const int ClientExchange::CANCELLED(3);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
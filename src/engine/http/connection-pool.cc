@@ -0,0 +1,111 @@
+#include <echo/engine/http/connection-pool.h>
+
+#include <errno.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::io::EventLoop;
+
+ConnectionPool::ConnectionPool(EventLoop& loop, HostResolver& resolver,
+                               const std::string& host, int port,
+                               int maxConnections, int timeout,
+                               int idleTimeout)
+    : loop(loop), resolver(resolver), host(host), port(port),
+      maxConnections(maxConnections), timeout(timeout),
+      idleTimeout(idleTimeout) {
+}
+
+ConnectionPool::~ConnectionPool() {
+  for (std::list<ClientConnection*>::iterator i = connections.begin();
+       i != connections.end(); ++i) {
+    delete *i;
+  }
+
+  for (size_t i = 0; i < waiting.size(); i++) {
+    waiting[i]->fail(ECONNABORTED);
+  }
+}
+
+void ConnectionPool::onClosed(
+    ClientConnection* connection,
+    std::deque<ClientConnection::Exchange>& retries) {
+  connections.remove(connection);
+
+  // The retries go first, they were sent before the waiting exchanges
+  waiting.insert(waiting.begin(), retries.begin(), retries.end());
+  retries.clear();
+  delete connection;
+  dispatch();
+}
+
+void ConnectionPool::onReleased(ClientConnection* connection) {
+  connections.remove(connection);
+  connections.push_front(connection);
+  dispatch();
+}
+
+void ConnectionPool::submit(const ClientConnection::Exchange& exchange) {
+  waiting.push_back(exchange);
+  dispatch();
+}
+
+void ConnectionPool::dispatch() {
+  while (!waiting.empty()) {
+    const ClientConnection::Exchange exchange = waiting.front();
+
+    if (exchange->isCancelled()) {
+      waiting.pop_front();
+      continue;
+    }
+
+    ClientConnection* target = NULL;
+    ClientConnection* lightest = NULL;
+    int open = 0;
+
+    for (std::list<ClientConnection*>::iterator i = connections.begin();
+         i != connections.end(); ++i) {
+      ClientConnection* connection = *i;
+
+      if (!connection->isOpen()) {
+        continue;
+      }
+
+      open++;
+
+      if (connection->getPending() == 0) {
+        // The most recently used connection is the most likely to be alive
+        target = connection;
+        break;
+      }
+
+      if (connection->canPipeline()
+          && ((lightest == NULL)
+              || (connection->getPending() < lightest->getPending()))) {
+        lightest = connection;
+      }
+    }
+
+    if ((target == NULL) && (open < maxConnections)) {
+      target = new ClientConnection(loop, resolver, host, port, timeout,
+                                    idleTimeout, this);
+      connections.push_front(target);
+      target->open();
+    } else if ((target == NULL) && exchange->isIdempotent()) {
+      target = lightest;
+    }
+
+    if (target == NULL) {
+      // Waits for a connection to be released or closed
+      break;
+    }
+
+    waiting.pop_front();
+    target->send(exchange);
+  }
+}
+
+} // namespace http
+} // namespace engine
+} // namespace echo
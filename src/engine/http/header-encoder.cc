@@ -0,0 +1,482 @@
+#include <echo/engine/http/header-encoder.h>
+
+#include <stdio.h>
+
+#include <echo/engine/http/status-table.h>
+#include <echo/engine/util/chunk-buffer.h>
+#include <echo/engine/util/date-utils.h>
+#include <echo/engine/util/name-table.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::DateUtils;
+using echo::engine::util::NameTable;
+
+/** The size of the vectors given to writev(), the header block included. */
+static const int VECTOR_SIZE = 16;
+
+/** The number of dimensions. */
+static const int DIMENSIONS = TIME + 1;
+
+/** The number of "Content-Type" lines kept by each encoder. */
+static const size_t CONTENT_TYPE_LINES = 8;
+
+/**
+ * The cache directives without value whose combinations are serialized once,
+ * in the order of their lines.
+ */
+static const char* const CACHE_DIRECTIVES[] = {
+  "public", "private", "no-cache", "no-store", "no-transform",
+  "must-revalidate", "proxy-revalidate"
+};
+
+/** The number of cache directives whose combinations are serialized once. */
+static const int CACHE_DIRECTIVE_COUNT = 7;
+
+/**
+ * Serialized "Cache-Control" lines of all the combinations of the cache
+ * directives without value, indexed by the bitmask of the directives.
+ */
+struct CacheControlLines {
+
+  CacheControlLines() {
+    for (int i = 0; i < CACHE_DIRECTIVE_COUNT; i++) {
+      bits[i] = i;
+      names.add(CACHE_DIRECTIVES[i], &bits[i]);
+    }
+
+    names.build();
+
+    for (int mask = 1; mask < (1 << CACHE_DIRECTIVE_COUNT); mask++) {
+      std::string value;
+
+      for (int i = 0; i < CACHE_DIRECTIVE_COUNT; i++) {
+        if (mask & (1 << i)) {
+          if (!value.empty()) {
+            value += ", ";
+          }
+
+          value += CACHE_DIRECTIVES[i];
+        }
+      }
+
+      lines[mask] = "Cache-Control: " + value + "\r\n";
+    }
+  }
+
+  NameTable<int> names;
+
+  int bits[CACHE_DIRECTIVE_COUNT];
+
+  std::string lines[1 << CACHE_DIRECTIVE_COUNT];
+
+};
+
+/**
+ * Serialized "Vary" lines of all the sets of dimensions, indexed by the
+ * bitmask of the dimensions.
+ */
+struct VaryLines {
+
+  VaryLines() {
+    for (int mask = 1; mask < (1 << DIMENSIONS); mask++) {
+      std::string value;
+
+      // These dimensions can't be expressed with request headers
+      if (mask & ((1 << UNSPECIFIED) | (1 << CLIENT_ADDRESS) | (1 << TIME))) {
+        value = "*";
+      } else {
+        appendName(value, mask, MEDIA_TYPE, "Accept");
+        appendName(value, mask, CHARACTER_SET, "Accept-Charset");
+        appendName(value, mask, ENCODING, "Accept-Encoding");
+        appendName(value, mask, LANGUAGE, "Accept-Language");
+        appendName(value, mask, AUTHORIZATION, "Authorization");
+        appendName(value, mask, CLIENT_AGENT, "User-Agent");
+      }
+
+      lines[mask] = "Vary: " + value + "\r\n";
+    }
+  }
+
+  static void appendName(std::string& value, int mask, int dimension,
+                         const char* name) {
+    if (mask & (1 << dimension)) {
+      if (!value.empty()) {
+        value += ", ";
+      }
+
+      value += name;
+    }
+  }
+
+  std::string lines[1 << DIMENSIONS];
+
+};
+
+HeaderEncoder::HeaderEncoder(bool cgi) : cgi(cgi), nextContentType(0) {
+}
+
+void HeaderEncoder::add(const char* name, const std::string& value) {
+  buffer.append(name);
+  buffer.append(": ", 2);
+
+  // Line breaks in values would allow injecting headers
+  for (std::string::size_type i = 0; i < value.size(); i++) {
+    buffer += ((value[i] == '\r') || (value[i] == '\n')) ? ' ' : value[i];
+  }
+
+  buffer.append("\r\n", 2);
+}
+
+void HeaderEncoder::addCacheControl(std::list<CacheDirective> directives) {
+  static const CacheControlLines CACHE_CONTROL_LINES;
+  int mask = 0;
+  int last = -1;
+
+  // Lists of directives without value in the order of the serialized lines
+  // are copied, the others are formatted
+  for (std::list<CacheDirective>::iterator it = directives.begin();
+       it != directives.end(); ++it) {
+    const int* bit = (it->getValue() == NULL)
+                     ? CACHE_CONTROL_LINES.names.find(it->getName()) : NULL;
+
+    if ((bit == NULL) || (*bit <= last)) {
+      mask = 0;
+      break;
+    }
+
+    mask |= 1 << *bit;
+    last = *bit;
+  }
+
+  if (mask != 0) {
+    buffer += CACHE_CONTROL_LINES.lines[mask];
+    return;
+  }
+
+  value.clear();
+
+  for (std::list<CacheDirective>::iterator it = directives.begin();
+       it != directives.end(); ++it) {
+    if (!value.empty()) {
+      value.append(", ", 2);
+    }
+
+    value += it->getName();
+
+    if (it->getValue() != NULL) {
+      value += '=';
+      value += it->getValue();
+    }
+  }
+
+  add("Cache-Control", value);
+}
+
+void HeaderEncoder::addContentType(MediaType mediaType,
+                                   CharacterSet characterSet) {
+  for (size_t i = 0; i < contentTypes.size(); i++) {
+    if ((contentTypes[i].mediaType == mediaType)
+        && (contentTypes[i].characterSet == characterSet)) {
+      buffer += contentTypes[i].line;
+      return;
+    }
+  }
+
+  value = mediaType.toString();
+
+  if ((characterSet != NULL)
+      && mediaType.getParameters().getFirst("charset") == NULL) {
+    value.append("; charset=", 10);
+    value += characterSet.getName();
+  }
+
+  const std::string::size_type start = buffer.size();
+  add("Content-Type", value);
+
+  // The oldest line is replaced once all the lines are used
+  if (contentTypes.size() < CONTENT_TYPE_LINES) {
+    contentTypes.resize(contentTypes.size() + 1);
+  }
+
+  ContentTypeLine& entry = contentTypes[nextContentType];
+  entry.mediaType = mediaType;
+  entry.characterSet = characterSet;
+  entry.line.assign(buffer, start, std::string::npos);
+  nextContentType = (nextContentType + 1) % CONTENT_TYPE_LINES;
+}
+
+void HeaderEncoder::addDate(const char* name, Date date) {
+  buffer.append(name);
+  buffer.append(": ", 2);
+  DateUtils::append(buffer, date.getTime() / 1000);
+  buffer.append("\r\n", 2);
+}
+
+void HeaderEncoder::addNumber(const char* name, long long number) {
+  char digits[24];
+  const int length = snprintf(digits, sizeof(digits), "%lld", number);
+  buffer.append(name);
+  buffer.append(": ", 2);
+  buffer.append(digits, length);
+  buffer.append("\r\n", 2);
+}
+
+void HeaderEncoder::addRequestHeaders(Request request) {
+  const ClientInfo clientInfo = request.getClientInfo();
+
+  if (clientInfo.getAgent() != NULL) {
+    add("User-Agent", clientInfo.getAgent());
+  }
+
+  addPreferences("Accept", clientInfo.getAcceptedMediaTypes());
+  addPreferences("Accept-Charset", clientInfo.getAcceptedCharacterSets());
+  addPreferences("Accept-Encoding", clientInfo.getAcceptedEncodings());
+  addPreferences("Accept-Language", clientInfo.getAcceptedLanguages());
+
+  const ChallengeResponse challengeResponse = request.getChallengeResponse();
+
+  if ((challengeResponse != NULL)
+      && (challengeResponse.getRawValue() != NULL)) {
+    add("Authorization", challengeResponse.getScheme().getTechnicalName()
+                         + " " + challengeResponse.getRawValue());
+  }
+
+  value.clear();
+
+  for (Cookie cookie : request.getCookies()) {
+    if (!value.empty()) {
+      value.append("; ", 2);
+    }
+
+    value += cookie.getName();
+    value += '=';
+    value += cookie.getValue();
+  }
+
+  if (!value.empty()) {
+    add("Cookie", value);
+  }
+
+  const Conditions conditions = request.getConditions();
+  addTags("If-Match", conditions.getMatch());
+  addTags("If-None-Match", conditions.getNoneMatch());
+
+  if (conditions.getModifiedSince() != NULL) {
+    addDate("If-Modified-Since", conditions.getModifiedSince());
+  }
+
+  if (conditions.getUnmodifiedSince() != NULL) {
+    addDate("If-Unmodified-Since", conditions.getUnmodifiedSince());
+  }
+}
+
+void HeaderEncoder::addResponseHeaders(Response response) {
+  addStatus(response.getStatus());
+
+  buffer.append("Date: ", 6);
+  DateUtils::appendNow(buffer);
+  buffer.append("\r\n", 2);
+
+  addServer(response.getServerInfo());
+
+  if (response.getAge() > 0) {
+    addNumber("Age", response.getAge());
+  }
+
+  if (response.getLocationRef() != NULL) {
+    add("Location", response.getLocationRef().getTargetRef().toString());
+  }
+
+  if (!response.getAllowedMethods().empty()) {
+    value.clear();
+
+    for (std::set<Method>::iterator it = response.getAllowedMethods().begin();
+         it != response.getAllowedMethods().end(); ++it) {
+      if (!value.empty()) {
+        value.append(", ", 2);
+      }
+
+      value += it->getName();
+    }
+
+    add("Allow", value);
+  }
+
+  if (!response.getDimensions().empty()) {
+    addVary(response.getDimensions());
+  }
+
+  if (!response.getCacheDirectives().empty()) {
+    addCacheControl(response.getCacheDirectives());
+  }
+
+  for (std::list<Warning>::iterator it = response.getWarnings().begin();
+       it != response.getWarnings().end(); ++it) {
+    char code[8];
+    snprintf(code, sizeof(code), "%d ", it->getStatus().getCode());
+    value = code;
+    value += it->getAgent();
+    value.append(" \"", 2);
+    value += it->getText();
+    value += '"';
+    add("Warning", value);
+  }
+
+  for (CookieSetting cookieSetting : response.getCookieSettings()) {
+    add("Set-Cookie", cookieSetting.getHeaderValue());
+  }
+
+  const Representation entity = response.getEntity();
+
+  if ((entity != NULL) && entity.isAvailable()) {
+    if (entity.getMediaType() != NULL) {
+      addContentType(entity.getMediaType(), entity.getCharacterSet());
+    }
+
+    if (entity.getSize() != Representation::UNKNOWN_SIZE) {
+      addNumber("Content-Length", entity.getSize());
+    }
+
+    value.clear();
+
+    for (Encoding encoding : entity.getEncodings()) {
+      if (!encoding.equals(Encoding.IDENTITY)) {
+        if (!value.empty()) {
+          value.append(", ", 2);
+        }
+
+        value += encoding.getName();
+      }
+    }
+
+    if (!value.empty()) {
+      add("Content-Encoding", value);
+    }
+
+    value.clear();
+
+    for (Language language : entity.getLanguages()) {
+      if (!value.empty()) {
+        value.append(", ", 2);
+      }
+
+      value += language.getName();
+    }
+
+    if (!value.empty()) {
+      add("Content-Language", value);
+    }
+
+    if (entity.getTag() != NULL) {
+      add("ETag", entity.getTag().format());
+    }
+
+    if (entity.getModificationDate() != NULL) {
+      addDate("Last-Modified", entity.getModificationDate());
+    }
+
+    if (entity.getExpirationDate() != NULL) {
+      addDate("Expires", entity.getExpirationDate());
+    }
+  } else if (!response.getStatus().isInformational()
+             && (response.getStatus().getCode() != 204)
+             && (response.getStatus().getCode() != 304)) {
+    buffer.append("Content-Length: 0\r\n", 19);
+  }
+}
+
+void HeaderEncoder::addServer(ServerInfo serverInfo) {
+  if ((serverInfo != NULL) && (serverInfo.getAgent() != NULL)) {
+    // The agent of a connector doesn't change, its line is formatted once
+    if (serverLine.empty() || (serverInfo.getAgent() != serverAgent)) {
+      const std::string::size_type start = buffer.size();
+      add("Server", serverInfo.getAgent());
+      serverAgent = serverInfo.getAgent();
+      serverLine.assign(buffer, start, std::string::npos);
+    } else {
+      buffer += serverLine;
+    }
+  }
+}
+
+void HeaderEncoder::addStatus(echo::data::Status status) {
+  const StatusTable::Entry* entry = StatusTable::find(status.getCode());
+  const std::string reason = ((entry != NULL)
+                              && (status.getName() == entry->reason))
+                             ? std::string() : status.getName();
+
+  if (cgi) {
+    StatusTable::appendCgiLine(buffer, status.getCode(), reason);
+  } else {
+    StatusTable::appendHttpLine(buffer, status.getCode(), reason);
+  }
+}
+
+void HeaderEncoder::addVary(std::set<Dimension> dimensions) {
+  static const VaryLines VARY_LINES;
+  int mask = 0;
+
+  for (std::set<Dimension>::iterator it = dimensions.begin();
+       it != dimensions.end(); ++it) {
+    mask |= 1 << *it;
+  }
+
+  if (mask != 0) {
+    buffer += VARY_LINES.lines[mask];
+  }
+}
+
+void HeaderEncoder::addTags(const char* name, std::list<Tag> tags) {
+  value.clear();
+
+  for (std::list<Tag>::iterator it = tags.begin(); it != tags.end(); ++it) {
+    if (!value.empty()) {
+      value.append(", ", 2);
+    }
+
+    value += it->format();
+  }
+
+  if (!value.empty()) {
+    add(name, value);
+  }
+}
+
+ssize_t HeaderEncoder::write(int file, const struct iovec* chunks, int count) {
+  struct iovec vector[VECTOR_SIZE];
+  int last = 1;
+  int next = 0;
+  ssize_t result = 0;
+
+  vector[0].iov_base = const_cast<char*>(buffer.data());
+  vector[0].iov_len = buffer.size();
+
+  // The chunks which don't fit with the header block follow in as many
+  // writev() calls as needed, without allocating a larger vector
+  do {
+    while ((next < count) && (last < VECTOR_SIZE)) {
+      vector[last++] = chunks[next++];
+    }
+
+    const ssize_t written = ChunkBuffer::writeVectors(file, vector, last);
+
+    if (written == -1) {
+      return -1;
+    }
+
+    result += written;
+    last = 0;
+  } while (next < count);
+
+  return result;
+}
+
+const int HeaderEncoder::MAX_CHUNKS(VECTOR_SIZE - 1);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,102 @@
+#include <echo/engine/http/header-reader.h>
+
+#include <stdlib.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Returns a header value without the surrounding white spaces.
+ */
+static std::string trim(const std::string& value) {
+  const std::string::size_type first = value.find_first_not_of(" \t");
+
+  if (first == std::string::npos) {
+    return "";
+  }
+
+  return value.substr(first, value.find_last_not_of(" \t") - first + 1);
+}
+
+float HeaderReader::getQuality(const std::string& element,
+                               std::string& metadata) {
+  std::vector<std::string> parameters;
+  split(element, ';', parameters);
+  metadata.clear();
+  float result = 1;
+
+  for (size_t i = 0; i < parameters.size(); i++) {
+    std::string name;
+    std::string value;
+
+    if ((i > 0) && splitParameter(parameters[i], name, value)
+        && ((name == "q") || (name == "Q"))) {
+      char* end = NULL;
+      result = strtof(value.c_str(), &end);
+
+      if ((end == value.c_str()) || (*end != '\0') || (result < 0)
+          || (result > 1)) {
+        result = 0;
+      }
+
+      // The parameters following the quality are extensions of the element
+      break;
+    }
+
+    if (i > 0) {
+      metadata += ';';
+    }
+
+    metadata += parameters[i];
+  }
+
+  return result;
+}
+
+void HeaderReader::split(const std::string& value, char separator,
+                         std::vector<std::string>& elements) {
+  std::string::size_type start = 0;
+  bool quoted = false;
+
+  for (std::string::size_type i = 0; i <= value.size(); i++) {
+    if ((i == value.size()) || (!quoted && (value[i] == separator))) {
+      const std::string element = trim(value.substr(start, i - start));
+
+      if (!element.empty()) {
+        elements.push_back(element);
+      }
+
+      start = i + 1;
+    } else if (value[i] == '"') {
+      quoted = !quoted;
+    } else if (quoted && (value[i] == '\\') && (i + 1 < value.size())) {
+      i++;
+    }
+  }
+}
+
+bool HeaderReader::splitParameter(const std::string& parameter,
+                                  std::string& name, std::string& value) {
+  const std::string::size_type equal = parameter.find('=');
+
+  if (equal == std::string::npos) {
+    name = parameter;
+    value.clear();
+    return false;
+  }
+
+  name = trim(parameter.substr(0, equal));
+  value = trim(parameter.substr(equal + 1));
+
+  if ((value.size() >= 2) && (value[0] == '"')
+      && (value[value.size() - 1] == '"')) {
+    value = value.substr(1, value.size() - 2);
+  }
+
+  return true;
+}
+
+} // namespace http
+} // namespace engine
+} // namespace echo
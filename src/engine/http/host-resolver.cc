@@ -0,0 +1,221 @@
+#include <echo/engine/http/host-resolver.h>
+
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <echo/engine/util/scoped-lock.h>
+#include <echo/engine/util/timer-wheel.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::io::EventLoop;
+using echo::engine::util::ScopedLock;
+using echo::engine::util::TimerWheel;
+
+/**
+ * Resolves a name with getaddrinfo(), possibly blocking.
+ */
+static int lookup(const std::string& host, int port, int flags,
+                 std::vector<HostResolver::Address>& result) {
+  // A literal IPv6 address is bracketed in URIs
+  const std::string name = ((host.size() > 2) && (host[0] == '['))
+                           ? host.substr(1, host.size() - 2) : host;
+  struct addrinfo hints;
+  struct addrinfo* addresses = NULL;
+  char service[8];
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = flags | AI_NUMERICSERV;
+  snprintf(service, sizeof(service), "%d", port);
+
+  const int error = getaddrinfo(name.c_str(), service, &hints, &addresses);
+
+  if (error != 0) {
+    return error;
+  }
+
+  for (struct addrinfo* i = addresses; i != NULL; i = i->ai_next) {
+    HostResolver::Address address;
+    memcpy(&address.address, i->ai_addr, i->ai_addrlen);
+    address.length = i->ai_addrlen;
+    result.push_back(address);
+  }
+
+  freeaddrinfo(addresses);
+  return 0;
+}
+
+void HostResolver::Notification::run() {
+  const std::tr1::shared_ptr<Listener*> target = listener.lock();
+
+  if (target) {
+    (*target)->onResolved(addresses, error);
+  }
+}
+
+HostResolver::HostResolver(int threads, long long positiveTtl,
+                           long long negativeTtl)
+    : stopped(false), positiveTtl(positiveTtl), negativeTtl(negativeTtl) {
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&queued, NULL);
+
+  for (int i = 0; i < threads; i++) {
+    pthread_t thread;
+
+    if (pthread_create(&thread, NULL, run, this) == 0) {
+      this->threads.push_back(thread);
+    }
+  }
+}
+
+HostResolver::~HostResolver() {
+  {
+    ScopedLock guard(&lock);
+    stopped = true;
+    pthread_cond_broadcast(&queued);
+  }
+
+  for (size_t i = 0; i < threads.size(); i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&queued);
+  pthread_mutex_destroy(&lock);
+}
+
+void HostResolver::resolve(EventLoop& loop, const std::string& host,
+                           int port,
+                           const std::tr1::weak_ptr<Listener*>& listener) {
+  std::vector<Address> addresses;
+
+  if (lookup(host, port, AI_NUMERICHOST, addresses) == 0) {
+    loop.post(new Notification(listener, addresses, 0));
+    return;
+  }
+
+  char suffix[8];
+  snprintf(suffix, sizeof(suffix), ":%d", port);
+  const std::string key = host + suffix;
+  const long long now = TimerWheel::currentTimeMillis();
+  ScopedLock guard(&lock);
+  std::map<std::string, Entry>::iterator entry = entries.find(key);
+
+  if (entry == entries.end()) {
+    if (entries.size() >= MAX_ENTRIES) {
+      for (std::map<std::string, Entry>::iterator i = entries.begin();
+           i != entries.end();) {
+        if (!i->second.querying && (i->second.expiration <= now)) {
+          entries.erase(i++);
+        } else {
+          ++i;
+        }
+      }
+
+      // Still full of fresh entries, drop the first idle one
+      for (std::map<std::string, Entry>::iterator i = entries.begin();
+           (entries.size() >= MAX_ENTRIES) && (i != entries.end()); ++i) {
+        if (!i->second.querying) {
+          entries.erase(i);
+          break;
+        }
+      }
+    }
+
+    Entry created;
+    created.error = 0;
+    created.expiration = 0;
+    created.querying = false;
+    entry = entries.insert(std::make_pair(key, created)).first;
+  }
+
+  Entry& cached = entry->second;
+  const bool expired = (cached.expiration <= now);
+
+  if (!expired || ((cached.error == 0) && !cached.addresses.empty())) {
+    // A stale address is usually still valid, refreshing it costs no wait
+    loop.post(new Notification(listener, cached.addresses, cached.error));
+  } else {
+    Waiter waiter;
+    waiter.loop = &loop;
+    waiter.listener = listener;
+    cached.waiters.push_back(waiter);
+  }
+
+  if (expired && !cached.querying) {
+    cached.querying = true;
+    queries.push_back(key);
+    pthread_cond_signal(&queued);
+  }
+}
+
+int HostResolver::query(const std::string& host, int port,
+                        std::vector<Address>& addresses) {
+  return lookup(host, port, AI_ADDRCONFIG, addresses);
+}
+
+void* HostResolver::run(void* resolver) {
+  static_cast<HostResolver*>(resolver)->runQueries();
+  return NULL;
+}
+
+void HostResolver::runQueries() {
+  ScopedLock guard(&lock);
+
+  for (;;) {
+    while (!stopped && queries.empty()) {
+      pthread_cond_wait(&queued, &lock);
+    }
+
+    if (stopped) {
+      return;
+    }
+
+    const std::string key = queries.front();
+    queries.pop_front();
+
+    const size_t separator = key.rfind(':');
+    std::vector<Address> addresses;
+    int error;
+
+    pthread_mutex_unlock(&lock);
+    error = query(key.substr(0, separator),
+                  atoi(key.c_str() + separator + 1), addresses);
+    pthread_mutex_lock(&lock);
+
+    std::map<std::string, Entry>::iterator entry = entries.find(key);
+
+    if (entry == entries.end()) {
+      continue;
+    }
+
+    Entry& cached = entry->second;
+    cached.addresses = addresses;
+    cached.error = error;
+    cached.querying = false;
+    cached.expiration = TimerWheel::currentTimeMillis()
+                        + ((error == 0) ? positiveTtl : negativeTtl);
+
+    for (size_t i = 0; i < cached.waiters.size(); i++) {
+      cached.waiters[i].loop->post(new Notification(
+          cached.waiters[i].listener, addresses, error));
+    }
+
+    cached.waiters.clear();
+  }
+}
+
+const long long HostResolver::DEFAULT_POSITIVE_TTL(60000);
+
+const long long HostResolver::DEFAULT_NEGATIVE_TTL(5000);
+
+const size_t HostResolver::MAX_ENTRIES(4096);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,317 @@
+#include <echo/engine/http/http-client.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <vector>
+
+#include <echo/engine/http/header-encoder.h>
+#include <echo/engine/http/header-reader.h>
+#include <echo/engine/util/date-utils.h>
+#include <echo/representation/chunk-stream-representation.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::data::Method;
+using echo::data::Protocol;
+using echo::engine::io::EventLoop;
+using echo::engine::util::DateUtils;
+using echo::representation::ChunkStreamRepresentation;
+
+/** The number of threads resolving the host names. */
+static const int RESOLVER_THREADS = 2;
+
+/**
+ * Parses a date header, returning null if the date is invalid.
+ */
+static Date readDate(const std::string& value) {
+  time_t seconds;
+  return DateUtils::parse(value, seconds) ? new Date(seconds * 1000L) : null;
+}
+
+/**
+ * Parses a "Set-Cookie" header such as "id=42; Path=/; HttpOnly".
+ */
+static CookieSetting readCookieSetting(const std::string& value) {
+  std::vector<std::string> parameters;
+  HeaderReader::split(value, ';', parameters);
+
+  if (parameters.empty()) {
+    return null;
+  }
+
+  std::string name;
+  std::string content;
+  HeaderReader::splitParameter(parameters[0], name, content);
+  const CookieSetting result = new CookieSetting(name, content);
+
+  for (size_t i = 1; i < parameters.size(); i++) {
+    HeaderReader::splitParameter(parameters[i], name, content);
+
+    if (strcasecmp(name.c_str(), "Path") == 0) {
+      result.setPath(content);
+    } else if (strcasecmp(name.c_str(), "Domain") == 0) {
+      result.setDomain(content);
+    } else if (strcasecmp(name.c_str(), "Max-Age") == 0) {
+      result.setMaxAge(atoi(content.c_str()));
+    } else if (strcasecmp(name.c_str(), "Comment") == 0) {
+      result.setComment(content);
+    } else if (strcasecmp(name.c_str(), "Version") == 0) {
+      result.setVersion(atoi(content.c_str()));
+    } else if (strcasecmp(name.c_str(), "Secure") == 0) {
+      result.setSecure(true);
+    } else if (strcasecmp(name.c_str(), "HttpOnly") == 0) {
+      result.setAccessRestricted(true);
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Maps a response header describing the entity onto the entity.
+ */
+static void readEntityHeader(Representation entity, const std::string& name,
+                             const std::string& value) {
+  std::vector<std::string> elements;
+
+  if (strcasecmp(name.c_str(), "Content-Encoding") == 0) {
+    HeaderReader::split(value, ',', elements);
+
+    for (size_t i = 0; i < elements.size(); i++) {
+      entity.getEncodings().add(Encoding.valueOf(elements[i]));
+    }
+  } else if (strcasecmp(name.c_str(), "Content-Language") == 0) {
+    HeaderReader::split(value, ',', elements);
+
+    for (size_t i = 0; i < elements.size(); i++) {
+      entity.getLanguages().add(Language.valueOf(elements[i]));
+    }
+  } else if (strcasecmp(name.c_str(), "ETag") == 0) {
+    entity.setTag(Tag.parse(value));
+  } else if (strcasecmp(name.c_str(), "Last-Modified") == 0) {
+    entity.setModificationDate(readDate(value));
+  } else if (strcasecmp(name.c_str(), "Expires") == 0) {
+    entity.setExpirationDate(readDate(value));
+  }
+}
+
+HttpClient::HttpClient(echo::Context context) {
+  std::list<Protocol> protocols;
+  protocols.push_back(Protocol::HTTP);
+  Connector(context, protocols);
+  this->maxConnections = DEFAULT_MAX_CONNECTIONS;
+  this->timeout = DEFAULT_TIMEOUT;
+  this->idleTimeout = DEFAULT_IDLE_TIMEOUT;
+  this->loop = NULL;
+  this->resolver = NULL;
+}
+
+void HttpClient::handle(echo::Request request, echo::Response response) {
+  if (this->loop == NULL) {
+    response.setStatus(Status.CONNECTOR_ERROR_INTERNAL);
+    return;
+  }
+
+  const Reference resourceRef = request.getResourceRef();
+  const std::string host = resourceRef.getHostDomain();
+  const int port = (resourceRef.getHostPort() == -1)
+                   ? Protocol::HTTP.getDefaultPort()
+                   : resourceRef.getHostPort();
+  const Method method = request.getMethod();
+  std::string target = resourceRef.getPath();
+
+  if (target.empty()) {
+    target = "/";
+  }
+
+  if (resourceRef.getQuery() != null) {
+    target += "?" + resourceRef.getQuery();
+  }
+
+  // The head and the entity are written with a single call, the request
+  // being forwarded with its preferences, credentials, cookies and
+  // conditions
+  HeaderEncoder encoder(false);
+  encoder.add("Host", resourceRef.getAuthority());
+  encoder.addRequestHeaders(request);
+  std::string text;
+
+  if (request.isEntityAvailable()) {
+    text = request.getEntity().getText();
+
+    if (request.getEntity().getMediaType() != null) {
+      encoder.addContentType(request.getEntity().getMediaType(),
+                             request.getEntity().getCharacterSet());
+    }
+
+    encoder.addNumber("Content-Length", text.size());
+  }
+
+  encoder.end();
+  const std::string message = method.getName() + " " + target
+                              + " HTTP/1.1\r\n" + encoder.getBuffer() + text;
+
+  const ClientConnection::Exchange exchange(new ClientExchange(
+      message, method.isIdempotent(), method.equals(Method::HEAD)));
+  this->loop->post(new Submission(this, host, port, exchange));
+
+  if (!exchange->await(this->timeout)) {
+    const int error = exchange->getError();
+    exchange->cancel();
+    getLogger().warning("HTTP call to " + resourceRef.toString()
+                        + " failed: " + strerror(error));
+    response.setStatus((error == ETIMEDOUT)
+                       ? Status.CONNECTOR_ERROR_COMMUNICATION
+                       : Status.CONNECTOR_ERROR_CONNECTION);
+    return;
+  }
+
+  response.setStatus(Status.valueOf(exchange->getStatus()));
+
+  // The raw headers are left to the caller, as for the other connectors,
+  // the known ones being mapped onto the response
+  const Form headers = new Form();
+  std::string mediaType;
+  long long size = -1;
+
+  for (size_t i = 0; i < exchange->getHeaders().size(); i++) {
+    const std::string& name = exchange->getHeaders()[i].first;
+    const std::string& value = exchange->getHeaders()[i].second;
+    std::vector<std::string> elements;
+    headers.add(name, value);
+
+    if (strcasecmp(name.c_str(), "Content-Type") == 0) {
+      mediaType = value;
+    } else if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+      size = strtoll(value.c_str(), NULL, 10);
+    } else if (strcasecmp(name.c_str(), "Location") == 0) {
+      response.setLocationRef(value);
+    } else if (strcasecmp(name.c_str(), "Age") == 0) {
+      response.setAge(atoi(value.c_str()));
+    } else if (strcasecmp(name.c_str(), "Allow") == 0) {
+      HeaderReader::split(value, ',', elements);
+
+      for (size_t j = 0; j < elements.size(); j++) {
+        response.getAllowedMethods().insert(Method.valueOf(elements[j]));
+      }
+    } else if (strcasecmp(name.c_str(), "Cache-Control") == 0) {
+      HeaderReader::split(value, ',', elements);
+
+      for (size_t j = 0; j < elements.size(); j++) {
+        std::string directive;
+        std::string argument;
+        const bool valued = HeaderReader::splitParameter(
+            elements[j], directive, argument);
+        response.getCacheDirectives().add(new CacheDirective(
+            directive, valued ? argument : null));
+      }
+    } else if (strcasecmp(name.c_str(), "Set-Cookie") == 0) {
+      const CookieSetting cookieSetting = readCookieSetting(value);
+
+      if (cookieSetting != null) {
+        response.getCookieSettings().add(cookieSetting);
+      }
+    } else if (strcasecmp(name.c_str(), "Server") == 0) {
+      response.getServerInfo().setAgent(value);
+    }
+  }
+
+  response.getAttributes().put("org.restlet.http.headers", headers);
+
+  if (exchange->getBody().isDone() && (size <= 0)) {
+    return;
+  }
+
+  const ChunkStreamRepresentation entity = new ChunkStreamRepresentation(
+      mediaType.empty() ? null : MediaType.valueOf(mediaType), exchange);
+
+  if (size >= 0) {
+    entity.setSize(size);
+  }
+
+  for (size_t i = 0; i < exchange->getHeaders().size(); i++) {
+    readEntityHeader(entity, exchange->getHeaders()[i].first,
+                     exchange->getHeaders()[i].second);
+  }
+
+  response.setEntity(entity);
+}
+
+void HttpClient::start() throw (std::runtime_error) {
+  if (isStopped()) {
+    this->resolver = new HostResolver(RESOLVER_THREADS,
+                                      HostResolver::DEFAULT_POSITIVE_TTL,
+                                      HostResolver::DEFAULT_NEGATIVE_TTL);
+    this->loop = new EventLoop();
+
+    if (pthread_create(&this->thread, NULL, run, this) != 0) {
+      delete this->loop;
+      delete this->resolver;
+      this->loop = NULL;
+      this->resolver = NULL;
+      throw std::runtime_error("Unable to start the HTTP client thread");
+    }
+
+    super.start();
+  }
+}
+
+void HttpClient::stop() throw (std::runtime_error) {
+  if (isStarted()) {
+    super.stop();
+    this->loop->stop();
+    pthread_join(this->thread, NULL);
+
+    // The connections fail the calls still waiting
+    for (std::map<std::string, ConnectionPool*>::iterator i = pools.begin();
+         i != pools.end(); ++i) {
+      delete i->second;
+    }
+
+    pools.clear();
+
+    // The resolver threads post to the loop until they are joined
+    delete this->resolver;
+    delete this->loop;
+    this->resolver = NULL;
+    this->loop = NULL;
+  }
+}
+
+void* HttpClient::run(void* client) {
+  static_cast<HttpClient*>(client)->loop->run();
+  return NULL;
+}
+
+ConnectionPool* HttpClient::getPool(const std::string& host, int port) {
+  char suffix[8];
+  snprintf(suffix, sizeof(suffix), ":%d", port);
+  const std::string origin = host + suffix;
+  std::map<std::string, ConnectionPool*>::iterator pool = pools.find(origin);
+
+  if (pool != pools.end()) {
+    return pool->second;
+  }
+
+  ConnectionPool* result = new ConnectionPool(
+      *this->loop, *this->resolver, host, port, this->maxConnections,
+      this->timeout, this->idleTimeout);
+  pools[origin] = result;
+  return result;
+}
+
+const int HttpClient::DEFAULT_MAX_CONNECTIONS(8);
+
+const int HttpClient::DEFAULT_TIMEOUT(60000);
+
+const int HttpClient::DEFAULT_IDLE_TIMEOUT(30000);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,353 @@
+#include <echo/engine/http/http-server.h>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+#include <echo/engine/http/header-reader.h>
+#include <echo/engine/util/date-utils.h>
+#include <echo/representation/appendable-representation.h>
+#include <echo/representation/asset-representation.h>
+#include <echo/representation/chunk-stream-representation.h>
+#include <echo/representation/file-representation.h>
+#include <echo/representation/shared-representation.h>
+#include <echo/representation/source-representation.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::data::Method;
+using echo::data::Protocol;
+using echo::engine::io::ReadableSource;
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::ChunkStream;
+using echo::engine::util::DateUtils;
+using echo::engine::util::AssetPack;
+using echo::representation::AppendableRepresentation;
+using echo::representation::AssetRepresentation;
+using echo::representation::ChunkStreamRepresentation;
+using echo::representation::FileRepresentation;
+using echo::representation::SharedRepresentation;
+using echo::representation::SourceRepresentation;
+
+/**
+ * Adds the preferences of an "Accept" header such as "text/html;q=0.9".
+ */
+template<class T>
+static void readPreferences(const std::string& value,
+                            std::list<Preference<T> > preferences) {
+  std::vector<std::string> elements;
+  HeaderReader::split(value, ',', elements);
+
+  for (size_t i = 0; i < elements.size(); i++) {
+    std::string metadata;
+    const float quality = HeaderReader::getQuality(elements[i], metadata);
+    preferences.push_back(new Preference<T>(T::valueOf(metadata), quality));
+  }
+}
+
+/**
+ * Returns the entity tags of a conditional header.
+ */
+static std::list<Tag> readTags(const std::string& value) {
+  std::vector<std::string> elements;
+  std::list<Tag> result;
+  HeaderReader::split(value, ',', elements);
+
+  for (size_t i = 0; i < elements.size(); i++) {
+    result.push_back(Tag.parse(elements[i]));
+  }
+
+  return result;
+}
+
+HttpServer::HttpServer(echo::Context context, int port,
+                       echo::Application application) {
+  std::list<Protocol> protocols;
+  protocols.push_back(Protocol::HTTP);
+  Connector(context, protocols);
+  this->port = port;
+  this->application = application;
+  this->timeout = DEFAULT_TIMEOUT;
+  this->idleTimeout = DEFAULT_IDLE_TIMEOUT;
+  this->maxEntitySize = DEFAULT_MAX_ENTITY_SIZE;
+  this->ioEngine = DEFAULT_IO_ENGINE;
+  this->shardCount = 0;
+}
+
+void HttpServer::onRequest(ServerShard& shard, ServerConnection* connection,
+                           const MessageParser& head, ChunkBuffer& body) {
+  const MessageParser::Header* host = head.getHeader("Host");
+  const std::string authority = (host != NULL) ? host->value.toString()
+                                : "localhost";
+  const Request request = new Request(
+      Method.valueOf(head.getMethod().toString()),
+      "http://" + authority + head.getTarget().toString());
+  request.setProtocol(Protocol::HTTP);
+  request.setHostRef("http://" + authority);
+
+  // The raw headers are left to the application, as for the other connectors,
+  // the preferences, credentials, cookies and conditions being mapped onto
+  // the request before it is handled
+  const Form headers = new Form();
+  const ClientInfo clientInfo = request.getClientInfo();
+  const Conditions conditions = request.getConditions();
+  std::string mediaType;
+  std::string cookies;
+
+  for (size_t i = 0; i < head.getHeaders().size(); i++) {
+    const MessageParser::Header& header = head.getHeaders()[i];
+    const std::string value = header.value.toString();
+    time_t seconds;
+    headers.add(header.name.toString(), value);
+
+    if (header.name.equalsIgnoreCase("User-Agent")) {
+      clientInfo.setAgent(value);
+    } else if (header.name.equalsIgnoreCase("Content-Type")) {
+      mediaType = value;
+    } else if (header.name.equalsIgnoreCase("Cookie")) {
+      cookies += cookies.empty() ? value : "; " + value;
+    } else if (header.name.equalsIgnoreCase("Authorization")) {
+      const std::string::size_type space = value.find(' ');
+      const ChallengeResponse challengeResponse = new ChallengeResponse(
+          ChallengeScheme.valueOf("HTTP_" + value.substr(0, space)));
+
+      if (space != std::string::npos) {
+        challengeResponse.setRawValue(value.substr(space + 1));
+      }
+
+      request.setChallengeResponse(challengeResponse);
+    } else if (header.name.equalsIgnoreCase("Accept")) {
+      readPreferences(value, clientInfo.getAcceptedMediaTypes());
+    } else if (header.name.equalsIgnoreCase("Accept-Charset")) {
+      readPreferences(value, clientInfo.getAcceptedCharacterSets());
+    } else if (header.name.equalsIgnoreCase("Accept-Encoding")) {
+      readPreferences(value, clientInfo.getAcceptedEncodings());
+    } else if (header.name.equalsIgnoreCase("Accept-Language")) {
+      readPreferences(value, clientInfo.getAcceptedLanguages());
+    } else if (header.name.equalsIgnoreCase("If-Match")) {
+      conditions.setMatch(readTags(value));
+    } else if (header.name.equalsIgnoreCase("If-None-Match")) {
+      conditions.setNoneMatch(readTags(value));
+    } else if (header.name.equalsIgnoreCase("If-Modified-Since")
+               && DateUtils::parse(value, seconds)) {
+      conditions.setModifiedSince(new Date(seconds * 1000L));
+    } else if (header.name.equalsIgnoreCase("If-Unmodified-Since")
+               && DateUtils::parse(value, seconds)) {
+      conditions.setUnmodifiedSince(new Date(seconds * 1000L));
+    }
+  }
+
+  // The cookies are only parsed if the application asks for them
+  if (!cookies.empty()) {
+    request.setCookieHeader(cookies);
+  }
+
+  request.getAttributes().put("org.restlet.http.headers", headers);
+
+  if (body.getSize() > 0) {
+    std::string text;
+    body.toString(text);
+    request.setEntity(text, mediaType.empty() ? null
+                            : MediaType.valueOf(mediaType));
+  }
+
+  const Response response = new Response(request);
+  handle(request, response);
+
+  // Responses without content don't write their entity
+  const int code = response.getStatus().getCode();
+  const Representation entity = response.getEntity();
+  const bool available = (entity != NULL) && entity.isAvailable()
+                         && !Method::HEAD.equals(request.getMethod())
+                         && (code >= 200) && (code != 204) && (code != 304);
+  ChunkStream* stream = NULL;
+  ReadableSource* source = NULL;
+  bool owned = false;
+  bool close = !head.isKeepAlive();
+
+  if (available && (entity instanceof AppendableRepresentation)) {
+    stream = ((AppendableRepresentation) entity).getStream();
+  } else if (available && (entity instanceof ChunkStreamRepresentation)) {
+    stream = &((ChunkStreamRepresentation) entity).getChunkStream();
+  } else if (available && (entity instanceof FileRepresentation)) {
+    source = ((FileRepresentation) entity).getSource(shard.getEngine());
+    owned = true;
+  } else if (available && (entity instanceof SourceRepresentation)) {
+    source = ((SourceRepresentation) entity).getSource();
+  }
+
+  // The content held in memory is written with the head, shared buffers
+  // and asset slices being referenced rather than copied
+  const ChunkBuffer* chunks = NULL;
+  struct iovec content;
+  std::string text;
+  content.iov_base = NULL;
+  content.iov_len = 0;
+
+  if (available && (stream == NULL) && (source == NULL)) {
+    if (entity instanceof AppendableRepresentation) {
+      chunks = &((AppendableRepresentation) entity).getChunks();
+    } else if (entity instanceof SharedRepresentation) {
+      const std::string& shared =
+          ((SharedRepresentation) entity).getContent();
+      content.iov_base = const_cast<char*>(shared.data());
+      content.iov_len = shared.size();
+    } else if (entity instanceof AssetRepresentation) {
+      const AssetPack::Slice slice =
+          ((AssetRepresentation) entity).getContent();
+      content.iov_base = const_cast<char*>(slice.data);
+      content.iov_len = slice.length;
+    } else {
+      text = entity.getText();
+      content.iov_base = const_cast<char*>(text.data());
+      content.iov_len = text.size();
+    }
+  }
+
+  HeaderEncoder& encoder = shard.getEncoder();
+  encoder.clear();
+  encoder.addResponseHeaders(response);
+
+  // Without a size, an HTTP/1.0 client reads the entity until the end
+  const bool sized = (entity != NULL)
+                     && (entity.getSize() != Representation::UNKNOWN_SIZE);
+  const bool chunked = (stream != NULL) && !sized
+                       && (head.getMinorVersion() >= 1);
+
+  if (chunked) {
+    encoder.add("Transfer-Encoding", "chunked");
+  } else if (((stream != NULL) || (source != NULL)) && !sized) {
+    close = true;
+  } else if (available && !sized) {
+    encoder.addNumber("Content-Length", (chunks != NULL) ? chunks->getSize()
+                                        : content.iov_len);
+  }
+
+  if (close) {
+    encoder.add("Connection", "close");
+  }
+
+  encoder.end();
+
+  if ((stream != NULL) || (source != NULL)) {
+    shard.hold(connection, response, owned ? source : NULL);
+
+    if (stream != NULL) {
+      connection->respond(encoder.getBuffer(), *stream, chunked, close);
+    } else {
+      connection->respond(encoder.getBuffer(), source, close);
+    }
+
+    return;
+  }
+
+  if (chunks != NULL) {
+    // The chunks of a generated page are written without being joined
+    std::vector<struct iovec> vectors(
+        chunks->getSize() / ChunkBuffer::CHUNK_SIZE + 1);
+    const int count = chunks->getVectors(&vectors[0], vectors.size());
+    connection->respond(encoder.getBuffer(), &vectors[0], count, close);
+  } else {
+    connection->respond(encoder.getBuffer(), &content,
+                        (content.iov_len > 0) ? 1 : 0, close);
+  }
+
+  if (entity != NULL) {
+    entity.release();
+  }
+}
+
+void HttpServer::start() throw (std::runtime_error) {
+  if (isStopped()) {
+    struct addrinfo hints;
+    struct addrinfo* addresses = NULL;
+    char service[8];
+    snprintf(service, sizeof(service), "%d", this->port);
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    if (getaddrinfo(this->address.empty() ? NULL : this->address.c_str(),
+                    service, &hints, &addresses) != 0) {
+      throw std::runtime_error("Unable to resolve the listening address");
+    }
+
+    // One shard per allowed CPU unless told otherwise, the extra shards
+    // sharing the CPUs in turn
+    cpu_set_t allowed;
+    std::vector<int> cpus;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+
+    const int count = (this->shardCount > 0) ? this->shardCount
+                      : cpus.empty() ? 1 : (int) cpus.size();
+    struct sockaddr_storage bound;
+    socklen_t length = addresses->ai_addrlen;
+    memcpy(&bound, addresses->ai_addr, length);
+    freeaddrinfo(addresses);
+
+    try {
+      for (int i = 0; i < count; i++) {
+        ServerShard* shard = new ServerShard(
+            this, cpus.empty() ? -1 : cpus[i % cpus.size()]);
+        this->shards.push_back(shard);
+        shard->start((struct sockaddr*) &bound, length);
+
+        // The next shards join the port chosen by the system for the first
+        if (i == 0) {
+          getsockname(shard->getListenFile(), (struct sockaddr*) &bound,
+                      &length);
+          this->port = ntohs((bound.ss_family == AF_INET6)
+                             ? ((struct sockaddr_in6*) &bound)->sin6_port
+                             : ((struct sockaddr_in*) &bound)->sin_port);
+        }
+      }
+    } catch (const std::runtime_error&) {
+      stopShards();
+      throw;
+    }
+
+    super.start();
+  }
+}
+
+void HttpServer::stop() throw (std::runtime_error) {
+  if (isStarted()) {
+    super.stop();
+    stopShards();
+  }
+}
+
+void HttpServer::stopShards() {
+  for (size_t i = 0; i < this->shards.size(); i++) {
+    delete this->shards[i];
+  }
+
+  this->shards.clear();
+}
+
+const int HttpServer::DEFAULT_TIMEOUT(60000);
+
+const int HttpServer::DEFAULT_IDLE_TIMEOUT(30000);
+
+const size_t HttpServer::DEFAULT_MAX_ENTITY_SIZE(1048576);
+
+const std::string HttpServer::DEFAULT_IO_ENGINE("auto");
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,486 @@
+#include <echo/engine/http/message-parser.h>
+
+#include <string.h>
+#include <strings.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::util::ChunkBuffer;
+
+/** The maximum length of a line of the chunked framing. */
+static const size_t MAX_LINE_SIZE = 4096;
+
+/**
+ * Indicates if a byte is a space or a horizontal tab.
+ */
+static bool isSpace(char value) {
+  return (value == ' ') || (value == '\t');
+}
+
+/**
+ * Indicates if a comma-separated header value contains a token, ignoring the
+ * case.
+ */
+static bool hasToken(const MessageParser::Slice& value, const char* token) {
+  const size_t length = strlen(token);
+  size_t start = 0;
+
+  while (start < value.length) {
+    size_t end = start;
+
+    while ((end < value.length) && (value.data[end] != ',')) {
+      end++;
+    }
+
+    size_t first = start;
+    size_t last = end;
+
+    while ((first < last) && isSpace(value.data[first])) {
+      first++;
+    }
+
+    while ((last > first) && isSpace(value.data[last - 1])) {
+      last--;
+    }
+
+    if ((last - first == length)
+        && (strncasecmp(value.data + first, token, length) == 0)) {
+      return true;
+    }
+
+    start = end + 1;
+  }
+
+  return false;
+}
+
+/**
+ * Indicates if the last token of a comma-separated header value is a given
+ * token, ignoring the case.
+ */
+static bool isLastToken(const MessageParser::Slice& value, const char* token) {
+  size_t last = value.length;
+
+  while ((last > 0) && isSpace(value.data[last - 1])) {
+    last--;
+  }
+
+  size_t first = last;
+
+  while ((first > 0) && (value.data[first - 1] != ',')) {
+    first--;
+  }
+
+  while ((first < last) && isSpace(value.data[first])) {
+    first++;
+  }
+
+  const size_t length = strlen(token);
+  return (last - first == length)
+         && (strncasecmp(value.data + first, token, length) == 0);
+}
+
+bool MessageParser::Slice::equalsIgnoreCase(const char* value) const {
+  return (strlen(value) == length)
+         && (strncasecmp(data, value, length) == 0);
+}
+
+MessageParser::MessageParser(int type) : type(type) {
+  reset();
+}
+
+bool MessageParser::finish() {
+  if (bodyState == BODY_UNTIL_CLOSE) {
+    bodyState = BODY_DONE;
+  }
+
+  return bodyState == BODY_DONE;
+}
+
+const MessageParser::Header* MessageParser::getHeader(const char* name)
+    const {
+  for (size_t i = 0; i < headers.size(); i++) {
+    if (headers[i].name.equalsIgnoreCase(name)) {
+      return &headers[i];
+    }
+  }
+
+  return NULL;
+}
+
+ssize_t MessageParser::parseBody(const char* data, size_t length,
+                                 ChunkBuffer& output) {
+  size_t consumed = 0;
+
+  while ((consumed < length) && (bodyState != BODY_DONE)) {
+    if ((bodyState == BODY_LENGTH) || (bodyState == BODY_CHUNK_DATA)) {
+      size_t count = length - consumed;
+
+      if (count > remaining) {
+        count = remaining;
+      }
+
+      output.append(data + consumed, count);
+      consumed += count;
+      remaining -= count;
+
+      if (remaining == 0) {
+        bodyState = (bodyState == BODY_LENGTH) ? BODY_DONE : BODY_CHUNK_END;
+      }
+    } else if (bodyState == BODY_UNTIL_CLOSE) {
+      output.append(data + consumed, length - consumed);
+      consumed = length;
+    } else {
+      const bool complete = readLine(data, length, consumed);
+
+      if (line.size() > MAX_LINE_SIZE) {
+        return -1;
+      }
+
+      if (!complete) {
+        continue;
+      }
+
+      if (bodyState == BODY_CHUNK_SIZE) {
+        // The chunk extensions are ignored
+        unsigned long long size = 0;
+        size_t digits = 0;
+
+        for (; digits < line.size(); digits++) {
+          const char digit = line[digits];
+          int value;
+
+          if ((digit >= '0') && (digit <= '9')) {
+            value = digit - '0';
+          } else if ((digit >= 'a') && (digit <= 'f')) {
+            value = digit - 'a' + 10;
+          } else if ((digit >= 'A') && (digit <= 'F')) {
+            value = digit - 'A' + 10;
+          } else {
+            break;
+          }
+
+          if (size >> 60 != 0) {
+            return -1;
+          }
+
+          size = (size << 4) | value;
+        }
+
+        if ((digits == 0) || ((digits < line.size())
+                              && (line[digits] != ';')
+                              && !isSpace(line[digits]))) {
+          return -1;
+        }
+
+        remaining = size;
+        bodyState = (size == 0) ? BODY_TRAILERS : BODY_CHUNK_DATA;
+      } else if (bodyState == BODY_CHUNK_END) {
+        if (!line.empty()) {
+          return -1;
+        }
+
+        bodyState = BODY_CHUNK_SIZE;
+      } else if (line.empty()) {
+        // The trailers are ignored, the head being already delivered
+        bodyState = BODY_DONE;
+      }
+
+      line.clear();
+    }
+  }
+
+  return consumed;
+}
+
+ssize_t MessageParser::parseHead(const char* data, size_t length) {
+  // Empty lines may precede the start line
+  size_t start = 0;
+
+  while ((start < length) && ((data[start] == '\r') || (data[start] == '\n'))) {
+    start++;
+  }
+
+  size_t end = 0;
+  size_t i = (scanned > start) ? scanned : start;
+
+  for (; i < length; i++) {
+    if ((data[i] == '\n') && (i > start)
+        && ((data[i - 1] == '\n')
+            || ((data[i - 1] == '\r') && (i - 1 > start)
+                && (data[i - 2] == '\n')))) {
+      end = i + 1;
+      break;
+    }
+  }
+
+  if (end == 0) {
+    this->scanned = length;
+    return (length > MAX_HEAD_SIZE) ? -1 : 0;
+  }
+
+  if (end > MAX_HEAD_SIZE) {
+    return -1;
+  }
+
+  // Split the lines, without their line breaks
+  size_t position = start;
+  bool first = true;
+
+  while (position < end) {
+    const char* next = static_cast<const char*>(
+        memchr(data + position, '\n', end - position));
+    size_t lineEnd = next - data;
+    const size_t nextPosition = lineEnd + 1;
+
+    if ((lineEnd > position) && (data[lineEnd - 1] == '\r')) {
+      lineEnd--;
+    }
+
+    if (lineEnd == position) {
+      break;
+    }
+
+    if (first) {
+      if (!parseStartLine(data + position, lineEnd - position)) {
+        return -1;
+      }
+
+      first = false;
+    } else {
+      // Folded and nameless headers are rejected
+      const char* colon = static_cast<const char*>(
+          memchr(data + position, ':', lineEnd - position));
+
+      if ((colon == NULL) || (colon == data + position)
+          || isSpace(data[position]) || isSpace(colon[-1])
+          || (headers.size() >= MAX_HEADERS)) {
+        return -1;
+      }
+
+      Header header;
+      header.name.data = data + position;
+      header.name.length = colon - (data + position);
+
+      const char* value = colon + 1;
+      const char* valueEnd = data + lineEnd;
+
+      while ((value < valueEnd) && isSpace(*value)) {
+        value++;
+      }
+
+      while ((valueEnd > value) && isSpace(valueEnd[-1])) {
+        valueEnd--;
+      }
+
+      header.value.data = value;
+      header.value.length = valueEnd - value;
+      headers.push_back(header);
+    }
+
+    position = nextPosition;
+  }
+
+  // Framing and persistence
+  keepAlive = (minorVersion >= 1);
+
+  for (size_t j = 0; j < headers.size(); j++) {
+    const Header& header = headers[j];
+
+    if (header.name.equalsIgnoreCase("Content-Length")) {
+      long long value = 0;
+
+      if (header.value.length == 0) {
+        return -1;
+      }
+
+      for (size_t k = 0; k < header.value.length; k++) {
+        const char digit = header.value.data[k];
+
+        if ((digit < '0') || (digit > '9')
+            || (value > (0x7fffffffffffffffLL - 9) / 10)) {
+          return -1;
+        }
+
+        value = value * 10 + (digit - '0');
+      }
+
+      // Conflicting lengths can't be trusted
+      if ((contentLength != -1) && (contentLength != value)) {
+        return -1;
+      }
+
+      contentLength = value;
+    } else if (header.name.equalsIgnoreCase("Transfer-Encoding")) {
+      chunked = isLastToken(header.value, "chunked");
+
+      if (!chunked && (type == REQUEST)) {
+        return -1;
+      }
+    } else if (header.name.equalsIgnoreCase("Connection")) {
+      if (hasToken(header.value, "close")) {
+        keepAlive = false;
+      } else if (hasToken(header.value, "keep-alive")) {
+        keepAlive = true;
+      }
+    }
+  }
+
+  // Both framings may smuggle a second request through an intermediary
+  if (chunked && (contentLength != -1)) {
+    if (type == REQUEST) {
+      return -1;
+    }
+
+    contentLength = -1;
+  }
+
+  return end;
+}
+
+void MessageParser::reset() {
+  scanned = 0;
+  method.data = NULL;
+  method.length = 0;
+  target = method;
+  reason = method;
+  status = 0;
+  minorVersion = 1;
+  headers.clear();
+  contentLength = -1;
+  chunked = false;
+  keepAlive = true;
+  bodyState = BODY_DONE;
+  remaining = 0;
+  line.clear();
+}
+
+void MessageParser::startBody(bool empty) {
+  remaining = 0;
+  line.clear();
+
+  if (empty) {
+    bodyState = BODY_DONE;
+  } else if (chunked) {
+    bodyState = BODY_CHUNK_SIZE;
+  } else if (contentLength > 0) {
+    bodyState = BODY_LENGTH;
+    remaining = contentLength;
+  } else if ((contentLength == -1) && (type == RESPONSE)) {
+    bodyState = BODY_UNTIL_CLOSE;
+    keepAlive = false;
+  } else {
+    bodyState = BODY_DONE;
+  }
+}
+
+bool MessageParser::parseStartLine(const char* data, size_t length) {
+  const char* end = data + length;
+  const char* version;
+
+  if (type == REQUEST) {
+    // METHOD SP TARGET SP HTTP/1.x
+    const char* space = static_cast<const char*>(memchr(data, ' ', length));
+
+    if ((space == NULL) || (space == data)) {
+      return false;
+    }
+
+    method.data = data;
+    method.length = space - data;
+    target.data = space + 1;
+
+    const char* last = end;
+
+    while ((last > target.data) && (last[-1] != ' ')) {
+      last--;
+    }
+
+    if ((last <= target.data + 1) || (end - last != 8)) {
+      return false;
+    }
+
+    target.length = last - 1 - target.data;
+    version = last;
+  } else {
+    // HTTP/1.x SP 3DIGIT [SP REASON]
+    if ((length < 12) || (data[8] != ' ')) {
+      return false;
+    }
+
+    version = data;
+    status = 0;
+
+    for (int i = 9; i < 12; i++) {
+      if ((data[i] < '0') || (data[i] > '9')) {
+        return false;
+      }
+
+      status = status * 10 + (data[i] - '0');
+    }
+
+    if ((length > 12) && (data[12] != ' ')) {
+      return false;
+    }
+
+    reason.data = data + ((length > 12) ? 13 : 12);
+    reason.length = end - reason.data;
+  }
+
+  if ((strncmp(version, "HTTP/1.", 7) != 0) || (version[7] < '0')
+      || (version[7] > '9')) {
+    return false;
+  }
+
+  minorVersion = version[7] - '0';
+  return true;
+}
+
+bool MessageParser::readLine(const char* data, size_t length,
+                             size_t& consumed) {
+  const char* next = static_cast<const char*>(
+      memchr(data + consumed, '\n', length - consumed));
+
+  if (next == NULL) {
+    line.append(data + consumed, length - consumed);
+    consumed = length;
+    return false;
+  }
+
+  line.append(data + consumed, next - (data + consumed));
+  consumed = next - data + 1;
+
+  if (!line.empty() && (line[line.size() - 1] == '\r')) {
+    line.erase(line.size() - 1);
+  }
+
+  return true;
+}
+
+const int MessageParser::REQUEST(0);
+
+const int MessageParser::RESPONSE(1);
+
+const size_t MessageParser::MAX_HEAD_SIZE(64 * 1024);
+
+const size_t MessageParser::MAX_HEADERS(100);
+
+const int MessageParser::BODY_LENGTH(0);
+
+const int MessageParser::BODY_CHUNK_SIZE(1);
+
+const int MessageParser::BODY_CHUNK_DATA(2);
+
+const int MessageParser::BODY_CHUNK_END(3);
+
+const int MessageParser::BODY_TRAILERS(4);
+
+const int MessageParser::BODY_UNTIL_CLOSE(5);
+
+const int MessageParser::BODY_DONE(6);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
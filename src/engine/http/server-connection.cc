@@ -0,0 +1,532 @@
+#include <echo/engine/http/server-connection.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <echo/engine/http/status-table.h>
+#include <echo/engine/util/timer-wheel.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::io::EventLoop;
+using echo::engine::io::ReadableSource;
+using echo::engine::io::Transfer;
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::ChunkStream;
+using echo::engine::util::TimerWheel;
+
+/** The size of the input buffer, and of its growth steps. */
+static const size_t READ_SIZE = 16384;
+
+/** The free space of the input buffer below which it is compacted. */
+static const size_t MIN_READ = 2048;
+
+/** The number of vectors given to each writev() call. */
+static const int VECTOR_SIZE = 64;
+
+/** The number of vectors of a frame of a streamed entity. */
+static const int FRAME_SIZE = 16;
+
+/** The number of staged output bytes above which the requests wait. */
+static const size_t HIGH_WATER_MARK = 65536;
+
+/** The interim response of the requests expecting it. */
+static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+
+ServerConnection::ServerConnection(EventLoop& loop, int file, int timeout,
+                                   int idleTimeout, size_t maxEntitySize,
+                                   Listener* listener)
+    : loop(loop), file(file), timeout(timeout), idleTimeout(idleTimeout),
+      maxEntitySize(maxEntitySize), listener(listener), state(READING),
+      events(-1), inputOffset(0), inputLength(0),
+      parser(MessageParser::REQUEST), headReceived(false), dispatching(false),
+      closing(false), writer(StreamWriter::CHUNKED, 0), stream(NULL),
+      chunked(false), activity(0), source(NULL), transfer(NULL),
+      transferred(0), timer(this) {
+}
+
+ServerConnection::~ServerConnection() {
+  loop.cancel(&timer);
+
+  // The transfer stops waiting for the socket before it is closed
+  delete transfer;
+
+  if (events != -1) {
+    loop.remove(file);
+  }
+
+  if (state != CLOSED) {
+    ::close(file);
+  }
+}
+
+void ServerConnection::close() {
+  if (state == CLOSED) {
+    return;
+  }
+
+  state = CLOSED;
+  loop.cancel(&timer);
+
+  // The producer stops generating an entity nobody will read
+  if (stream != NULL) {
+    stream->abort();
+  }
+
+  delete transfer;
+  transfer = NULL;
+
+  if (events != -1) {
+    loop.remove(file);
+    events = -1;
+  }
+
+  ::close(file);
+  body.clear();
+  output.clear();
+  loop.post(new Disposal(this));
+}
+
+void ServerConnection::onComplete(Transfer* transfer, bool success) {
+  delete transfer;
+  this->transfer = NULL;
+  this->source = NULL;
+
+  if (!success) {
+    close();
+    return;
+  }
+
+  state = READING;
+  listener->onResponded(this);
+
+  if (complete() && process()) {
+    update();
+  }
+}
+
+void ServerConnection::onReady(int file, int events) {
+  if ((events & EventLoop::WRITABLE) != 0) {
+    if (!flush()) {
+      return;
+    }
+
+    // The output drained, the stream and the held back requests go on
+    if (((state == STREAMING) && !pump())
+        || ((state == READING) && !process())) {
+      return;
+    }
+  }
+
+  if (((events & (EventLoop::READABLE | EventLoop::CLOSED)) != 0)
+      && ((state == READING) || (state == STREAMING))) {
+    receive();
+  }
+
+  update();
+}
+
+void ServerConnection::open() {
+  activity = TimerWheel::currentTimeMillis();
+  update();
+}
+
+void ServerConnection::respond(const std::string& head,
+                               const struct iovec* vectors, int count,
+                               bool close) {
+  closing = closing || close || !parser.isKeepAlive();
+
+  // Most responses fit the vectors of the stack
+  struct iovec local[VECTOR_SIZE];
+  std::vector<struct iovec> allocated;
+  struct iovec* all = local;
+
+  if (count >= VECTOR_SIZE) {
+    allocated.resize(count + 1);
+    all = &allocated[0];
+  }
+
+  all[0].iov_base = const_cast<char*>(head.data());
+  all[0].iov_len = head.size();
+
+  for (int i = 0; i < count; i++) {
+    all[i + 1] = vectors[i];
+  }
+
+  if (write(all, count + 1)) {
+    complete();
+  }
+}
+
+void ServerConnection::respond(const std::string& head, ChunkStream& stream,
+                               bool chunked, bool close) {
+  // An unframed entity is delimited by the end of the connection
+  closing = closing || close || !chunked || !parser.isKeepAlive();
+
+  struct iovec vector;
+  vector.iov_base = const_cast<char*>(head.data());
+  vector.iov_len = head.size();
+
+  if (!write(&vector, 1)) {
+    return;
+  }
+
+  this->state = STREAMING;
+  this->stream = &stream;
+  this->chunked = chunked;
+  pump();
+}
+
+void ServerConnection::respond(const std::string& head,
+                               ReadableSource* source, bool close) {
+  closing = closing || close || !parser.isKeepAlive();
+
+  struct iovec vector;
+  vector.iov_base = const_cast<char*>(head.data());
+  vector.iov_len = head.size();
+
+  if (!write(&vector, 1)) {
+    return;
+  }
+
+  this->state = TRANSFERRING;
+  this->source = source;
+  this->transferred = 0;
+
+  // The transfer writes to the socket once the head is written
+  if (output.getSize() == 0) {
+    startTransfer();
+  }
+}
+
+bool ServerConnection::complete() {
+  if (closing && (output.getSize() == 0)) {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+bool ServerConnection::flush() {
+  struct iovec vectors[VECTOR_SIZE];
+
+  while (output.getSize() > 0) {
+    const int count = output.getVectors(vectors, VECTOR_SIZE);
+    const ssize_t written = writev(file, vectors, count);
+
+    if (written > 0) {
+      output.consume(written);
+      activity = TimerWheel::currentTimeMillis();
+    } else if ((written == -1) && (errno == EINTR)) {
+      continue;
+    } else if ((written == -1) && (errno == EAGAIN)) {
+      return true;
+    } else {
+      close();
+      return false;
+    }
+  }
+
+  if ((state == READING) && !complete()) {
+    return false;
+  }
+
+  if ((state == TRANSFERRING) && (transfer == NULL)) {
+    startTransfer();
+  }
+
+  return state != CLOSED;
+}
+
+void ServerConnection::onTimeout() {
+  const long long now = TimerWheel::currentTimeMillis();
+
+  if ((state == STREAMING) && (now - activity < timeout)) {
+    if (!pump()) {
+      return;
+    }
+  } else if ((state == TRANSFERRING) && (transfer != NULL)
+             && (transfer->getTransferred() != transferred)) {
+    // A slow transfer making progress isn't timed out
+    transferred = transfer->getTransferred();
+  } else {
+    close();
+    return;
+  }
+
+  update();
+}
+
+bool ServerConnection::process() {
+  while ((state == READING) && !closing && !dispatching
+         && (output.getSize() < HIGH_WATER_MARK)) {
+    const char* data = input.data() + inputOffset;
+    const size_t length = inputLength - inputOffset;
+
+    if (!headReceived) {
+      if (length == 0) {
+        break;
+      }
+
+      const ssize_t size = parser.parseHead(data, length);
+
+      if (size == 0) {
+        break;
+      }
+
+      if (size < 0) {
+        reject(400);
+        break;
+      }
+
+      inputOffset += size;
+      headReceived = true;
+      parser.startBody(false);
+
+      if (parser.getContentLength() > (long long) maxEntitySize) {
+        reject(413);
+        break;
+      }
+
+      // The head stays in place unless its body spans several reads
+      if (parser.isChunked() || (parser.getContentLength()
+                                 > (long long) (length - size))) {
+        headCopy.assign(data, size);
+        parser.reset();
+        parser.parseHead(headCopy.data(), headCopy.size());
+        parser.startBody(false);
+
+        const MessageParser::Header* expect = parser.getHeader("Expect");
+
+        if ((expect != NULL) && expect->value.equalsIgnoreCase("100-continue")
+            && (parser.getMinorVersion() == 1)) {
+          struct iovec vector;
+          vector.iov_base = const_cast<char*>(CONTINUE);
+          vector.iov_len = sizeof(CONTINUE) - 1;
+
+          if (!write(&vector, 1)) {
+            return false;
+          }
+        }
+      }
+    }
+
+    if (!parser.isBodyDone()) {
+      const ssize_t count = parser.parseBody(input.data() + inputOffset,
+                                             inputLength - inputOffset, body);
+
+      if (count < 0) {
+        reject(400);
+        break;
+      }
+
+      inputOffset += count;
+
+      if (body.getSize() > maxEntitySize) {
+        reject(413);
+        break;
+      }
+
+      if (!parser.isBodyDone()) {
+        break;
+      }
+    }
+
+    // A response completed from respond() doesn't handle the next request
+    headReceived = false;
+    dispatching = true;
+    listener->onRequest(this, parser, body);
+    dispatching = false;
+    body.clear();
+    parser.reset();
+  }
+
+  return state != CLOSED;
+}
+
+bool ServerConnection::pump() {
+  struct iovec vectors[FRAME_SIZE];
+
+  // The chunks stay in the stream while the socket lags behind, holding the
+  // producer back
+  while (output.getSize() == 0) {
+    size_t length = 0;
+    int count;
+
+    if (chunked) {
+      count = writer.getFrame(*stream, vectors, FRAME_SIZE, length);
+    } else {
+      count = stream->getVectors(vectors, FRAME_SIZE);
+
+      for (int i = 0; i < count; i++) {
+        length += vectors[i].iov_len;
+      }
+    }
+
+    if (count == 0) {
+      break;
+    }
+
+    if (!write(vectors, count)) {
+      return false;
+    }
+
+    stream->consume(length);
+    activity = TimerWheel::currentTimeMillis();
+  }
+
+  if (stream->isAborted()) {
+    close();
+    return false;
+  }
+
+  if (!stream->isDone()) {
+    return true;
+  }
+
+  if (chunked && !write(vectors, writer.getLastFrame(vectors))) {
+    return false;
+  }
+
+  state = READING;
+  stream = NULL;
+  listener->onResponded(this);
+  return complete() && process();
+}
+
+void ServerConnection::receive() {
+  // Reuse the input buffer from the start once everything was parsed, and
+  // only move the unparsed bytes when the free space runs low
+  if (inputOffset == inputLength) {
+    inputOffset = 0;
+    inputLength = 0;
+  } else if ((input.size() - inputLength < MIN_READ) && (inputOffset > 0)) {
+    input.erase(0, inputOffset);
+    inputLength -= inputOffset;
+    inputOffset = 0;
+  }
+
+  if (input.size() - inputLength < MIN_READ) {
+    input.resize(input.size() + READ_SIZE);
+  }
+
+  ssize_t count;
+
+  do {
+    count = ::read(file, &input[inputLength], input.size() - inputLength);
+  } while ((count == -1) && (errno == EINTR));
+
+  if (count > 0) {
+    inputLength += count;
+    activity = TimerWheel::currentTimeMillis();
+    process();
+  } else if ((count == 0) || (errno != EAGAIN)) {
+    close();
+  }
+}
+
+void ServerConnection::reject(int status) {
+  std::string response;
+  StatusTable::appendHttpLine(response, status, std::string());
+  response += "Content-Length: 0\r\nConnection: close\r\n\r\n";
+
+  struct iovec vector;
+  vector.iov_base = const_cast<char*>(response.data());
+  vector.iov_len = response.size();
+
+  closing = true;
+  headReceived = false;
+
+  if (write(&vector, 1)) {
+    complete();
+  }
+}
+
+void ServerConnection::startTransfer() {
+  // The transfer registers the socket while it waits for writability
+  if (events != -1) {
+    loop.remove(file);
+    events = -1;
+  }
+
+  transfer = new Transfer(loop, source, file, HIGH_WATER_MARK);
+  transfer->start(this);
+}
+
+void ServerConnection::update() {
+  if ((state == CLOSED) || (dispatching && (state == READING))) {
+    return;
+  }
+
+  if (transfer != NULL) {
+    loop.schedule(&timer, timeout);
+    return;
+  }
+
+  int interest = (output.getSize() > 0) ? EventLoop::WRITABLE : 0;
+
+  if ((state == READING) && !closing
+      && (output.getSize() < HIGH_WATER_MARK)) {
+    interest |= EventLoop::READABLE;
+  }
+
+  if (events == -1) {
+    if (!loop.add(file, interest, this)) {
+      close();
+      return;
+    }
+
+    events = interest;
+  } else if (interest != events) {
+    loop.modify(file, interest);
+    events = interest;
+  }
+
+  if ((state == STREAMING) && (output.getSize() == 0)) {
+    // The stream has no readiness notification, it is checked every tick
+    loop.schedule(&timer, STREAM_CHECK);
+  } else if ((state == READING) && !headReceived
+             && (inputOffset == inputLength) && (output.getSize() == 0)) {
+    loop.schedule(&timer, idleTimeout);
+  } else {
+    loop.schedule(&timer, timeout);
+  }
+}
+
+bool ServerConnection::write(struct iovec* vectors, int count) {
+  int index = 0;
+
+  // Nothing is staged: the vectors go out directly, most often whole
+  if ((output.getSize() == 0)
+      && (ChunkBuffer::writeVectors(file, vectors, count, index) == -1)) {
+    close();
+    return false;
+  }
+
+  // The rest is copied, the caller's data being released on return
+  for (; index < count; index++) {
+    output.append(static_cast<const char*>(vectors[index].iov_base),
+                  vectors[index].iov_len);
+  }
+
+  return true;
+}
+
+const int ServerConnection::READING(0);
+
+const int ServerConnection::STREAMING(1);
+
+const int ServerConnection::TRANSFERRING(2);
+
+const int ServerConnection::CLOSED(3);
+
+const int ServerConnection::STREAM_CHECK(10);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
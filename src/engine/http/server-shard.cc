@@ -0,0 +1,208 @@
+#include <echo/engine/http/server-shard.h>
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <echo/engine/http/http-server.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::io::EventLoop;
+using echo::engine::io::IoEngine;
+using echo::engine::io::ReadableSource;
+using echo::engine::util::ChunkBuffer;
+
+/** The length of the queue of the connections not accepted yet. */
+static const int BACKLOG = 1024;
+
+/**
+ * The pause of the listening socket when the process is out of descriptors,
+ * in milliseconds.
+ */
+static const int ACCEPT_PAUSE = 100;
+
+ServerShard::ServerShard(HttpServer* server, int cpu)
+    : server(server), cpu(cpu), listenFile(-1), loop(NULL), engine(NULL),
+      acceptor(this), resumer(this), encoder(false) {
+}
+
+ServerShard::~ServerShard() {
+  stop();
+}
+
+void ServerShard::hold(ServerConnection* connection, echo::Response response,
+                       ReadableSource* source) {
+  Pending& pending = connections[connection];
+  pending.response = response;
+  pending.source = source;
+}
+
+void ServerShard::onClosed(ServerConnection* connection) {
+  release(connection);
+  connections.erase(connection);
+  delete connection;
+}
+
+void ServerShard::onRequest(ServerConnection* connection,
+                            const MessageParser& head, ChunkBuffer& body) {
+  server->onRequest(*this, connection, head, body);
+}
+
+void ServerShard::onResponded(ServerConnection* connection) {
+  release(connection);
+}
+
+void ServerShard::start(const struct sockaddr* address, socklen_t length)
+    throw (std::runtime_error) {
+  // Every shard binds its own socket to the same address, the kernel
+  // balancing the connections between them
+  listenFile = socket(address->sa_family,
+                      SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  const int enabled = 1;
+  const bool bound = (listenFile != -1)
+                     && (setsockopt(listenFile, SOL_SOCKET, SO_REUSEADDR,
+                                    &enabled, sizeof(enabled)) == 0)
+                     && (setsockopt(listenFile, SOL_SOCKET, SO_REUSEPORT,
+                                    &enabled, sizeof(enabled)) == 0)
+                     && (bind(listenFile, address, length) == 0)
+                     && (listen(listenFile, BACKLOG) == 0);
+
+  if (!bound) {
+    if (listenFile != -1) {
+      ::close(listenFile);
+      listenFile = -1;
+    }
+
+    throw std::runtime_error("Unable to bind the HTTP server socket");
+  }
+
+  loop = new EventLoop();
+  engine = IoEngine::create(*loop, server->getIoEngine());
+  loop->add(listenFile, EventLoop::READABLE, &acceptor);
+
+  // The thread starts on its CPU, so that the loop never runs elsewhere
+  pthread_attr_t attributes;
+  pthread_attr_init(&attributes);
+
+  if (cpu != -1) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    pthread_attr_setaffinity_np(&attributes, sizeof(cpus), &cpus);
+  }
+
+  const int error = pthread_create(&thread, &attributes, run, this);
+  pthread_attr_destroy(&attributes);
+
+  if (error != 0) {
+    loop->remove(listenFile);
+    ::close(listenFile);
+    delete engine;
+    delete loop;
+    listenFile = -1;
+    engine = NULL;
+    loop = NULL;
+    throw std::runtime_error("Unable to start the HTTP server thread");
+  }
+}
+
+void ServerShard::stop() {
+  if (loop == NULL) {
+    return;
+  }
+
+  loop->stop();
+  pthread_join(thread, NULL);
+  loop->cancel(&resumer);
+
+  // The entities being written are released with their connections
+  while (!connections.empty()) {
+    ServerConnection* connection = connections.begin()->first;
+    release(connection);
+    connections.erase(connection);
+    delete connection;
+  }
+
+  loop->remove(listenFile);
+  ::close(listenFile);
+  delete engine;
+  delete loop;
+  listenFile = -1;
+  engine = NULL;
+  loop = NULL;
+}
+
+void* ServerShard::run(void* shard) {
+  static_cast<ServerShard*>(shard)->loop->run();
+  return NULL;
+}
+
+void ServerShard::accept() {
+  for (;;) {
+    const int file = accept4(listenFile, NULL, NULL,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+    if (file == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      // Out of descriptors, the socket stays readable until some are
+      // released; otherwise EAGAIN once the queue is empty
+      if ((errno == EMFILE) || (errno == ENFILE) || (errno == ENOBUFS)
+          || (errno == ENOMEM)) {
+        pause();
+      }
+
+      break;
+    }
+
+    // The responses are written whole, don't delay the last segment
+    const int enabled = 1;
+    setsockopt(file, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+
+    ServerConnection* connection = new ServerConnection(
+        *loop, file, server->getTimeout(), server->getIdleTimeout(),
+        server->getMaxEntitySize(), this);
+    connections[connection].source = NULL;
+    connection->open();
+  }
+}
+
+void ServerShard::pause() {
+  loop->modify(listenFile, 0);
+  loop->schedule(&resumer, ACCEPT_PAUSE);
+}
+
+void ServerShard::release(ServerConnection* connection) {
+  std::map<ServerConnection*, Pending>::iterator pending =
+      connections.find(connection);
+
+  if (pending == connections.end()) {
+    return;
+  }
+
+  delete pending->second.source;
+  pending->second.source = NULL;
+
+  if (pending->second.response != NULL) {
+    if (pending->second.response.getEntity() != NULL) {
+      pending->second.response.getEntity().release();
+    }
+
+    pending->second.response = NULL;
+  }
+}
+
+void ServerShard::resume() {
+  loop->modify(listenFile, EventLoop::READABLE);
+}
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,205 @@
+#include <echo/engine/http/status-table.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+/**
+ * Declares an entry with its status lines, formatted by the preprocessor.
+ */
+#define ECHO_STATUS(code, reason) \
+  { code, reason, \
+    "Status: " #code " " reason "\r\n", \
+    sizeof("Status: " #code " " reason "\r\n") - 1, \
+    "HTTP/1.1 " #code " " reason "\r\n", \
+    sizeof("HTTP/1.1 " #code " " reason "\r\n") - 1 }
+
+/** The entries, sorted by code. */
+static const StatusTable::Entry ENTRIES[] = {
+  ECHO_STATUS(100, "Continue"),
+  ECHO_STATUS(101, "Switching Protocols"),
+  ECHO_STATUS(102, "Processing"),
+  ECHO_STATUS(110, "Response is stale"),
+  ECHO_STATUS(111, "Revalidation failed"),
+  ECHO_STATUS(112, "Disconnected operation"),
+  ECHO_STATUS(113, "Heuristic expiration"),
+  ECHO_STATUS(199, "Miscellaneous warning"),
+  ECHO_STATUS(200, "OK"),
+  ECHO_STATUS(201, "Created"),
+  ECHO_STATUS(202, "Accepted"),
+  ECHO_STATUS(203, "Non-Authoritative Information"),
+  ECHO_STATUS(204, "No Content"),
+  ECHO_STATUS(205, "Reset Content"),
+  ECHO_STATUS(206, "Partial Content"),
+  ECHO_STATUS(207, "Multi-Status"),
+  ECHO_STATUS(214, "Transformation applied"),
+  ECHO_STATUS(299, "Miscellaneous persistent warning"),
+  ECHO_STATUS(300, "Multiple Choices"),
+  ECHO_STATUS(301, "Moved Permanently"),
+  ECHO_STATUS(302, "Found"),
+  ECHO_STATUS(303, "See Other"),
+  ECHO_STATUS(304, "Not Modified"),
+  ECHO_STATUS(305, "Use Proxy"),
+  ECHO_STATUS(307, "Temporary Redirect"),
+  ECHO_STATUS(400, "Bad Request"),
+  ECHO_STATUS(401, "Unauthorized"),
+  ECHO_STATUS(402, "Payment Required"),
+  ECHO_STATUS(403, "Forbidden"),
+  ECHO_STATUS(404, "Not Found"),
+  ECHO_STATUS(405, "Method Not Allowed"),
+  ECHO_STATUS(406, "Not Acceptable"),
+  ECHO_STATUS(407, "Proxy Authentication Required"),
+  ECHO_STATUS(408, "Request Timeout"),
+  ECHO_STATUS(409, "Conflict"),
+  ECHO_STATUS(410, "Gone"),
+  ECHO_STATUS(411, "Length Required"),
+  ECHO_STATUS(412, "Precondition Failed"),
+  ECHO_STATUS(413, "Request Entity Too Large"),
+  ECHO_STATUS(414, "Request URI Too Long"),
+  ECHO_STATUS(415, "Unsupported Media Type"),
+  ECHO_STATUS(416, "Requested Range Not Satisfiable"),
+  ECHO_STATUS(417, "Expectation Failed"),
+  ECHO_STATUS(422, "Unprocessable Entity"),
+  ECHO_STATUS(423, "Locked"),
+  ECHO_STATUS(424, "Failed Dependency"),
+  ECHO_STATUS(500, "Internal Server Error"),
+  ECHO_STATUS(501, "Not Implemented"),
+  ECHO_STATUS(502, "Bad Gateway"),
+  ECHO_STATUS(503, "Service Unavailable"),
+  ECHO_STATUS(504, "Gateway Timeout"),
+  ECHO_STATUS(505, "Version Not Supported"),
+  ECHO_STATUS(507, "Insufficient Storage"),
+  ECHO_STATUS(1000, "Connection Error"),
+  ECHO_STATUS(1001, "Communication Error"),
+  ECHO_STATUS(1002, "Internal Connector Error")
+};
+
+#undef ECHO_STATUS
+
+/** The first code of the index. */
+static const int FIRST_CODE = 100;
+
+/** The first connector error code, indexed separately. */
+static const int FIRST_CONNECTOR_CODE = 1000;
+
+/** The position of the first connector error entry. */
+static const int FIRST_CONNECTOR_ENTRY = 53;
+
+/** The number of connector error entries. */
+static const int CONNECTOR_ENTRIES = 3;
+
+/**
+ * The position plus one of the entry of each code from 100 to 599, or 0 if the
+ * code isn't well-known.
+ */
+static const unsigned char INDEX[500] = {
+  /* 100 */ 1, 2, 3, 0, 0, 0, 0, 0, 0, 0,
+  /* 110 */ 4, 5, 6, 7, 0, 0, 0, 0, 0, 0,
+  /* 120 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 130 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 140 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 150 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 160 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 170 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 180 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 190 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 8,
+  /* 200 */ 9, 10, 11, 12, 13, 14, 15, 16, 0, 0,
+  /* 210 */ 0, 0, 0, 0, 17, 0, 0, 0, 0, 0,
+  /* 220 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 230 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 240 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 250 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 260 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 270 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 280 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 290 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 18,
+  /* 300 */ 19, 20, 21, 22, 23, 24, 0, 25, 0, 0,
+  /* 310 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 320 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 330 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 340 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 350 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 360 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 370 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 380 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 390 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 400 */ 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
+  /* 410 */ 36, 37, 38, 39, 40, 41, 42, 43, 0, 0,
+  /* 420 */ 0, 0, 44, 45, 46, 0, 0, 0, 0, 0,
+  /* 430 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 440 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 450 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 460 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 470 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 480 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 490 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 500 */ 47, 48, 49, 50, 51, 52, 0, 53, 0, 0,
+  /* 510 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 520 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 530 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 540 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 550 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 560 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 570 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 580 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  /* 590 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+void StatusTable::appendCgiLine(std::string& buffer, int code,
+                                const std::string& reason) {
+  const Entry* entry = find(code);
+
+  if ((entry != NULL) && (reason.empty() || (reason == entry->reason))) {
+    buffer.append(entry->cgiLine, entry->cgiLength);
+  } else {
+    appendLine(buffer, "Status: ", code,
+               reason.empty() && (entry != NULL) ? entry->reason : reason);
+  }
+}
+
+void StatusTable::appendHttpLine(std::string& buffer, int code,
+                                 const std::string& reason) {
+  const Entry* entry = find(code);
+
+  if ((entry != NULL) && (reason.empty() || (reason == entry->reason))) {
+    buffer.append(entry->httpLine, entry->httpLength);
+  } else {
+    appendLine(buffer, "HTTP/1.1 ", code,
+               reason.empty() && (entry != NULL) ? entry->reason : reason);
+  }
+}
+
+const StatusTable::Entry* StatusTable::find(int code) {
+  const unsigned int offset = code - FIRST_CODE;
+
+  if (offset < sizeof(INDEX)) {
+    const int position = INDEX[offset];
+    return (position == 0) ? NULL : &ENTRIES[position - 1];
+  }
+
+  const unsigned int connectorOffset = code - FIRST_CONNECTOR_CODE;
+  return (connectorOffset < static_cast<unsigned int>(CONNECTOR_ENTRIES))
+         ? &ENTRIES[FIRST_CONNECTOR_ENTRY + connectorOffset] : NULL;
+}
+
+void StatusTable::appendLine(std::string& buffer, const char* prefix,
+                             int code, const std::string& reason) {
+  char digits[16];
+  snprintf(digits, sizeof(digits), "%d ", code);
+  buffer.append(prefix);
+  buffer.append(digits);
+
+  // The reason phrase must not break the header
+  for (std::string::size_type i = 0; i < reason.size(); i++) {
+    buffer += ((reason[i] == '\r') || (reason[i] == '\n')) ? ' ' : reason[i];
+  }
+
+  buffer.append("\r\n");
+}
+
+} // namespace http
+} // namespace engine
+} // namespace echo
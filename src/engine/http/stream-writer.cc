@@ -0,0 +1,149 @@
+#include <echo/engine/http/stream-writer.h>
+
+#include <stdio.h>
+
+#include <echo/engine/util/chunk-buffer.h>
+
+namespace echo {
+namespace engine {
+namespace http {
+
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::ChunkStream;
+
+/** The size of the vectors given to writev(), header and trailer included. */
+static const int VECTOR_SIZE = 16;
+
+/** The FastCGI protocol version. */
+static const unsigned char FCGI_VERSION_1 = 1;
+
+/** The FastCGI record type carrying the response. */
+static const unsigned char FCGI_STDOUT = 6;
+
+/** The size of the FastCGI record headers. */
+static const size_t FCGI_HEADER_LEN = 8;
+
+/** The maximum content length of a FastCGI record. */
+static const size_t FCGI_MAX_LENGTH = 65535;
+
+/** The bytes padding FastCGI records to a multiple of eight bytes. */
+static const char PADDING[8] = { 0 };
+
+/** The trailer of the chunks. */
+static const char CRLF[] = "\r\n";
+
+/** The last empty chunk, without trailer fields. */
+static const char LAST_CHUNK[] = "0\r\n\r\n";
+
+StreamWriter::StreamWriter(int format, int requestId)
+    : format(format), requestId(requestId) {
+}
+
+ssize_t StreamWriter::finish(int file) {
+  struct iovec vectors[VECTOR_SIZE];
+  return ChunkBuffer::writeVectors(file, vectors, getLastFrame(vectors));
+}
+
+ssize_t StreamWriter::flush(int file, ChunkStream& stream) {
+  struct iovec vectors[VECTOR_SIZE];
+  ssize_t result = 0;
+  size_t length = 0;
+  int count = 0;
+
+  while ((count = getFrame(stream, vectors, VECTOR_SIZE, length)) > 0) {
+    if (ChunkBuffer::writeVectors(file, vectors, count) == -1) {
+      stream.abort();
+      return -1;
+    }
+
+    stream.consume(length);
+    result += length;
+  }
+
+  return result;
+}
+
+int StreamWriter::getFrame(ChunkStream& stream, struct iovec* vectors,
+                           int count, size_t& length) {
+  // The first vector holds the header, the last ones the trailer
+  count = stream.getVectors(vectors + 1, count - 2);
+  length = 0;
+
+  if (count == 0) {
+    return 0;
+  }
+
+  for (int i = 0; i < count; i++) {
+    // A FastCGI record can't hold more than 64 KB
+    if ((format == FASTCGI)
+        && (length + vectors[i + 1].iov_len > FCGI_MAX_LENGTH)) {
+      vectors[i + 1].iov_len = FCGI_MAX_LENGTH - length;
+      count = i + 1;
+    }
+
+    length += vectors[i + 1].iov_len;
+  }
+
+  return setFrame(vectors, count, length);
+}
+
+int StreamWriter::getLastFrame(struct iovec* vectors) {
+  return setFrame(vectors, 0, 0);
+}
+
+bool StreamWriter::transfer(int file, ChunkStream& stream, int timeout) {
+  while (!stream.isDone()) {
+    if (!stream.await(timeout) || (flush(file, stream) == -1)) {
+      stream.abort();
+      return false;
+    }
+  }
+
+  if (stream.isAborted() || (finish(file) == -1)) {
+    stream.abort();
+    return false;
+  }
+
+  return true;
+}
+
+int StreamWriter::setFrame(struct iovec* vectors, int count, size_t length) {
+  int last = count + 1;
+
+  if (format == FASTCGI) {
+    const size_t padding = (8 - (length % 8)) % 8;
+    header[0] = FCGI_VERSION_1;
+    header[1] = FCGI_STDOUT;
+    header[2] = (requestId >> 8) & 0xff;
+    header[3] = requestId & 0xff;
+    header[4] = (length >> 8) & 0xff;
+    header[5] = length & 0xff;
+    header[6] = padding;
+    header[7] = 0;
+    vectors[0].iov_base = header;
+    vectors[0].iov_len = FCGI_HEADER_LEN;
+
+    if (padding > 0) {
+      vectors[last].iov_base = const_cast<char*>(PADDING);
+      vectors[last++].iov_len = padding;
+    }
+  } else if (length == 0) {
+    vectors[0].iov_base = const_cast<char*>(LAST_CHUNK);
+    vectors[0].iov_len = sizeof(LAST_CHUNK) - 1;
+  } else {
+    vectors[0].iov_base = header;
+    vectors[0].iov_len = snprintf(header, sizeof(header), "%lx\r\n",
+                                  static_cast<unsigned long>(length));
+    vectors[last].iov_base = const_cast<char*>(CRLF);
+    vectors[last++].iov_len = sizeof(CRLF) - 1;
+  }
+
+  return last;
+}
+
+const int StreamWriter::CHUNKED(0);
+const int StreamWriter::FASTCGI(1);
+
+} // namespace http
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,131 @@
+#include <echo/engine/io/deflating-source.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+using echo::engine::util::Deflater;
+
+/** The number of bytes read from the wrapped source at once. */
+static const size_t INPUT_SIZE = 16384;
+
+DeflatingSource::DeflatingSource(ReadableSource* source, bool gzip,
+                                 int level)
+    : source(source), deflater(Deflater::acquire(gzip, level)),
+      listener(NULL), offset(0), pending(false), ended(false) {
+}
+
+DeflatingSource::~DeflatingSource() {
+  close();
+}
+
+void DeflatingSource::close() {
+  if (source != NULL) {
+    source->close();
+    source = NULL;
+  }
+
+  if (deflater != NULL) {
+    Deflater::release(deflater);
+    deflater = NULL;
+  }
+
+  listener = NULL;
+  output.clear();
+  offset = 0;
+}
+
+void DeflatingSource::onReadable(ReadableSource* source) {
+  if (listener != NULL) {
+    listener->onReadable(this);
+  }
+}
+
+ssize_t DeflatingSource::read(char* buffer, size_t length) {
+  if (source == NULL) {
+    errno = EBADF;
+    return -1;
+  }
+
+  if (offset == output.size()) {
+    if (ended) {
+      return 0;
+    } else if (deflater == NULL) {
+      errno = ENOMEM;
+      return -1;
+    } else if (!fill()) {
+      return -1;
+    }
+  }
+
+  const size_t count = std::min(length, output.size() - offset);
+  memcpy(buffer, output.data() + offset, count);
+  offset += count;
+  return count;
+}
+
+void DeflatingSource::resume(ReadableSource::Listener* listener) {
+  if (source != NULL) {
+    this->listener = listener;
+    source->resume(this);
+  }
+}
+
+void DeflatingSource::suspend() {
+  this->listener = NULL;
+
+  if (source != NULL) {
+    source->suspend();
+  }
+}
+
+bool DeflatingSource::fill() {
+  char input[INPUT_SIZE];
+  output.clear();
+  offset = 0;
+
+  // The output stays empty until enough input was compressed, the end of
+  // the wrapped source still producing the trailer of the format
+  while (output.empty() && !ended) {
+    const ssize_t count = source->read(input, sizeof(input));
+
+    if (count > 0) {
+      pending = true;
+
+      if (!deflater->update(input, count, false, output)) {
+        errno = EIO;
+        return false;
+      }
+    } else if (count == 0) {
+      if (!deflater->update(NULL, 0, true, output)) {
+        errno = EIO;
+        return false;
+      }
+
+      Deflater::release(deflater);
+      deflater = NULL;
+      ended = true;
+    } else if ((errno == EAGAIN) && pending) {
+      // The bytes compressed so far go out while the source waits
+      pending = false;
+
+      if (!deflater->flush(output)) {
+        errno = EIO;
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace io
+} // namespace engine
+} // namespace echo
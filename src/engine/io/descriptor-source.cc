@@ -0,0 +1,92 @@
+#include <echo/engine/io/descriptor-source.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+DescriptorSource::DescriptorSource(EventLoop& loop, int file, bool owned)
+    : loop(loop), file(file), owned(owned), registered(false),
+      listener(NULL) {
+  const int flags = fcntl(file, F_GETFL);
+
+  if ((flags != -1) && ((flags & O_NONBLOCK) == 0)) {
+    fcntl(file, F_SETFL, flags | O_NONBLOCK);
+  }
+}
+
+DescriptorSource::~DescriptorSource() {
+  close();
+}
+
+void DescriptorSource::close() {
+  if (file == -1) {
+    return;
+  }
+
+  if (registered) {
+    loop.remove(file);
+    registered = false;
+  }
+
+  if (owned) {
+    ::close(file);
+  }
+
+  file = -1;
+  listener = NULL;
+}
+
+void DescriptorSource::onReady(int file, int events) {
+  if (listener != NULL) {
+    listener->onReadable(this);
+  }
+}
+
+ssize_t DescriptorSource::read(char* buffer, size_t length) {
+  if (file == -1) {
+    errno = EBADF;
+    return -1;
+  }
+
+  ssize_t result;
+
+  do {
+    result = ::read(file, buffer, length);
+  } while ((result == -1) && (errno == EINTR));
+
+  if ((result == -1) && (errno == EWOULDBLOCK)) {
+    errno = EAGAIN;
+  }
+
+  return result;
+}
+
+void DescriptorSource::resume(Listener* listener) {
+  if (file == -1) {
+    return;
+  }
+
+  this->listener = listener;
+
+  if (registered) {
+    loop.modify(file, EventLoop::READABLE);
+  } else {
+    registered = loop.add(file, EventLoop::READABLE, this);
+  }
+}
+
+void DescriptorSource::suspend() {
+  this->listener = NULL;
+
+  if (registered) {
+    loop.modify(file, 0);
+  }
+}
+
+} // namespace io
+} // namespace engine
+} // namespace echo
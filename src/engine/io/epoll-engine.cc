@@ -0,0 +1,253 @@
+#include <echo/engine/io/epoll-engine.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <new>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+using echo::engine::util::ScopedLock;
+
+/** The number of threads reading the files of an engine. */
+static const int READ_THREADS = 2;
+
+EpollEngine::EpollEngine(EventLoop& loop) : loop(loop), stopped(false) {
+  this->buffers = static_cast<char*>(malloc(BUFFER_COUNT * BUFFER_SIZE));
+
+  if (this->buffers == NULL) {
+    throw std::bad_alloc();
+  }
+
+  for (int i = BUFFER_COUNT - 1; i >= 0; i--) {
+    available.push_back(i);
+  }
+
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&queuedReads, NULL);
+
+  for (int i = 0; i < READ_THREADS; i++) {
+    pthread_t thread;
+
+    if (pthread_create(&thread, NULL, run, this) == 0) {
+      threads.push_back(thread);
+    }
+  }
+}
+
+EpollEngine::~EpollEngine() {
+  {
+    ScopedLock guard(&lock);
+    stopped = true;
+    pthread_cond_broadcast(&queuedReads);
+  }
+
+  for (size_t i = 0; i < threads.size(); i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for (size_t i = 0; i < reads.size(); i++) {
+    delete reads[i];
+  }
+
+  pthread_cond_destroy(&queuedReads);
+  pthread_mutex_destroy(&lock);
+
+  for (size_t i = 0; i < queued.size(); i++) {
+    delete queued[i];
+  }
+
+  for (size_t i = 0; i < submitted.size(); i++) {
+    delete submitted[i];
+  }
+
+  for (std::map<int, Operation*>::iterator it = waiting.begin();
+       it != waiting.end(); ++it) {
+    loop.remove(it->first);
+    delete it->second;
+  }
+
+  free(buffers);
+}
+
+void EpollEngine::onReady(int file, int events) {
+  const std::map<int, Operation*>::iterator it = waiting.find(file);
+
+  if (it == waiting.end()) {
+    return;
+  }
+
+  Operation* operation = it->second;
+  waiting.erase(it);
+  loop.remove(file);
+  perform(operation);
+}
+
+bool EpollEngine::read(int handle, long long offset, size_t length,
+                       Completion* completion) {
+  if (available.empty()) {
+    return false;
+  }
+
+  Operation* operation = new Operation();
+  operation->completion = completion;
+  operation->file = handle;
+  operation->offset = offset;
+  operation->length = (length < BUFFER_SIZE) ? length : BUFFER_SIZE;
+  operation->buffer = available.back();
+  operation->result = 0;
+  available.pop_back();
+  queued.push_back(operation);
+  return true;
+}
+
+void EpollEngine::submit() {
+  if (queued.empty()) {
+    return;
+  }
+
+  const bool post = submitted.empty();
+
+  {
+    ScopedLock guard(&lock);
+    const size_t count = reads.size();
+
+    // Without reading threads, the reads are performed by the loop thread
+    for (size_t i = 0; i < queued.size(); i++) {
+      if ((queued[i]->buffer >= 0) && !threads.empty()) {
+        reads.push_back(queued[i]);
+      } else {
+        submitted.push_back(queued[i]);
+      }
+    }
+
+    if (reads.size() > count) {
+      pthread_cond_broadcast(&queuedReads);
+    }
+  }
+
+  queued.clear();
+
+  // A single batch task runs everything submitted before it
+  if (post && !submitted.empty()) {
+    loop.post(new Batch(this));
+  }
+}
+
+bool EpollEngine::write(int file, const struct iovec* vectors, int count,
+                        Completion* completion) {
+  Operation* operation = new Operation();
+  operation->completion = completion;
+  operation->file = file;
+  operation->offset = 0;
+  operation->length = 0;
+  operation->buffer = -1;
+  operation->result = 0;
+  operation->vectors.assign(vectors, vectors + count);
+  queued.push_back(operation);
+  return true;
+}
+
+void EpollEngine::Batch::run() {
+  std::vector<Operation*> operations;
+  operations.swap(engine->submitted);
+
+  for (size_t i = 0; i < operations.size(); i++) {
+    engine->perform(operations[i]);
+  }
+}
+
+void EpollEngine::ReadCompletion::run() {
+  const char* data = engine->buffers + (operation->buffer * BUFFER_SIZE);
+  operation->completion->onComplete(data, operation->result);
+  engine->available.push_back(operation->buffer);
+  delete operation;
+  operation = NULL;
+}
+
+void EpollEngine::perform(Operation* operation) {
+  ssize_t result;
+
+  if (operation->buffer >= 0) {
+    // Read by the loop thread when the reading threads couldn't be started
+    char* data = buffers + (operation->buffer * BUFFER_SIZE);
+
+    do {
+      result = pread(operation->file, data, operation->length,
+                     operation->offset);
+    } while ((result == -1) && (errno == EINTR));
+
+    operation->completion->onComplete(data, (result == -1) ? -errno : result);
+    available.push_back(operation->buffer);
+    delete operation;
+    return;
+  }
+
+  do {
+    result = writev(operation->file, &operation->vectors[0],
+                    operation->vectors.size());
+  } while ((result == -1) && (errno == EINTR));
+
+  int error = (result == -1) ? errno : 0;
+
+  if ((error == EAGAIN) || (error == EWOULDBLOCK)) {
+    // Retried once the socket is writable, unless another handler already
+    // watches it, in which case that handler retries on its own readiness
+    if (loop.add(operation->file, EventLoop::WRITABLE, this)) {
+      waiting[operation->file] = operation;
+      return;
+    } else if (errno != EEXIST) {
+      error = errno;
+    }
+  }
+
+  operation->completion->onComplete(NULL, (error != 0) ? -error : result);
+  delete operation;
+}
+
+void* EpollEngine::run(void* engine) {
+  static_cast<EpollEngine*>(engine)->runReads();
+  return NULL;
+}
+
+void EpollEngine::runReads() {
+  for (;;) {
+    Operation* operation;
+
+    {
+      ScopedLock guard(&lock);
+
+      while (!stopped && reads.empty()) {
+        pthread_cond_wait(&queuedReads, &lock);
+      }
+
+      if (stopped) {
+        return;
+      }
+
+      operation = reads.front();
+      reads.pop_front();
+    }
+
+    // The buffer belongs to the read until its completion runs
+    char* data = buffers + (operation->buffer * BUFFER_SIZE);
+    ssize_t result;
+
+    do {
+      result = pread(operation->file, data, operation->length,
+                     operation->offset);
+    } while ((result == -1) && (errno == EINTR));
+
+    operation->result = (result == -1) ? -errno : result;
+    loop.post(new ReadCompletion(this, operation));
+  }
+}
+
+} // namespace io
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,226 @@
+#include <echo/engine/io/event-loop.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+using echo::engine::util::ScopedLock;
+using echo::engine::util::TimerWheel;
+
+/** The maximum number of events dispatched per iteration. */
+static const int MAX_EVENTS = 64;
+
+/** The number of slots of the timer wheel. */
+static const int WHEEL_SLOTS = 512;
+
+/** The duration of a tick of the timer wheel in milliseconds. */
+static const int WHEEL_TICK = 10;
+
+/** The loop run by the current thread. */
+static __thread EventLoop* currentLoop = NULL;
+
+EventLoop::EventLoop()
+    : wheel(WHEEL_SLOTS, WHEEL_TICK, TimerWheel::currentTimeMillis()) {
+  pthread_mutex_init(&lock, NULL);
+  this->stopped = false;
+  this->file = epoll_create1(EPOLL_CLOEXEC);
+  this->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = wakeup;
+  epoll_ctl(file, EPOLL_CTL_ADD, wakeup, &event);
+}
+
+EventLoop::~EventLoop() {
+  for (size_t i = 0; i < tasks.size(); i++) {
+    delete tasks[i];
+  }
+
+  close(wakeup);
+  close(file);
+  pthread_mutex_destroy(&lock);
+}
+
+bool EventLoop::add(int file, int events, Handler* handler) {
+  struct epoll_event event;
+  event.events = events;
+  event.data.fd = file;
+
+  if (epoll_ctl(this->file, EPOLL_CTL_ADD, file, &event) != 0) {
+    return false;
+  }
+
+  if (static_cast<size_t>(file) >= handlers.size()) {
+    handlers.resize(file + 1, NULL);
+  }
+
+  handlers[file] = handler;
+  return true;
+}
+
+void EventLoop::cancel(Timeout* timeout) {
+  wheel.cancel(timeout);
+}
+
+bool EventLoop::modify(int file, int events) {
+  struct epoll_event event;
+  event.events = events;
+  event.data.fd = file;
+  return epoll_ctl(this->file, EPOLL_CTL_MOD, file, &event) == 0;
+}
+
+int EventLoop::poll(int timeout) {
+  struct epoll_event events[MAX_EVENTS];
+
+  // Wake up on every tick while timeouts are pending
+  if ((wheel.getSize() > 0) && ((timeout < 0) || (timeout > WHEEL_TICK))) {
+    timeout = WHEEL_TICK;
+  }
+
+  int count = epoll_wait(file, events, MAX_EVENTS, timeout);
+
+  if (count == -1) {
+    if (errno != EINTR) {
+      return -1;
+    }
+
+    count = 0;
+  }
+
+  for (int i = 0; i < count; i++) {
+    const int ready = events[i].data.fd;
+
+    if (ready == wakeup) {
+      uint64_t value;
+
+      while (read(wakeup, &value, sizeof(value)) > 0) {
+      }
+
+      continue;
+    }
+
+    // A previous handler of the batch may have removed the descriptor
+    Handler* handler = (static_cast<size_t>(ready) < handlers.size())
+                       ? handlers[ready] : NULL;
+
+    if (handler != NULL) {
+      int flags = events[i].events & (READABLE | WRITABLE);
+
+      if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0) {
+        flags |= CLOSED;
+      }
+
+      handler->onReady(ready, flags);
+    }
+  }
+
+  runTasks();
+
+  if (wheel.getSize() > 0) {
+    std::vector<TimerWheel::Timer*> expired;
+    wheel.advance(TimerWheel::currentTimeMillis(), expired);
+
+    for (size_t i = 0; i < expired.size(); i++) {
+      static_cast<Timeout*>(expired[i])->onTimeout();
+    }
+  }
+
+  return count;
+}
+
+void EventLoop::post(Task* task) {
+  {
+    ScopedLock guard(&lock);
+    tasks.push_back(task);
+  }
+
+  wake();
+}
+
+void EventLoop::remove(int file) {
+  epoll_ctl(this->file, EPOLL_CTL_DEL, file, NULL);
+
+  if (static_cast<size_t>(file) < handlers.size()) {
+    handlers[file] = NULL;
+  }
+}
+
+EventLoop* EventLoop::getCurrent() {
+  return currentLoop;
+}
+
+void EventLoop::run() {
+  EventLoop* const previous = currentLoop;
+  currentLoop = this;
+
+  for (;;) {
+    {
+      ScopedLock guard(&lock);
+
+      if (stopped) {
+        stopped = false;
+        break;
+      }
+    }
+
+    if (poll(-1) == -1) {
+      break;
+    }
+  }
+
+  currentLoop = previous;
+}
+
+void EventLoop::schedule(Timeout* timeout, long long delay) {
+  wheel.schedule(timeout, TimerWheel::currentTimeMillis() + delay);
+}
+
+void EventLoop::stop() {
+  {
+    ScopedLock guard(&lock);
+    stopped = true;
+  }
+
+  wake();
+}
+
+void EventLoop::runTasks() {
+  std::vector<Task*> pending;
+
+  {
+    ScopedLock guard(&lock);
+    pending.swap(tasks);
+  }
+
+  // Tasks posted while running are run on the next iteration
+  for (size_t i = 0; i < pending.size(); i++) {
+    pending[i]->run();
+    delete pending[i];
+  }
+}
+
+void EventLoop::wake() {
+  const uint64_t value = 1;
+  ssize_t written;
+
+  do {
+    written = write(wakeup, &value, sizeof(value));
+  } while ((written == -1) && (errno == EINTR));
+}
+
+const int EventLoop::READABLE(EPOLLIN);
+const int EventLoop::WRITABLE(EPOLLOUT);
+const int EventLoop::CLOSED(EPOLLHUP);
+
+} // namespace io
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,207 @@
+#include <echo/engine/io/file-source.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+FileSource::FileSource(IoEngine& engine, const std::string& path)
+    : engine(engine), file(-1), handle(-1), size(-1), next(0),
+      listener(NULL), error(0), pending(false), self(new FileSource*(this)) {
+  struct stat status;
+  this->file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if ((file == -1) || (fstat(file, &status) != 0)) {
+    this->error = errno;
+    return;
+  }
+
+  this->size = status.st_size;
+  this->handle = engine.registerFile(file);
+
+  if (handle == -1) {
+    this->error = EMFILE;
+  }
+}
+
+FileSource::~FileSource() {
+  close();
+}
+
+void FileSource::close() {
+  for (size_t i = 0; i < reads.size(); i++) {
+    if (reads[i]->done) {
+      delete reads[i];
+    } else {
+      // Deleted by its completion
+      reads[i]->source = NULL;
+    }
+  }
+
+  reads.clear();
+  staged.clear();
+  listener = NULL;
+  self.reset();
+
+  if (handle != -1) {
+    engine.unregisterFile(handle);
+    handle = -1;
+  }
+
+  if (file != -1) {
+    ::close(file);
+    file = -1;
+  }
+}
+
+ssize_t FileSource::read(char* buffer, size_t length) {
+  if (staged.getSize() > 0) {
+    const ssize_t result = staged.read(buffer, length);
+    fill();
+    return result;
+  }
+
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  if (file == -1) {
+    errno = EBADF;
+    return -1;
+  }
+
+  if (reads.empty() && (next >= size)) {
+    return 0;
+  }
+
+  errno = EAGAIN;
+  return -1;
+}
+
+void FileSource::resume(Listener* listener) {
+  this->listener = listener;
+  fill();
+
+  if (isReadable()) {
+    notify();
+  }
+}
+
+void FileSource::suspend() {
+  this->listener = NULL;
+}
+
+void FileSource::Read::onComplete(const char* data, ssize_t result) {
+  if (source == NULL) {
+    delete this;
+    return;
+  }
+
+  this->done = true;
+  this->result = result;
+
+  if (result > 0) {
+    content.assign(data, result);
+  }
+
+  source->onRead(this);
+}
+
+void FileSource::Notification::run() {
+  const std::tr1::shared_ptr<FileSource*> source = this->source.lock();
+
+  if (!source) {
+    return;
+  }
+
+  FileSource* target = *source;
+  target->pending = false;
+  target->fill();
+
+  if ((target->listener != NULL) && target->isReadable()) {
+    target->listener->onReadable(target);
+  }
+}
+
+void FileSource::fill() {
+  bool queued = false;
+
+  // Stop reading ahead while the reader lags behind
+  while ((file != -1) && (handle != -1) && (error == 0) && (next < size)
+         && (reads.size() < READ_AHEAD)
+         && (staged.getSize() < READ_AHEAD * IoEngine::BUFFER_SIZE)) {
+    const size_t length = (size - next < (long long) IoEngine::BUFFER_SIZE)
+                          ? size - next : IoEngine::BUFFER_SIZE;
+    Read* read = new Read(this, next, length);
+
+    if (!engine.read(handle, next, length, read)) {
+      delete read;
+
+      // All the buffers are used by other sources, retry on the next turn
+      if (reads.empty()) {
+        notify();
+      }
+
+      break;
+    }
+
+    reads.push_back(read);
+    next += length;
+    queued = true;
+  }
+
+  if (queued) {
+    engine.submit();
+  }
+}
+
+bool FileSource::isReadable() const {
+  return (staged.getSize() > 0) || (error != 0)
+         || ((file != -1) && reads.empty() && (next >= size));
+}
+
+void FileSource::notify() {
+  if (!pending && self) {
+    pending = true;
+    engine.getLoop().post(new Notification(self));
+  }
+}
+
+void FileSource::onRead(Read* read) {
+  // Completions may come out of order, the bytes are staged in order
+  while (!reads.empty() && reads.front()->done) {
+    Read* first = reads.front();
+    reads.pop_front();
+
+    if (first->result < 0) {
+      error = -first->result;
+    } else {
+      staged.append(first->content);
+
+      // The file was truncated since it was opened
+      if ((first->result < static_cast<ssize_t>(first->length))
+          && (first->offset + first->result < size)) {
+        size = first->offset + first->result;
+      }
+    }
+
+    delete first;
+  }
+
+  fill();
+
+  if ((listener != NULL) && isReadable()) {
+    listener->onReadable(this);
+  }
+}
+
+const size_t FileSource::READ_AHEAD(4);
+
+} // namespace io
+} // namespace engine
+} // namespace echo
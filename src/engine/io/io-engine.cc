@@ -0,0 +1,31 @@
+#include <echo/engine/io/io-engine.h>
+
+#include <echo/engine/io/epoll-engine.h>
+#include <echo/engine/io/uring-engine.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+IoEngine* IoEngine::create(EventLoop& loop, const std::string& name) {
+#ifdef ECHO_HAVE_LIBURING
+  if (name != "epoll") {
+    UringEngine* result = new UringEngine(loop);
+
+    if (result->isAvailable()) {
+      return result;
+    }
+
+    delete result;
+  }
+#endif
+
+  return new EpollEngine(loop);
+}
+
+const size_t IoEngine::BUFFER_SIZE(65536);
+const int IoEngine::BUFFER_COUNT(64);
+
+} // namespace io
+} // namespace engine
+} // namespace echo
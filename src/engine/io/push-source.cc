@@ -0,0 +1,113 @@
+#include <echo/engine/io/push-source.h>
+
+#include <errno.h>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+using echo::engine::util::ScopedLock;
+
+PushSource::PushSource(EventLoop& loop) : loop(loop), state(new State()) {
+  state->source = this;
+}
+
+PushSource::~PushSource() {
+  close();
+}
+
+void PushSource::close() {
+  ScopedLock guard(&state->lock);
+  state->source = NULL;
+  state->listener = NULL;
+  state->ended = true;
+  state->buffer.clear();
+}
+
+void PushSource::end() {
+  ScopedLock guard(&state->lock);
+
+  if (!state->ended) {
+    state->ended = true;
+    notify();
+  }
+}
+
+size_t PushSource::getSize() {
+  ScopedLock guard(&state->lock);
+  return state->buffer.getSize();
+}
+
+bool PushSource::offer(const char* data, size_t length) {
+  ScopedLock guard(&state->lock);
+
+  if (state->ended) {
+    return false;
+  }
+
+  state->buffer.append(data, length);
+  notify();
+  return true;
+}
+
+ssize_t PushSource::read(char* buffer, size_t length) {
+  ScopedLock guard(&state->lock);
+
+  if (state->buffer.getSize() == 0) {
+    if (state->ended) {
+      return 0;
+    }
+
+    errno = EAGAIN;
+    return -1;
+  }
+
+  return state->buffer.read(buffer, length);
+}
+
+void PushSource::resume(Listener* listener) {
+  ScopedLock guard(&state->lock);
+  state->listener = listener;
+
+  if ((state->buffer.getSize() > 0) || state->ended) {
+    notify();
+  }
+}
+
+void PushSource::suspend() {
+  ScopedLock guard(&state->lock);
+  state->listener = NULL;
+}
+
+void PushSource::notify() {
+  if ((state->listener != NULL) && !state->pending) {
+    state->pending = true;
+    loop.post(new Notification(state));
+  }
+}
+
+void PushSource::Notification::run() {
+  PushSource* source = NULL;
+  Listener* listener = NULL;
+
+  {
+    ScopedLock guard(&state->lock);
+    state->pending = false;
+
+    if ((state->buffer.getSize() > 0) || state->ended) {
+      source = state->source;
+      listener = state->listener;
+    }
+  }
+
+  // The source is only closed by the loop thread, which runs this task
+  if ((source != NULL) && (listener != NULL)) {
+    listener->onReadable(source);
+  }
+}
+
+} // namespace io
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,140 @@
+#include <echo/engine/io/transfer.h>
+
+#include <errno.h>
+#include <sys/uio.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+using echo::engine::util::ChunkBuffer;
+
+/** The number of vectors given to each writev() call. */
+static const int VECTOR_SIZE = 16;
+
+/** The size of the buffer receiving the bytes read. */
+static const size_t READ_SIZE = 16384;
+
+Transfer::Transfer(EventLoop& loop, ReadableSource* source, int target,
+                   size_t highWaterMark)
+    : loop(loop), source(source), target(target),
+      highWaterMark(highWaterMark), listener(NULL), ended(false),
+      suspended(true), registered(false), transferred(0) {
+}
+
+Transfer::~Transfer() {
+  if (listener != NULL) {
+    source->suspend();
+    unregister();
+  }
+}
+
+void Transfer::onReadable(ReadableSource* source) {
+  char buffer[READ_SIZE];
+
+  while (!ended && (staged.getSize() < highWaterMark)) {
+    const ssize_t count = source->read(buffer, sizeof(buffer));
+
+    if (count > 0) {
+      staged.append(buffer, count);
+    } else if (count == 0) {
+      ended = true;
+    } else if (errno == EAGAIN) {
+      break;
+    } else {
+      complete(false);
+      return;
+    }
+  }
+
+  // Hold the source back until the destination drains the staged bytes
+  if (ended || (staged.getSize() >= highWaterMark)) {
+    source->suspend();
+    suspended = true;
+  }
+
+  flush();
+}
+
+void Transfer::onReady(int file, int events) {
+  if ((events & EventLoop::WRITABLE) != 0) {
+    flush();
+  } else if ((events & EventLoop::CLOSED) != 0) {
+    complete(false);
+  }
+}
+
+void Transfer::start(Listener* listener) {
+  this->listener = listener;
+  this->suspended = false;
+  source->resume(this);
+}
+
+void Transfer::complete(bool success) {
+  Listener* listener = this->listener;
+
+  if (listener == NULL) {
+    return;
+  }
+
+  this->listener = NULL;
+  source->suspend();
+  suspended = true;
+  unregister();
+  staged.clear();
+
+  // The listener may delete the transfer
+  listener->onComplete(this, success);
+}
+
+void Transfer::flush() {
+  struct iovec vectors[VECTOR_SIZE];
+
+  while (staged.getSize() > 0) {
+    const int count = staged.getVectors(vectors, VECTOR_SIZE);
+    const ssize_t written = writev(target, vectors, count);
+
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+        // Wait for the destination to drain
+        if (!registered) {
+          registered = loop.add(target, EventLoop::WRITABLE, this);
+        }
+
+        return;
+      }
+
+      complete(false);
+      return;
+    }
+
+    staged.consume(written);
+    transferred += written;
+  }
+
+  unregister();
+
+  if (ended) {
+    complete(true);
+  } else if (suspended && (listener != NULL)) {
+    suspended = false;
+    source->resume(this);
+  }
+}
+
+void Transfer::unregister() {
+  if (registered) {
+    loop.remove(target);
+    registered = false;
+  }
+}
+
+const size_t Transfer::DEFAULT_HIGH_WATER_MARK(256 * 1024);
+
+} // namespace io
+} // namespace engine
+} // namespace echo
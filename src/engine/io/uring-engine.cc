@@ -0,0 +1,209 @@
+#include <echo/engine/io/uring-engine.h>
+
+#ifdef ECHO_HAVE_LIBURING
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace echo {
+namespace engine {
+namespace io {
+
+/** The alignment of the registered buffers. */
+static const size_t PAGE_SIZE = 4096;
+
+UringEngine::UringEngine(EventLoop& loop)
+    : loop(loop), wakeup(-1), available(false), buffers(NULL), queued(0) {
+  if (io_uring_queue_init(QUEUE_DEPTH, &ring, 0) != 0) {
+    return;
+  }
+
+  void* memory = NULL;
+
+  if (posix_memalign(&memory, PAGE_SIZE, BUFFER_COUNT * BUFFER_SIZE) == 0) {
+    this->buffers = static_cast<char*>(memory);
+  }
+
+  std::vector<struct iovec> vectors(BUFFER_COUNT);
+
+  for (int i = 0; (buffers != NULL) && (i < BUFFER_COUNT); i++) {
+    vectors[i].iov_base = buffers + (i * BUFFER_SIZE);
+    vectors[i].iov_len = BUFFER_SIZE;
+  }
+
+  files.assign(FILE_COUNT, -1);
+  this->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  // Older kernels lack sparse file tables or eventfd registration
+  this->available = (buffers != NULL)
+      && (io_uring_register_buffers(&ring, &vectors[0], BUFFER_COUNT) == 0)
+      && (io_uring_register_files(&ring, &files[0], FILE_COUNT) == 0)
+      && (wakeup != -1)
+      && (io_uring_register_eventfd(&ring, wakeup) == 0)
+      && loop.add(wakeup, EventLoop::READABLE, this);
+
+  if (!available) {
+    io_uring_queue_exit(&ring);
+
+    if (wakeup != -1) {
+      close(wakeup);
+      this->wakeup = -1;
+    }
+
+    free(buffers);
+    this->buffers = NULL;
+    return;
+  }
+
+  for (int i = BUFFER_COUNT - 1; i >= 0; i--) {
+    freeBuffers.push_back(i);
+  }
+}
+
+UringEngine::~UringEngine() {
+  if (!available) {
+    return;
+  }
+
+  loop.remove(wakeup);
+  io_uring_queue_exit(&ring);
+  close(wakeup);
+  free(buffers);
+}
+
+void UringEngine::onReady(int file, int events) {
+  uint64_t value;
+
+  while (::read(wakeup, &value, sizeof(value)) > 0) {
+  }
+
+  struct io_uring_cqe* entry = NULL;
+
+  while (io_uring_peek_cqe(&ring, &entry) == 0) {
+    Operation* operation = static_cast<Operation*>(
+        io_uring_cqe_get_data(entry));
+    const ssize_t result = entry->res;
+    io_uring_cqe_seen(&ring, entry);
+
+    const char* data = (operation->buffer >= 0)
+                       ? buffers + (operation->buffer * BUFFER_SIZE) : NULL;
+    operation->completion->onComplete(data, result);
+
+    if (operation->buffer >= 0) {
+      freeBuffers.push_back(operation->buffer);
+    }
+
+    delete operation;
+  }
+
+  // The completions typically queued the next reads of their transfers
+  submit();
+}
+
+bool UringEngine::read(int handle, long long offset, size_t length,
+                       Completion* completion) {
+  if (freeBuffers.empty()) {
+    return false;
+  }
+
+  struct io_uring_sqe* entry = getEntry();
+
+  if (entry == NULL) {
+    return false;
+  }
+
+  Operation* operation = new Operation();
+  operation->completion = completion;
+  operation->buffer = freeBuffers.back();
+  freeBuffers.pop_back();
+
+  // The files left out of the full table are read through their descriptor
+  const bool registered = handle < FILE_COUNT;
+  io_uring_prep_read_fixed(entry, registered ? handle : handle - FILE_COUNT,
+                           buffers + (operation->buffer * BUFFER_SIZE),
+                           (length < BUFFER_SIZE) ? length : BUFFER_SIZE,
+                           offset, operation->buffer);
+
+  if (registered) {
+    io_uring_sqe_set_flags(entry, IOSQE_FIXED_FILE);
+  }
+
+  io_uring_sqe_set_data(entry, operation);
+  queued++;
+  return true;
+}
+
+int UringEngine::registerFile(int file) {
+  for (int i = 0; i < FILE_COUNT; i++) {
+    if (files[i] == -1) {
+      if (io_uring_register_files_update(&ring, i, &file, 1) < 0) {
+        break;
+      }
+
+      files[i] = file;
+      return i;
+    }
+  }
+
+  return FILE_COUNT + file;
+}
+
+void UringEngine::submit() {
+  if (queued > 0) {
+    io_uring_submit(&ring);
+    queued = 0;
+  }
+}
+
+void UringEngine::unregisterFile(int handle) {
+  if ((handle < 0) || (handle >= FILE_COUNT) || (files[handle] == -1)) {
+    return;
+  }
+
+  // Reads in flight keep their own reference to the file
+  int none = -1;
+  io_uring_register_files_update(&ring, handle, &none, 1);
+  files[handle] = -1;
+}
+
+bool UringEngine::write(int file, const struct iovec* vectors, int count,
+                        Completion* completion) {
+  struct io_uring_sqe* entry = getEntry();
+
+  if (entry == NULL) {
+    return false;
+  }
+
+  Operation* operation = new Operation();
+  operation->completion = completion;
+  operation->buffer = -1;
+  operation->vectors.assign(vectors, vectors + count);
+
+  io_uring_prep_writev(entry, file, &operation->vectors[0], count, 0);
+  io_uring_sqe_set_data(entry, operation);
+  queued++;
+  return true;
+}
+
+struct io_uring_sqe* UringEngine::getEntry() {
+  struct io_uring_sqe* result = io_uring_get_sqe(&ring);
+
+  if ((result == NULL) && (queued > 0)) {
+    submit();
+    result = io_uring_get_sqe(&ring);
+  }
+
+  return result;
+}
+
+const unsigned UringEngine::QUEUE_DEPTH(256);
+const int UringEngine::FILE_COUNT(1024);
+
+} // namespace io
+} // namespace engine
+} // namespace echo
+
+#endif // ECHO_HAVE_LIBURING
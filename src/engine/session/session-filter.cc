@@ -0,0 +1,122 @@
+#include <echo/engine/session/session-filter.h>
+
+#include <stdio.h>
+
+namespace echo {
+namespace engine {
+namespace session {
+
+SessionFilter::SessionFilter(echo::Context context, Echo::Echo next) {
+  Filter(context, next);
+  this->store = SessionStore::getStore(context);
+  this->ownedStore = false;
+
+  if (this->store == NULL) {
+    this->store = new SessionStore();
+
+    // A registered store is shared with the other filters of the context
+    if (context != NULL) {
+      SessionStore::setStore(context, this->store);
+    } else {
+      this->ownedStore = true;
+    }
+  }
+
+  this->cookieTemplate = new CookieSetting(DEFAULT_COOKIE_NAME, NULL);
+  this->cookieTemplate.setPath("/");
+  this->cookieTemplate.setAccessRestricted(true);
+}
+
+SessionFilter::~SessionFilter() {
+  if (this->ownedStore) {
+    delete this->store;
+  }
+}
+
+void SessionFilter::close(echo::Request request, echo::Response response) {
+  const std::string id = request.getCookieValue(
+      cookieTemplate.getName());
+
+  if (id != NULL) {
+    store->remove(id);
+    request.getAttributes().remove(ATTRIBUTE_ID);
+    request.getAttributes().remove(ATTRIBUTE_DATA);
+    addCookieSetting(response, "", 0);
+  }
+}
+
+std::string SessionFilter::open(echo::Request request, echo::Response response,
+                                const std::string& identifier,
+                                const std::string& data) {
+  const std::string result = store->create(identifier, data);
+  request.getAttributes().put(ATTRIBUTE_ID, result);
+  request.getAttributes().put(ATTRIBUTE_DATA, data);
+  addCookieSetting(response, result, cookieTemplate.getMaxAge());
+  return result;
+}
+
+void SessionFilter::start() throw (std::runtime_error) {
+  if (isStopped()) {
+    // A missing snapshot is expected on the first start
+    if (!snapshotPath.empty() && store->load(snapshotPath)) {
+      char count[16];
+      snprintf(count, sizeof(count), "%d", store->getSize());
+      getLogger().fine(std::string("Reloaded ") + count + " sessions from "
+                       + snapshotPath);
+    }
+
+    super.start();
+  }
+}
+
+void SessionFilter::stop() throw (std::runtime_error) {
+  if (isStarted()) {
+    super.stop();
+
+    if (!snapshotPath.empty() && !store->save(snapshotPath)) {
+      getLogger().warning("Unable to save the sessions to " + snapshotPath);
+    }
+  }
+}
+
+int SessionFilter::beforeHandle(echo::Request request,
+                                echo::Response response) {
+  const std::string id = request.getCookieValue(cookieTemplate.getName());
+  std::string identifier;
+  std::string data;
+
+  if ((id == NULL) || !store->get(id, identifier, data)) {
+    return CONTINUE;
+  }
+
+  request.getAttributes().put(ATTRIBUTE_ID, id);
+  request.getAttributes().put(ATTRIBUTE_DATA, data);
+
+  // The session cookie vouches for the user it was opened for
+  if (!identifier.empty() && (request.getChallengeResponse() == NULL)) {
+    request.setChallengeResponse(new ChallengeResponse(
+        ChallengeScheme.HTTP_COOKIE, identifier, id));
+    request.getClientInfo().setAuthenticated(true);
+  }
+
+  return CONTINUE;
+}
+
+void SessionFilter::addCookieSetting(echo::Response response,
+                                     const std::string& value, int maxAge) {
+  CookieSetting cookieSetting = new CookieSetting(cookieTemplate, value);
+
+  if (maxAge != cookieTemplate.getMaxAge()) {
+    cookieSetting.setMaxAge(maxAge);
+  }
+
+  response.getCookieSettings().add(cookieSetting);
+}
+
+const std::string SessionFilter::ATTRIBUTE_ID("echo.engine.session.id");
+const std::string SessionFilter::ATTRIBUTE_DATA("echo.engine.session.data");
+const std::string SessionFilter::DEFAULT_COOKIE_NAME("ECHOSESSIONID");
+
+} // namespace session
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,463 @@
+#include <echo/engine/session/session-store.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace session {
+
+using echo::engine::util::ScopedLock;
+using echo::engine::util::TimerWheel;
+
+/** The magic number starting the snapshot files. */
+static const char SNAPSHOT_MAGIC[8] = { 'E', 'C', 'H', 'O', 'S', 'E', 'S', '1' };
+
+/** The size of the fixed part of a snapshot record. */
+static const size_t RECORD_HEADER_SIZE = 3 * sizeof(uint32_t)
+                                         + sizeof(int64_t);
+
+/** The number of random bytes of a session identifier. */
+static const size_t ID_SIZE = 16;
+
+/** The number of slots of the expiry wheels. */
+static const int WHEEL_SLOTS = 512;
+
+/** The tick of the expiry wheels in milliseconds. */
+static const long long WHEEL_TICK = 1000;
+
+/**
+ * Appends a value to a snapshot buffer.
+ */
+static void append(std::string& buffer, const void* value, size_t length) {
+  buffer.append(static_cast<const char*>(value), length);
+}
+
+SessionStore* SessionStore::getStore(Context context) {
+  return (context == NULL) ? NULL
+         : (SessionStore*) context.getAttributes().get(ATTRIBUTE);
+}
+
+void SessionStore::setStore(Context context, SessionStore* store) {
+  context.getAttributes().put(ATTRIBUTE, store);
+}
+
+SessionStore::SessionStore() {
+  this->maxSessions = DEFAULT_MAX_SESSIONS;
+  this->timeToLive = DEFAULT_TIME_TO_LIVE;
+  initialize();
+}
+
+SessionStore::SessionStore(int maxSessions, int timeToLive) {
+  this->maxSessions = maxSessions;
+  this->timeToLive = timeToLive;
+  initialize();
+}
+
+SessionStore::~SessionStore() {
+  for (int i = 0; i < SHARDS; i++) {
+    Shard& shard = shards[i];
+
+    for (EntryMap::iterator it = shard.entries.begin();
+         it != shard.entries.end(); ++it) {
+      delete it->second;
+    }
+
+    delete shard.wheel;
+    pthread_mutex_destroy(&shard.lock);
+    shard.~Shard();
+  }
+
+  free(shards);
+
+  if (random != -1) {
+    close(random);
+  }
+}
+
+void SessionStore::initialize() {
+  const long long now = TimerWheel::currentTimeMillis();
+  void* memory = NULL;
+
+  // The shards must not share cache lines, which operator new[] doesn't
+  // guarantee for over-aligned types
+  if (posix_memalign(&memory, __alignof__(Shard), SHARDS * sizeof(Shard))
+      != 0) {
+    throw std::bad_alloc();
+  }
+
+  this->shards = static_cast<Shard*>(memory);
+  this->maxShardSessions = (maxSessions + SHARDS - 1) / SHARDS;
+  this->random = open("/dev/urandom", O_RDONLY);
+
+  for (int i = 0; i < SHARDS; i++) {
+    Shard* shard = new (&shards[i]) Shard();
+    pthread_mutex_init(&shard->lock, NULL);
+    shard->wheel = new TimerWheel(WHEEL_SLOTS, WHEEL_TICK, now);
+    shard->oldest = NULL;
+    shard->newest = NULL;
+  }
+}
+
+std::string SessionStore::create(const std::string& identifier,
+                                 const std::string& data)
+    throw (std::runtime_error) {
+  static const char* DIGITS = "0123456789abcdef";
+  unsigned char bytes[ID_SIZE];
+  size_t count = 0;
+
+  while ((random != -1) && (count < ID_SIZE)) {
+    const ssize_t result = read(random, bytes + count, ID_SIZE - count);
+
+    if (result > 0) {
+      count += result;
+    } else if ((result == -1) && (errno != EINTR)) {
+      break;
+    }
+  }
+
+  if (count < ID_SIZE) {
+    throw std::runtime_error("Unable to generate a session identifier");
+  }
+
+  std::string id(2 * ID_SIZE, '0');
+
+  for (size_t i = 0; i < ID_SIZE; i++) {
+    id[2 * i] = DIGITS[bytes[i] >> 4];
+    id[2 * i + 1] = DIGITS[bytes[i] & 0xf];
+  }
+
+  Shard& shard = getShard(id);
+  ScopedLock lock(&shard.lock);
+  expire(shard, TimerWheel::currentTimeMillis());
+  insert(shard, id, identifier, data, timeToLive * 1000LL);
+  return id;
+}
+
+bool SessionStore::get(const std::string& id, std::string& identifier,
+                       std::string& data) {
+  const long long now = TimerWheel::currentTimeMillis();
+  Shard& shard = getShard(id);
+  ScopedLock lock(&shard.lock);
+  expire(shard, now);
+
+  const EntryMap::iterator it = shard.entries.find(id);
+
+  if (it == shard.entries.end()) {
+    return false;
+  }
+
+  touch(shard, it->second, now);
+  identifier = it->second->identifier;
+  data = it->second->data;
+  return true;
+}
+
+int SessionStore::getSize() {
+  const long long now = TimerWheel::currentTimeMillis();
+  int result = 0;
+
+  for (int i = 0; i < SHARDS; i++) {
+    ScopedLock lock(&shards[i].lock);
+    expire(shards[i], now);
+    result += shards[i].entries.size();
+  }
+
+  return result;
+}
+
+bool SessionStore::load(const std::string& path) {
+  const int file = open(path.c_str(), O_RDONLY);
+
+  if (file == -1) {
+    return false;
+  }
+
+  struct stat status;
+  const char* snapshot = NULL;
+
+  if ((fstat(file, &status) == 0)
+      && (static_cast<size_t>(status.st_size)
+          >= sizeof(SNAPSHOT_MAGIC) + sizeof(uint64_t))) {
+    void* mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    if (mapped != MAP_FAILED) {
+      snapshot = static_cast<const char*>(mapped);
+    }
+  }
+
+  close(file);
+
+  if (snapshot == NULL) {
+    return false;
+  }
+
+  const size_t size = status.st_size;
+  bool result = (memcmp(snapshot, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0);
+  const long long now = TimerWheel::currentTimeMillis();
+  size_t position = sizeof(SNAPSHOT_MAGIC);
+  uint64_t count;
+
+  if (result) {
+    memcpy(&count, snapshot + position, sizeof(count));
+    position += sizeof(count);
+  }
+
+  for (uint64_t i = 0; result && (i < count); i++) {
+    uint32_t lengths[3];
+    int64_t remaining;
+
+    if (size - position < RECORD_HEADER_SIZE) {
+      result = false;
+      break;
+    }
+
+    memcpy(lengths, snapshot + position, sizeof(lengths));
+    memcpy(&remaining, snapshot + position + sizeof(lengths),
+           sizeof(remaining));
+    position += RECORD_HEADER_SIZE;
+
+    const uint64_t length = static_cast<uint64_t>(lengths[0]) + lengths[1]
+                            + lengths[2];
+
+    if (size - position < length) {
+      result = false;
+      break;
+    }
+
+    const char* record = snapshot + position;
+    position += length;
+
+    if (remaining > 0) {
+      const std::string id(record, lengths[0]);
+      Shard& shard = getShard(id);
+      ScopedLock lock(&shard.lock);
+      expire(shard, now);
+      insert(shard, id, std::string(record + lengths[0], lengths[1]),
+             std::string(record + lengths[0] + lengths[1], lengths[2]),
+             remaining);
+    }
+  }
+
+  munmap(const_cast<char*>(snapshot), size);
+  return result;
+}
+
+bool SessionStore::remove(const std::string& id) {
+  Shard& shard = getShard(id);
+  ScopedLock lock(&shard.lock);
+  const EntryMap::iterator it = shard.entries.find(id);
+
+  if (it == shard.entries.end()) {
+    return false;
+  }
+
+  erase(shard, it->second);
+  return true;
+}
+
+bool SessionStore::save(const std::string& path) {
+  const long long now = TimerWheel::currentTimeMillis();
+  std::string records;
+  uint64_t count = 0;
+
+  // 1 - Serialize the live sessions, one shard at a time
+  for (int i = 0; i < SHARDS; i++) {
+    ScopedLock lock(&shards[i].lock);
+    expire(shards[i], now);
+
+    // From the oldest entry, so that loading restores the same order
+    for (Entry* entry = shards[i].oldest; entry != NULL;
+         entry = entry->newer) {
+      const uint32_t lengths[3] = {
+        static_cast<uint32_t>(entry->id.size()),
+        static_cast<uint32_t>(entry->identifier.size()),
+        static_cast<uint32_t>(entry->data.size())
+      };
+      const int64_t remaining = entry->getDeadline() - now;
+
+      append(records, lengths, sizeof(lengths));
+      append(records, &remaining, sizeof(remaining));
+      records += entry->id;
+      records += entry->identifier;
+      records += entry->data;
+      count++;
+    }
+  }
+
+  // 2 - Write a temporary file through a shared mapping
+  const std::string temporary = path + ".tmp";
+  const size_t size = sizeof(SNAPSHOT_MAGIC) + sizeof(count) + records.size();
+  const int file = open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+  if (file == -1) {
+    return false;
+  }
+
+  bool result = (ftruncate(file, size) == 0);
+
+  if (result) {
+    void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file,
+                        0);
+    result = (mapped != MAP_FAILED);
+
+    if (result) {
+      char* snapshot = static_cast<char*>(mapped);
+      memcpy(snapshot, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+      memcpy(snapshot + sizeof(SNAPSHOT_MAGIC), &count, sizeof(count));
+
+      if (!records.empty()) {
+        memcpy(snapshot + sizeof(SNAPSHOT_MAGIC) + sizeof(count),
+               records.data(), records.size());
+      }
+
+      result = (msync(mapped, size, MS_SYNC) == 0);
+      munmap(mapped, size);
+    }
+  }
+
+  close(file);
+
+  // 3 - Atomically replace the previous snapshot
+  if (result) {
+    result = (rename(temporary.c_str(), path.c_str()) == 0);
+  }
+
+  if (!result) {
+    unlink(temporary.c_str());
+  }
+
+  return result;
+}
+
+bool SessionStore::update(const std::string& id, const std::string& data) {
+  const long long now = TimerWheel::currentTimeMillis();
+  Shard& shard = getShard(id);
+  ScopedLock lock(&shard.lock);
+  expire(shard, now);
+
+  const EntryMap::iterator it = shard.entries.find(id);
+
+  if (it == shard.entries.end()) {
+    return false;
+  }
+
+  touch(shard, it->second, now);
+  it->second->data = data;
+  return true;
+}
+
+void SessionStore::insert(Shard& shard, const std::string& id,
+                          const std::string& identifier,
+                          const std::string& data, long long timeToLive) {
+  const EntryMap::iterator it = shard.entries.find(id);
+
+  if (it != shard.entries.end()) {
+    erase(shard, it->second);
+  }
+
+  if ((shard.entries.size() >= maxShardSessions) && (shard.oldest != NULL)) {
+    erase(shard, shard.oldest);
+  }
+
+  Entry* entry = new Entry();
+  entry->id = id;
+  entry->identifier = identifier;
+  entry->data = data;
+  entry->older = shard.newest;
+  entry->newer = NULL;
+
+  if (shard.newest != NULL) {
+    shard.newest->newer = entry;
+  } else {
+    shard.oldest = entry;
+  }
+
+  shard.newest = entry;
+  shard.entries[id] = entry;
+  shard.wheel->schedule(entry,
+                        TimerWheel::currentTimeMillis() + timeToLive);
+}
+
+void SessionStore::expire(Shard& shard, long long now) {
+  std::vector<TimerWheel::Timer*> expired;
+  shard.wheel->advance(now, expired);
+
+  for (size_t i = 0; i < expired.size(); i++) {
+    erase(shard, static_cast<Entry*>(expired[i]));
+  }
+}
+
+void SessionStore::erase(Shard& shard, Entry* entry) {
+  shard.wheel->cancel(entry);
+  shard.entries.erase(entry->id);
+
+  if (entry->older != NULL) {
+    entry->older->newer = entry->newer;
+  } else {
+    shard.oldest = entry->newer;
+  }
+
+  if (entry->newer != NULL) {
+    entry->newer->older = entry->older;
+  } else {
+    shard.newest = entry->older;
+  }
+
+  delete entry;
+}
+
+void SessionStore::touch(Shard& shard, Entry* entry, long long now) {
+  shard.wheel->schedule(entry, now + timeToLive * 1000LL);
+
+  if (entry == shard.newest) {
+    return;
+  }
+
+  // Unlink the entry, then link it as the most recently used one
+  entry->newer->older = entry->older;
+
+  if (entry->older != NULL) {
+    entry->older->newer = entry->newer;
+  } else {
+    shard.oldest = entry->newer;
+  }
+
+  entry->older = shard.newest;
+  entry->newer = NULL;
+  shard.newest->newer = entry;
+  shard.newest = entry;
+}
+
+SessionStore::Shard& SessionStore::getShard(const std::string& id) {
+  // FNV-1a, the identifiers being random a simple hash spreads them evenly
+  uint32_t hash = 2166136261u;
+
+  for (std::string::size_type i = 0; i < id.size(); i++) {
+    hash = (hash ^ static_cast<unsigned char>(id[i])) * 16777619u;
+  }
+
+  return shards[hash & (SHARDS - 1)];
+}
+
+const std::string SessionStore::ATTRIBUTE("echo.engine.session.SessionStore");
+const int SessionStore::DEFAULT_MAX_SESSIONS(100000);
+const int SessionStore::DEFAULT_TIME_TO_LIVE(1800);
+const int SessionStore::SHARDS(64);
+
+} // namespace session
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,237 @@
+#include <echo/engine/util/asset-pack-writer.h>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <vector>
+
+#include <echo/engine/util/asset-pack.h>
+#include <echo/engine/util/deflater.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/** The media types of the usual static file extensions. */
+static const char* MEDIA_TYPES[][2] = {
+  { "css", "text/css" },
+  { "csv", "text/csv" },
+  { "gif", "image/gif" },
+  { "htm", "text/html" },
+  { "html", "text/html" },
+  { "ico", "image/x-icon" },
+  { "jpeg", "image/jpeg" },
+  { "jpg", "image/jpeg" },
+  { "js", "application/javascript" },
+  { "json", "application/json" },
+  { "map", "application/json" },
+  { "pdf", "application/pdf" },
+  { "png", "image/png" },
+  { "svg", "image/svg+xml" },
+  { "txt", "text/plain" },
+  { "wasm", "application/wasm" },
+  { "webp", "image/webp" },
+  { "woff", "font/woff" },
+  { "woff2", "font/woff2" },
+  { "xml", "application/xml" }
+};
+
+/** The alignment of the contents within a pack. */
+static const size_t ALIGNMENT = 8;
+
+/**
+ * Overwrites a little-endian 64-bit integer.
+ */
+static void setLong(std::string& output, size_t offset,
+                    unsigned long long value) {
+  for (int i = 0; i < 8; i++) {
+    output[offset + i] = (char) ((value >> (i * 8)) & 0xff);
+  }
+}
+
+/**
+ * Appends a region, padded to the alignment, and records its offset and
+ * length in an index entry.
+ */
+static void appendRegion(std::string& output, size_t entry,
+                         const std::string& region) {
+  if (region.empty()) {
+    setLong(output, entry, 0);
+    setLong(output, entry + 8, 0);
+    return;
+  }
+
+  output.append((ALIGNMENT - output.size() % ALIGNMENT) % ALIGNMENT, '\0');
+  setLong(output, entry, output.size());
+  setLong(output, entry + 8, region.size());
+  output.append(region);
+}
+
+std::string AssetPackWriter::getMediaType(const std::string& path) {
+  const size_t dot = path.rfind('.');
+
+  if ((dot != std::string::npos)
+      && (path.find('/', dot) == std::string::npos)) {
+    std::string extension = path.substr(dot + 1);
+
+    for (size_t i = 0; i < extension.size(); i++) {
+      extension[i] = tolower((unsigned char) extension[i]);
+    }
+
+    for (size_t i = 0; i < sizeof(MEDIA_TYPES) / sizeof(MEDIA_TYPES[0]);
+         i++) {
+      if (extension == MEDIA_TYPES[i][0]) {
+        return MEDIA_TYPES[i][1];
+      }
+    }
+  }
+
+  return "application/octet-stream";
+}
+
+void AssetPackWriter::add(const std::string& path, const std::string& content,
+                          const std::string& mediaType, time_t modified) {
+  Entry& entry = entries[path];
+  entry.content = content;
+  entry.mediaType = mediaType;
+  entry.modified = modified;
+  entry.gzip.clear();
+
+  // 64-bit FNV-1a hash of the content
+  unsigned long long hash = 14695981039346656037ULL;
+
+  for (size_t i = 0; i < content.size(); i++) {
+    hash = (hash ^ (unsigned char) content[i]) * 1099511628211ULL;
+  }
+
+  char tag[17];
+  snprintf(tag, sizeof(tag), "%016llx", hash);
+  entry.tag = tag;
+
+  // The build pays for the best compression once
+  if (!Deflater::encode(true, 9, content.data(), content.size(), entry.gzip)
+      || (entry.gzip.size() >= content.size())) {
+    entry.gzip.clear();
+  }
+}
+
+bool AssetPackWriter::addDirectory(const std::string& directory) {
+  return addFiles(directory, "");
+}
+
+void AssetPackWriter::write(std::string& output) const {
+  output.assign("ECHOPAK1", 8);
+
+  for (int i = 0; i < 4; i++) {
+    output += (char) ((entries.size() >> (i * 8)) & 0xff);
+  }
+
+  output.append(4, '\0');
+  output.append(entries.size() * AssetPack::ENTRY_SIZE, '\0');
+  size_t entry = AssetPack::HEADER_SIZE;
+
+  for (std::map<std::string, Entry>::const_iterator i = entries.begin();
+       i != entries.end(); ++i, entry += AssetPack::ENTRY_SIZE) {
+    appendRegion(output, entry, i->first);
+    appendRegion(output, entry + 16, i->second.mediaType);
+    appendRegion(output, entry + 32, i->second.tag);
+    appendRegion(output, entry + 48, i->second.content);
+    appendRegion(output, entry + 64, i->second.gzip);
+    setLong(output, entry + 80, (long long) i->second.modified);
+  }
+}
+
+void AssetPackWriter::writeSource(const std::string& name,
+                                  std::string& output) const {
+  std::string pack;
+  write(pack);
+
+  std::string literal;
+
+  for (size_t i = 0; i < name.size(); i++) {
+    if ((name[i] == '"') || (name[i] == '\\')) {
+      literal += '\\';
+    }
+
+    literal += name[i];
+  }
+
+  output = "// Generated by echo-pack, do not edit.\n\n"
+           "#include <echo/engine/util/asset-pack.h>\n\n"
+           "using echo::engine::util::AssetPack;\n\n"
+           "static const unsigned char data[] = {";
+  char hex[16];
+
+  for (size_t i = 0; i < pack.size(); i++) {
+    snprintf(hex, sizeof(hex), "%s0x%02x,", (i % 12 == 0) ? "\n  " : " ",
+             (unsigned char) pack[i]);
+    output += hex;
+  }
+
+  output += "\n};\n\n"
+            "static AssetPack pack(reinterpret_cast<const char*>(data),\n"
+            "                      sizeof(data));\n\n"
+            "static struct Registration {\n"
+            "  Registration() {\n"
+            "    AssetPack::registerPack(\"" + literal + "\", &pack);\n"
+            "  }\n"
+            "} registration;\n";
+}
+
+bool AssetPackWriter::addFiles(const std::string& directory,
+                               const std::string& path) {
+  DIR* stream = opendir((directory + path).c_str());
+
+  if (stream == NULL) {
+    return false;
+  }
+
+  std::vector<std::string> names;
+  struct dirent* entry;
+
+  while ((entry = readdir(stream)) != NULL) {
+    // Skips ".", ".." and hidden files such as editor backups
+    if (entry->d_name[0] != '.') {
+      names.push_back(entry->d_name);
+    }
+  }
+
+  closedir(stream);
+  bool result = true;
+
+  for (size_t i = 0; result && (i < names.size()); i++) {
+    const std::string name = path + "/" + names[i];
+    struct stat status;
+
+    if (stat((directory + name).c_str(), &status) != 0) {
+      result = false;
+    } else if (S_ISDIR(status.st_mode)) {
+      result = addFiles(directory, name);
+    } else if (S_ISREG(status.st_mode)) {
+      std::ifstream file((directory + name).c_str(),
+                         std::ios::in | std::ios::binary);
+      std::string content;
+      char buffer[8192];
+
+      while (file.read(buffer, sizeof(buffer)) || (file.gcount() > 0)) {
+        content.append(buffer, file.gcount());
+      }
+
+      if (!file.is_open() || file.bad()) {
+        result = false;
+      } else {
+        add(name, content, getMediaType(name), status.st_mtime);
+      }
+    }
+  }
+
+  return result;
+}
+
+} // namespace util
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,295 @@
+#include <echo/engine/util/asset-pack.h>
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * The magic number starting a pack. It is followed by the number of entries
+ * as a 32-bit integer and 4 reserved bytes, then by the index sorted by path.
+ * Index entries are made of 64-bit integers: the offset and length of the
+ * path, of the media type, of the tag, of the content and of the gzip
+ * variant, then the modification date. Integers are little-endian and
+ * offsets start at the beginning of the pack.
+ */
+static const char MAGIC[] = "ECHOPAK1";
+
+/** The guard of the registry. */
+static pthread_mutex_t registryLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Returns the registry, created on first use so that the static initializers
+ * of embedded packs may register them in any order.
+ */
+static std::map<std::string, AssetPack*>& getRegistry() {
+  static std::map<std::string, AssetPack*> registry;
+  return registry;
+}
+
+/**
+ * Reads a little-endian integer.
+ */
+static unsigned long long readLong(const unsigned char* data, size_t count) {
+  unsigned long long result = 0;
+
+  for (size_t i = count; i > 0; i--) {
+    result = (result << 8) | data[i - 1];
+  }
+
+  return result;
+}
+
+/**
+ * Decodes the percent-encoded octets of a path.
+ */
+static std::string decode(const std::string& path) {
+  std::string result;
+  result.reserve(path.size());
+
+  for (size_t i = 0; i < path.size(); i++) {
+    if ((path[i] == '%') && (i + 2 < path.size())
+        && isxdigit((unsigned char) path[i + 1])
+        && isxdigit((unsigned char) path[i + 2])) {
+      result += (char) strtol(path.substr(i + 1, 2).c_str(), NULL, 16);
+      i += 2;
+    } else {
+      result += path[i];
+    }
+  }
+
+  return result;
+}
+
+AssetPack* AssetPack::getPack(const std::string& name) {
+  ScopedLock guard(&registryLock);
+  const std::map<std::string, AssetPack*>::const_iterator entry =
+      getRegistry().find(name);
+  return (entry == getRegistry().end()) ? NULL : entry->second;
+}
+
+AssetPack* AssetPack::open(const std::string& path) {
+  const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  struct stat status;
+
+  if (file == -1) {
+    return NULL;
+  }
+
+  if ((fstat(file, &status) != 0) || (status.st_size == 0)) {
+    ::close(file);
+    return NULL;
+  }
+
+  // The mapping stays valid once the descriptor is closed
+  void* data = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, file, 0);
+  ::close(file);
+
+  if (data == MAP_FAILED) {
+    return NULL;
+  }
+
+  AssetPack* result = new AssetPack((const char*) data, status.st_size,
+                                    true);
+
+  if (!result->isValid()) {
+    delete result;
+    return NULL;
+  }
+
+  return result;
+}
+
+bool AssetPack::registerPack(const std::string& name, AssetPack* pack) {
+  ScopedLock guard(&registryLock);
+  return getRegistry().insert(std::make_pair(name, pack)).second;
+}
+
+bool AssetPack::resolve(const std::string& reference, Asset& result) {
+  AssetPack* pack = NULL;
+  std::string path;
+
+  if (reference.compare(0, 7, "clap://") == 0) {
+    // The authority selects a Java class loader, there's a single pack
+    const size_t start = reference.find('/', 7);
+
+    if (start == std::string::npos) {
+      return false;
+    }
+
+    pack = getPack("");
+    path = reference.substr(start);
+  } else if ((reference.compare(0, 4, "zip:") == 0)
+             || (reference.compare(0, 4, "jar:") == 0)) {
+    const size_t separator = reference.find("!/", 4);
+
+    if (separator == std::string::npos) {
+      return false;
+    }
+
+    const std::string name = reference.substr(4, separator - 4);
+    path = reference.substr(separator + 1);
+    pack = getPack(name);
+
+    if ((pack == NULL) && (name.compare(0, 7, "file://") == 0)) {
+      const size_t start = name.find('/', 7);
+      const std::string host = name.substr(7, start - 7);
+
+      if ((start != std::string::npos)
+          && (host.empty() || (host == "localhost"))) {
+        pack = open(decode(name.substr(start)));
+
+        // Another thread may have mapped the same file meanwhile
+        if ((pack != NULL) && !registerPack(name, pack)) {
+          delete pack;
+          pack = getPack(name);
+        }
+      }
+    }
+  }
+
+  if (pack == NULL) {
+    return false;
+  }
+
+  const size_t query = path.find_first_of("?#");
+
+  if (query != std::string::npos) {
+    path.erase(query);
+  }
+
+  return pack->find(decode(path), result);
+}
+
+AssetPack::AssetPack(const char* data, size_t size)
+    : data((const unsigned char*) data), size(size), mapped(false),
+      valid(false), count(0) {
+  this->valid = validate();
+}
+
+AssetPack::AssetPack(const char* data, size_t size, bool mapped)
+    : data((const unsigned char*) data), size(size), mapped(mapped),
+      valid(false), count(0) {
+  this->valid = validate();
+}
+
+AssetPack::~AssetPack() {
+  if (mapped) {
+    munmap((void*) data, size);
+  }
+}
+
+bool AssetPack::find(const std::string& path, Asset& result) const {
+  size_t low = 0;
+  size_t high = count;
+
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const Slice name = getSlice(middle);
+    const size_t length = (name.length < path.size()) ? name.length
+                          : path.size();
+    int comparison = memcmp(name.data, path.data(), length);
+
+    if (comparison == 0) {
+      comparison = (name.length < path.size()) ? -1
+                   : ((name.length > path.size()) ? 1 : 0);
+    }
+
+    if (comparison == 0) {
+      getAsset(middle, result);
+      return true;
+    } else if (comparison < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return false;
+}
+
+std::string AssetPack::getPath(size_t index) const {
+  const Slice result = getSlice(index);
+  return std::string(result.data, result.length);
+}
+
+void AssetPack::getAsset(size_t index, Asset& result) const {
+  const unsigned char* entry = data + HEADER_SIZE + index * ENTRY_SIZE;
+  Slice* slices[] = { &result.mediaType, &result.tag, &result.content,
+                      &result.gzip };
+
+  for (size_t i = 0; i < sizeof(slices) / sizeof(slices[0]); i++) {
+    const unsigned long long offset = readLong(entry + 16 + i * 16, 8);
+    slices[i]->length = readLong(entry + 24 + i * 16, 8);
+    slices[i]->data = (slices[i]->length == 0) ? NULL
+                      : (const char*) data + offset;
+  }
+
+  result.modified = (time_t) (long long) readLong(entry + 80, 8);
+}
+
+AssetPack::Slice AssetPack::getSlice(size_t index) const {
+  const unsigned char* entry = data + HEADER_SIZE + index * ENTRY_SIZE;
+  Slice result;
+  result.data = (const char*) data + readLong(entry, 8);
+  result.length = readLong(entry + 8, 8);
+  return result;
+}
+
+bool AssetPack::validate() {
+  if ((size < HEADER_SIZE) || (memcmp(data, MAGIC, 8) != 0)) {
+    return false;
+  }
+
+  const unsigned long long entries = readLong(data + 8, 4);
+
+  if (entries > (size - HEADER_SIZE) / ENTRY_SIZE) {
+    return false;
+  }
+
+  // Checked once so that lookups trust the offsets
+  for (unsigned long long i = 0; i < entries; i++) {
+    const unsigned char* entry = data + HEADER_SIZE + i * ENTRY_SIZE;
+
+    for (size_t j = 0; j < 5; j++) {
+      const unsigned long long offset = readLong(entry + j * 16, 8);
+      const unsigned long long length = readLong(entry + j * 16 + 8, 8);
+
+      if ((offset > size) || (length > size - offset)) {
+        return false;
+      }
+    }
+  }
+
+  this->count = entries;
+
+  // The lookups are binary searches
+  for (size_t i = 1; i < count; i++) {
+    if (getPath(i - 1) >= getPath(i)) {
+      this->count = 0;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+const size_t AssetPack::HEADER_SIZE(16);
+
+const size_t AssetPack::ENTRY_SIZE(88);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
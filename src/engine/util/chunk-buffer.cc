@@ -0,0 +1,344 @@
+#include <echo/engine/util/chunk-buffer.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/** The number of vectors given to each writev() call. */
+static const int VECTOR_SIZE = 64;
+
+ChunkBuffer::ChunkBuffer() : first(NULL), last(NULL), offset(0), size(0) {
+}
+
+ChunkBuffer::~ChunkBuffer() {
+  release(first);
+}
+
+void ChunkBuffer::append(const char* data, size_t length) {
+  while (length > 0) {
+    if ((last == NULL) || (last->length == CHUNK_SIZE)) {
+      Chunk* chunk = acquire();
+
+      if (last == NULL) {
+        first = chunk;
+      } else {
+        last->next = chunk;
+      }
+
+      last = chunk;
+    }
+
+    const size_t count = (length < CHUNK_SIZE - last->length) ? length
+                         : CHUNK_SIZE - last->length;
+    memcpy(last->data + last->length, data, count);
+    last->length += count;
+    size += count;
+    data += count;
+    length -= count;
+  }
+}
+
+void ChunkBuffer::clear() {
+  release(first);
+  first = NULL;
+  last = NULL;
+  offset = 0;
+  size = 0;
+}
+
+void ChunkBuffer::consume(size_t count) {
+  while ((count > 0) && (first != NULL)) {
+    const size_t available = first->length - offset;
+
+    if (count < available) {
+      offset += count;
+      size -= count;
+      return;
+    }
+
+    // The first chunk is entirely consumed
+    Chunk* chunk = first;
+    first = chunk->next;
+    chunk->next = NULL;
+    release(chunk);
+    offset = 0;
+    size -= available;
+    count -= available;
+  }
+
+  if (first == NULL) {
+    last = NULL;
+  }
+}
+
+int ChunkBuffer::getVectors(struct iovec* vectors, int count) const {
+  int result = 0;
+
+  for (Chunk* chunk = first; (chunk != NULL) && (result < count);
+       chunk = chunk->next) {
+    const size_t skipped = (chunk == first) ? offset : 0;
+    vectors[result].iov_base = chunk->data + skipped;
+    vectors[result].iov_len = chunk->length - skipped;
+    result++;
+  }
+
+  return result;
+}
+
+size_t ChunkBuffer::read(char* buffer, size_t length) {
+  size_t result = 0;
+
+  for (Chunk* chunk = first; (chunk != NULL) && (result < length);
+       chunk = chunk->next) {
+    const size_t skipped = (chunk == first) ? offset : 0;
+    const size_t available = chunk->length - skipped;
+    const size_t count = (available < length - result) ? available
+                         : length - result;
+    memcpy(buffer + result, chunk->data + skipped, count);
+    result += count;
+  }
+
+  consume(result);
+  return result;
+}
+
+void ChunkBuffer::transfer(ChunkBuffer& target, bool all) {
+  Chunk* end = all ? NULL : last;
+
+  if ((end != NULL) && (end->length == CHUNK_SIZE)) {
+    end = NULL;
+  }
+
+  if (first == end) {
+    return;
+  }
+
+  // Find the last moved chunk and the moved size
+  Chunk* moved = first;
+  size_t count = moved->length;
+
+  while (moved->next != end) {
+    moved = moved->next;
+    count += moved->length;
+  }
+
+  if (target.last == NULL) {
+    target.first = first;
+  } else {
+    target.last->next = first;
+  }
+
+  target.last = moved;
+  target.size += count;
+  moved->next = NULL;
+  first = end;
+  size -= count;
+
+  if (first == NULL) {
+    last = NULL;
+  }
+}
+
+void ChunkBuffer::toString(std::string& result) const {
+  result.clear();
+  result.reserve(size);
+
+  for (Chunk* chunk = first; chunk != NULL; chunk = chunk->next) {
+    const size_t skipped = (chunk == first) ? offset : 0;
+    result.append(chunk->data + skipped, chunk->length - skipped);
+  }
+}
+
+ssize_t ChunkBuffer::write(int file, size_t offset) const {
+  struct iovec vector[VECTOR_SIZE];
+  Chunk* chunk = first;
+  ssize_t result = 0;
+
+  // Start after the consumed bytes
+  offset += this->offset;
+
+  // Skip the chunks already written
+  while ((chunk != NULL) && (offset >= chunk->length)) {
+    offset -= chunk->length;
+    chunk = chunk->next;
+  }
+
+  while (chunk != NULL) {
+    int count = 0;
+
+    for (; (chunk != NULL) && (count < VECTOR_SIZE); chunk = chunk->next) {
+      vector[count].iov_base = chunk->data + offset;
+      vector[count].iov_len = chunk->length - offset;
+      offset = 0;
+      count++;
+    }
+
+    const ssize_t written = writeVectors(file, vector, count);
+
+    if (written == -1) {
+      return -1;
+    }
+
+    result += written;
+  }
+
+  return result;
+}
+
+ssize_t ChunkBuffer::writeVectors(int file, struct iovec* vectors,
+                                  int count) {
+  int index = 0;
+  const ssize_t result = writeVectors(file, vectors, count, index);
+
+  // A descriptor which would block is an error for the blocking writers
+  return (index < count) ? -1 : result;
+}
+
+ssize_t ChunkBuffer::writeVectors(int file, struct iovec* vectors, int count,
+                                  int& index) {
+  ssize_t result = 0;
+
+  while (index < count) {
+    const int batch = (count - index < VECTOR_SIZE) ? count - index
+                                                    : VECTOR_SIZE;
+    const ssize_t written = writev(file, vectors + index, batch);
+
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return (errno == EAGAIN) ? result : -1;
+    }
+
+    result += written;
+
+    // Skip the fully written vectors and advance in the partial one
+    size_t remaining = written;
+
+    while ((index < count) && (remaining >= vectors[index].iov_len)) {
+      remaining -= vectors[index].iov_len;
+      index++;
+    }
+
+    if (index < count) {
+      vectors[index].iov_base = static_cast<char*>(vectors[index].iov_base)
+                                + remaining;
+      vectors[index].iov_len -= remaining;
+    }
+  }
+
+  return result;
+}
+
+ChunkBuffer::Chunk* ChunkBuffer::acquire() {
+  Chunk* result = threadPool;
+
+  if (result != NULL) {
+    threadPool = result->next;
+    threadPooled--;
+  } else {
+    ScopedLock lock(&poolLock);
+
+    if (pool != NULL) {
+      result = pool;
+      pool = pool->next;
+      pooled--;
+    }
+  }
+
+  if (result == NULL) {
+    result = static_cast<Chunk*>(malloc(offsetof(Chunk, data) + CHUNK_SIZE));
+
+    if (result == NULL) {
+      throw std::bad_alloc();
+    }
+  }
+
+  result->next = NULL;
+  result->length = 0;
+  return result;
+}
+
+void ChunkBuffer::createThreadKey() {
+  pthread_key_create(&threadKey, releaseThreadPool);
+}
+
+void ChunkBuffer::releaseThreadPool(void* marker) {
+  releaseShared(threadPool);
+  threadPool = NULL;
+  threadPooled = 0;
+}
+
+void ChunkBuffer::release(Chunk* chunk) {
+  if ((chunk != NULL) && (threadPooled < THREAD_POOL_SIZE)) {
+    while ((chunk != NULL) && (threadPooled < THREAD_POOL_SIZE)) {
+      Chunk* next = chunk->next;
+      chunk->next = threadPool;
+      threadPool = chunk;
+      threadPooled++;
+      chunk = next;
+    }
+
+    // The key hands the pool back when the thread exits, its value being a
+    // mere marker of the threads having a pool
+    pthread_once(&threadKeyOnce, createThreadKey);
+
+    if (pthread_getspecific(threadKey) == NULL) {
+      pthread_setspecific(threadKey, &threadPool);
+    }
+  }
+
+  if (chunk != NULL) {
+    releaseShared(chunk);
+  }
+}
+
+void ChunkBuffer::releaseShared(Chunk* chunk) {
+  Chunk* excess = NULL;
+
+  {
+    ScopedLock lock(&poolLock);
+
+    while ((chunk != NULL) && (pooled < POOL_SIZE)) {
+      Chunk* next = chunk->next;
+      chunk->next = pool;
+      pool = chunk;
+      pooled++;
+      chunk = next;
+    }
+
+    excess = chunk;
+  }
+
+  // Free the chunks the pool can't hold outside of the lock
+  while (excess != NULL) {
+    Chunk* next = excess->next;
+    free(excess);
+    excess = next;
+  }
+}
+
+ChunkBuffer::Chunk* ChunkBuffer::pool(NULL);
+size_t ChunkBuffer::pooled(0);
+pthread_mutex_t ChunkBuffer::poolLock = PTHREAD_MUTEX_INITIALIZER;
+__thread ChunkBuffer::Chunk* ChunkBuffer::threadPool(NULL);
+__thread size_t ChunkBuffer::threadPooled(0);
+pthread_key_t ChunkBuffer::threadKey;
+pthread_once_t ChunkBuffer::threadKeyOnce = PTHREAD_ONCE_INIT;
+const size_t ChunkBuffer::CHUNK_SIZE(16384);
+const size_t ChunkBuffer::POOL_SIZE(256);
+const size_t ChunkBuffer::THREAD_POOL_SIZE(64);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,225 @@
+#include <echo/engine/util/chunk-stream.h>
+
+#include <errno.h>
+#include <time.h>
+
+#include <echo/engine/util/scoped-lock.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+ChunkStream::ChunkStream()
+    : highWaterMark(DEFAULT_HIGH_WATER_MARK), blocking(true) {
+  initialize();
+}
+
+ChunkStream::ChunkStream(size_t highWaterMark, bool blocking)
+    : highWaterMark(highWaterMark), blocking(blocking) {
+  initialize();
+}
+
+ChunkStream::~ChunkStream() {
+  if (deflater != NULL) {
+    Deflater::release(deflater);
+  }
+
+  pthread_cond_destroy(&readable);
+  pthread_cond_destroy(&writable);
+  pthread_mutex_destroy(&lock);
+}
+
+void ChunkStream::abort() {
+  ScopedLock guard(&lock);
+  aborted = true;
+  queue.clear();
+
+  if (deflater != NULL) {
+    Deflater::release(deflater);
+    deflater = NULL;
+  }
+  pthread_cond_broadcast(&writable);
+  pthread_cond_broadcast(&readable);
+}
+
+void ChunkStream::close() {
+  ScopedLock guard(&lock);
+
+  // The end of the compressed data follows the last chunk
+  if (deflater != NULL) {
+    compressed.clear();
+
+    if (!aborted && deflater->update(NULL, 0, true, compressed)) {
+      queue.append(compressed.data(), compressed.size());
+    }
+
+    Deflater::release(deflater);
+    deflater = NULL;
+  }
+
+  closed = true;
+  pthread_cond_broadcast(&readable);
+}
+
+void ChunkStream::consume(size_t count) {
+  ScopedLock guard(&lock);
+  const bool above = (queue.getSize() > highWaterMark);
+  queue.consume(count);
+
+  if (above && (queue.getSize() <= highWaterMark)) {
+    pthread_cond_broadcast(&writable);
+  }
+}
+
+bool ChunkStream::deflate(bool gzip, int level) {
+  ScopedLock guard(&lock);
+
+  if (aborted || closed) {
+    return false;
+  } else if (deflater != NULL) {
+    return true;
+  }
+
+  deflater = Deflater::acquire(gzip, level);
+
+  if (deflater == NULL) {
+    return false;
+  }
+
+  // The chunks already queued weren't consumed yet
+  ChunkBuffer queued;
+  queue.transfer(queued, true);
+  return compress(queued, true);
+}
+
+size_t ChunkStream::getSize() {
+  ScopedLock guard(&lock);
+  return queue.getSize();
+}
+
+int ChunkStream::getVectors(struct iovec* vectors, int count) {
+  ScopedLock guard(&lock);
+  return queue.getVectors(vectors, count);
+}
+
+bool ChunkStream::isAborted() {
+  ScopedLock guard(&lock);
+  return aborted;
+}
+
+bool ChunkStream::isDone() {
+  ScopedLock guard(&lock);
+  return aborted || (closed && (queue.getSize() == 0));
+}
+
+bool ChunkStream::isWritable() {
+  ScopedLock guard(&lock);
+  return !aborted && (queue.getSize() <= highWaterMark);
+}
+
+bool ChunkStream::offer(ChunkBuffer& chunks, bool all) {
+  ScopedLock guard(&lock);
+
+  if (aborted) {
+    chunks.clear();
+    return false;
+  }
+
+  const size_t size = queue.getSize();
+
+  if (deflater != NULL) {
+    if (!compress(chunks, all)) {
+      aborted = true;
+      queue.clear();
+      pthread_cond_broadcast(&readable);
+      return false;
+    }
+  } else {
+    chunks.transfer(queue, all);
+  }
+
+  if (queue.getSize() > size) {
+    pthread_cond_broadcast(&readable);
+  }
+
+  if (blocking) {
+    while (!aborted && (queue.getSize() > highWaterMark)) {
+      pthread_cond_wait(&writable, &lock);
+    }
+  }
+
+  return !aborted && (queue.getSize() <= highWaterMark);
+}
+
+bool ChunkStream::await(int timeout) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += timeout / 1000;
+  deadline.tv_nsec += (timeout % 1000) * 1000000L;
+
+  if (deadline.tv_nsec >= 1000000000L) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  ScopedLock guard(&lock);
+  int status = 0;
+
+  while (!aborted && !closed && (queue.getSize() == 0)
+         && (status != ETIMEDOUT)) {
+    status = pthread_cond_timedwait(&readable, &lock, &deadline);
+  }
+
+  return aborted || closed || (queue.getSize() > 0);
+}
+
+bool ChunkStream::compress(ChunkBuffer& chunks, bool all) {
+  ChunkBuffer plain;
+  struct iovec vectors[16];
+  int count;
+  chunks.transfer(plain, all);
+  compressed.clear();
+
+  while ((count = plain.getVectors(vectors, 16)) > 0) {
+    size_t length = 0;
+
+    for (int i = 0; i < count; i++) {
+      if (!deflater->update(static_cast<const char*>(vectors[i].iov_base),
+                            vectors[i].iov_len, false, compressed)) {
+        return false;
+      }
+
+      length += vectors[i].iov_len;
+    }
+
+    plain.consume(length);
+  }
+
+  if (all && !deflater->flush(compressed)) {
+    return false;
+  }
+
+  queue.append(compressed.data(), compressed.size());
+  return true;
+}
+
+void ChunkStream::initialize() {
+  // The waits are measured on the monotonic clock
+  pthread_condattr_t attributes;
+  pthread_condattr_init(&attributes);
+  pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+
+  pthread_mutex_init(&lock, NULL);
+  pthread_cond_init(&writable, NULL);
+  pthread_cond_init(&readable, &attributes);
+  pthread_condattr_destroy(&attributes);
+  closed = false;
+  aborted = false;
+  deflater = NULL;
+}
+
+const size_t ChunkStream::DEFAULT_HIGH_WATER_MARK(256 * 1024);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,202 @@
+#include <echo/engine/util/cookie-reader.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Indicates if a character separates two cookies.
+ */
+static inline bool isSeparator(char c) {
+  return (c == ';') || (c == ',');
+}
+
+/**
+ * Indicates if a character is a linear white space.
+ */
+static inline bool isSpace(char c) {
+  return (c == ' ') || (c == '\t');
+}
+
+/**
+ * Indicates if a view is equal to a given attribute name, ignoring case.
+ */
+static inline bool isAttribute(const char* name, size_t nameLength,
+                               const char* attribute) {
+  return (nameLength == strlen(attribute))
+      && (strncasecmp(name, attribute, nameLength) == 0);
+}
+
+bool CookieReader::find(const std::string& header, const std::string& name,
+                        const char*& value, size_t& valueLength) {
+  CookieReader reader(header);
+  const char* cookieName;
+  size_t cookieNameLength;
+
+  while (reader.readNext(cookieName, cookieNameLength, value, valueLength)) {
+    if ((cookieNameLength == name.size())
+        && (memcmp(cookieName, name.data(), cookieNameLength) == 0)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::string CookieReader::getFirstValue(const std::string& header,
+                                        const std::string& name) {
+  const char* value;
+  size_t valueLength;
+
+  if (!find(header, name, value, valueLength)) {
+    return NULL;
+  }
+
+  return std::string(value, valueLength);
+}
+
+CookieReader::CookieReader(const std::string& header) {
+  this->position = header.data();
+  this->end = header.data() + header.size();
+  this->version = 0;
+}
+
+void CookieReader::addCookies(Series<Cookie> cookies) {
+  for (Cookie cookie = readNextCookie(); cookie != NULL;
+       cookie = readNextCookie()) {
+    cookies.add(cookie);
+  }
+}
+
+bool CookieReader::readNext(const char*& name, size_t& nameLength,
+                            const char*& value, size_t& valueLength) {
+  while (readPair(name, nameLength, value, valueLength)) {
+    if (nameLength == 0) {
+      continue;
+    }
+
+    if (name[0] != '$') {
+      return true;
+    }
+
+    if (isAttribute(name, nameLength, "$Version")) {
+      version = atoi(std::string(value, valueLength).c_str());
+    }
+  }
+
+  return false;
+}
+
+Cookie CookieReader::readNextCookie() {
+  const char* name;
+  const char* value;
+  size_t nameLength;
+  size_t valueLength;
+
+  if (!readNext(name, nameLength, value, valueLength)) {
+    return NULL;
+  }
+
+  Cookie result = new Cookie(version, std::string(name, nameLength),
+                             std::string(value, valueLength));
+
+  // Apply the attributes following the cookie, stopping before the next one
+  const char* attributeName;
+  const char* attributeValue;
+  size_t attributeNameLength;
+  size_t attributeValueLength;
+  const char* mark = position;
+
+  while (readPair(attributeName, attributeNameLength, attributeValue,
+                  attributeValueLength)
+         && (attributeNameLength > 0) && (attributeName[0] == '$')) {
+    if (isAttribute(attributeName, attributeNameLength, "$Path")) {
+      result.setPath(std::string(attributeValue, attributeValueLength));
+    } else if (isAttribute(attributeName, attributeNameLength, "$Domain")) {
+      result.setDomain(std::string(attributeValue, attributeValueLength));
+    }
+
+    mark = position;
+  }
+
+  position = mark;
+  return result;
+}
+
+bool CookieReader::readPair(const char*& name, size_t& nameLength,
+                            const char*& value, size_t& valueLength) {
+  // 1 - Skip the separators and white spaces
+  while ((position < end) && (isSeparator(*position) || isSpace(*position))) {
+    position++;
+  }
+
+  if (position == end) {
+    return false;
+  }
+
+  // 2 - Read the name, up to the equal sign or the next separator
+  name = position;
+
+  while ((position < end) && (*position != '=') && !isSeparator(*position)) {
+    position++;
+  }
+
+  nameLength = position - name;
+
+  while ((nameLength > 0) && isSpace(name[nameLength - 1])) {
+    nameLength--;
+  }
+
+  value = position;
+  valueLength = 0;
+
+  if ((position == end) || (*position != '=')) {
+    return true;
+  }
+
+  // 3 - Read the value, quoted or not
+  position++;
+
+  while ((position < end) && isSpace(*position)) {
+    position++;
+  }
+
+  if ((position < end) && (*position == '"')) {
+    const char* closing = static_cast<const char*>(
+        memchr(position + 1, '"', end - position - 1));
+
+    if (closing != NULL) {
+      value = position + 1;
+      valueLength = closing - value;
+      position = closing + 1;
+
+      while ((position < end) && !isSeparator(*position)) {
+        position++;
+      }
+
+      return true;
+    }
+  }
+
+  value = position;
+
+  while ((position < end) && !isSeparator(*position)) {
+    position++;
+  }
+
+  valueLength = position - value;
+
+  while ((valueLength > 0) && isSpace(value[valueLength - 1])) {
+    valueLength--;
+  }
+
+  return true;
+}
+
+} // namespace util
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,286 @@
+#include <echo/engine/util/date-utils.h>
+
+#include <stdint.h>
+#include <string.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/** The number of entries of the per-thread cache of parsed dates. */
+static const size_t PARSED_SIZE = 32;
+
+/** The maximum length of the strings kept in the cache of parsed dates. */
+static const size_t PARSED_LENGTH = 40;
+
+/** The abbreviated names of the days, starting on Sunday. */
+static const char DAYS[] = "SunMonTueWedThuFriSat";
+
+/** The abbreviated names of the months. */
+static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+/**
+ * Entry of the per-thread cache of parsed dates.
+ */
+struct ParsedDate {
+
+  /** The length of the parsed string, zero for empty entries. */
+  size_t length;
+
+  /** The parsed string. */
+  char value[PARSED_LENGTH];
+
+  /** The date in seconds since the epoch. */
+  time_t seconds;
+
+};
+
+/** The second of the cached current date. */
+static __thread time_t nowSeconds = -1;
+
+/** The cached current date. */
+static __thread char nowValue[29];
+
+/** The cache of parsed dates. */
+static __thread ParsedDate parsedDates[PARSED_SIZE];
+
+/**
+ * Returns the number of days since the epoch of a date of the proleptic
+ * Gregorian calendar.
+ */
+static long daysFromCivil(long year, int month, int day) {
+  year -= (month <= 2) ? 1 : 0;
+  const long era = ((year >= 0) ? year : year - 399) / 400;
+  const long yearOfEra = year - era * 400;
+  const long dayOfYear = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5
+                         + day - 1;
+  const long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100
+                        + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * Returns the month, from 1 to 12, of an abbreviated name or 0.
+ */
+static int getMonth(const char* name) {
+  for (int i = 0; i < 12; i++) {
+    if (memcmp(name, MONTHS + 3 * i, 3) == 0) {
+      return i + 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Reads a number of decimal digits, returning -1 if one of them isn't a digit.
+ */
+static int readDigits(const char* value, int count) {
+  int result = 0;
+
+  for (int i = 0; i < count; i++) {
+    const unsigned int digit = static_cast<unsigned char>(value[i]) - '0';
+
+    if (digit > 9) {
+      return -1;
+    }
+
+    result = result * 10 + digit;
+  }
+
+  return result;
+}
+
+/**
+ * Reads a "HH:MM:SS" time of day, returning -1 if it's invalid.
+ */
+static long readTime(const char* value) {
+  const int hour = readDigits(value, 2);
+  const int minute = readDigits(value + 3, 2);
+  const int second = readDigits(value + 6, 2);
+
+  if ((value[2] != ':') || (value[5] != ':') || (hour < 0) || (hour > 23)
+      || (minute < 0) || (minute > 59) || (second < 0) || (second > 60)) {
+    return -1;
+  }
+
+  return hour * 3600L + minute * 60L + second;
+}
+
+/**
+ * Combines the fields of a date, returning false if they are invalid.
+ */
+static bool toSeconds(long year, int month, int day, long time,
+                      time_t& seconds) {
+  if ((month == 0) || (day < 1) || (day > 31) || (time < 0)) {
+    return false;
+  }
+
+  seconds = static_cast<time_t>(daysFromCivil(year, month, day)) * 86400
+            + time;
+  return true;
+}
+
+/**
+ * Writes a number of two digits.
+ */
+static inline void writeDigits(char* result, int value) {
+  result[0] = '0' + value / 10;
+  result[1] = '0' + value % 10;
+}
+
+void DateUtils::append(std::string& buffer, time_t seconds) {
+  char result[29];
+  format(seconds, result);
+  buffer.append(result, LENGTH);
+}
+
+void DateUtils::appendNow(std::string& buffer) {
+  const time_t now = time(NULL);
+
+  if (now != nowSeconds) {
+    format(now, nowValue);
+    nowSeconds = now;
+  }
+
+  buffer.append(nowValue, LENGTH);
+}
+
+void DateUtils::format(time_t seconds, char* result) {
+  long days = seconds / 86400;
+  long time = seconds % 86400;
+
+  if (time < 0) {
+    time += 86400;
+    days--;
+  }
+
+  // Inverse of daysFromCivil()
+  const long shifted = days + 719468;
+  const long era = ((shifted >= 0) ? shifted : shifted - 146096) / 146097;
+  const long dayOfEra = shifted - era * 146097;
+  const long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524
+                          - dayOfEra / 146096) / 365;
+  const long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4
+                                     - yearOfEra / 100);
+  const long monthIndex = (5 * dayOfYear + 2) / 153;
+  const int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+  const int month = (monthIndex < 10) ? monthIndex + 3 : monthIndex - 9;
+  const long year = yearOfEra + era * 400 + ((month <= 2) ? 1 : 0);
+
+  // The epoch was a Thursday
+  const int weekDay = ((days % 7) + 11) % 7;
+
+  memcpy(result, DAYS + 3 * weekDay, 3);
+  result[3] = ',';
+  result[4] = ' ';
+  writeDigits(result + 5, day);
+  result[7] = ' ';
+  memcpy(result + 8, MONTHS + 3 * (month - 1), 3);
+  result[11] = ' ';
+  writeDigits(result + 12, (year / 100) % 100);
+  writeDigits(result + 14, year % 100);
+  result[16] = ' ';
+  writeDigits(result + 17, time / 3600);
+  result[19] = ':';
+  writeDigits(result + 20, (time / 60) % 60);
+  result[22] = ':';
+  writeDigits(result + 23, time % 60);
+  memcpy(result + 25, " GMT", 4);
+}
+
+bool DateUtils::parse(const char* value, size_t length, time_t& seconds) {
+  // Look up the cache first
+  uint32_t hash = 2166136261u;
+
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ static_cast<unsigned char>(value[i])) * 16777619u;
+  }
+
+  ParsedDate& entry = parsedDates[(hash ^ (hash >> 16)) & (PARSED_SIZE - 1)];
+
+  if ((entry.length == length) && (length > 0)
+      && (memcmp(entry.value, value, length) == 0)) {
+    seconds = entry.seconds;
+    return true;
+  }
+
+  const bool result = parseFixdate(value, length, seconds)
+                      || parseRfc850(value, length, seconds)
+                      || parseAsctime(value, length, seconds);
+
+  if (result && (length <= PARSED_LENGTH)) {
+    memcpy(entry.value, value, length);
+    entry.length = length;
+    entry.seconds = seconds;
+  }
+
+  return result;
+}
+
+bool DateUtils::parseAsctime(const char* value, size_t length,
+                             time_t& seconds) {
+  if ((length != 24) || (value[3] != ' ') || (value[7] != ' ')
+      || (value[10] != ' ') || (value[19] != ' ')) {
+    return false;
+  }
+
+  // The day of the month is padded with a space
+  const int day = (value[8] == ' ') ? readDigits(value + 9, 1)
+                                    : readDigits(value + 8, 2);
+  const int year = readDigits(value + 20, 4);
+
+  return (year >= 0) && toSeconds(year, getMonth(value + 4), day,
+                                  readTime(value + 11), seconds);
+}
+
+bool DateUtils::parseFixdate(const char* value, size_t length,
+                             time_t& seconds) {
+  if ((length != LENGTH) || (value[3] != ',') || (value[4] != ' ')
+      || (value[7] != ' ') || (value[11] != ' ') || (value[16] != ' ')
+      || (memcmp(value + 25, " GMT", 4) != 0)) {
+    return false;
+  }
+
+  const int year = readDigits(value + 12, 4);
+
+  return (year >= 0) && toSeconds(year, getMonth(value + 8),
+                                  readDigits(value + 5, 2),
+                                  readTime(value + 17), seconds);
+}
+
+bool DateUtils::parseRfc850(const char* value, size_t length,
+                            time_t& seconds) {
+  // Skip the full name of the day
+  const char* comma = static_cast<const char*>(memchr(value, ',', length));
+
+  if (comma == NULL) {
+    return false;
+  }
+
+  const char* date = comma + 2;
+
+  if ((value + length - date != 22) || (comma[1] != ' ') || (date[2] != '-')
+      || (date[6] != '-') || (date[9] != ' ')
+      || (memcmp(date + 18, " GMT", 4) != 0)) {
+    return false;
+  }
+
+  // Two-digit years before 70 are taken as being in the 21st century
+  int year = readDigits(date + 7, 2);
+
+  if (year < 0) {
+    return false;
+  }
+
+  year += (year < 70) ? 2000 : 1900;
+
+  return toSeconds(year, getMonth(date + 3), readDigits(date, 2),
+                   readTime(date + 10), seconds);
+}
+
+const size_t DateUtils::LENGTH(29);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
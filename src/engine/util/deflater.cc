@@ -0,0 +1,214 @@
+#include <echo/engine/util/deflater.h>
+
+#include <pthread.h>
+#include <string.h>
+
+#include <vector>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/** The size of the output chunks. */
+static const size_t CHUNK_SIZE = 16384;
+
+/** The zlib window bits producing the "deflate" format. */
+static const int ZLIB_WINDOW = 15;
+
+/** The zlib window bits producing the "gzip" format. */
+static const int GZIP_WINDOW = 15 + 16;
+
+/** The maximum number of idle streams of each format kept by a thread. */
+static const size_t MAX_POOLED = 8;
+
+/** The thread keys of the streams of each format. */
+static pthread_key_t keys[2];
+
+/** The thread keys of the pools of idle streams of each format. */
+static pthread_key_t poolKeys[2];
+
+/** Ensures the thread keys are created once. */
+static pthread_once_t keysOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Deletes the stream of an exiting thread.
+ */
+static void deleteDeflater(void* deflater) {
+  delete static_cast<Deflater*>(deflater);
+}
+
+/**
+ * Deletes the pool of an exiting thread and its idle streams.
+ */
+static void deletePool(void* pool) {
+  std::vector<Deflater*>* deflaters = static_cast<std::vector<Deflater*>*>(
+      pool);
+
+  for (size_t i = 0; i < deflaters->size(); i++) {
+    delete (*deflaters)[i];
+  }
+
+  delete deflaters;
+}
+
+/**
+ * Creates the thread keys.
+ */
+static void createKeys() {
+  pthread_key_create(&keys[0], deleteDeflater);
+  pthread_key_create(&keys[1], deleteDeflater);
+  pthread_key_create(&poolKeys[0], deletePool);
+  pthread_key_create(&poolKeys[1], deletePool);
+}
+
+/**
+ * Returns the pool of idle streams of the current thread for a format.
+ */
+static std::vector<Deflater*>& getPool(bool gzip) {
+  pthread_once(&keysOnce, createKeys);
+  const pthread_key_t key = poolKeys[gzip ? 1 : 0];
+  std::vector<Deflater*>* result = static_cast<std::vector<Deflater*>*>(
+      pthread_getspecific(key));
+
+  if (result == NULL) {
+    result = new std::vector<Deflater*>();
+    pthread_setspecific(key, result);
+  }
+
+  return *result;
+}
+
+Deflater* Deflater::acquire(bool gzip, int level) {
+  std::vector<Deflater*>& pool = getPool(gzip);
+  Deflater* result;
+
+  if (pool.empty()) {
+    result = new Deflater(gzip);
+  } else {
+    result = pool.back();
+    pool.pop_back();
+  }
+
+  if (!result->reset(level)) {
+    delete result;
+    return NULL;
+  }
+
+  return result;
+}
+
+bool Deflater::encode(bool gzip, int level, const char* data, size_t length,
+                      std::string& output) {
+  Deflater& deflater = getCurrent(gzip);
+  return deflater.reset(level) && deflater.update(data, length, true, output);
+}
+
+Deflater& Deflater::getCurrent(bool gzip) {
+  pthread_once(&keysOnce, createKeys);
+  const pthread_key_t key = keys[gzip ? 1 : 0];
+  Deflater* result = static_cast<Deflater*>(pthread_getspecific(key));
+
+  if (result == NULL) {
+    result = new Deflater(gzip);
+    pthread_setspecific(key, result);
+  }
+
+  return *result;
+}
+
+void Deflater::release(Deflater* deflater) {
+  std::vector<Deflater*>& pool = getPool(deflater->gzip);
+
+  if (pool.size() < MAX_POOLED) {
+    pool.push_back(deflater);
+  } else {
+    delete deflater;
+  }
+}
+
+Deflater::Deflater(bool gzip) : gzip(gzip), level(DEFAULT_LEVEL) {
+  memset(&stream, 0, sizeof(stream));
+  this->initialized = (deflateInit2(&stream, level, Z_DEFLATED,
+                                    gzip ? GZIP_WINDOW : ZLIB_WINDOW, 8,
+                                    Z_DEFAULT_STRATEGY) == Z_OK);
+}
+
+Deflater::~Deflater() {
+  if (initialized) {
+    deflateEnd(&stream);
+  }
+}
+
+bool Deflater::flush(std::string& output) {
+  stream.next_in = NULL;
+  stream.avail_in = 0;
+  int status = Z_OK;
+
+  // A flush is complete once deflate() leaves room in the output
+  do {
+    const std::string::size_type start = output.size();
+    output.resize(start + CHUNK_SIZE);
+    stream.next_out = reinterpret_cast<Bytef*>(&output[start]);
+    stream.avail_out = CHUNK_SIZE;
+    status = deflate(&stream, Z_SYNC_FLUSH);
+    output.resize(start + CHUNK_SIZE - stream.avail_out);
+
+    if ((status != Z_OK) && (status != Z_BUF_ERROR)) {
+      return false;
+    }
+  } while (stream.avail_out == 0);
+
+  return true;
+}
+
+bool Deflater::reset(int level) {
+  if (!initialized || (deflateReset(&stream) != Z_OK)) {
+    return false;
+  }
+
+  // Changing the parameters of a fresh stream doesn't flush anything
+  if (level != this->level) {
+    if (deflateParams(&stream, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+
+    this->level = level;
+  }
+
+  return true;
+}
+
+bool Deflater::update(const char* data, size_t length, bool finish,
+                      std::string& output) {
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream.avail_in = length;
+
+  if (finish) {
+    output.reserve(output.size() + deflateBound(&stream, length));
+  }
+
+  int status = Z_OK;
+
+  do {
+    const std::string::size_type start = output.size();
+    output.resize(start + CHUNK_SIZE);
+    stream.next_out = reinterpret_cast<Bytef*>(&output[start]);
+    stream.avail_out = CHUNK_SIZE;
+    status = deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+    output.resize(start + CHUNK_SIZE - stream.avail_out);
+
+    if ((status != Z_OK) && (status != Z_STREAM_END)
+        && (status != Z_BUF_ERROR)) {
+      return false;
+    }
+  } while (finish ? (status != Z_STREAM_END)
+                  : ((stream.avail_in > 0) || (stream.avail_out == 0)));
+
+  return true;
+}
+
+const int Deflater::DEFAULT_LEVEL(6);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,200 @@
+#include <echo/engine/util/form-reader.h>
+
+#include <string.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Returns the value of an hexadecimal digit or -1.
+ */
+static int hexValue(char c) {
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  } else if ((c >= 'a') && (c <= 'f')) {
+    return c - 'a' + 10;
+  } else if ((c >= 'A') && (c <= 'F')) {
+    return c - 'A' + 10;
+  }
+
+  return -1;
+}
+
+FormReader::FormReader(Representation representation)
+    : chunk(BUFFER_SIZE) {
+  initialize(representation, DEFAULT_MAX_PARAMETERS,
+             DEFAULT_MAX_PARAMETER_SIZE);
+}
+
+FormReader::FormReader(Representation representation, int maxParameters,
+                       int maxParameterSize)
+    : chunk(BUFFER_SIZE) {
+  initialize(representation, maxParameters, maxParameterSize);
+}
+
+FormReader::~FormReader() {
+  if (stream != NULL) {
+    try {
+      stream.close();
+    } catch (IOException ioe) {
+    }
+  }
+}
+
+void FormReader::addParameters(Series<Parameter> parameters)
+    throw (std::runtime_error) {
+  for (Parameter parameter = readNextParameter(); parameter != NULL;
+       parameter = readNextParameter()) {
+    parameters.add(parameter);
+  }
+}
+
+bool FormReader::readNext(const char*& name, size_t& nameLength,
+                          const char*& value, size_t& valueLength)
+    throw (std::runtime_error) {
+  bool separated = true;
+  parameter.clear();
+
+  // 1 - Collect the encoded parameter up to the next separator, skipping the
+  // empty parameters between consecutive separators
+  while (parameter.empty() && separated) {
+    separated = false;
+
+    while (!separated) {
+      if ((chunkPosition == chunkLength) && !fill()) {
+        break;
+      }
+
+      const char* start = &chunk[chunkPosition];
+      const size_t available = chunkLength - chunkPosition;
+      const char* separator = static_cast<const char*>(
+          memchr(start, '&', available));
+      const size_t length = (separator == NULL) ? available
+                            : static_cast<size_t>(separator - start);
+
+      if ((maxParameterSize != -1)
+          && (parameter.size() + length
+              > static_cast<size_t>(maxParameterSize))) {
+        throw std::runtime_error(
+            "The form entity contains a parameter larger than the limit");
+      }
+
+      parameter.insert(parameter.end(), start, start + length);
+      chunkPosition += length;
+
+      if (separator != NULL) {
+        chunkPosition++;
+        separated = true;
+      }
+    }
+  }
+
+  if (parameter.empty()) {
+    return false;
+  }
+
+  if ((maxParameters != -1) && (count >= maxParameters)) {
+    throw std::runtime_error(
+        "The form entity contains more parameters than the limit");
+  }
+
+  count++;
+
+  // 2 - Decode the name and value in place
+  char* data = &parameter[0];
+  char* equals = static_cast<char*>(memchr(data, '=', parameter.size()));
+
+  if (equals == NULL) {
+    name = data;
+    nameLength = decode(data, parameter.size());
+    value = NULL;
+    valueLength = 0;
+  } else {
+    const size_t encodedNameLength = equals - data;
+    name = data;
+    nameLength = decode(data, encodedNameLength);
+    value = equals + 1;
+    valueLength = decode(equals + 1, parameter.size() - encodedNameLength - 1);
+  }
+
+  return true;
+}
+
+Parameter FormReader::readNextParameter() throw (std::runtime_error) {
+  const char* name;
+  const char* value;
+  size_t nameLength;
+  size_t valueLength;
+
+  if (!readNext(name, nameLength, value, valueLength)) {
+    return NULL;
+  }
+
+  return new Parameter(std::string(name, nameLength),
+                       (value == NULL) ? NULL
+                       : std::string(value, valueLength));
+}
+
+size_t FormReader::decode(char* data, size_t length) {
+  size_t read = 0;
+  size_t written = 0;
+
+  while (read < length) {
+    const char c = data[read];
+
+    if (c == '+') {
+      data[written++] = ' ';
+      read++;
+    } else if ((c == '%') && (read + 2 < length)
+               && (hexValue(data[read + 1]) != -1)
+               && (hexValue(data[read + 2]) != -1)) {
+      data[written++] = static_cast<char>((hexValue(data[read + 1]) << 4)
+                                          | hexValue(data[read + 2]));
+      read += 3;
+    } else {
+      data[written++] = c;
+      read++;
+    }
+  }
+
+  return written;
+}
+
+void FormReader::initialize(Representation representation,
+                            int maxParameters, int maxParameterSize) {
+  this->stream = (representation == NULL) ? NULL : representation.getStream();
+  this->maxParameters = maxParameters;
+  this->maxParameterSize = maxParameterSize;
+  this->count = 0;
+  this->finished = (this->stream == NULL);
+  this->chunkPosition = 0;
+  this->chunkLength = 0;
+}
+
+bool FormReader::fill() throw (std::runtime_error) {
+  if (finished) {
+    return false;
+  }
+
+  int result;
+
+  try {
+    result = stream.read(&chunk[0], 0, chunk.size());
+  } catch (IOException ioe) {
+    throw std::runtime_error("Unable to read the form entity");
+  }
+
+  chunkPosition = 0;
+  chunkLength = (result > 0) ? result : 0;
+  finished = (result == -1);
+  return chunkLength > 0;
+}
+
+const int FormReader::DEFAULT_MAX_PARAMETERS(1000);
+const int FormReader::DEFAULT_MAX_PARAMETER_SIZE(1024 * 1024);
+const int FormReader::BUFFER_SIZE(8192);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
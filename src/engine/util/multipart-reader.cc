@@ -0,0 +1,438 @@
+#include <echo/engine/util/multipart-reader.h>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/**
+ * Returns a header value without the surrounding white spaces.
+ */
+static std::string trim(const std::string& value) {
+  const std::string::size_type first = value.find_first_not_of(" \t");
+
+  if (first == std::string::npos) {
+    return "";
+  }
+
+  return value.substr(first, value.find_last_not_of(" \t") - first + 1);
+}
+
+/**
+ * Returns the value of a parameter of a header such as
+ * "form-data; name=\"field\"; filename=\"file.txt\"".
+ */
+static std::string getParameter(const std::string& header, const char* name) {
+  const size_t nameLength = strlen(name);
+  std::string::size_type position = header.find(';');
+
+  while (position != std::string::npos) {
+    position = header.find_first_not_of(" \t", position + 1);
+
+    if (position == std::string::npos) {
+      break;
+    }
+
+    const std::string::size_type equals = header.find('=', position);
+
+    if (equals == std::string::npos) {
+      break;
+    }
+
+    const bool matched = (trim(header.substr(position, equals - position))
+                          .size() == nameLength)
+                         && (strncasecmp(header.c_str() + position, name,
+                                         nameLength) == 0);
+    std::string value;
+    position = equals + 1;
+
+    if ((position < header.size()) && (header[position] == '"')) {
+      // Quoted string, with escaped characters
+      for (position++; (position < header.size())
+               && (header[position] != '"'); position++) {
+        if ((header[position] == '\\') && (position + 1 < header.size())) {
+          position++;
+        }
+        value += header[position];
+      }
+      position = header.find(';', position);
+    } else {
+      const std::string::size_type semicolon = header.find(';', position);
+      value = trim(header.substr(position, semicolon - position));
+      position = semicolon;
+    }
+
+    if (matched) {
+      return value;
+    }
+  }
+
+  return "";
+}
+
+/**
+ * Writes a whole buffer to a file descriptor.
+ */
+static void writeAll(int file, const char* data, size_t length,
+                     const std::string& path) throw (std::runtime_error) {
+  while (length > 0) {
+    const ssize_t written = write(file, data, length);
+
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      throw std::runtime_error("Unable to write the temporary file " + path);
+    }
+
+    data += written;
+    length -= written;
+  }
+}
+
+Representation MultipartReader::Part::getEntity() const {
+  const MediaType type = mediaType.empty() ? MediaType.APPLICATION_OCTET_STREAM
+                         : MediaType.valueOf(mediaType);
+
+  if (isInMemory()) {
+    return new StringRepresentation(std::string(data, size), type);
+  }
+
+  FileRepresentation result = new FileRepresentation(filePath, type);
+  result.setAutoDeleting(true);
+  released = true;
+  return result;
+}
+
+void MultipartReader::Part::clear() {
+  if (!filePath.empty() && !released) {
+    unlink(filePath.c_str());
+  }
+
+  data = NULL;
+  size = 0;
+  name.clear();
+  fileName.clear();
+  mediaType.clear();
+  filePath.clear();
+  released = false;
+}
+
+std::string MultipartReader::getBoundary(MediaType mediaType) {
+  if (mediaType == NULL) {
+    return "";
+  }
+
+  const std::string result = mediaType.getParameters().getFirstValue(
+      "boundary");
+  return (result == NULL) ? "" : result;
+}
+
+MultipartReader::MultipartReader(Representation entity) {
+  initialize(entity, getBoundary(entity.getMediaType()),
+             DEFAULT_MEMORY_THRESHOLD, DEFAULT_MAX_PARTS, "/tmp");
+}
+
+MultipartReader::MultipartReader(Representation entity, std::string boundary,
+                                 int memoryThreshold, int maxParts,
+                                 std::string directory) {
+  initialize(entity, boundary, memoryThreshold, maxParts, directory);
+}
+
+MultipartReader::~MultipartReader() {
+  if (file != -1) {
+    close(file);
+  }
+
+  if (stream != NULL) {
+    try {
+      stream.close();
+    } catch (IOException ioe) {
+    }
+  }
+}
+
+bool MultipartReader::readNextPart(Part& part) throw (std::runtime_error) {
+  size_t partial;
+  long position;
+
+  if (closed) {
+    return false;
+  }
+
+  // 1 - Skip the preamble before the first delimiter
+  if (count == 0) {
+    while ((position = findDelimiter(partial)) == -1) {
+      start = partial;
+
+      if (!fill()) {
+        throw std::runtime_error("No boundary found in the multipart entity");
+      }
+    }
+
+    start = position + delimiter.size();
+  }
+
+  // 2 - Detect the closing delimiter
+  if (!require(2)) {
+    throw std::runtime_error("Unexpected end of the multipart entity");
+  }
+
+  if ((buffer[start] == '-') && (buffer[start + 1] == '-')) {
+    closed = true;
+    return false;
+  }
+
+  while (require(1) && ((buffer[start] == ' ') || (buffer[start] == '\t'))) {
+    start++;
+  }
+
+  if (!require(2) || (buffer[start] != '\r') || (buffer[start + 1] != '\n')) {
+    throw std::runtime_error("Malformed boundary in the multipart entity");
+  }
+
+  start += 2;
+
+  if ((maxParts != -1) && (count >= maxParts)) {
+    throw std::runtime_error(
+        "The multipart entity contains more parts than the limit");
+  }
+
+  // A spilled part the caller didn't hand over is deleted
+  count++;
+  part.clear();
+  memory.clear();
+  readHeaders(part);
+
+  // 3 - Stream the content up to the next delimiter
+  while ((position = findDelimiter(partial)) == -1) {
+    append(part, &buffer[start], partial - start);
+    start = partial;
+
+    if (!fill()) {
+      throw std::runtime_error("Unexpected end of the multipart entity");
+    }
+  }
+
+  append(part, &buffer[start], position - start);
+  start = position + delimiter.size();
+
+  if (file != -1) {
+    close(file);
+    file = -1;
+  } else {
+    part.data = memory.empty() ? "" : &memory[0];
+  }
+
+  return true;
+}
+
+long MultipartReader::findDelimiter(size_t& partial) {
+  const char* base = &buffer[0];
+  const size_t length = delimiter.size();
+  size_t position = start;
+
+  while (position < end) {
+    const char* hit = static_cast<const char*>(
+        memchr(base + position, delimiter[0], end - position));
+
+    if (hit == NULL) {
+      break;
+    }
+
+    position = hit - base;
+    const size_t available = end - position;
+
+    if (available >= length) {
+      if (memcmp(hit, delimiter.data(), length) == 0) {
+        return position;
+      }
+    } else if (memcmp(hit, delimiter.data(), available) == 0) {
+      partial = position;
+      return -1;
+    }
+
+    position++;
+  }
+
+  partial = end;
+  return -1;
+}
+
+bool MultipartReader::fill() throw (std::runtime_error) {
+  if (finished) {
+    return false;
+  }
+
+  // Move the unconsumed data to the beginning of the buffer
+  if (start > 0) {
+    memmove(&buffer[0], &buffer[start], end - start);
+    end -= start;
+    start = 0;
+  }
+
+  if (end == buffer.size()) {
+    return false;
+  }
+
+  int result;
+
+  try {
+    result = stream.read(&buffer[0], end, buffer.size() - end);
+  } catch (IOException ioe) {
+    throw std::runtime_error("Unable to read the multipart entity");
+  }
+
+  // A stream reading nothing into a non-empty buffer breaks the blocking
+  // contract, it is handled as its end instead of being polled
+  if (result <= 0) {
+    finished = true;
+    return false;
+  }
+
+  end += result;
+  return true;
+}
+
+void MultipartReader::initialize(Representation entity, std::string boundary,
+                                 int memoryThreshold, int maxParts,
+                                 std::string directory) {
+  this->stream = (entity == NULL) ? NULL : entity.getStream();
+  this->delimiter = "\r\n--" + boundary;
+  this->memoryThreshold = memoryThreshold;
+  this->maxParts = maxParts;
+  this->directory = directory;
+  this->count = 0;
+  this->closed = boundary.empty();
+  this->finished = (this->stream == NULL);
+  this->file = -1;
+
+  // The buffer can hold a chunk after the largest unconsumed data, which is
+  // a header block or a delimiter prefix
+  this->buffer.resize(BUFFER_SIZE + MAX_HEADERS_SIZE + this->delimiter.size());
+
+  // The first delimiter isn't preceded by a line break, pretend it is
+  this->buffer[0] = '\r';
+  this->buffer[1] = '\n';
+  this->start = 0;
+  this->end = 2;
+}
+
+bool MultipartReader::require(size_t count) throw (std::runtime_error) {
+  while (end - start < count) {
+    if (!fill()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void MultipartReader::append(Part& part, const char* data, size_t length)
+    throw (std::runtime_error) {
+  if (length == 0) {
+    return;
+  }
+
+  part.size += length;
+
+  if ((file == -1) && (memory.size() + length <= memoryThreshold)) {
+    memory.insert(memory.end(), data, data + length);
+    return;
+  }
+
+  if (file == -1) {
+    // Spill the part to a temporary file, starting with the content held in
+    // memory so far
+    std::string path = directory + "/echo-part-XXXXXX";
+    file = mkstemp(&path[0]);
+
+    if (file == -1) {
+      throw std::runtime_error("Unable to create a temporary file in "
+                               + directory);
+    }
+
+    part.filePath = path;
+
+    if (!memory.empty()) {
+      writeAll(file, &memory[0], memory.size(), path);
+      memory.clear();
+    }
+  }
+
+  writeAll(file, data, length, part.filePath);
+}
+
+void MultipartReader::readHeaders(Part& part) throw (std::runtime_error) {
+  static const char* SEPARATOR = "\r\n\r\n";
+
+  // A part without headers starts with an empty line
+  if (require(2) && (buffer[start] == '\r') && (buffer[start + 1] == '\n')) {
+    start += 2;
+    return;
+  }
+
+  const char* separator = NULL;
+
+  while (separator == NULL) {
+    separator = static_cast<const char*>(
+        memmem(&buffer[start], end - start, SEPARATOR, strlen(SEPARATOR)));
+
+    if (separator == NULL) {
+      if (end - start > static_cast<size_t>(MAX_HEADERS_SIZE)) {
+        throw std::runtime_error(
+            "The headers of a multipart entity part exceed the limit");
+      }
+
+      if (!fill()) {
+        throw std::runtime_error("Unexpected end of the multipart entity");
+      }
+    }
+  }
+
+  const std::string headers(&buffer[start], separator - &buffer[start]);
+  start += headers.size() + strlen(SEPARATOR);
+
+  std::string::size_type lineStart = 0;
+
+  while (lineStart < headers.size()) {
+    std::string::size_type lineEnd = headers.find("\r\n", lineStart);
+
+    if (lineEnd == std::string::npos) {
+      lineEnd = headers.size();
+    }
+
+    const std::string line = headers.substr(lineStart, lineEnd - lineStart);
+    const std::string::size_type colon = line.find(':');
+    lineStart = lineEnd + 2;
+
+    if (colon == std::string::npos) {
+      continue;
+    }
+
+    const std::string name = trim(line.substr(0, colon));
+    const std::string value = trim(line.substr(colon + 1));
+
+    if (strcasecmp(name.c_str(), "Content-Disposition") == 0) {
+      part.name = getParameter(value, "name");
+      part.fileName = getParameter(value, "filename");
+    } else if (strcasecmp(name.c_str(), "Content-Type") == 0) {
+      part.mediaType = value;
+    }
+  }
+}
+
+const int MultipartReader::DEFAULT_MEMORY_THRESHOLD(64 * 1024);
+const int MultipartReader::DEFAULT_MAX_PARTS(1000);
+const int MultipartReader::MAX_HEADERS_SIZE(8 * 1024);
+const int MultipartReader::BUFFER_SIZE(64 * 1024);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
@@ -0,0 +1,751 @@
+#include <echo/engine/util/pattern.h>
+
+#include <cctype>
+#include <cstdlib>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+/** Automaton operation matching a byte of a set. */
+static const int OP_SET = 0;
+
+/** Automaton operation forking the execution. */
+static const int OP_SPLIT = 1;
+
+/** Automaton operation jumping to another instruction. */
+static const int OP_JUMP = 2;
+
+/** Automaton operation accepting the value. */
+static const int OP_MATCH = 3;
+
+/** Maximum number of instructions produced by the expansion of quantifiers. */
+static const size_t MAX_INSTRUCTIONS = 8192;
+
+/**
+ * Indicates if a regular expression uses a backslash escape followed by a
+ * letter or a digit, such as "\d", "\b", "\x41" or "\Q", which POSIX
+ * regular expressions would silently read as the bare character.
+ */
+static bool hasNamedEscape(const std::string& regex) {
+  for (std::string::size_type i = 0; i + 1 < regex.size(); i++) {
+    if (regex[i] == '\\') {
+      if (isalnum(static_cast<unsigned char>(regex[i + 1]))) {
+        return true;
+      }
+
+      // Skip the escaped punctuation, "\\" included
+      i++;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Recursive descent parser of the supported regular expression syntax,
+ * producing a syntax tree then the scanner segments or the automaton.
+ */
+class Pattern::Parser {
+
+ public:
+
+  Parser(const std::string& source, std::vector<CharSet>& sets)
+      : source(source), sets(sets), position(0), failed(false) {
+  }
+
+  /**
+   * Parses the whole source and returns the root node, or -1 if the syntax
+   * isn't supported.
+   */
+  int parse() {
+    int result = parseAlternation();
+
+    if (position < source.size()) {
+      failed = true;
+    }
+
+    return failed ? -1 : result;
+  }
+
+  /**
+   * Lowers the tree to scanner segments if it is a sequence of character
+   * classes where only the last one has a variable length.
+   */
+  bool toSegments(int root, std::vector<Segment>& segments) {
+    std::vector<int> items;
+
+    if (nodes[root].type == CAT) {
+      items = nodes[root].children;
+    } else if (nodes[root].type != EMPTY) {
+      items.push_back(root);
+    }
+
+    for (size_t i = 0; i < items.size(); i++) {
+      const Node& node = nodes[items[i]];
+      Segment segment;
+
+      if (node.type == SET) {
+        segment.set = node.set;
+        segment.min = 1;
+        segment.max = 1;
+      } else if ((node.type == REPEAT)
+                 && (nodes[node.children[0]].type == SET)) {
+        segment.set = nodes[node.children[0]].set;
+        segment.min = node.min;
+        segment.max = node.max;
+      } else {
+        return false;
+      }
+
+      if ((segment.min != segment.max) && (i + 1 < items.size())) {
+        return false;
+      }
+
+      segments.push_back(segment);
+    }
+
+    return true;
+  }
+
+  /**
+   * Generates the automaton instructions of the tree, or returns false if the
+   * program would be too large.
+   */
+  bool toInstructions(int root, std::vector<Instruction>& instructions) {
+    generate(root, instructions);
+    emit(instructions, OP_MATCH, 0, 0);
+    return instructions.size() <= MAX_INSTRUCTIONS;
+  }
+
+ private:
+
+  enum Type { EMPTY, SET, CAT, ALT, REPEAT };
+
+  struct Node {
+    Type type;
+    int set;
+    int min;
+    int max;
+    std::vector<int> children;
+  };
+
+  int node(Type type) {
+    Node n;
+    n.type = type;
+    n.set = -1;
+    n.min = 0;
+    n.max = 0;
+    nodes.push_back(n);
+    return nodes.size() - 1;
+  }
+
+  int setNode(const CharSet& set) {
+    int result = node(SET);
+    nodes[result].set = sets.size();
+    sets.push_back(set);
+    return result;
+  }
+
+  bool more() const {
+    return position < source.size();
+  }
+
+  char peek() const {
+    return source[position];
+  }
+
+  int parseAlternation() {
+    int result = parseSequence();
+
+    while (!failed && more() && (peek() == '|')) {
+      position++;
+      int other = parseSequence();
+      int alternative = node(ALT);
+      nodes[alternative].children.push_back(result);
+      nodes[alternative].children.push_back(other);
+      result = alternative;
+    }
+
+    return result;
+  }
+
+  int parseSequence() {
+    int result = node(CAT);
+
+    while (!failed && more() && (peek() != '|') && (peek() != ')')) {
+      int item = parseRepetition();
+
+      if (item != -1) {
+        nodes[result].children.push_back(item);
+      }
+    }
+
+    if (nodes[result].children.empty()) {
+      nodes[result].type = EMPTY;
+    } else if (nodes[result].children.size() == 1) {
+      return nodes[result].children[0];
+    }
+
+    return result;
+  }
+
+  int parseRepetition() {
+    int result = parseAtom();
+
+    while (!failed && (result != -1) && more()) {
+      int min;
+      int max;
+      const char c = peek();
+
+      if (c == '*') {
+        min = 0;
+        max = -1;
+        position++;
+      } else if (c == '+') {
+        min = 1;
+        max = -1;
+        position++;
+      } else if (c == '?') {
+        min = 0;
+        max = 1;
+        position++;
+      } else if (c == '{') {
+        if (!parseBounds(min, max)) {
+          failed = true;
+          return -1;
+        }
+      } else {
+        break;
+      }
+
+      if (more() && (peek() == '?')) {
+        // Reluctant quantifiers match the same whole values
+        position++;
+      } else if (more() && (peek() == '+')) {
+        // Possessive quantifiers can reject values, not supported
+        failed = true;
+        return -1;
+      }
+
+      int repeat = node(REPEAT);
+      nodes[repeat].min = min;
+      nodes[repeat].max = max;
+      nodes[repeat].children.push_back(result);
+      result = repeat;
+    }
+
+    return result;
+  }
+
+  bool parseBounds(int& min, int& max) {
+    const std::string::size_type end = source.find('}', position);
+
+    if (end == std::string::npos) {
+      return false;
+    }
+
+    const std::string bounds = source.substr(position + 1,
+                                             end - position - 1);
+    const std::string::size_type comma = bounds.find(',');
+    const std::string low = bounds.substr(0, comma);
+    const std::string high = (comma == std::string::npos) ? low
+                             : bounds.substr(comma + 1);
+
+    if (low.empty() || (low.find_first_not_of("0123456789")
+                        != std::string::npos)
+        || (high.find_first_not_of("0123456789") != std::string::npos)) {
+      return false;
+    }
+
+    min = std::atoi(low.c_str());
+    max = high.empty() ? -1 : std::atoi(high.c_str());
+    position = end + 1;
+    return (max == -1) || (min <= max);
+  }
+
+  int parseAtom() {
+    const char c = source[position++];
+    CharSet set;
+
+    switch (c) {
+      case '(': {
+        if (more() && (peek() == '?')) {
+          // Only non-capturing groups are supported
+          if ((position + 1 < source.size())
+              && (source[position + 1] == ':')) {
+            position += 2;
+          } else {
+            failed = true;
+            return -1;
+          }
+        }
+
+        int result = parseAlternation();
+
+        if (!more() || (peek() != ')')) {
+          failed = true;
+          return -1;
+        }
+
+        position++;
+        return result;
+      }
+
+      case '[':
+        if (!parseClass(set)) {
+          failed = true;
+          return -1;
+        }
+        return setNode(set);
+
+      case '.':
+        set.set();
+        set.reset('\n');
+        set.reset('\r');
+        return setNode(set);
+
+      case '\\':
+        if (!parseEscape(set)) {
+          failed = true;
+          return -1;
+        }
+        return setNode(set);
+
+      case '^':
+        // Whole values are matched, anchors are implicit at the boundaries
+        if (position != 1) {
+          failed = true;
+        }
+        return -1;
+
+      case '$':
+        if (position != source.size()) {
+          failed = true;
+        }
+        return -1;
+
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+        failed = true;
+        return -1;
+
+      default:
+        set.set(static_cast<unsigned char>(c));
+        return setNode(set);
+    }
+  }
+
+  bool parseEscape(CharSet& set) {
+    if (!more()) {
+      return false;
+    }
+
+    const char c = source[position++];
+
+    switch (c) {
+      case 'd':
+      case 'D':
+        for (int i = '0'; i <= '9'; i++) {
+          set.set(i);
+        }
+        break;
+
+      case 'w':
+      case 'W':
+        for (int i = 0; i < 256; i++) {
+          if (std::isalnum(i) && (i < 128)) {
+            set.set(i);
+          }
+        }
+        set.set('_');
+        break;
+
+      case 's':
+      case 'S':
+        set.set(' ');
+        set.set('\t');
+        set.set('\n');
+        set.set('\x0B');
+        set.set('\f');
+        set.set('\r');
+        break;
+
+      case 't':
+        set.set('\t');
+        return true;
+
+      case 'n':
+        set.set('\n');
+        return true;
+
+      case 'r':
+        set.set('\r');
+        return true;
+
+      case 'f':
+        set.set('\f');
+        return true;
+
+      default:
+        // Only escaped punctuation is literal, other escapes are anchors,
+        // back-references or properties
+        if (!std::ispunct(static_cast<unsigned char>(c))) {
+          return false;
+        }
+        set.set(static_cast<unsigned char>(c));
+        return true;
+    }
+
+    if (std::isupper(static_cast<unsigned char>(c))) {
+      set.flip();
+    }
+
+    return true;
+  }
+
+  bool parseClass(CharSet& set) {
+    bool negated = false;
+    bool first = true;
+
+    if (more() && (peek() == '^')) {
+      negated = true;
+      position++;
+    }
+
+    while (more() && ((peek() != ']') || first)) {
+      CharSet item;
+      int low = -1;
+
+      if (peek() == '[') {
+        // Unions and intersections of classes
+        return false;
+      } else if (peek() == '\\') {
+        position++;
+        if (!parseEscape(item)) {
+          return false;
+        }
+        if (item.count() == 1) {
+          for (int i = 0; i < 256; i++) {
+            if (item.test(i)) {
+              low = i;
+            }
+          }
+        }
+      } else {
+        low = static_cast<unsigned char>(source[position++]);
+        item.set(low);
+      }
+
+      if ((low != -1) && (position + 1 < source.size()) && (peek() == '-')
+          && (source[position + 1] != ']')) {
+        position++;
+        int high = static_cast<unsigned char>(source[position++]);
+
+        if (high == '\\') {
+          return false;
+        }
+
+        if (high < low) {
+          return false;
+        }
+
+        for (int i = low; i <= high; i++) {
+          item.set(i);
+        }
+      }
+
+      set |= item;
+      first = false;
+    }
+
+    if (!more()) {
+      return false;
+    }
+
+    position++;
+
+    if (negated) {
+      set.flip();
+    }
+
+    return true;
+  }
+
+  static int emit(std::vector<Instruction>& instructions, int op, int x,
+                  int y) {
+    Instruction instruction;
+    instruction.op = op;
+    instruction.x = x;
+    instruction.y = y;
+    instructions.push_back(instruction);
+    return instructions.size() - 1;
+  }
+
+  void generate(int index, std::vector<Instruction>& instructions) {
+    if (instructions.size() > MAX_INSTRUCTIONS) {
+      return;
+    }
+
+    const Node n = nodes[index];
+
+    switch (n.type) {
+      case EMPTY:
+        break;
+
+      case SET:
+        emit(instructions, OP_SET, n.set, 0);
+        break;
+
+      case CAT:
+        for (size_t i = 0; i < n.children.size(); i++) {
+          generate(n.children[i], instructions);
+        }
+        break;
+
+      case ALT: {
+        int split = emit(instructions, OP_SPLIT, 0, 0);
+        instructions[split].x = instructions.size();
+        generate(n.children[0], instructions);
+        int jump = emit(instructions, OP_JUMP, 0, 0);
+        instructions[split].y = instructions.size();
+        generate(n.children[1], instructions);
+        instructions[jump].x = instructions.size();
+        break;
+      }
+
+      case REPEAT: {
+        for (int i = 0; i < n.min; i++) {
+          generate(n.children[0], instructions);
+        }
+
+        if (n.max == -1) {
+          int split = emit(instructions, OP_SPLIT, 0, 0);
+          instructions[split].x = instructions.size();
+          generate(n.children[0], instructions);
+          emit(instructions, OP_JUMP, split, 0);
+          instructions[split].y = instructions.size();
+        } else {
+          std::vector<int> splits;
+
+          for (int i = n.min; i < n.max; i++) {
+            int split = emit(instructions, OP_SPLIT, 0, 0);
+            instructions[split].x = instructions.size();
+            splits.push_back(split);
+            generate(n.children[0], instructions);
+          }
+
+          for (size_t i = 0; i < splits.size(); i++) {
+            instructions[splits[i]].y = instructions.size();
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  /** The source regular expression. */
+  const std::string& source;
+
+  /** The byte sets of the program. */
+  std::vector<CharSet>& sets;
+
+  /** The syntax tree nodes. */
+  std::vector<Node> nodes;
+
+  /** The parsing position. */
+  std::string::size_type position;
+
+  /** Indicates if the syntax isn't supported. */
+  bool failed;
+
+};
+
+Pattern::Program::~Program() {
+  if (kind == KIND_POSIX) {
+    regfree(&posix);
+  }
+}
+
+Pattern::Pattern() {
+  Program* compiled = new Program();
+  compiled->kind = KIND_INVALID;
+  program.reset(compiled);
+}
+
+Pattern::Pattern(const std::string& regex) {
+  Program* compiled = new Program();
+  compiled->source = regex;
+  compiled->kind = KIND_INVALID;
+
+  Parser parser(regex, compiled->sets);
+  const int root = parser.parse();
+
+  if (root != -1) {
+    if (parser.toSegments(root, compiled->segments)) {
+      compiled->kind = KIND_SCANNER;
+    } else if (parser.toInstructions(root, compiled->instructions)) {
+      compiled->kind = KIND_AUTOMATON;
+    }
+  }
+
+  if (compiled->kind == KIND_INVALID) {
+    compiled->sets.clear();
+    compiled->segments.clear();
+    compiled->instructions.clear();
+  }
+
+  // Only the syntax the parser accepted means the same to POSIX, the
+  // automaton being merely too large: the rejected syntax, such as
+  // possessive quantifiers, nested classes or "{,n}", and the named escapes
+  // would be misread, so such patterns are rejected
+  if ((compiled->kind == KIND_INVALID) && (root != -1)
+      && !hasNamedEscape(regex)) {
+    const std::string anchored = "^(" + regex + ")$";
+    if (regcomp(&compiled->posix, anchored.c_str(),
+                REG_EXTENDED | REG_NOSUB) == 0) {
+      compiled->kind = KIND_POSIX;
+    }
+  }
+
+  program.reset(compiled);
+}
+
+int Pattern::getKind() const {
+  return program->kind;
+}
+
+std::string Pattern::getPattern() const {
+  return program->source;
+}
+
+bool Pattern::matches(const std::string& value) const {
+  const int kind = program->kind;
+
+  if (kind == KIND_SCANNER) {
+    return scan(value);
+  } else if (kind == KIND_AUTOMATON) {
+    return run(value);
+  } else if (kind == KIND_POSIX) {
+    return regexec(&program->posix, value.c_str(), 0, NULL, 0) == 0;
+  }
+
+  return false;
+}
+
+bool Pattern::scan(const std::string& value) const {
+  const std::vector<Segment>& segments = program->segments;
+  const unsigned char* data =
+      reinterpret_cast<const unsigned char*>(value.data());
+  const size_t length = value.size();
+  size_t position = 0;
+
+  for (size_t i = 0; i < segments.size(); i++) {
+    const Segment& segment = segments[i];
+    const CharSet& set = program->sets[segment.set];
+    size_t end;
+
+    if (segment.min == segment.max) {
+      end = position + segment.min;
+    } else {
+      // Only the last segment has a variable length
+      end = length;
+      const size_t count = length - position;
+      if ((count < static_cast<size_t>(segment.min))
+          || ((segment.max != -1)
+              && (count > static_cast<size_t>(segment.max)))) {
+        return false;
+      }
+    }
+
+    if (end > length) {
+      return false;
+    }
+
+    for (; position < end; position++) {
+      if (!set.test(data[position])) {
+        return false;
+      }
+    }
+  }
+
+  return position == length;
+}
+
+/**
+ * Adds an instruction and the instructions reachable without consuming a byte
+ * to a list of threads, each instruction being added once per step.
+ */
+template <typename Instruction>
+static void addThread(const std::vector<Instruction>& instructions,
+                      std::vector<int>& list, std::vector<int>& marks,
+                      int step, int start, std::vector<int>& stack) {
+  stack.push_back(start);
+
+  while (!stack.empty()) {
+    const int pc = stack.back();
+    stack.pop_back();
+
+    if (marks[pc] == step) {
+      continue;
+    }
+
+    marks[pc] = step;
+
+    if (instructions[pc].op == OP_JUMP) {
+      stack.push_back(instructions[pc].x);
+    } else if (instructions[pc].op == OP_SPLIT) {
+      stack.push_back(instructions[pc].y);
+      stack.push_back(instructions[pc].x);
+    } else {
+      list.push_back(pc);
+    }
+  }
+}
+
+bool Pattern::run(const std::string& value) const {
+  const std::vector<Instruction>& instructions = program->instructions;
+  std::vector<int> current;
+  std::vector<int> next;
+  std::vector<int> marks(instructions.size(), -1);
+  std::vector<int> stack;
+  int step = 0;
+
+  addThread(instructions, current, marks, step, 0, stack);
+
+  for (size_t i = 0; (i < value.size()) && !current.empty(); i++) {
+    const unsigned char c = static_cast<unsigned char>(value[i]);
+    step++;
+    next.clear();
+
+    for (size_t t = 0; t < current.size(); t++) {
+      const Instruction& instruction = instructions[current[t]];
+
+      if ((instruction.op == OP_SET)
+          && program->sets[instruction.x].test(c)) {
+        addThread(instructions, next, marks, step, current[t] + 1, stack);
+      }
+    }
+
+    current.swap(next);
+  }
+
+  for (size_t t = 0; t < current.size(); t++) {
+    if (instructions[current[t]].op == OP_MATCH) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+const int Pattern::KIND_INVALID(0);
+const int Pattern::KIND_SCANNER(1);
+const int Pattern::KIND_AUTOMATON(2);
+const int Pattern::KIND_POSIX(3);
+
+} // namespace util
+} // namespace engine
+} // namespace echo
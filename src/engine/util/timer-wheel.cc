@@ -0,0 +1,97 @@
+#include <echo/engine/util/timer-wheel.h>
+
+#include <time.h>
+
+namespace echo {
+namespace engine {
+namespace util {
+
+long long TimerWheel::currentTimeMillis() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec * 1000LL) + (now.tv_nsec / 1000000);
+}
+
+TimerWheel::TimerWheel(int slots, long long tick, long long now) {
+  int count = 1;
+
+  while (count < slots) {
+    count <<= 1;
+  }
+
+  this->slots.resize(count);
+  this->mask = count - 1;
+  this->tick = (tick > 0) ? tick : 1;
+  this->current = now / this->tick;
+  this->size = 0;
+
+  for (int i = 0; i < count; i++) {
+    this->slots[i].previous = &this->slots[i];
+    this->slots[i].next = &this->slots[i];
+  }
+}
+
+void TimerWheel::advance(long long now, std::vector<Timer*>& expired) {
+  const long long target = now / tick;
+
+  if (target <= current) {
+    return;
+  }
+
+  // Beyond a revolution, each slot only needs to be visited once
+  const long long first = (target - current > mask) ? target - mask
+                          : current + 1;
+
+  for (long long t = first; t <= target; t++) {
+    Timer* head = &slots[t & mask];
+    Timer* timer = head->next;
+
+    while (timer != head) {
+      Timer* next = timer->next;
+
+      if (timer->deadline <= now) {
+        cancel(timer);
+        expired.push_back(timer);
+      }
+
+      timer = next;
+    }
+  }
+
+  current = target;
+}
+
+void TimerWheel::cancel(Timer* timer) {
+  if (timer->previous == NULL) {
+    return;
+  }
+
+  timer->previous->next = timer->next;
+  timer->next->previous = timer->previous;
+  timer->previous = NULL;
+  timer->next = NULL;
+  size--;
+}
+
+void TimerWheel::schedule(Timer* timer, long long deadline) {
+  cancel(timer);
+
+  // Past deadlines expire on the next tick rather than a revolution later
+  long long t = deadline / tick;
+
+  if (t <= current) {
+    t = current + 1;
+  }
+
+  Timer* head = &slots[t & mask];
+  timer->deadline = deadline;
+  timer->previous = head->previous;
+  timer->next = head;
+  head->previous->next = timer;
+  head->previous = timer;
+  size++;
+}
+
+} // namespace util
+} // namespace engine
+} // namespace echo
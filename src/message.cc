@@ -1,4 +1,7 @@
+#include <stdexcept>
+
 #include <echo/message.h>
+#include <echo/engine/util/form-reader.h>
 
 namespace echo {
   
@@ -25,8 +28,21 @@ namespace echo {
   }
 
   Form Message::getEntityAsForm() {
-	if (entityForm == NULL) {
-	  entityForm = new Form(getEntity());
+	// The entity stream was consumed by the failed parse, it can't be read
+	// again
+	if ((entityForm == NULL) && !entityFormInvalid && (getEntity() != NULL)) {
+	  // Parse the entity incrementally instead of reading it as text first
+	  Form form = new Form();
+
+	  try {
+		echo::engine::util::FormReader reader(getEntity());
+		reader.addParameters(form);
+		entityForm = form;
+	  } catch (std::runtime_error& e) {
+		entityFormInvalid = true;
+		Context.getCurrentLogger().log(Level.WARNING,
+									   "Unable to parse the entity as a form.", e);
+	  }
 	}
 
 	return entityForm;
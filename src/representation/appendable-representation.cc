@@ -4,50 +4,95 @@ namespace echo {
 namespace representation {
 
 Appendable AppendableRepresentation::append(char c) throws IOException {
-  if (this->appendableText == NULL) {
-    this->appendableText = new StringBuilder(c);
-  } else {
-    this->appendableText.append(c);
-  }
+  this->appendableText.append(c);
+  this->textAvailable = true;
+  offer(false);
 
   return this;
 }
 
 Appendable AppendableRepresentation::append(CharSequence csq) throws IOException {
-  if (this->appendableText == NULL) {
-    this->appendableText = new StringBuilder(csq);
-  } else {
-    this->appendableText.append(csq);
-  }
+  this->appendableText.append(csq.toString());
+  this->textAvailable = true;
+  offer(false);
 
   return this;
 }
 
 Appendable AppendableRepresentation::append(CharSequence csq, int start, int end)
     throws IOException {
-  if (this->appendableText == NULL) {
-    this->appendableText = new StringBuilder();
+  this->appendableText.append(csq.subSequence(start, end).toString());
+  this->textAvailable = true;
+  offer(false);
+
+  return this;
+}
+
+void AppendableRepresentation::finish() throws IOException {
+  if (this->stream) {
+    offer(true);
+    this->stream->close();
   }
+}
 
-  this->appendableText.append(csq, start, end);
+void AppendableRepresentation::flush() throws IOException {
+  offer(true);
+}
 
-  return this;
+std::string AppendableRepresentation::getText() {
+  if (!this->textAvailable) {
+    return std::string();
+  }
+
+  std::string result;
+  this->appendableText.toString(result);
+  return result;
 }
 
 void AppendableRepresentation::setText(CharSequence text) {
+  this->appendableText.clear();
+  this->textAvailable = (text != NULL);
+
   if (text != NULL) {
-    if (this->appendableText == NULL) {
-      this->appendableText = new StringBuilder(text);
-    } else {
-      this->appendableText.delete(0, this->appendableText.length());
-      this->appendableText.append(text);
-    }
-  } else {
-    this->appendableText = NULL;
+    this->appendableText.append(text.toString());
   }
 }
 
-} // namespace representation
-} // namespace echo
+void AppendableRepresentation::release() {
+  if (this->stream && !this->stream->isDone()) {
+    this->stream->abort();
+  }
+
+  super.release();
+}
+
+void AppendableRepresentation::startStreaming(size_t highWaterMark,
+                                              bool blocking)
+    throws IOException {
+  // A producer suspended on a loop thread would stop the loop draining it
+  const bool loop = (echo::engine::io::EventLoop::getCurrent() != NULL);
+  this->stream.reset(new echo::engine::util::ChunkStream(
+      highWaterMark, blocking && !loop));
+  offer(false);
+}
+
+void AppendableRepresentation::initialize(CharSequence text) {
+  this->textAvailable = false;
+  this->stream.reset();
+  setText(text);
+}
 
+void AppendableRepresentation::offer(bool all) throws IOException {
+  if (!this->stream || (!all && !this->appendableText.hasFullChunk())) {
+    return;
+  }
 
+  // Only fails for a non-blocking stream above its mark, or a lost client
+  if (!this->stream->offer(this->appendableText, all)
+      && this->stream->isAborted()) {
+    throw IOException("The client connection was closed");
+  }
+}
+
+} // namespace representation
+} // namespace echo
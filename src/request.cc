@@ -12,10 +12,13 @@ namespace echo {
 	challengeResponse = NULL;
 	clientInfo = NULL;
 	conditions = NULL;
+	cookieHeader = NULL;
 	cookies = NULL;
 	hostRef = NULL;
 	this->method = method;
 	originalRef = NULL;
+	queryForm = NULL;
+	queryFormSource = NULL;
 	proxyChallengeResponse = NULL;
 	ranges = NULL;
 	referrerRef = NULL;
@@ -66,13 +69,31 @@ namespace echo {
 	  synchronized (this) {
 		c = cookies;
 		if (c == NULL) {
-		  cookies = c = new CookieSeries();
+		  c = new CookieSeries();
+
+		  if (cookieHeader != NULL) {
+			engine::util::CookieReader(cookieHeader).addCookies(c);
+		  }
+
+		  cookies = c;
 		}
 	  }
 	}
 	return c;
   }
 
+  std::string Request::getCookieValue(std::string name) {
+	const Series<Cookie> c = cookies;
+
+	if (c != NULL) {
+	  return c.getFirstValue(name);
+	}
+
+	const std::string header = cookieHeader;
+	return (header == NULL) ? NULL
+	  : engine::util::CookieReader::getFirstValue(header, name);
+  }
+
   Protocol Request::getProtocol() {
 	Protocol result = NULL;
 
@@ -91,6 +112,28 @@ namespace echo {
 	return result;
   }
 
+  Form Request::getQueryAsForm() {
+	if (getResourceRef() == NULL) {
+	  return NULL;
+	}
+
+	// The cached form is keyed to the query it was parsed from, so that
+	// changes of the resource reference invalidate it
+	const std::string query = getResourceRef().getQuery();
+	Form f = queryForm;
+	if ((f == NULL) || (queryFormSource != query)) {
+	  synchronized (this) {
+		f = queryForm;
+		if ((f == NULL) || (queryFormSource != query)) {
+		  f = new Form(query);
+		  queryFormSource = query;
+		  queryForm = f;
+		}
+	  }
+	}
+	return f;
+  }
+
   std::list<Range> Request::getRanges() {
 	// Lazy initialization with double-check.
 	std::list<Range> r = ranges;
@@ -138,6 +181,13 @@ namespace echo {
 	this->cookies = cookies;
   }
 
+  void Request::setCookieHeader(std::string cookieHeader) {
+	synchronized (this) {
+	  this->cookieHeader = cookieHeader;
+	  this->cookies = NULL;
+	}
+  }
+
   void Request::setHostRef(Reference hostRef) {
 	this->hostRef = hostRef;
   }
@@ -178,6 +228,7 @@ namespace echo {
 
   void Request::setResourceRef(Reference resourceRef) {
 	this->resourceRef = resourceRef;
+	this->queryForm = NULL;
   }
 
   void Request::setResourceRef(String resourceUri) {
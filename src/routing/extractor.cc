@@ -18,7 +18,7 @@ void Extractor::extractQuery(std::string attribute, std::string parameter, bool
 int Extractor::beforeHandle(echo::Request request, echo::Response response) {
   // Extract the query parameters
   if (!getQueryExtracts().isEmpty()) {
-    const Form form = request.getResourceRef().getQueryAsForm();
+    const Form form = request.getQueryAsForm();
 
     if (form != NULL) {
       for (const ExtractInfo ei : getQueryExtracts()) {
@@ -52,17 +52,14 @@ int Extractor::beforeHandle(echo::Request request, echo::Response response) {
 
   // Extract the cookie parameters
   if (!getCookieExtracts().isEmpty()) {
-    const Series<Cookie> cookies = request.getCookies();
-
-    if (cookies != NULL) {
-      for (const ExtractInfo ei : getCookieExtracts()) {
-        if (ei.first) {
-          request.getAttributes().put(ei.attribute,
-                                      cookies.getFirstValue(ei.parameter));
-        } else {
-          request.getAttributes().put(ei.attribute,
-                                      cookies.subList(ei.parameter));
-        }
+    for (const ExtractInfo ei : getCookieExtracts()) {
+      if (ei.first) {
+        // Look up the raw header, without materializing the cookies
+        request.getAttributes().put(ei.attribute,
+                                    request.getCookieValue(ei.parameter));
+      } else {
+        request.getAttributes().put(ei.attribute,
+                                    request.getCookies().subList(ei.parameter));
       }
     }
   }
@@ -4,6 +4,11 @@ namespace echo {
 namespace routing {
 
 void Filter::handle(echo::Request request, echo::Response response) {
+    if (isPipelined() && !pipeline.empty()) {
+      handlePipeline(request, response);
+      return;
+    }
+
     super.handle(request, response);
 
     switch (beforeHandle(request, response)) {
@@ -49,11 +54,18 @@ void Filter::start() throw (std::runtime_error) {
       if (getNext() != null) {
         getNext().start();
       }
+
+      if (isPipelined()) {
+        compilePipeline();
+      }
     }
   }
 
 void Filter::stop() throw (std::runtime_error) {
     if (isStarted()) {
+      pipeline.clear();
+      pipelineTail = null;
+
       if (getNext() != null) {
         getNext().stop();
       }
@@ -87,6 +99,95 @@ int Filter::doHandle(echo::Request request, echo::Response response) {
     return result;
   }
   
+void Filter::compilePipeline() {
+    pipeline.clear();
+    pipeline.push_back(*this);
+    pipelineTail = getNext();
+
+    // Follow the chain while the next Echo is a plain filter
+    while ((pipelineTail != null) && (pipelineTail instanceof Filter)
+           && ((Filter) pipelineTail).isLinearizable()) {
+      Filter filter = (Filter) pipelineTail;
+      pipeline.push_back(filter);
+      pipelineTail = filter.getNext();
+    }
+
+    if (getLogger().isLoggable(Level.FINE)) {
+      getLogger().fine(
+          "The filter " + getName() + " compiled a pipeline of "
+          + pipeline.size() + " filters.");
+    }
+  }
+
+void Filter::handlePipeline(echo::Request request, echo::Response response) {
+    // Associates the response and the context of the head filter
+    super.handle(request, response);
+
+    echo::Context current = getContext();
+    const int count = pipeline.size();
+    int continued = -1;
+    int skipped = -1;
+    bool stopped = false;
+
+    // 1 - Pre-filtering, in chain order
+    for (int i = 0; (i < count) && (skipped == -1) && !stopped; i++) {
+      Filter filter = pipeline[i];
+
+      if ((filter.getContext() != null) && (filter.getContext() != current)) {
+        current = filter.getContext();
+        Context.setCurrent(current);
+      }
+
+      switch (filter.beforeHandle(request, response)) {
+        case CONTINUE:
+          continued = i;
+          break;
+
+        case SKIP:
+          skipped = i;
+          break;
+
+        default:
+          stopped = true;
+          break;
+      }
+    }
+
+    // 2 - Handling by the Echo following the last filter
+    if (continued == count - 1) {
+      if (pipelineTail != null) {
+        pipelineTail.handle(request, response);
+
+        // Re-associate the response to the current thread
+        echo::Response.setCurrent(response);
+
+        // The context was possibly changed downstream
+        current = null;
+      } else {
+        response.setStatus(Status.SERVER_ERROR_INTERNAL);
+        getLogger()
+            .warning(
+                "The filter "
+                + pipeline[count - 1].getName()
+                + " was executed without a next Echo attached to it.");
+      }
+    } else if (skipped != -1) {
+      pipeline[skipped].afterHandle(request, response);
+    }
+
+    // 3 - Post-filtering, in reverse chain order
+    for (int i = continued; i >= 0; i--) {
+      Filter filter = pipeline[i];
+
+      if ((filter.getContext() != null) && (filter.getContext() != current)) {
+        current = filter.getContext();
+        Context.setCurrent(current);
+      }
+
+      filter.afterHandle(request, response);
+    }
+  }
+
 static const int Filter::CONTINUE(0);
 static const int Filter::SKIP(1);
 static const int Filter::STOP(2);
@@ -24,7 +24,15 @@ Route::Route Route::extractQuery(std::string attribute, std::string parameter, b
 }
 
 void Route::validate(std::string attribute, bool required, std::string format) {
-  getValidations().add(new ValidateInfo(attribute, required, format));
+  const ValidateInfo validation(attribute, required, format);
+
+  if ((format != null) && !validation.pattern.isValid()) {
+    getLogger().warning(
+        "Unable to compile the \"" + format + "\" format of the \""
+        + attribute + "\" attribute. Its values will never be valid.");
+  }
+
+  getValidations().add(validation);
 }
 
 int Route::beforeHandle(echo::Request request, echo::Response response) {
@@ -90,7 +98,7 @@ int Route::beforeHandle(echo::Request request, echo::Response response) {
 void Route::extractAttributes(echo::Request request, echo::Response response) {
   // Extract the query parameters
   if (!getQueryExtracts().isEmpty()) {
-    const Form form = request.getResourceRef().getQueryAsForm();
+    const Form form = request.getQueryAsForm();
 
     if (form != null) {
       for (const ExtractInfo ei : getQueryExtracts()) {
@@ -124,17 +132,14 @@ void Route::extractAttributes(echo::Request request, echo::Response response) {
 
   // Extract the cookie parameters
   if (!getCookieExtracts().isEmpty()) {
-    const Series<Cookie> cookies = request.getCookies();
-
-    if (cookies != null) {
-      for (const ExtractInfo ei : getCookieExtracts()) {
-        if (ei.first) {
-          request.getAttributes().put(ei.attribute,
-                                      cookies.getFirstValue(ei.parameter));
-        } else {
-          request.getAttributes().put(ei.attribute,
-                                      cookies.subList(ei.parameter));
-        }
+    for (const ExtractInfo ei : getCookieExtracts()) {
+      if (ei.first) {
+        // Look up the raw header, without materializing the cookies
+        request.getAttributes().put(ei.attribute,
+                                    request.getCookieValue(ei.parameter));
+      } else {
+        request.getAttributes().put(ei.attribute,
+                                    request.getCookies().subList(ei.parameter));
       }
     }
   }
@@ -219,7 +224,7 @@ void Route::validateAttributes(echo::Request request, echo::Response response) {
                   + validate.attribute
                   + "\" attribute with a null value. Please check your request.");
         } else {
-          if (!Pattern.matches(validate.format, value.toString())) {
+          if (!validate.pattern.matches(value.toString())) {
             response
                 .setStatus(
                     Status.CLIENT_ERROR_BAD_REQUEST,
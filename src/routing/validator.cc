@@ -26,7 +26,7 @@ int Validator::beforeHandle(echo::Request request, echo::Response response) {
                   + validate.attribute
                   + "\" attribute with a null value. Please check your request.");
         } else {
-          if (!Pattern.matches(validate.format, value.toString())) {
+          if (!validate.pattern.matches(value.toString())) {
             response
                 .setStatus(
                     Status.CLIENT_ERROR_BAD_REQUEST,
@@ -45,7 +45,15 @@ int Validator::beforeHandle(echo::Request request, echo::Response response) {
 }
 
 void Validator::validate(std::string attribute, bool required, std::string format) {
-  getValidations().add(new ValidateInfo(attribute, required, format));
+  const ValidateInfo validation(attribute, required, format);
+
+  if ((format != null) && !validation.pattern.isValid()) {
+    getLogger().warning(
+        "Unable to compile the \"" + format + "\" format of the \""
+        + attribute + "\" attribute. Its values will never be valid.");
+  }
+
+  getValidations().add(validation);
 }
 
 std::list<ValidateInfo> Validator::getValidations() {
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <echo/representation/appendable-representation.h>
+
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::ChunkStream;
+using echo::representation::AppendableRepresentation;
+
+TEST(AppendableRepresentationTest, StartsEmpty)
+{
+	AppendableRepresentation representation = new AppendableRepresentation();
+	EXPECT_EQ("", representation.getText());
+	EXPECT_TRUE(representation.getStream() == NULL);
+	EXPECT_TRUE(representation.isWritable());
+}
+
+TEST(AppendableRepresentationTest, KeepsInitialText)
+{
+	AppendableRepresentation representation = new AppendableRepresentation(
+			"Hello", MediaType.TEXT_HTML);
+	EXPECT_EQ("Hello", representation.getText());
+	EXPECT_EQ(5, representation.getSize());
+	EXPECT_TRUE(MediaType.TEXT_HTML.equals(representation.getMediaType()));
+	EXPECT_TRUE(representation.getStream() == NULL);
+}
+
+TEST(AppendableRepresentationTest, AppendAcrossChunks)
+{
+	AppendableRepresentation representation = new AppendableRepresentation();
+	std::string expected;
+
+	for (int i = 0; i < 5000; i++) {
+		representation.append("0123456789");
+		expected += "0123456789";
+	}
+
+	representation.append('!');
+	expected += '!';
+	EXPECT_EQ(expected, representation.getText());
+	EXPECT_EQ((long) expected.size(), representation.getSize());
+	EXPECT_EQ(expected.size(), representation.getChunks().getSize());
+}
+
+TEST(AppendableRepresentationTest, SetTextReplaces)
+{
+	AppendableRepresentation representation = new AppendableRepresentation(
+			"first");
+	representation.setText("second");
+	EXPECT_EQ("second", representation.getText());
+
+	representation.setText(NULL);
+	EXPECT_EQ("", representation.getText());
+}
+
+TEST(AppendableRepresentationTest, StreamFilledChunks)
+{
+	AppendableRepresentation representation = new AppendableRepresentation();
+	representation.append("head");
+	representation.startStreaming();
+	ChunkStream* stream = representation.getStream();
+	ASSERT_TRUE(stream != NULL);
+	EXPECT_EQ(Representation::UNKNOWN_SIZE, representation.getSize());
+
+	// Only the filled chunks are handed until the entity is finished
+	representation.append(std::string(ChunkBuffer::CHUNK_SIZE, 'a'));
+	EXPECT_EQ(ChunkBuffer::CHUNK_SIZE, stream->getSize());
+	EXPECT_EQ("aaaa", representation.getText());
+
+	representation.finish();
+	EXPECT_EQ(ChunkBuffer::CHUNK_SIZE + 4, stream->getSize());
+	EXPECT_EQ("", representation.getText());
+	stream->consume(stream->getSize());
+	EXPECT_TRUE(stream->isDone());
+}
+
+TEST(AppendableRepresentationTest, ReleaseAbortsUnfinishedStream)
+{
+	AppendableRepresentation representation = new AppendableRepresentation();
+	representation.startStreaming();
+	representation.append("partial");
+	representation.release();
+	EXPECT_TRUE(representation.getStream()->isAborted());
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <echo/engine/component/asset-client.h>
+#include <echo/engine/util/asset-pack.h>
+#include <echo/engine/util/asset-pack-writer.h>
+
+using echo::engine::component::AssetClient;
+using echo::engine::util::AssetPack;
+using echo::engine::util::AssetPackWriter;
+using echo::representation::AssetRepresentation;
+
+/**
+ * Registers the pack of the "clap" references once.
+ */
+static void registerAssets() {
+	static std::string output;
+
+	if (output.empty()) {
+		AssetPackWriter writer;
+		writer.add("/index.html", "<html></html>", "text/html", 0);
+		writer.write(output);
+		AssetPack::registerPack("", new AssetPack(output.data(),
+				output.size()));
+	}
+}
+
+static Response call(Method method, std::string uri) {
+	registerAssets();
+	AssetClient client = new AssetClient(null);
+	Response response = new Response(null);
+	client.handle(new Request(method, uri), response);
+	return response;
+}
+
+TEST(AssetClientTest, ServesAssetSlices)
+{
+	Response response = call(Method::GET, "clap://class/index.html");
+	EXPECT_EQ(Status.SUCCESS_OK, response.getStatus());
+	ASSERT_TRUE(response.getEntity() instanceof AssetRepresentation);
+	EXPECT_EQ("<html></html>", response.getEntityAsText());
+	EXPECT_EQ(MediaType.TEXT_HTML, response.getEntity().getMediaType());
+	EXPECT_TRUE(response.getEntity().getTag() != NULL);
+}
+
+TEST(AssetClientTest, AnswersNotFound)
+{
+	EXPECT_EQ(Status.CLIENT_ERROR_NOT_FOUND,
+			call(Method::GET, "clap://class/missing.html").getStatus());
+	EXPECT_EQ(Status.CLIENT_ERROR_NOT_FOUND,
+			call(Method::GET, "zip:missing!/index.html").getStatus());
+}
+
+TEST(AssetClientTest, RejectsWrites)
+{
+	Response response = call(Method::PUT, "clap://class/index.html");
+	EXPECT_EQ(Status.CLIENT_ERROR_METHOD_NOT_ALLOWED, response.getStatus());
+	EXPECT_EQ(1U, response.getAllowedMethods().count(Method::GET));
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/asset-pack.h>
+#include <echo/engine/util/asset-pack-writer.h>
+
+#include <string>
+
+using echo::engine::util::AssetPack;
+using echo::engine::util::AssetPackWriter;
+
+/**
+ * Returns the content of a slice.
+ */
+static std::string text(const AssetPack::Slice& slice)
+{
+	return std::string(slice.data, slice.length);
+}
+
+TEST(AssetPackTest, FindsWrittenAssets)
+{
+	AssetPackWriter writer;
+	writer.add("/index.html", "<html></html>", "text/html", 1000);
+	writer.add("/css/site.css", "body {}", "text/css", 2000);
+	std::string output;
+	writer.write(output);
+
+	AssetPack pack(output.data(), output.size());
+	ASSERT_TRUE(pack.isValid());
+	EXPECT_EQ(2U, pack.getCount());
+
+	AssetPack::Asset asset;
+	ASSERT_TRUE(pack.find("/css/site.css", asset));
+	EXPECT_EQ("body {}", text(asset.content));
+	EXPECT_EQ("text/css", text(asset.mediaType));
+	EXPECT_EQ(2000, asset.modified);
+	EXPECT_LT(0U, asset.tag.length);
+	ASSERT_TRUE(pack.find("/index.html", asset));
+	EXPECT_EQ("<html></html>", text(asset.content));
+	EXPECT_FALSE(pack.find("/missing.html", asset));
+}
+
+TEST(AssetPackTest, KeepsSmallerGzipVariants)
+{
+	AssetPackWriter writer;
+	writer.add("/large.txt", std::string(4096, 'a'), "text/plain", 0);
+	writer.add("/small.txt", "a", "text/plain", 0);
+	std::string output;
+	writer.write(output);
+	AssetPack pack(output.data(), output.size());
+
+	AssetPack::Asset asset;
+	ASSERT_TRUE(pack.find("/large.txt", asset));
+	EXPECT_LT(0U, asset.gzip.length);
+	EXPECT_GT(asset.content.length, asset.gzip.length);
+	ASSERT_TRUE(pack.find("/small.txt", asset));
+	EXPECT_EQ(0U, asset.gzip.length);
+}
+
+TEST(AssetPackTest, RejectsTruncatedPacks)
+{
+	AssetPackWriter writer;
+	writer.add("/index.html", "<html></html>", "text/html", 0);
+	std::string output;
+	writer.write(output);
+
+	AssetPack pack(output.data(), AssetPack::HEADER_SIZE - 1);
+	EXPECT_FALSE(pack.isValid());
+	EXPECT_EQ(0U, pack.getCount());
+}
+
+TEST(AssetPackTest, ResolvesRegisteredPacks)
+{
+	AssetPackWriter writer;
+	writer.add("/index.html", "<html></html>", "text/html", 0);
+	static std::string output;
+	writer.write(output);
+	AssetPack* pack = new AssetPack(output.data(), output.size());
+	ASSERT_TRUE(AssetPack::registerPack("test-assets", pack));
+
+	AssetPack::Asset asset;
+	ASSERT_TRUE(AssetPack::resolve("zip:test-assets!/index.html", asset));
+	EXPECT_EQ("<html></html>", text(asset.content));
+	EXPECT_FALSE(AssetPack::resolve("zip:test-assets!/other.html", asset));
+	EXPECT_FALSE(AssetPack::resolve("zip:missing-assets!/index.html",
+	                                asset));
+	EXPECT_FALSE(AssetPack::resolve("zip:test-assets", asset));
+}
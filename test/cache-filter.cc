@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <echo/engine/application/cache-filter.h>
+#include <echo/representation/source-representation.h>
+
+using echo::engine::application::CacheFilter;
+using echo::representation::SourceRepresentation;
+
+/**
+ * Echo counting the calls it handles, answering with a cacheable entity
+ * either fixed or transient.
+ */
+class CountEcho : public echo::Echo {
+ public:
+	CountEcho(bool transient, int* count) : transient(transient),
+	    count(count) {
+		echo::Echo(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		(*count)++;
+
+		if (transient) {
+			response.setEntity(new SourceRepresentation(
+					MediaType.TEXT_PLAIN, NULL));
+		} else {
+			response.setEntity(new StringRepresentation("cached",
+					MediaType.TEXT_PLAIN));
+		}
+
+		response.getCacheDirectives().add(CacheDirective::maxAge(60));
+	}
+
+ private:
+	bool transient;
+	int* count;
+};
+
+static Response get(CacheFilter filter, std::string uri) {
+	Response response = new Response(null);
+	filter.handle(new Request(Method::GET, uri), response);
+	return response;
+}
+
+TEST(CacheFilterTest, ServesFixedEntitiesFromCache)
+{
+	int count = 0;
+	CacheFilter filter = new CacheFilter(null, new CountEcho(false, &count));
+
+	for (int i = 0; i < 2; i++) {
+		EXPECT_EQ("cached",
+				get(filter, "http://localhost/fixed").getEntityAsText());
+	}
+
+	EXPECT_EQ(1, count);
+	EXPECT_LT(0U, filter.getCache()->getSize());
+}
+
+TEST(CacheFilterTest, PassesTransientEntitiesThrough)
+{
+	int count = 0;
+	CacheFilter filter = new CacheFilter(null, new CountEcho(true, &count));
+
+	// The source isn't read, the entity reaches the connector untouched
+	Response response = get(filter, "http://localhost/transient");
+	EXPECT_TRUE(response.getEntity() instanceof SourceRepresentation);
+
+	get(filter, "http://localhost/transient");
+	EXPECT_EQ(2, count);
+	EXPECT_EQ(0U, filter.getCache()->getSize());
+}
+
+TEST(CacheFilterTest, PassesLargeEntitiesThrough)
+{
+	int count = 0;
+	CacheFilter filter = new CacheFilter(null, new CountEcho(false, &count));
+	filter.setMaxEntitySize(3);
+
+	EXPECT_EQ("cached",
+			get(filter, "http://localhost/large").getEntityAsText());
+	get(filter, "http://localhost/large");
+	EXPECT_EQ(2, count);
+	EXPECT_EQ(0U, filter.getCache()->getSize());
+}
+
+/**
+ * Echo counting the calls it handles, answering with a fixed entity under
+ * given cache directives and dimensions.
+ */
+class PolicyEcho : public echo::Echo {
+ public:
+	PolicyEcho() : count(0) {
+		echo::Echo(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		count++;
+		response.setEntity(new StringRepresentation(
+				request.getClientInfo().getAcceptedLanguages().isEmpty()
+				? "any" : request.getClientInfo().getAcceptedLanguages()
+				.front().getMetadata().getName(), MediaType.TEXT_PLAIN));
+		response.setCacheDirectives(directives);
+		response.setDimensions(dimensions);
+	}
+
+	std::list<CacheDirective> directives;
+	std::set<Dimension> dimensions;
+	int count;
+};
+
+/**
+ * Sends two identical requests and returns the number of calls which
+ * reached the echo.
+ */
+static int countCalls(PolicyEcho* echo, Request request) {
+	CacheFilter filter = new CacheFilter(null, echo);
+
+	for (int i = 0; i < 2; i++) {
+		filter.handle(request, new Response(request));
+	}
+
+	return echo->count;
+}
+
+TEST(CacheFilterTest, SharedMaxAgeOverridesMaxAge)
+{
+	PolicyEcho* shared = new PolicyEcho();
+	shared->directives.push_back(CacheDirective::maxAge(0));
+	shared->directives.push_back(CacheDirective::sharedMaxAge(60));
+	EXPECT_EQ(1, countCalls(shared,
+			new Request(Method::GET, "http://localhost/a")));
+
+	PolicyEcho* expired = new PolicyEcho();
+	expired->directives.push_back(CacheDirective::maxAge(60));
+	expired->directives.push_back(CacheDirective::sharedMaxAge(0));
+	EXPECT_EQ(2, countCalls(expired,
+			new Request(Method::GET, "http://localhost/a")));
+}
+
+TEST(CacheFilterTest, NoStoreAndPrivateResponsesArentStored)
+{
+	PolicyEcho* noStore = new PolicyEcho();
+	noStore->directives.push_back(CacheDirective::maxAge(60));
+	noStore->directives.push_back(CacheDirective::noStore());
+	EXPECT_EQ(2, countCalls(noStore,
+			new Request(Method::GET, "http://localhost/a")));
+
+	PolicyEcho* privateInfo = new PolicyEcho();
+	privateInfo->directives.push_back(CacheDirective::maxAge(60));
+	privateInfo->directives.push_back(CacheDirective::privateInfo());
+	EXPECT_EQ(2, countCalls(privateInfo,
+			new Request(Method::GET, "http://localhost/a")));
+}
+
+TEST(CacheFilterTest, NoStoreAndNoCacheRequestsBypassTheCache)
+{
+	PolicyEcho* echo = new PolicyEcho();
+	echo->directives.push_back(CacheDirective::maxAge(60));
+	CacheFilter filter = new CacheFilter(null, echo);
+
+	// A "no-store" request is neither served nor stored
+	Request noStore = new Request(Method::GET, "http://localhost/a");
+	noStore.getCacheDirectives().add(CacheDirective::noStore());
+	filter.handle(noStore, new Response(noStore));
+	EXPECT_EQ(0U, filter.getCache()->getSize());
+
+	// A "no-cache" request isn't served but refreshes the stored response
+	Request noCache = new Request(Method::GET, "http://localhost/a");
+	noCache.getCacheDirectives().add(CacheDirective::noCache());
+	filter.handle(noCache, new Response(noCache));
+	filter.handle(noCache, new Response(noCache));
+	EXPECT_EQ(3, echo->count);
+	EXPECT_LT(0U, filter.getCache()->getSize());
+
+	Request request = new Request(Method::GET, "http://localhost/a");
+	filter.handle(request, new Response(request));
+	EXPECT_EQ(3, echo->count);
+}
+
+TEST(CacheFilterTest, AuthenticatedRequestsArePrivate)
+{
+	PolicyEcho* echo = new PolicyEcho();
+	echo->directives.push_back(CacheDirective::maxAge(60));
+	Request request = new Request(Method::GET, "http://localhost/a");
+	request.setChallengeResponse(new ChallengeResponse(
+			ChallengeScheme.HTTP_BASIC, "user", "pass"));
+	EXPECT_EQ(2, countCalls(echo, request));
+
+	PolicyEcho* shared = new PolicyEcho();
+	shared->directives.push_back(CacheDirective::maxAge(60));
+	shared->directives.push_back(CacheDirective::publicInfo());
+	EXPECT_EQ(1, countCalls(shared, request));
+}
+
+TEST(CacheFilterTest, StoresOneVariantPerLanguage)
+{
+	PolicyEcho* echo = new PolicyEcho();
+	echo->directives.push_back(CacheDirective::maxAge(60));
+	echo->dimensions.insert(Dimension::LANGUAGE);
+	CacheFilter filter = new CacheFilter(null, echo);
+	const char* languages[] = { "fr", "en", "fr", "en" };
+
+	for (int i = 0; i < 4; i++) {
+		Request request = new Request(Method::GET, "http://localhost/a");
+		request.getClientInfo().getAcceptedLanguages().add(
+				new Preference<Language>(Language.valueOf(languages[i])));
+		Response response = new Response(request);
+		filter.handle(request, response);
+		EXPECT_EQ(languages[i], response.getEntityAsText());
+	}
+
+	EXPECT_EQ(2, echo->count);
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <string>
+
+using echo::engine::util::ChunkBuffer;
+
+/**
+ * Returns a text spanning several chunks.
+ */
+static std::string sample(size_t size)
+{
+	std::string result;
+
+	for (size_t i = 0; i < size; i++) {
+		result += (char) ('a' + i % 26);
+	}
+
+	return result;
+}
+
+static std::string readAll(int file)
+{
+	std::string result;
+	char buffer[4096];
+	ssize_t length;
+
+	while ((length = read(file, buffer, sizeof(buffer))) > 0) {
+		result.append(buffer, length);
+	}
+
+	return result;
+}
+
+TEST(ChunkBufferTest, AppendAcrossChunks)
+{
+	const std::string text = sample(ChunkBuffer::CHUNK_SIZE * 2 + 100);
+	ChunkBuffer buffer;
+	EXPECT_FALSE(buffer.hasFullChunk());
+
+	buffer.append(text.data(), 10);
+	buffer.append(text.substr(10, text.size() - 11));
+	buffer.append(text[text.size() - 1]);
+	EXPECT_EQ(text.size(), buffer.getSize());
+	EXPECT_TRUE(buffer.hasFullChunk());
+
+	std::string result;
+	buffer.toString(result);
+	EXPECT_EQ(text, result);
+
+	struct iovec vectors[8];
+	EXPECT_EQ(3, buffer.getVectors(vectors, 8));
+	EXPECT_EQ(ChunkBuffer::CHUNK_SIZE, vectors[0].iov_len);
+	EXPECT_EQ(1, buffer.getVectors(vectors, 1));
+
+	buffer.clear();
+	EXPECT_EQ(0U, buffer.getSize());
+	EXPECT_EQ(0, buffer.getVectors(vectors, 8));
+}
+
+TEST(ChunkBufferTest, ReadAndConsume)
+{
+	const std::string text = sample(ChunkBuffer::CHUNK_SIZE + 50);
+	ChunkBuffer buffer;
+	buffer.append(text);
+
+	char head[20];
+	EXPECT_EQ(sizeof(head), buffer.read(head, sizeof(head)));
+	EXPECT_EQ(text.substr(0, sizeof(head)), std::string(head, sizeof(head)));
+
+	buffer.consume(ChunkBuffer::CHUNK_SIZE);
+	std::string result;
+	buffer.toString(result);
+	EXPECT_EQ(text.substr(sizeof(head) + ChunkBuffer::CHUNK_SIZE), result);
+}
+
+TEST(ChunkBufferTest, TransferKeepsPartialChunk)
+{
+	const std::string text = sample(ChunkBuffer::CHUNK_SIZE + 50);
+	ChunkBuffer source;
+	ChunkBuffer target;
+	source.append(text);
+
+	source.transfer(target, false);
+	EXPECT_EQ(ChunkBuffer::CHUNK_SIZE, target.getSize());
+	EXPECT_EQ(50U, source.getSize());
+
+	source.append("xyz");
+	source.transfer(target, true);
+	EXPECT_EQ(0U, source.getSize());
+
+	std::string result;
+	target.toString(result);
+	EXPECT_EQ(text + "xyz", result);
+}
+
+TEST(ChunkBufferTest, WriteWithOffset)
+{
+	const std::string text = sample(ChunkBuffer::CHUNK_SIZE + 50);
+	ChunkBuffer buffer;
+	buffer.append(text);
+
+	int files[2];
+	ASSERT_EQ(0, pipe(files));
+	EXPECT_EQ((ssize_t) text.size() - 10, buffer.write(files[1], 10));
+	close(files[1]);
+	EXPECT_EQ(text.substr(10), readAll(files[0]));
+	close(files[0]);
+}
+
+TEST(ChunkBufferTest, WriteVectorsStopsWhenFull)
+{
+	int files[2];
+	ASSERT_EQ(0, pipe(files));
+	fcntl(files[1], F_SETFL, O_NONBLOCK);
+	fcntl(files[1], F_SETPIPE_SZ, 4096);
+
+	const std::string head = "head";
+	const std::string text = sample(100000);
+	struct iovec vectors[2];
+	vectors[0].iov_base = const_cast<char*>(head.data());
+	vectors[0].iov_len = head.size();
+	vectors[1].iov_base = const_cast<char*>(text.data());
+	vectors[1].iov_len = text.size();
+
+	int index = 0;
+	const ssize_t written = ChunkBuffer::writeVectors(files[1], vectors, 2,
+			index);
+	EXPECT_LT(0, written);
+	EXPECT_EQ(1, index);
+	EXPECT_EQ(head.size() + text.size() - written, vectors[1].iov_len);
+
+	// The blocking writers see a descriptor which would block as an error
+	EXPECT_EQ(-1, ChunkBuffer::writeVectors(files[1], vectors + 1, 1));
+
+	close(files[0]);
+	close(files[1]);
+}
+
+/**
+ * Fills and empties buffers many times, checking their content.
+ */
+static void* recycle(void* failures)
+{
+	const std::string text = sample(5 * ChunkBuffer::CHUNK_SIZE + 7);
+
+	for (int i = 0; i < 200; i++) {
+		ChunkBuffer buffer;
+		buffer.append(text.data(), text.size());
+		std::string result;
+		buffer.toString(result);
+
+		if (result != text) {
+			(*static_cast<int*>(failures))++;
+		}
+	}
+
+	return NULL;
+}
+
+TEST(ChunkBufferTest, ThreadsRecycleTheirChunks)
+{
+	pthread_t threads[4];
+	int failures[4] = { 0, 0, 0, 0 };
+
+	for (int i = 0; i < 4; i++) {
+		ASSERT_EQ(0, pthread_create(&threads[i], NULL, recycle,
+				&failures[i]));
+	}
+
+	for (int i = 0; i < 4; i++) {
+		pthread_join(threads[i], NULL);
+		EXPECT_EQ(0, failures[i]);
+	}
+
+	// The pools of the exited threads went back to the process
+	int failure = 0;
+	recycle(&failure);
+	EXPECT_EQ(0, failure);
+}
+
+/**
+ * Releases a buffer filled by another thread.
+ */
+static void* clear(void* buffer)
+{
+	static_cast<ChunkBuffer*>(buffer)->clear();
+	return NULL;
+}
+
+TEST(ChunkBufferTest, ReleasesChunksOfOtherThreads)
+{
+	const std::string text = sample(200 * ChunkBuffer::CHUNK_SIZE);
+
+	for (int i = 0; i < 3; i++) {
+		ChunkBuffer buffer;
+		buffer.append(text.data(), text.size());
+		pthread_t thread;
+		ASSERT_EQ(0, pthread_create(&thread, NULL, clear, &buffer));
+		pthread_join(thread, NULL);
+		EXPECT_EQ(0U, buffer.getSize());
+
+		buffer.append(text.data(), text.size());
+		std::string result;
+		buffer.toString(result);
+		EXPECT_EQ(text, result);
+	}
+}
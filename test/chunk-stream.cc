@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/chunk-stream.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <string>
+
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::ChunkStream;
+
+/**
+ * Producer offering a given number of full chunks then closing the stream.
+ */
+struct Producer {
+	ChunkStream* stream;
+	int chunks;
+	int offered;
+	bool result;
+};
+
+static void* produce(void* argument)
+{
+	Producer* producer = static_cast<Producer*>(argument);
+	ChunkBuffer buffer;
+	producer->result = true;
+
+	for (int i = 0; i < producer->chunks; i++) {
+		buffer.append(std::string(ChunkBuffer::CHUNK_SIZE, 'a' + i % 26));
+		producer->result = producer->stream->offer(buffer, true);
+
+		if (!producer->result) {
+			return NULL;
+		}
+
+		__sync_fetch_and_add(&producer->offered, 1);
+	}
+
+	producer->stream->close();
+	return NULL;
+}
+
+/**
+ * Consumes everything queued in a stream until it is done.
+ */
+static size_t drain(ChunkStream& stream)
+{
+	size_t result = 0;
+	struct iovec vectors[4];
+
+	while (!stream.isDone() && !stream.isAborted()) {
+		if (!stream.await(1000)) {
+			break;
+		}
+
+		const int count = stream.getVectors(vectors, 4);
+		size_t size = 0;
+
+		for (int i = 0; i < count; i++) {
+			size += vectors[i].iov_len;
+		}
+
+		stream.consume(size);
+		result += size;
+	}
+
+	return result;
+}
+
+TEST(ChunkStreamTest, BlockingProducerWaitsForConsumer)
+{
+	ChunkStream stream(ChunkBuffer::CHUNK_SIZE * 2, true);
+	Producer producer = { &stream, 10, 0, false };
+	pthread_t thread;
+	pthread_create(&thread, NULL, produce, &producer);
+
+	// The producer is held back above the mark until the queue is drained
+	usleep(100000);
+	EXPECT_LE(producer.offered, 3);
+	EXPECT_FALSE(stream.isWritable());
+
+	EXPECT_EQ(10 * ChunkBuffer::CHUNK_SIZE, drain(stream));
+	pthread_join(thread, NULL);
+	EXPECT_TRUE(producer.result);
+	EXPECT_TRUE(stream.isDone());
+}
+
+TEST(ChunkStreamTest, NonBlockingProducerIsReported)
+{
+	ChunkStream stream(ChunkBuffer::CHUNK_SIZE, false);
+	ChunkBuffer buffer;
+	buffer.append(std::string(ChunkBuffer::CHUNK_SIZE, 'a'));
+	EXPECT_TRUE(stream.offer(buffer, true));
+
+	// Above the mark, the chunks are still queued
+	buffer.append(std::string(10, 'b'));
+	EXPECT_FALSE(stream.offer(buffer, true));
+	EXPECT_EQ(ChunkBuffer::CHUNK_SIZE + 10, stream.getSize());
+	EXPECT_FALSE(stream.isWritable());
+	EXPECT_FALSE(stream.isAborted());
+
+	stream.close();
+	EXPECT_FALSE(stream.isDone());
+	EXPECT_EQ(ChunkBuffer::CHUNK_SIZE + 10, drain(stream));
+	EXPECT_TRUE(stream.isDone());
+}
+
+TEST(ChunkStreamTest, AbortWakesProducer)
+{
+	ChunkStream stream(ChunkBuffer::CHUNK_SIZE, true);
+	Producer producer = { &stream, 10, 0, true };
+	pthread_t thread;
+	pthread_create(&thread, NULL, produce, &producer);
+
+	usleep(100000);
+	stream.abort();
+	pthread_join(thread, NULL);
+	EXPECT_FALSE(producer.result);
+	EXPECT_TRUE(stream.isAborted());
+	EXPECT_EQ(0U, stream.getSize());
+}
+
+/**
+ * Inflates the gzip data queued in a stream, consuming it.
+ */
+static std::string inflateQueued(ChunkStream& stream, bool end)
+{
+	std::string input;
+	struct iovec vectors[4];
+	int count;
+
+	while ((count = stream.getVectors(vectors, 4)) > 0) {
+		size_t size = 0;
+
+		for (int i = 0; i < count; i++) {
+			input.append((const char*) vectors[i].iov_base,
+					vectors[i].iov_len);
+			size += vectors[i].iov_len;
+		}
+
+		stream.consume(size);
+	}
+
+	z_stream inflater = z_stream();
+	EXPECT_EQ(Z_OK, inflateInit2(&inflater, 31));
+	inflater.next_in = (Bytef*) input.data();
+	inflater.avail_in = input.size();
+
+	std::string result;
+	char buffer[4096];
+	int status;
+
+	do {
+		inflater.next_out = (Bytef*) buffer;
+		inflater.avail_out = sizeof(buffer);
+		status = inflate(&inflater, Z_SYNC_FLUSH);
+		result.append(buffer, sizeof(buffer) - inflater.avail_out);
+	} while ((status == Z_OK) && (inflater.avail_in > 0));
+
+	EXPECT_EQ(end ? Z_STREAM_END : Z_OK, status);
+	inflateEnd(&inflater);
+	return result;
+}
+
+TEST(ChunkStreamTest, CompressOfferedChunks)
+{
+	ChunkStream stream;
+	ChunkBuffer buffer;
+	std::string text;
+
+	for (int i = 0; i < 2000; i++) {
+		text += "The quick brown fox jumps over the lazy dog. ";
+	}
+
+	// The chunks queued before are compressed as well
+	buffer.append(text.substr(0, 1000));
+	EXPECT_TRUE(stream.offer(buffer, true));
+	ASSERT_TRUE(stream.deflate(true, 6));
+
+	buffer.append(text.substr(1000));
+	EXPECT_TRUE(stream.offer(buffer, false));
+	EXPECT_TRUE(stream.offer(buffer, true));
+	EXPECT_LT(stream.getSize(), text.size());
+
+	// Flushed chunks decode before the stream is closed
+	ChunkStream partial;
+	buffer.append(text.substr(0, 500));
+	ASSERT_TRUE(partial.deflate(true, 6));
+	EXPECT_TRUE(partial.offer(buffer, true));
+	EXPECT_EQ(text.substr(0, 500), inflateQueued(partial, false));
+	partial.abort();
+
+	stream.close();
+	EXPECT_EQ(text, inflateQueued(stream, true));
+	EXPECT_FALSE(stream.deflate(true, 6));
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <echo/engine/application/coalescing-filter.h>
+#include <echo/representation/source-representation.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+using echo::engine::application::CoalescingFilter;
+using echo::representation::SourceRepresentation;
+
+/**
+ * Echo counting the calls it handles, holding each of them long enough for
+ * the concurrent requests to arrive. A failing echo throws from its first
+ * call.
+ */
+class SlowEcho : public echo::Echo {
+ public:
+	SlowEcho(bool transient, bool failing, int* count)
+	    : transient(transient), failing(failing), count(count) {
+		echo::Echo(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		const int call = __sync_fetch_and_add(count, 1);
+		usleep(200000);
+
+		if (failing && (call == 0)) {
+			throw std::runtime_error("First call failed");
+		}
+
+		if (transient) {
+			response.setEntity(new SourceRepresentation(
+					MediaType.TEXT_PLAIN, NULL));
+		} else {
+			response.setEntity(new StringRepresentation("shared",
+					MediaType.TEXT_PLAIN));
+		}
+	}
+
+ private:
+	bool transient;
+	bool failing;
+	int* count;
+};
+
+/**
+ * Request handled by one of the concurrent threads.
+ */
+struct Call {
+	CoalescingFilter* filter;
+	bool cookie;
+	bool failed;
+	Response response;
+};
+
+static void* handle(void* argument) {
+	Call* call = static_cast<Call*>(argument);
+	Request request = new Request(Method::GET, "http://localhost/resource");
+
+	if (call->cookie) {
+		request.getCookies().add(new Cookie("session", "1234"));
+	}
+
+	call->response = new Response(request);
+	call->failed = false;
+
+	try {
+		call->filter->handle(request, call->response);
+	} catch (const std::runtime_error&) {
+		call->failed = true;
+	}
+
+	return NULL;
+}
+
+static int run(bool transient, bool cookie, bool failing, int timeout) {
+	int count = 0;
+	int failures = 0;
+	CoalescingFilter filter = new CoalescingFilter(null,
+			new SlowEcho(transient, failing, &count));
+	filter.setTimeout(timeout);
+	Call calls[4];
+	pthread_t threads[4];
+
+	for (int i = 0; i < 4; i++) {
+		calls[i].filter = &filter;
+		calls[i].cookie = cookie;
+		pthread_create(&threads[i], NULL, handle, &calls[i]);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		pthread_join(threads[i], NULL);
+
+		if (calls[i].failed) {
+			failures++;
+		} else if (!transient) {
+			EXPECT_EQ("shared", calls[i].response.getEntityAsText());
+		}
+	}
+
+	EXPECT_EQ(failing ? 1 : 0, failures);
+	return count;
+}
+
+static int run(bool transient, bool cookie) {
+	return run(transient, cookie, false, CoalescingFilter::DEFAULT_TIMEOUT);
+}
+
+TEST(CoalescingFilterTest, CoalescesConcurrentRequests)
+{
+	EXPECT_EQ(1, run(false, false));
+}
+
+TEST(CoalescingFilterTest, DoesntCoalesceRequestsWithCookies)
+{
+	EXPECT_EQ(4, run(false, true));
+}
+
+TEST(CoalescingFilterTest, DoesntShareTransientEntities)
+{
+	// The waiters invoke the next Echo themselves
+	EXPECT_EQ(4, run(true, false));
+}
+
+TEST(CoalescingFilterTest, WaitersPastTheTimeoutCallTheNextEcho)
+{
+	// The first call outlasts the timeout of the waiters
+	EXPECT_EQ(4, run(false, false, false, 50));
+}
+
+TEST(CoalescingFilterTest, WaitersFallBackWhenTheFirstCallThrows)
+{
+	// Only the first request fails, the waiters are handled again
+	EXPECT_EQ(4, run(false, false, true, CoalescingFilter::DEFAULT_TIMEOUT));
+}
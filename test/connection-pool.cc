@@ -0,0 +1,296 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/client-connection.h>
+#include <echo/engine/http/client-exchange.h>
+#include <echo/engine/http/connection-pool.h>
+#include <echo/engine/http/host-resolver.h>
+#include <echo/engine/io/event-loop.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+using echo::engine::http::ClientConnection;
+using echo::engine::http::ClientExchange;
+using echo::engine::http::ConnectionPool;
+using echo::engine::http::HostResolver;
+using echo::engine::io::EventLoop;
+
+/**
+ * Loopback server reading a given number of requests on each connection it
+ * accepts, then answering them in order or dropping the connection.
+ */
+class LoopbackServer {
+ public:
+	LoopbackServer() : port(0) {
+		struct sockaddr_in address;
+		socklen_t length = sizeof(address);
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		file = socket(AF_INET, SOCK_STREAM, 0);
+
+		// A missing connection fails the test instead of blocking it
+		struct timeval timeout = { 5, 0 };
+		setsockopt(file, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		bind(file, (struct sockaddr*) &address, sizeof(address));
+		listen(file, 16);
+		getsockname(file, (struct sockaddr*) &address, &length);
+		port = ntohs(address.sin_port);
+	}
+
+	~LoopbackServer() {
+		close(file);
+	}
+
+	void expect(int requests, bool answer) {
+		this->requests.push_back(requests);
+		this->answers.push_back(answer);
+	}
+
+	void start() {
+		targets.resize(requests.size());
+		pthread_create(&thread, NULL, run, this);
+	}
+
+	void join() {
+		pthread_join(thread, NULL);
+	}
+
+	int port;
+	std::vector<std::vector<std::string> > targets;
+
+ private:
+	static void* run(void* server) {
+		static_cast<LoopbackServer*>(server)->serve();
+		return NULL;
+	}
+
+	void serve() {
+		std::vector<int> accepted;
+
+		for (size_t i = 0; i < requests.size(); i++) {
+			const int connection = accept(file, NULL, NULL);
+
+			if (connection == -1) {
+				break;
+			}
+
+			// Same for a missing request
+			struct timeval timeout = { 2, 0 };
+			setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+					sizeof(timeout));
+			accepted.push_back(connection);
+			std::string input;
+			size_t end = 0;
+			char buffer[4096];
+			ssize_t count;
+
+			while ((int) targets[i].size() < requests[i]) {
+				const size_t next = input.find("\r\n\r\n", end);
+
+				if (next != std::string::npos) {
+					const size_t start = input.find(' ', end) + 1;
+					targets[i].push_back(input.substr(start,
+							input.find(' ', start) - start));
+					end = next + 4;
+				} else if ((count = read(connection, buffer,
+						sizeof(buffer))) > 0) {
+					input.append(buffer, count);
+				} else {
+					break;
+				}
+			}
+
+			if (!answers[i]) {
+				close(connection);
+				accepted.back() = -1;
+				continue;
+			}
+
+			for (size_t j = 0; j < targets[i].size(); j++) {
+				const std::string response = "HTTP/1.1 200 OK\r\n"
+						"Content-Length: 0\r\nX-Target: " + targets[i][j]
+						+ "\r\n\r\n";
+				write(connection, response.data(), response.size());
+			}
+		}
+
+		for (size_t i = 0; i < accepted.size(); i++) {
+			if (accepted[i] != -1) {
+				close(accepted[i]);
+			}
+		}
+	}
+
+	int file;
+	pthread_t thread;
+	std::vector<int> requests;
+	std::vector<bool> answers;
+};
+
+/**
+ * Task submitting an exchange to a pool on the loop thread.
+ */
+class Submission : public EventLoop::Task {
+ public:
+	Submission(ConnectionPool* pool, const ClientConnection::Exchange& exchange)
+	    : pool(pool), exchange(exchange) {
+	}
+
+	void run() {
+		pool->submit(exchange);
+	}
+
+ private:
+	ConnectionPool* pool;
+	ClientConnection::Exchange exchange;
+};
+
+/**
+ * Client loop running on its own thread, with a pool to the loopback
+ * server.
+ */
+class Client {
+ public:
+	Client(int port, int maxConnections) : resolver(1, 60000, 5000),
+	    pool(loop, resolver, "127.0.0.1", port, maxConnections, 5000, 5000) {
+		pthread_create(&thread, NULL, run, this);
+	}
+
+	~Client() {
+		loop.stop();
+		pthread_join(thread, NULL);
+	}
+
+	ClientConnection::Exchange submit(const std::string& method,
+			const std::string& target) {
+		std::string message = method + " " + target
+				+ " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+		const ClientConnection::Exchange result(new ClientExchange(message,
+				method == "GET", false));
+		loop.post(new Submission(&pool, result));
+		return result;
+	}
+
+ private:
+	static void* run(void* client) {
+		static_cast<Client*>(client)->loop.run();
+		return NULL;
+	}
+
+	EventLoop loop;
+	HostResolver resolver;
+	ConnectionPool pool;
+	pthread_t thread;
+};
+
+/**
+ * Returns the target echoed by the server for an exchange.
+ */
+static std::string getTarget(const ClientConnection::Exchange& exchange)
+{
+	const ClientExchange::Headers& headers = exchange->getHeaders();
+
+	for (size_t i = 0; i < headers.size(); i++) {
+		if (headers[i].first == "X-Target") {
+			return headers[i].second;
+		}
+	}
+
+	return std::string();
+}
+
+TEST(ConnectionPoolTest, PipelineOnTheLeastLoadedConnection)
+{
+	LoopbackServer server;
+	server.expect(2, true);
+	server.expect(2, true);
+	server.start();
+
+	// Beyond two connections, the requests are spread between them
+	std::vector<ClientConnection::Exchange> exchanges;
+	{
+		Client client(server.port, 2);
+		exchanges.push_back(client.submit("GET", "/a"));
+		exchanges.push_back(client.submit("GET", "/b"));
+		exchanges.push_back(client.submit("GET", "/c"));
+		exchanges.push_back(client.submit("GET", "/d"));
+
+		for (size_t i = 0; i < exchanges.size(); i++) {
+			ASSERT_TRUE(exchanges[i]->await(5000));
+		}
+	}
+	server.join();
+
+	// Each response matches its request, whatever its connection
+	EXPECT_EQ("/a", getTarget(exchanges[0]));
+	EXPECT_EQ("/b", getTarget(exchanges[1]));
+	EXPECT_EQ("/c", getTarget(exchanges[2]));
+	EXPECT_EQ("/d", getTarget(exchanges[3]));
+	ASSERT_EQ(2U, server.targets[0].size());
+	ASSERT_EQ(2U, server.targets[1].size());
+	EXPECT_EQ(1, exchanges[2]->getAttempts());
+	EXPECT_EQ(1, exchanges[3]->getAttempts());
+}
+
+TEST(ConnectionPoolTest, RetryIdempotentRequestsOnce)
+{
+	LoopbackServer server;
+	server.expect(1, false);
+	server.expect(1, true);
+	server.start();
+
+	// The dropped request succeeds on another connection
+	{
+		Client client(server.port, 1);
+		const ClientConnection::Exchange exchange = client.submit("GET",
+				"/retried");
+		ASSERT_TRUE(exchange->await(5000));
+		EXPECT_EQ(2, exchange->getAttempts());
+		EXPECT_EQ("/retried", getTarget(exchange));
+	}
+	server.join();
+}
+
+TEST(ConnectionPoolTest, FailRequestsDroppedTwice)
+{
+	LoopbackServer server;
+	server.expect(1, false);
+	server.expect(1, false);
+	server.start();
+
+	{
+		Client client(server.port, 1);
+		const ClientConnection::Exchange exchange = client.submit("GET",
+				"/failed");
+		EXPECT_FALSE(exchange->await(5000));
+		EXPECT_EQ(2, exchange->getAttempts());
+		EXPECT_NE(0, exchange->getError());
+	}
+	server.join();
+}
+
+TEST(ConnectionPoolTest, FailDroppedNonIdempotentRequests)
+{
+	LoopbackServer server;
+	server.expect(1, false);
+	server.start();
+
+	{
+		Client client(server.port, 1);
+		const ClientConnection::Exchange exchange = client.submit("POST",
+				"/posted");
+		EXPECT_FALSE(exchange->await(5000));
+		EXPECT_EQ(1, exchange->getAttempts());
+		EXPECT_NE(0, exchange->getError());
+	}
+	server.join();
+	EXPECT_EQ("/posted", server.targets[0][0]);
+}
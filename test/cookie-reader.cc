@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/cookie-reader.h>
+
+using echo::engine::util::CookieReader;
+
+TEST(CookieReaderTest, FindSingleCookie)
+{
+	const std::string header("a=1; session=\"abc\" ;b=2");
+	const char* value;
+	size_t length;
+
+	ASSERT_TRUE(CookieReader::find(header, "session", value, length));
+	EXPECT_EQ("abc", std::string(value, length));
+	EXPECT_FALSE(CookieReader::find(header, "sess", value, length));
+	EXPECT_EQ("2", CookieReader::getFirstValue(header, "b"));
+	EXPECT_EQ(null, CookieReader::getFirstValue(header, "c"));
+}
+
+TEST(CookieReaderTest, ReadViewsInOrder)
+{
+	const std::string header("a=1;;b=;c=3");
+	CookieReader reader(header);
+	const char* name;
+	const char* value;
+	size_t nameLength;
+	size_t valueLength;
+
+	ASSERT_TRUE(reader.readNext(name, nameLength, value, valueLength));
+	EXPECT_EQ("a", std::string(name, nameLength));
+	EXPECT_EQ("1", std::string(value, valueLength));
+	ASSERT_TRUE(reader.readNext(name, nameLength, value, valueLength));
+	EXPECT_EQ("b", std::string(name, nameLength));
+	EXPECT_EQ(0u, valueLength);
+	ASSERT_TRUE(reader.readNext(name, nameLength, value, valueLength));
+	EXPECT_EQ("c", std::string(name, nameLength));
+	EXPECT_FALSE(reader.readNext(name, nameLength, value, valueLength));
+}
+
+TEST(CookieReaderTest, ApplyVersionOneAttributes)
+{
+	const std::string header("$Version=1; a=1; $Path=/p; $Domain=.x.org");
+	CookieReader reader(header);
+	Cookie cookie = reader.readNextCookie();
+
+	EXPECT_EQ(1, cookie.getVersion());
+	EXPECT_EQ("a", cookie.getName());
+	EXPECT_EQ("/p", cookie.getPath());
+	EXPECT_EQ(".x.org", cookie.getDomain());
+	EXPECT_EQ(null, reader.readNextCookie());
+}
+
+TEST(CookieReaderTest, RequestCookiesFromRawHeader)
+{
+	Request request = new Request(Method::GET, "http://localhost/");
+	request.setCookieHeader("a=1; b=2");
+	EXPECT_EQ("2", request.getCookieValue("b"));
+	EXPECT_EQ(2, request.getCookies().size());
+}
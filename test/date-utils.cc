@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/date-utils.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <string>
+
+using echo::engine::util::DateUtils;
+
+TEST(DateUtilsTest, Format)
+{
+	char result[32];
+	DateUtils::format(784111777, result);
+	EXPECT_EQ("Sun, 06 Nov 1994 08:49:37 GMT",
+			std::string(result, DateUtils::LENGTH));
+
+	DateUtils::format(0, result);
+	EXPECT_EQ("Thu, 01 Jan 1970 00:00:00 GMT",
+			std::string(result, DateUtils::LENGTH));
+
+	// Leap day
+	DateUtils::format(951782400, result);
+	EXPECT_EQ("Tue, 29 Feb 2000 00:00:00 GMT",
+			std::string(result, DateUtils::LENGTH));
+}
+
+TEST(DateUtilsTest, FormatMatchesGmtime)
+{
+	for (time_t seconds = 0; seconds < 4102444800LL; seconds += 86399 * 37) {
+		char expected[32];
+		struct tm fields;
+		gmtime_r(&seconds, &fields);
+		strftime(expected, sizeof(expected), "%a, %d %b %Y %H:%M:%S GMT",
+				&fields);
+
+		char result[32];
+		DateUtils::format(seconds, result);
+		ASSERT_EQ(std::string(expected),
+				std::string(result, DateUtils::LENGTH));
+	}
+}
+
+TEST(DateUtilsTest, Append)
+{
+	std::string buffer("Date: ");
+	DateUtils::append(buffer, 784111777);
+	EXPECT_EQ("Date: Sun, 06 Nov 1994 08:49:37 GMT", buffer);
+
+	buffer.clear();
+	DateUtils::appendNow(buffer);
+	EXPECT_EQ(DateUtils::LENGTH, buffer.size());
+
+	time_t seconds;
+	ASSERT_TRUE(DateUtils::parse(buffer, seconds));
+	EXPECT_LE(labs((long) (seconds - time(NULL))), 2);
+}
+
+TEST(DateUtilsTest, ParseLayouts)
+{
+	time_t seconds = 0;
+	EXPECT_TRUE(DateUtils::parse("Sun, 06 Nov 1994 08:49:37 GMT", seconds));
+	EXPECT_EQ(784111777, seconds);
+
+	seconds = 0;
+	EXPECT_TRUE(DateUtils::parse("Sunday, 06-Nov-94 08:49:37 GMT", seconds));
+	EXPECT_EQ(784111777, seconds);
+
+	seconds = 0;
+	EXPECT_TRUE(DateUtils::parse("Sun Nov  6 08:49:37 1994", seconds));
+	EXPECT_EQ(784111777, seconds);
+}
+
+TEST(DateUtilsTest, ParseRepeatedValue)
+{
+	// The second parse is answered by the cache
+	for (int i = 0; i < 3; i++) {
+		time_t seconds = 0;
+		EXPECT_TRUE(DateUtils::parse("Tue, 29 Feb 2000 00:00:00 GMT",
+				seconds));
+		EXPECT_EQ(951782400, seconds);
+	}
+}
+
+TEST(DateUtilsTest, ParseInvalid)
+{
+	time_t seconds = 0;
+	EXPECT_FALSE(DateUtils::parse("", seconds));
+	EXPECT_FALSE(DateUtils::parse("yesterday", seconds));
+	EXPECT_FALSE(DateUtils::parse("Sun, 06 Nov 1994 08:49:37 PST", seconds));
+	EXPECT_FALSE(DateUtils::parse("Sun, 32 Nov 1994 08:49:37 GMT", seconds));
+	EXPECT_FALSE(DateUtils::parse("Sun, 06 Foo 1994 08:49:37 GMT", seconds));
+	EXPECT_FALSE(DateUtils::parse("Sun, 06 Nov 1994 25:49:37 GMT", seconds));
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/deflater.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <string>
+
+using echo::engine::util::Deflater;
+
+/**
+ * Inflates a gzip or deflate buffer.
+ */
+static std::string inflate(bool gzip, const std::string& input)
+{
+	z_stream stream = z_stream();
+	EXPECT_EQ(Z_OK, inflateInit2(&stream, gzip ? 31 : 15));
+	stream.next_in = (Bytef*) input.data();
+	stream.avail_in = input.size();
+
+	std::string result;
+	char buffer[4096];
+	int status;
+
+	do {
+		stream.next_out = (Bytef*) buffer;
+		stream.avail_out = sizeof(buffer);
+		status = ::inflate(&stream, Z_NO_FLUSH);
+		result.append(buffer, sizeof(buffer) - stream.avail_out);
+	} while (status == Z_OK);
+
+	EXPECT_EQ(Z_STREAM_END, status);
+	inflateEnd(&stream);
+	return result;
+}
+
+static std::string sample()
+{
+	std::string result;
+
+	for (int i = 0; i < 1000; i++) {
+		result += "The quick brown fox jumps over the lazy dog. ";
+	}
+
+	return result;
+}
+
+TEST(DeflaterTest, EncodeGzip)
+{
+	const std::string content = sample();
+	std::string output;
+	ASSERT_TRUE(Deflater::encode(true, Deflater::DEFAULT_LEVEL,
+			content.data(), content.size(), output));
+	ASSERT_LT(output.size(), content.size());
+	EXPECT_EQ('\x1f', output[0]);
+	EXPECT_EQ('\x8b', output[1]);
+	EXPECT_EQ(content, inflate(true, output));
+}
+
+TEST(DeflaterTest, EncodeDeflate)
+{
+	const std::string content = sample();
+	std::string output;
+	ASSERT_TRUE(Deflater::encode(false, 9, content.data(), content.size(),
+			output));
+	EXPECT_EQ(content, inflate(false, output));
+}
+
+TEST(DeflaterTest, ReuseStreamOfThread)
+{
+	Deflater& first = Deflater::getCurrent(true);
+	EXPECT_EQ(&first, &Deflater::getCurrent(true));
+	EXPECT_NE(&first, &Deflater::getCurrent(false));
+
+	// Each entity starts from a reset stream
+	for (int i = 0; i < 3; i++) {
+		const std::string content = sample().substr(i * 100);
+		std::string output;
+		ASSERT_TRUE(Deflater::encode(true, 1 + i * 4, content.data(),
+				content.size(), output));
+		EXPECT_EQ(content, inflate(true, output));
+	}
+}
+
+TEST(DeflaterTest, UpdateByChunks)
+{
+	const std::string content = sample();
+	Deflater deflater(true);
+	std::string output;
+	ASSERT_TRUE(deflater.reset(Deflater::DEFAULT_LEVEL));
+
+	for (size_t offset = 0; offset < content.size(); offset += 1000) {
+		const size_t length = std::min((size_t) 1000,
+				content.size() - offset);
+		ASSERT_TRUE(deflater.update(content.data() + offset, length,
+				offset + length == content.size(), output));
+	}
+
+	EXPECT_EQ(content, inflate(true, output));
+}
+
+TEST(DeflaterTest, PoolStreamsOfThread)
+{
+	Deflater* first = Deflater::acquire(true, Deflater::DEFAULT_LEVEL);
+	Deflater* second = Deflater::acquire(true, 1);
+	ASSERT_TRUE(first != NULL);
+	ASSERT_TRUE(second != NULL);
+	EXPECT_NE(first, second);
+
+	// A stream given back is reset for the next entity
+	Deflater::release(first);
+	Deflater* third = Deflater::acquire(true, 9);
+	EXPECT_EQ(first, third);
+
+	const std::string content = sample();
+	std::string output;
+	ASSERT_TRUE(third->update(content.data(), content.size(), true, output));
+	EXPECT_EQ(content, inflate(true, output));
+	Deflater::release(second);
+	Deflater::release(third);
+}
+
+TEST(DeflaterTest, FlushDecodableData)
+{
+	const std::string content = sample();
+	Deflater deflater(false);
+	std::string output;
+	ASSERT_TRUE(deflater.reset(Deflater::DEFAULT_LEVEL));
+	ASSERT_TRUE(deflater.update(content.data(), 100, false, output));
+	ASSERT_TRUE(deflater.flush(output));
+
+	// The flushed data decodes to the chunk without the end of the stream
+	z_stream stream = z_stream();
+	ASSERT_EQ(Z_OK, inflateInit(&stream));
+	char buffer[200];
+	stream.next_in = (Bytef*) output.data();
+	stream.avail_in = output.size();
+	stream.next_out = (Bytef*) buffer;
+	stream.avail_out = sizeof(buffer);
+	EXPECT_EQ(Z_OK, ::inflate(&stream, Z_SYNC_FLUSH));
+	EXPECT_EQ(content.substr(0, 100),
+			std::string(buffer, sizeof(buffer) - stream.avail_out));
+	inflateEnd(&stream);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <echo/engine/application/encoder.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/push-source.h>
+#include <echo/representation/shared-representation.h>
+#include <echo/representation/source-representation.h>
+
+using echo::engine::application::Encoder;
+using echo::engine::io::EventLoop;
+using echo::engine::io::PushSource;
+using echo::engine::io::ReadableSource;
+using echo::representation::SharedRepresentation;
+using echo::representation::SourceRepresentation;
+
+/**
+ * Echo answering with a given status and entity.
+ */
+class EntityEcho : public echo::Echo {
+ public:
+	EntityEcho(int status, Representation entity) : status(status),
+	    entity(entity) {
+		echo::Echo(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		response.setStatus(new Status(status));
+		response.setEntity(entity);
+	}
+
+ private:
+	int status;
+	Representation entity;
+};
+
+static std::string text()
+{
+	std::string result;
+
+	for (int i = 0; i < 200; i++) {
+		result += "The quick brown fox jumps over the lazy dog. ";
+	}
+
+	return result;
+}
+
+static Response handle(Encoder encoder)
+{
+	Request request = new Request(Method::GET, "http://localhost/");
+	request.getClientInfo().getAcceptedEncodings().push_back(
+			new Preference<Encoding>(Encoding::GZIP));
+	Response response = new Response(request);
+	encoder.handle(request, response);
+	return response;
+}
+
+static Response run(int status, Representation entity)
+{
+	return handle(new Encoder(null, new EntityEcho(status, entity)));
+}
+
+TEST(EncoderTest, EncodesText)
+{
+	Response response = run(200, new StringRepresentation(text(),
+			MediaType.TEXT_PLAIN));
+	ASSERT_EQ(1U, response.getEntity().getEncodings().size());
+	EXPECT_TRUE(Encoding::GZIP.equals(
+			response.getEntity().getEncodings().front()));
+	EXPECT_LT(response.getEntity().getSize(), (long long) text().size());
+	EXPECT_TRUE(response.getDimensions().contains(ENCODING));
+}
+
+TEST(EncoderTest, LeavesPartialContent)
+{
+	Representation entity = new StringRepresentation(text(),
+			MediaType.TEXT_PLAIN);
+	Response response = run(206, entity);
+	EXPECT_TRUE(response.getEntity() == entity);
+	EXPECT_TRUE(response.getEntity().getEncodings().isEmpty());
+}
+
+TEST(EncoderTest, LeavesOctetStream)
+{
+	Representation entity = new StringRepresentation(text(),
+			MediaType.APPLICATION_OCTET_STREAM);
+	Response response = run(200, entity);
+	EXPECT_TRUE(response.getEntity() == entity);
+	EXPECT_FALSE(response.getDimensions().contains(ENCODING));
+}
+
+TEST(EncoderTest, EncodesSourcesWhileStreaming)
+{
+	EventLoop loop;
+	PushSource source(loop);
+	const std::string content = "Streamed content";
+	source.offer(content.data(), content.size());
+	source.end();
+
+	// The content is compressed as read, however small it is
+	Response response = run(200, new SourceRepresentation(MediaType.TEXT_PLAIN,
+			&source));
+	ASSERT_TRUE(response.getEntity() instanceof SourceRepresentation);
+	ASSERT_EQ(1U, response.getEntity().getEncodings().size());
+	EXPECT_TRUE(Encoding::GZIP.equals(
+			response.getEntity().getEncodings().front()));
+	ReadableSource* encoded =
+			((SourceRepresentation) response.getEntity()).getSource();
+	std::string result;
+	char buffer[4096];
+	ssize_t count;
+
+	while ((count = encoded->read(buffer, sizeof(buffer))) > 0) {
+		result.append(buffer, count);
+	}
+
+	EXPECT_EQ(0, count);
+	ASSERT_LT(2U, result.size());
+	EXPECT_EQ('\x1f', result[0]);
+	EXPECT_EQ('\x8b', result[1]);
+	response.getEntity().release();
+}
+
+TEST(EncoderTest, SharesCachedBodies)
+{
+	Representation entity = new StringRepresentation(text(),
+			MediaType.TEXT_PLAIN);
+	entity.setTag(new Tag("v1", false));
+	Encoder encoder = new Encoder(null, new EntityEcho(200, entity));
+
+	// The second response references the body encoded for the first one
+	Response first = handle(encoder);
+	Response second = handle(encoder);
+	ASSERT_TRUE(first.getEntity() instanceof SharedRepresentation);
+	ASSERT_TRUE(second.getEntity() instanceof SharedRepresentation);
+	EXPECT_EQ(&((SharedRepresentation) first.getEntity()).getContent(),
+			&((SharedRepresentation) second.getEntity()).getContent());
+	EXPECT_EQ("v1-gzip", second.getEntity().getTag().getName());
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <echo/engine/io/event-loop.h>
+
+#include <pthread.h>
+
+using echo::engine::io::EventLoop;
+
+/**
+ * Task recording the loop of the thread running it, then stopping the loop.
+ */
+class CurrentTask : public EventLoop::Task {
+ public:
+	CurrentTask(EventLoop* loop, EventLoop** current) : loop(loop),
+	    current(current) {
+	}
+
+	void run() {
+		*current = EventLoop::getCurrent();
+		loop->stop();
+	}
+
+ private:
+	EventLoop* loop;
+	EventLoop** current;
+};
+
+static void* run(void* loop)
+{
+	static_cast<EventLoop*>(loop)->run();
+	return NULL;
+}
+
+TEST(EventLoopTest, CurrentLoop)
+{
+	EventLoop loop;
+	EventLoop* current = NULL;
+	EXPECT_TRUE(EventLoop::getCurrent() == NULL);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, run, &loop);
+	loop.post(new CurrentTask(&loop, &current));
+	pthread_join(thread, NULL);
+
+	EXPECT_EQ(&loop, current);
+	EXPECT_TRUE(EventLoop::getCurrent() == NULL);
+}
+
+TEST(EventLoopTest, CurrentLoopIsRestored)
+{
+	EventLoop loop;
+	EventLoop* current = NULL;
+	loop.post(new CurrentTask(&loop, &current));
+	loop.run();
+
+	EXPECT_EQ(&loop, current);
+	EXPECT_TRUE(EventLoop::getCurrent() == NULL);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/io-engine.h>
+#include <echo/engine/io/readable-source.h>
+#include <echo/representation/file-representation.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <string>
+
+using echo::engine::io::EventLoop;
+using echo::engine::io::IoEngine;
+using echo::engine::io::ReadableSource;
+using echo::representation::FileRepresentation;
+
+/**
+ * Listener reading everything a source delivers, stopping the loop at the
+ * end of the source.
+ */
+class ReadListener : public ReadableSource::Listener {
+ public:
+	ReadListener(EventLoop* loop) : loop(loop) {
+	}
+
+	void onReadable(ReadableSource* source) {
+		char buffer[4096];
+		ssize_t length;
+
+		while ((length = source->read(buffer, sizeof(buffer))) > 0) {
+			text.append(buffer, length);
+		}
+
+		if ((length == 0) || (errno != EAGAIN)) {
+			source->suspend();
+			loop->stop();
+		}
+	}
+
+	EventLoop* loop;
+	std::string text;
+};
+
+TEST(FileRepresentationTest, SourceReadsFile)
+{
+	char path[] = "/tmp/echo-file-representation-XXXXXX";
+	const int file = mkstemp(path);
+	std::string text;
+
+	for (int i = 0; i < 10000; i++) {
+		text += "0123456789abcdef";
+	}
+
+	ASSERT_EQ((ssize_t) text.size(), write(file, text.data(), text.size()));
+	close(file);
+
+	FileRepresentation representation = new FileRepresentation(path,
+			MediaType.TEXT_PLAIN);
+	EXPECT_EQ((long) text.size(), representation.getSize());
+
+	EventLoop loop;
+	IoEngine* engine = IoEngine::create(loop, "auto");
+	ReadableSource* source = representation.getSource(*engine);
+	ReadListener listener(&loop);
+	source->resume(&listener);
+	loop.run();
+
+	EXPECT_EQ(text, listener.text);
+	source->close();
+	delete source;
+	delete engine;
+	unlink(path);
+}
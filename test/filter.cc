@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <echo/routing/filter.h>
+
+#include <string>
+
+using echo::routing::Filter;
+
+/**
+ * Filter tracing its callbacks, returning a given status before handling.
+ */
+class TraceFilter : public Filter {
+ public:
+	TraceFilter(std::string name, int status, std::string* trace)
+	    : name(name), status(status), trace(trace) {
+		Filter(null);
+	}
+
+	int beforeHandle(echo::Request request, echo::Response response) {
+		*trace += "<" + name;
+		return status;
+	}
+
+	void afterHandle(echo::Request request, echo::Response response) {
+		*trace += name + ">";
+	}
+
+ private:
+	std::string name;
+	int status;
+	std::string* trace;
+};
+
+/**
+ * Echo tracing the calls it handles.
+ */
+class TraceEcho : public echo::Echo {
+ public:
+	TraceEcho(std::string* trace) : trace(trace) {
+		echo::Echo(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		*trace += "*";
+	}
+
+ private:
+	std::string* trace;
+};
+
+static std::string run(bool pipelined, int middleStatus) {
+	std::string trace;
+	TraceFilter first = new TraceFilter("a", Filter::CONTINUE, &trace);
+	TraceFilter middle = new TraceFilter("b", middleStatus, &trace);
+	TraceFilter last = new TraceFilter("c", Filter::CONTINUE, &trace);
+	first.setNext(middle);
+	middle.setNext(last);
+	last.setNext(new TraceEcho(&trace));
+	first.setPipelined(pipelined);
+	first.start();
+	first.handle(new Request(Method::GET, "http://localhost/"),
+	             new Response(null));
+	first.stop();
+	return trace;
+}
+
+TEST(FilterTest, PipelineRunsCallbacksInChainOrder)
+{
+	EXPECT_EQ("<a<b<c*c>b>a>", run(true, Filter::CONTINUE));
+	EXPECT_EQ(run(false, Filter::CONTINUE), run(true, Filter::CONTINUE));
+}
+
+TEST(FilterTest, PipelineSkipsLikeRecursion)
+{
+	EXPECT_EQ("<a<bb>a>", run(true, Filter::SKIP));
+	EXPECT_EQ(run(false, Filter::SKIP), run(true, Filter::SKIP));
+}
+
+TEST(FilterTest, PipelineStopsLikeRecursion)
+{
+	EXPECT_EQ(run(false, Filter::STOP), run(true, Filter::STOP));
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/form-reader.h>
+
+#include <stdexcept>
+
+using echo::engine::util::FormReader;
+
+TEST(FormReaderTest, DecodeInPlace)
+{
+	char data[] = "a+b%20c%3D";
+	const size_t length = FormReader::decode(data, sizeof(data) - 1);
+	EXPECT_EQ("a b c=", std::string(data, length));
+}
+
+TEST(FormReaderTest, ReadParametersWithDefaultLimits)
+{
+	FormReader reader(new StringRepresentation("a=1&&b=x%2By&c"));
+	Form form = new Form();
+	reader.addParameters(form);
+	EXPECT_EQ(3, reader.getCount());
+	EXPECT_EQ("1", form.getFirstValue("a"));
+	EXPECT_EQ("x+y", form.getFirstValue("b"));
+	EXPECT_EQ(null, form.getFirstValue("c"));
+}
+
+TEST(FormReaderTest, ReadParameterSpanningChunks)
+{
+	const std::string value(FormReader::BUFFER_SIZE * 2, 'v');
+	FormReader reader(new StringRepresentation("a=" + value + "&b=2"));
+	Form form = new Form();
+	reader.addParameters(form);
+	EXPECT_EQ(value, form.getFirstValue("a"));
+	EXPECT_EQ("2", form.getFirstValue("b"));
+}
+
+TEST(FormReaderTest, RejectTooManyParameters)
+{
+	FormReader reader(new StringRepresentation("a=1&b=2&c=3"), 2, -1);
+	EXPECT_THROW(reader.addParameters(new Form()), std::runtime_error);
+}
+
+TEST(FormReaderTest, RejectTooLargeParameter)
+{
+	FormReader reader(new StringRepresentation("a=12345"), -1, 4);
+	EXPECT_THROW(reader.addParameters(new Form()), std::runtime_error);
+}
+
+TEST(FormReaderTest, InvalidEntityFormIsNotReadTwice)
+{
+	Request request = new Request(Method::POST, "http://localhost/");
+	request.setEntity(std::string(FormReader::DEFAULT_MAX_PARAMETER_SIZE + 1,
+	                              'a'), MediaType.APPLICATION_WWW_FORM);
+	EXPECT_EQ(null, request.getEntityAsForm());
+	EXPECT_EQ(null, request.getEntityAsForm());
+}
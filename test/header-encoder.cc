@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/header-encoder.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+using echo::engine::http::HeaderEncoder;
+
+/**
+ * Reads everything written to a pipe.
+ */
+static std::string readAll(int file)
+{
+	std::string result;
+	char buffer[4096];
+	ssize_t length;
+
+	while ((length = read(file, buffer, sizeof(buffer))) > 0) {
+		result.append(buffer, length);
+	}
+
+	return result;
+}
+
+TEST(HeaderEncoderTest, AddStripsLineBreaks)
+{
+	HeaderEncoder encoder(false);
+	encoder.add("X-Test", "a\r\nInjected: b");
+	encoder.end();
+	EXPECT_EQ("X-Test: a  Injected: b\r\n\r\n", encoder.getBuffer());
+
+	encoder.clear();
+	EXPECT_TRUE(encoder.getBuffer().empty());
+}
+
+TEST(HeaderEncoderTest, AddNumber)
+{
+	HeaderEncoder encoder(false);
+	encoder.addNumber("Content-Length", 1234567890123LL);
+	EXPECT_EQ("Content-Length: 1234567890123\r\n", encoder.getBuffer());
+}
+
+TEST(HeaderEncoderTest, WriteFewChunks)
+{
+	int files[2];
+	ASSERT_EQ(0, pipe(files));
+
+	HeaderEncoder encoder(false);
+	encoder.add("Server", "Echo");
+	encoder.end();
+
+	char first[] = "Hello, ";
+	char second[] = "world";
+	struct iovec chunks[2];
+	chunks[0].iov_base = first;
+	chunks[0].iov_len = sizeof(first) - 1;
+	chunks[1].iov_base = second;
+	chunks[1].iov_len = sizeof(second) - 1;
+
+	const std::string expected = encoder.getBuffer() + "Hello, world";
+	EXPECT_EQ((ssize_t) expected.size(), encoder.write(files[1], chunks, 2));
+	close(files[1]);
+	EXPECT_EQ(expected, readAll(files[0]));
+	close(files[0]);
+}
+
+TEST(HeaderEncoderTest, WriteMoreChunksThanVector)
+{
+	int files[2];
+	ASSERT_EQ(0, pipe(files));
+
+	HeaderEncoder encoder(false);
+	encoder.add("Server", "Echo");
+	encoder.end();
+
+	// More than twice the chunks given to a single writev() call
+	const int count = HeaderEncoder::MAX_CHUNKS * 2 + 7;
+	std::vector<std::string> texts;
+	std::vector<struct iovec> chunks(count);
+	std::string expected = encoder.getBuffer();
+
+	for (int i = 0; i < count; i++) {
+		texts.push_back(std::string(1 + i % 5, (char) ('a' + i % 26)));
+	}
+
+	for (int i = 0; i < count; i++) {
+		chunks[i].iov_base = const_cast<char*>(texts[i].data());
+		chunks[i].iov_len = texts[i].size();
+		expected += texts[i];
+	}
+
+	EXPECT_EQ((ssize_t) expected.size(),
+			encoder.write(files[1], &chunks[0], count));
+	close(files[1]);
+	EXPECT_EQ(expected, readAll(files[0]));
+	close(files[0]);
+}
+
+TEST(HeaderEncoderTest, WriteHeaderOnly)
+{
+	int files[2];
+	ASSERT_EQ(0, pipe(files));
+
+	HeaderEncoder encoder(true);
+	encoder.end();
+
+	EXPECT_EQ(2, encoder.write(files[1], NULL, 0));
+	close(files[1]);
+	EXPECT_EQ("\r\n", readAll(files[0]));
+	close(files[0]);
+}
+
+TEST(HeaderEncoderTest, AddRequestHeaders)
+{
+	Request request = new Request(Method::GET, "http://localhost/");
+	request.getClientInfo().getAcceptedEncodings().push_back(
+			new Preference<Encoding>(Encoding.GZIP));
+	request.getClientInfo().getAcceptedLanguages().push_back(
+			new Preference<Language>(Language.valueOf("fr"), 0.5F));
+	request.setCookieHeader("id=42");
+	ChallengeResponse challengeResponse = new ChallengeResponse(
+			ChallengeScheme.HTTP_BASIC);
+	challengeResponse.setRawValue("dXNlcjpwYXNz");
+	request.setChallengeResponse(challengeResponse);
+	std::list<Tag> tags;
+	tags.push_back(new Tag("v1", false));
+	request.getConditions().setNoneMatch(tags);
+
+	HeaderEncoder encoder(false);
+	encoder.addRequestHeaders(request);
+	const std::string& buffer = encoder.getBuffer();
+	EXPECT_NE(std::string::npos, buffer.find("Accept-Encoding: gzip\r\n"));
+	EXPECT_NE(std::string::npos,
+			buffer.find("Accept-Language: fr;q=0.5\r\n"));
+	EXPECT_NE(std::string::npos,
+			buffer.find("Authorization: Basic dXNlcjpwYXNz\r\n"));
+	EXPECT_NE(std::string::npos, buffer.find("Cookie: id=42\r\n"));
+	EXPECT_NE(std::string::npos, buffer.find("If-None-Match: \"v1\"\r\n"));
+	EXPECT_EQ(std::string::npos, buffer.find("If-Modified-Since"));
+}
+
+TEST(HeaderEncoderTest, AddCacheControlCombinations)
+{
+	HeaderEncoder encoder(false);
+	std::list<CacheDirective> directives;
+	directives.push_back(CacheDirective.noCache());
+	directives.push_back(CacheDirective.noStore());
+	directives.push_back(CacheDirective.mustRevalidate());
+	encoder.addCacheControl(directives);
+	EXPECT_EQ("Cache-Control: no-cache, no-store, must-revalidate\r\n",
+			encoder.getBuffer());
+
+	// Other orders and directives with a value are formatted as given
+	encoder.clear();
+	directives.clear();
+	directives.push_back(CacheDirective.noStore());
+	directives.push_back(CacheDirective.noCache());
+	encoder.addCacheControl(directives);
+	EXPECT_EQ("Cache-Control: no-store, no-cache\r\n", encoder.getBuffer());
+
+	encoder.clear();
+	directives.clear();
+	directives.push_back(CacheDirective.publicInfo());
+	directives.push_back(CacheDirective.maxAge(60));
+	encoder.addCacheControl(directives);
+	EXPECT_EQ("Cache-Control: public, max-age=60\r\n", encoder.getBuffer());
+}
+
+TEST(HeaderEncoderTest, AddContentTypeAgain)
+{
+	HeaderEncoder encoder(false);
+	encoder.addContentType(MediaType.TEXT_HTML, CharacterSet.UTF_8);
+	encoder.addContentType(MediaType.APPLICATION_JSON, null);
+	encoder.addContentType(MediaType.TEXT_HTML, CharacterSet.UTF_8);
+	encoder.addContentType(MediaType.TEXT_HTML, CharacterSet.ISO_8859_1);
+	EXPECT_EQ("Content-Type: text/html; charset=UTF-8\r\n"
+			"Content-Type: application/json\r\n"
+			"Content-Type: text/html; charset=UTF-8\r\n"
+			"Content-Type: text/html; charset=ISO-8859-1\r\n",
+			encoder.getBuffer());
+}
+
+TEST(HeaderEncoderTest, AddServerOfAnotherAgent)
+{
+	HeaderEncoder encoder(false);
+	ServerInfo serverInfo = new ServerInfo();
+	serverInfo.setAgent("Echo/1.0");
+	encoder.addServer(serverInfo);
+	encoder.addServer(serverInfo);
+	serverInfo.setAgent("Echo/2.0");
+	encoder.addServer(serverInfo);
+	EXPECT_EQ("Server: Echo/1.0\r\nServer: Echo/1.0\r\nServer: Echo/2.0\r\n",
+			encoder.getBuffer());
+}
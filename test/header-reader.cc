@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/header-reader.h>
+
+#include <string>
+#include <vector>
+
+using echo::engine::http::HeaderReader;
+
+TEST(HeaderReaderTest, SplitsElements)
+{
+	std::vector<std::string> elements;
+	HeaderReader::split(" gzip ,, deflate;q=0.5 ,\"a,b\", ", ',', elements);
+	ASSERT_EQ(3U, elements.size());
+	EXPECT_EQ("gzip", elements[0]);
+	EXPECT_EQ("deflate;q=0.5", elements[1]);
+	EXPECT_EQ("\"a,b\"", elements[2]);
+}
+
+TEST(HeaderReaderTest, KeepsEscapedQuotes)
+{
+	std::vector<std::string> elements;
+	HeaderReader::split("\"a\\\",b\", W/\"c\"", ',', elements);
+	ASSERT_EQ(2U, elements.size());
+	EXPECT_EQ("\"a\\\",b\"", elements[0]);
+	EXPECT_EQ("W/\"c\"", elements[1]);
+}
+
+TEST(HeaderReaderTest, SplitsParameters)
+{
+	std::string name;
+	std::string value;
+	EXPECT_TRUE(HeaderReader::splitParameter("Max-Age = 60", name, value));
+	EXPECT_EQ("Max-Age", name);
+	EXPECT_EQ("60", value);
+	EXPECT_TRUE(HeaderReader::splitParameter("realm=\"echo\"", name, value));
+	EXPECT_EQ("echo", value);
+	EXPECT_FALSE(HeaderReader::splitParameter("Secure", name, value));
+	EXPECT_EQ("Secure", name);
+	EXPECT_EQ("", value);
+}
+
+TEST(HeaderReaderTest, ReadsQualities)
+{
+	std::string metadata;
+	EXPECT_FLOAT_EQ(1, HeaderReader::getQuality("text/html", metadata));
+	EXPECT_EQ("text/html", metadata);
+	EXPECT_FLOAT_EQ(0.5, HeaderReader::getQuality(
+			"text/html; level=1; q=0.5; ext=1", metadata));
+	EXPECT_EQ("text/html;level=1", metadata);
+	EXPECT_FLOAT_EQ(0, HeaderReader::getQuality("gzip;q=2", metadata));
+	EXPECT_FLOAT_EQ(0, HeaderReader::getQuality("gzip;q=x", metadata));
+	EXPECT_EQ("gzip", metadata);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <echo/engine/component/host-index.h>
+
+using echo::engine::component::HostIndex;
+using echo::routing::Route;
+using echo::routing::VirtualHost;
+
+static Route addHost(HostIndex& index, std::string domain) {
+	VirtualHost host = new VirtualHost(null);
+	host.setHostDomain(domain);
+	Route route = new Route(host);
+	index.add(host, route);
+	return route;
+}
+
+static Request createRequest(std::string hostRef) {
+	Request request = new Request(Method::GET, "http://localhost/");
+	request.setHostRef(hostRef);
+	return request;
+}
+
+TEST(HostIndexTest, FindExactDomainIgnoringCase)
+{
+	HostIndex index;
+	Route route = addHost(index, "www.example.com");
+	EXPECT_EQ(route, index.find(createRequest("http://WWW.Example.com"),
+	                            new Response(null)));
+}
+
+TEST(HostIndexTest, DotsBetweenLabelsAreLiteral)
+{
+	std::string value;
+	EXPECT_TRUE(HostIndex::isLiteral("www.example.com", value));
+	EXPECT_EQ("www.example.com", value);
+	EXPECT_TRUE(HostIndex::isLiteral("www\\.example\\.com", value));
+	EXPECT_EQ("www.example.com", value);
+	EXPECT_FALSE(HostIndex::isLiteral(".example.com", value));
+	EXPECT_FALSE(HostIndex::isLiteral("www.*.com", value));
+	EXPECT_FALSE(HostIndex::isLiteral("www..com", value));
+}
+
+TEST(HostIndexTest, FindExactTierOnly)
+{
+	HostIndex index;
+	Route route = addHost(index, "www.example.com");
+	EXPECT_EQ(route, index.find(createRequest("http://www.example.com"),
+	                            new Response(null)));
+
+	// The regular expression tier would take the dot for any character
+	EXPECT_EQ(null, index.find(createRequest("http://wwwxexample.com"),
+	                           new Response(null)));
+}
+
+TEST(HostIndexTest, FindWildcardSuffix)
+{
+	HostIndex index;
+	Route route = addHost(index, ".*\\.example\\.com");
+	EXPECT_EQ(route, index.find(createRequest("http://a.b.example.com"),
+	                            new Response(null)));
+	EXPECT_EQ(null, index.find(createRequest("http://example.com"),
+	                           new Response(null)));
+}
+
+TEST(HostIndexTest, FindPatternIgnoringCase)
+{
+	HostIndex index;
+	Route route = addHost(index, "www\\.(example|sample)\\.com");
+	EXPECT_EQ(route, index.find(createRequest("http://WWW.Example.com"),
+	                            new Response(null)));
+}
+
+TEST(HostIndexTest, FindFirstAddedHost)
+{
+	HostIndex index;
+	Route first = addHost(index, "www\\.example\\..*");
+	addHost(index, "www.example.com");
+	EXPECT_EQ(first, index.find(createRequest("http://www.example.com"),
+	                            new Response(null)));
+}
+
+TEST(HostIndexTest, FindMatchAllWithoutHostRef)
+{
+	HostIndex index;
+	addHost(index, "www.example.com");
+	Route any = addHost(index, ".*");
+	Request request = new Request(Method::GET, "http://localhost/");
+	EXPECT_EQ(any, index.find(request, new Response(null)));
+}
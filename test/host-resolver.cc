@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/host-resolver.h>
+#include <echo/engine/io/event-loop.h>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tr1/memory>
+#include <vector>
+
+using echo::engine::http::HostResolver;
+using echo::engine::io::EventLoop;
+
+/**
+ * Resolver answering every query with the loopback address or a given
+ * error, counting the queries.
+ */
+class ScriptedResolver : public HostResolver {
+ public:
+	ScriptedResolver(long long positiveTtl, long long negativeTtl)
+	    : HostResolver(1, positiveTtl, negativeTtl), error(0), count(0) {
+		pthread_mutex_init(&lock, NULL);
+	}
+
+	~ScriptedResolver() {
+		pthread_mutex_destroy(&lock);
+	}
+
+	int getCount() {
+		pthread_mutex_lock(&lock);
+		const int result = count;
+		pthread_mutex_unlock(&lock);
+		return result;
+	}
+
+	void setError(int error) {
+		pthread_mutex_lock(&lock);
+		this->error = error;
+		pthread_mutex_unlock(&lock);
+	}
+
+ protected:
+	int query(const std::string& host, int port,
+			std::vector<Address>& addresses) {
+		pthread_mutex_lock(&lock);
+		const int result = error;
+		count++;
+		pthread_mutex_unlock(&lock);
+
+		if (result == 0) {
+			Address address;
+			struct sockaddr_in* ipv4 = (struct sockaddr_in*) &address.address;
+			memset(&address.address, 0, sizeof(address.address));
+			ipv4->sin_family = AF_INET;
+			ipv4->sin_port = htons(port);
+			ipv4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			address.length = sizeof(struct sockaddr_in);
+			addresses.push_back(address);
+		}
+
+		return result;
+	}
+
+ private:
+	pthread_mutex_t lock;
+	int error;
+	int count;
+};
+
+/**
+ * Listener recording the last resolution and stopping the loop.
+ */
+class RecordListener : public HostResolver::Listener {
+ public:
+	RecordListener(EventLoop* loop) : loop(loop), count(0), error(0) {
+	}
+
+	void onResolved(const std::vector<HostResolver::Address>& addresses,
+			int error) {
+		this->count = addresses.size();
+		this->error = error;
+		loop->stop();
+	}
+
+	EventLoop* loop;
+	size_t count;
+	int error;
+};
+
+/**
+ * Resolves "example.org" and runs the loop until notified.
+ */
+static void resolve(HostResolver& resolver, EventLoop& loop,
+		RecordListener& listener)
+{
+	const std::tr1::shared_ptr<HostResolver::Listener*> target(
+			new HostResolver::Listener*(&listener));
+	resolver.resolve(loop, "example.org", 80, target);
+	loop.run();
+}
+
+TEST(HostResolverTest, ResolveNumericAddressesWithoutQuery)
+{
+	EventLoop loop;
+	ScriptedResolver resolver(60000, 60000);
+	RecordListener listener(&loop);
+	const std::tr1::shared_ptr<HostResolver::Listener*> target(
+			new HostResolver::Listener*(&listener));
+	resolver.resolve(loop, "127.0.0.1", 80, target);
+	loop.run();
+	EXPECT_EQ(0, listener.error);
+	EXPECT_EQ(1U, listener.count);
+	EXPECT_EQ(0, resolver.getCount());
+}
+
+TEST(HostResolverTest, CacheAddressesUntilTheirTtl)
+{
+	EventLoop loop;
+	ScriptedResolver resolver(200, 60000);
+	RecordListener listener(&loop);
+	resolve(resolver, loop, listener);
+	EXPECT_EQ(1U, listener.count);
+	EXPECT_EQ(1, resolver.getCount());
+
+	resolve(resolver, loop, listener);
+	EXPECT_EQ(1U, listener.count);
+	EXPECT_EQ(1, resolver.getCount());
+
+	// The stale addresses are served while the failed refresh runs
+	usleep(300000);
+	resolver.setError(EAI_NONAME);
+	resolve(resolver, loop, listener);
+	EXPECT_EQ(0, listener.error);
+	EXPECT_EQ(1U, listener.count);
+
+	for (int i = 0; (i < 200) && (listener.error == 0); i++) {
+		usleep(5000);
+		resolve(resolver, loop, listener);
+	}
+
+	// The failure then replaces them, with a single query
+	EXPECT_EQ(EAI_NONAME, listener.error);
+	EXPECT_EQ(0U, listener.count);
+	EXPECT_EQ(2, resolver.getCount());
+}
+
+TEST(HostResolverTest, CacheFailuresUntilTheirTtl)
+{
+	EventLoop loop;
+	ScriptedResolver resolver(60000, 200);
+	RecordListener listener(&loop);
+	resolver.setError(EAI_NONAME);
+	resolve(resolver, loop, listener);
+	EXPECT_EQ(EAI_NONAME, listener.error);
+	EXPECT_EQ(1, resolver.getCount());
+
+	resolver.setError(0);
+	resolve(resolver, loop, listener);
+	EXPECT_EQ(EAI_NONAME, listener.error);
+	EXPECT_EQ(1, resolver.getCount());
+
+	// An expired failure isn't served, the lookup waits for the query
+	usleep(300000);
+	resolve(resolver, loop, listener);
+	EXPECT_EQ(0, listener.error);
+	EXPECT_EQ(1U, listener.count);
+	EXPECT_EQ(2, resolver.getCount());
+}
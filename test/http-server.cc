@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/http-server.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+using echo::engine::http::HttpServer;
+
+/**
+ * Application keeping the last request it handled.
+ */
+class CaptureApplication : public echo::Application {
+ public:
+	CaptureApplication() {
+		echo::Application(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		this->request = request;
+		response.setEntity("ok", MediaType.TEXT_PLAIN);
+	}
+
+	echo::Request request;
+};
+
+/**
+ * Sends a request to a local port and returns the whole response.
+ */
+static std::string call(int port, const std::string& message) {
+	const int file = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(port);
+	EXPECT_EQ(0, connect(file, (struct sockaddr*) &address,
+			sizeof(address)));
+	EXPECT_EQ((ssize_t) message.size(),
+			write(file, message.data(), message.size()));
+
+	std::string result;
+	char buffer[4096];
+	ssize_t length;
+
+	while ((length = read(file, buffer, sizeof(buffer))) > 0) {
+		result.append(buffer, length);
+	}
+
+	close(file);
+	return result;
+}
+
+TEST(HttpServerTest, MapsRequestHeaders)
+{
+	CaptureApplication application = new CaptureApplication();
+	HttpServer server = new HttpServer(null, 0, application);
+	server.setShards(1);
+	server.start();
+
+	const std::string response = call(server.getPort(),
+			"GET /page HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"Cookie: id=42\r\n"
+			"Cookie: lang=fr\r\n"
+			"Authorization: Basic dXNlcjpwYXNz\r\n"
+			"Accept: text/html, text/plain;q=0.5\r\n"
+			"Accept-Encoding: gzip\r\n"
+			"If-None-Match: \"v1\", W/\"v2\"\r\n"
+			"If-Modified-Since: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+			"Connection: close\r\n\r\n");
+	server.stop();
+
+	EXPECT_EQ(0U, response.find("HTTP/1.1 200"));
+	echo::Request request = application.request;
+	EXPECT_EQ("42", request.getCookieValue("id"));
+	EXPECT_EQ("fr", request.getCookieValue("lang"));
+	EXPECT_EQ(ChallengeScheme.HTTP_BASIC,
+			request.getChallengeResponse().getScheme());
+	EXPECT_EQ("dXNlcjpwYXNz", request.getChallengeResponse().getRawValue());
+	ASSERT_EQ(2U, request.getClientInfo().getAcceptedMediaTypes().size());
+	EXPECT_FLOAT_EQ(0.5F, request.getClientInfo().getAcceptedMediaTypes()
+			.back().getQuality());
+	EXPECT_EQ(Encoding.GZIP, request.getClientInfo().getAcceptedEncodings()
+			.front().getMetadata());
+	EXPECT_EQ(2U, request.getConditions().getNoneMatch().size());
+	EXPECT_EQ(784111777000L,
+			request.getConditions().getModifiedSince().getTime());
+}
+
+TEST(HttpServerTest, IgnoresInvalidConditions)
+{
+	CaptureApplication application = new CaptureApplication();
+	HttpServer server = new HttpServer(null, 0, application);
+	server.setShards(1);
+	server.start();
+
+	call(server.getPort(), "GET / HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"If-Modified-Since: yesterday\r\n"
+			"Connection: close\r\n\r\n");
+	server.stop();
+
+	EXPECT_EQ(null, application.request.getConditions().getModifiedSince());
+	EXPECT_EQ(null, application.request.getChallengeResponse());
+}
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include <echo/engine/io/epoll-engine.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/file-source.h>
+#include <echo/engine/io/io-engine.h>
+#include <echo/engine/io/transfer.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+using echo::engine::io::EpollEngine;
+using echo::engine::io::EventLoop;
+using echo::engine::io::FileSource;
+using echo::engine::io::IoEngine;
+using echo::engine::io::Transfer;
+
+/**
+ * Completion recording the bytes read, stopping the loop once the expected
+ * number of reads completed.
+ */
+class RecordCompletion : public IoEngine::Completion {
+ public:
+	RecordCompletion(EventLoop* loop, int* remaining) : loop(loop),
+	    remaining(remaining), result(0), onLoop(false) {
+	}
+
+	void onComplete(const char* data, ssize_t result) {
+		this->result = result;
+		this->onLoop = (EventLoop::getCurrent() == loop);
+
+		if (result > 0) {
+			text.assign(data, result);
+		}
+
+		if (--*remaining == 0) {
+			loop->stop();
+		}
+	}
+
+	EventLoop* loop;
+	int* remaining;
+	ssize_t result;
+	bool onLoop;
+	std::string text;
+};
+
+/**
+ * Listener stopping the loop once the transfer is complete.
+ */
+class StopListener : public Transfer::Listener {
+ public:
+	StopListener(EventLoop* loop) : loop(loop), success(false) {
+	}
+
+	void onComplete(Transfer* transfer, bool success) {
+		this->success = success;
+		loop->stop();
+	}
+
+	EventLoop* loop;
+	bool success;
+};
+
+/**
+ * Handler ignoring the readiness of its descriptors.
+ */
+class IdleHandler : public EventLoop::Handler {
+ public:
+	void onReady(int file, int events) {
+	}
+};
+
+/**
+ * Temporary file holding a given text, removed when destroyed.
+ */
+struct TemporaryFile {
+	TemporaryFile(const std::string& text) {
+		char name[] = "/tmp/echo-io-engine-XXXXXX";
+		file = mkstemp(name);
+		path = name;
+		EXPECT_EQ((ssize_t) text.size(), write(file, text.data(),
+				text.size()));
+	}
+
+	~TemporaryFile() {
+		close(file);
+		unlink(path.c_str());
+	}
+
+	int file;
+	std::string path;
+};
+
+static std::string sample(size_t size)
+{
+	std::string result;
+
+	for (size_t i = 0; i < size; i++) {
+		result += (char) ('a' + i % 26);
+	}
+
+	return result;
+}
+
+static void* collect(void* argument)
+{
+	std::pair<int, std::string>* collector =
+			static_cast<std::pair<int, std::string>*>(argument);
+	char buffer[4096];
+	ssize_t length;
+
+	while ((length = read(collector->first, buffer, sizeof(buffer))) > 0) {
+		collector->second.append(buffer, length);
+	}
+
+	return NULL;
+}
+
+TEST(IoEngineTest, CreateFallsBackToEpoll)
+{
+	EventLoop loop;
+	IoEngine* engine = IoEngine::create(loop, "epoll");
+	EXPECT_EQ("epoll", engine->getName());
+	EXPECT_EQ(&loop, &engine->getLoop());
+	delete engine;
+
+	// io_uring when compiled in and allowed by the kernel
+	engine = IoEngine::create(loop, "auto");
+	EXPECT_TRUE((engine->getName() == "epoll")
+			|| (engine->getName() == "io_uring"));
+	delete engine;
+}
+
+TEST(IoEngineTest, EpollReadsOffLoop)
+{
+	const std::string text = sample(100000);
+	TemporaryFile file(text);
+	EventLoop loop;
+	EpollEngine engine(loop);
+	const int handle = engine.registerFile(file.file);
+
+	int remaining = 3;
+	RecordCompletion first(&loop, &remaining);
+	RecordCompletion second(&loop, &remaining);
+	RecordCompletion last(&loop, &remaining);
+	ASSERT_TRUE(engine.read(handle, 0, 100, &first));
+	ASSERT_TRUE(engine.read(handle, 99950, 100, &second));
+	ASSERT_TRUE(engine.read(handle, 200000, 100, &last));
+	engine.submit();
+	loop.run();
+	engine.unregisterFile(handle);
+
+	// The completions are delivered on the loop thread
+	EXPECT_EQ(text.substr(0, 100), first.text);
+	EXPECT_TRUE(first.onLoop);
+	EXPECT_EQ(50, second.result);
+	EXPECT_EQ(text.substr(99950), second.text);
+	EXPECT_TRUE(second.onLoop);
+	EXPECT_EQ(0, last.result);
+}
+
+TEST(IoEngineTest, EpollReportsReadErrors)
+{
+	EventLoop loop;
+	EpollEngine engine(loop);
+	int remaining = 1;
+	RecordCompletion completion(&loop, &remaining);
+	ASSERT_TRUE(engine.read(-1, 0, 100, &completion));
+	engine.submit();
+	loop.run();
+	EXPECT_EQ(-EBADF, completion.result);
+}
+
+TEST(IoEngineTest, EpollLeavesWatchedSocketsToTheirHandler)
+{
+	EventLoop loop;
+	EpollEngine engine(loop);
+	int files[2];
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, files));
+	const std::string text = sample(4096);
+
+	while (write(files[0], text.data(), text.size()) > 0) {
+	}
+
+	// The handler watching the full socket retries the write itself
+	IdleHandler handler;
+	ASSERT_TRUE(loop.add(files[0], EventLoop::READABLE, &handler));
+	struct iovec vector;
+	vector.iov_base = const_cast<char*>(text.data());
+	vector.iov_len = text.size();
+	int remaining = 1;
+	RecordCompletion completion(&loop, &remaining);
+	ASSERT_TRUE(engine.write(files[0], &vector, 1, &completion));
+	engine.submit();
+	loop.run();
+	EXPECT_EQ(-EAGAIN, completion.result);
+
+	loop.remove(files[0]);
+	close(files[0]);
+	close(files[1]);
+}
+
+TEST(IoEngineTest, TransferFileSource)
+{
+	const std::string text = sample(IoEngine::BUFFER_SIZE * 5 + 123);
+	TemporaryFile file(text);
+	EventLoop loop;
+	IoEngine* engine = IoEngine::create(loop, "auto");
+
+	int files[2];
+	ASSERT_EQ(0, pipe2(files, O_NONBLOCK));
+	fcntl(files[0], F_SETFL, 0);
+	std::pair<int, std::string> collector(files[0], "");
+	pthread_t consumer;
+	pthread_create(&consumer, NULL, collect, &collector);
+
+	FileSource* source = new FileSource(*engine, file.path);
+	StopListener listener(&loop);
+	Transfer* transfer = new Transfer(loop, source, files[1],
+			Transfer::DEFAULT_HIGH_WATER_MARK);
+	transfer->start(&listener);
+	loop.run();
+
+	delete transfer;
+	delete source;
+	close(files[1]);
+	pthread_join(consumer, NULL);
+	close(files[0]);
+	delete engine;
+
+	EXPECT_TRUE(listener.success);
+	EXPECT_EQ(text, collector.second);
+}
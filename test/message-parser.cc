@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/util/chunk-buffer.h>
+
+#include <string>
+
+using echo::engine::http::MessageParser;
+using echo::engine::util::ChunkBuffer;
+
+/**
+ * Decodes a body fed in pieces of a given size, returning the number of
+ * bytes consumed or -1.
+ */
+static ssize_t parseBody(MessageParser& parser, const std::string& data,
+		size_t piece, std::string& content)
+{
+	ChunkBuffer output;
+	size_t consumed = 0;
+
+	while ((consumed < data.size()) && !parser.isBodyDone()) {
+		const size_t length = (data.size() - consumed < piece)
+				? data.size() - consumed : piece;
+		const ssize_t count = parser.parseBody(data.data() + consumed, length,
+				output);
+
+		if (count < 0) {
+			return -1;
+		}
+
+		consumed += count;
+	}
+
+	output.toString(content);
+	return consumed;
+}
+
+TEST(MessageParserTest, ParseHeadIncrementally)
+{
+	const std::string head = "GET /path?query HTTP/1.1\r\nHost: example.org"
+			"\r\nAccept:  text/html \r\n\r\n";
+	MessageParser parser(MessageParser::REQUEST);
+
+	// The head is only parsed once its empty line is received
+	for (size_t length = 0; length < head.size(); length++) {
+		ASSERT_EQ(0, parser.parseHead(head.data(), length));
+	}
+
+	ASSERT_EQ((ssize_t) head.size(), parser.parseHead(head.data(),
+			head.size()));
+	EXPECT_TRUE(parser.getMethod().equalsIgnoreCase("GET"));
+	EXPECT_EQ("/path?query", parser.getTarget().toString());
+	EXPECT_EQ(1, parser.getMinorVersion());
+	ASSERT_EQ(2U, parser.getHeaders().size());
+	EXPECT_EQ("example.org", parser.getHeader("host")->value.toString());
+	EXPECT_EQ("text/html", parser.getHeader("Accept")->value.toString());
+	EXPECT_TRUE(parser.isKeepAlive());
+}
+
+TEST(MessageParserTest, ParsePipelinedHeads)
+{
+	const std::string first = "GET /first HTTP/1.1\r\nHost: a\r\n\r\n";
+	const std::string second = "POST /second HTTP/1.1\r\nHost: a\r\n"
+			"Content-Length: 5\r\nConnection: close\r\n\r\nhello";
+	const std::string input = first + second;
+	MessageParser parser(MessageParser::REQUEST);
+
+	// Each head ends where the next message starts
+	ASSERT_EQ((ssize_t) first.size(), parser.parseHead(input.data(),
+			input.size()));
+	parser.startBody(false);
+	EXPECT_TRUE(parser.isBodyDone());
+	EXPECT_EQ("/first", parser.getTarget().toString());
+
+	parser.reset();
+	const std::string rest = input.substr(first.size());
+	const ssize_t size = parser.parseHead(rest.data(), rest.size());
+	ASSERT_EQ((ssize_t) (second.size() - 5), size);
+	EXPECT_EQ("/second", parser.getTarget().toString());
+	EXPECT_EQ(5, parser.getContentLength());
+	EXPECT_FALSE(parser.isKeepAlive());
+
+	std::string content;
+	parser.startBody(false);
+	EXPECT_EQ(5, parseBody(parser, rest.substr(size), 2, content));
+	EXPECT_TRUE(parser.isBodyDone());
+	EXPECT_EQ("hello", content);
+}
+
+TEST(MessageParserTest, DecodeChunkedBodies)
+{
+	const std::string head = "PUT /upload HTTP/1.1\r\nHost: a\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n";
+	const std::string body = "4\r\nWiki\r\n5;name=value\r\npedia\r\n"
+			"E\r\n in\r\n\r\nchunks.\r\n0\r\nExpires: never\r\n\r\n";
+	const std::string next = "GET /next HTTP/1.1\r\n\r\n";
+	MessageParser parser(MessageParser::REQUEST);
+	ASSERT_EQ((ssize_t) head.size(), parser.parseHead(head.data(),
+			head.size()));
+	EXPECT_TRUE(parser.isChunked());
+
+	// Any split of the framing decodes the same content
+	for (size_t piece = 1; piece <= body.size(); piece += 7) {
+		std::string content;
+		parser.startBody(false);
+		EXPECT_EQ((ssize_t) body.size(), parseBody(parser, body + next,
+				piece, content));
+		EXPECT_TRUE(parser.isBodyDone());
+		EXPECT_EQ("Wikipedia in\r\n\r\nchunks.", content);
+	}
+
+	std::string content;
+	parser.startBody(false);
+	EXPECT_EQ(-1, parseBody(parser, "4\r\nWikiX\r\n0\r\n\r\n", 64,
+			content));
+	parser.startBody(false);
+	EXPECT_EQ(-1, parseBody(parser, "zz\r\n", 64, content));
+}
+
+TEST(MessageParserTest, RejectContentLengthWithChunked)
+{
+	const std::string smuggled = "POST / HTTP/1.1\r\nHost: a\r\n"
+			"Content-Length: 4\r\nTransfer-Encoding: chunked\r\n\r\n";
+	MessageParser request(MessageParser::REQUEST);
+	EXPECT_EQ(-1, request.parseHead(smuggled.data(), smuggled.size()));
+
+	// A response is still read, the chunked coding taking precedence
+	const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: 4\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n";
+	MessageParser parser(MessageParser::RESPONSE);
+	ASSERT_EQ((ssize_t) response.size(), parser.parseHead(response.data(),
+			response.size()));
+	EXPECT_EQ(200, parser.getStatus());
+	EXPECT_TRUE(parser.isChunked());
+	EXPECT_EQ(-1, parser.getContentLength());
+
+	// Conflicting lengths and unknown codings of a request are rejected too
+	const std::string lengths = "POST / HTTP/1.1\r\nContent-Length: 4\r\n"
+			"Content-Length: 5\r\n\r\n";
+	request.reset();
+	EXPECT_EQ(-1, request.parseHead(lengths.data(), lengths.size()));
+	const std::string coding = "POST / HTTP/1.1\r\n"
+			"Transfer-Encoding: gzip\r\n\r\n";
+	request.reset();
+	EXPECT_EQ(-1, request.parseHead(coding.data(), coding.size()));
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/multipart-reader.h>
+
+#include <unistd.h>
+
+#include <stdexcept>
+
+using echo::engine::util::MultipartReader;
+
+static Representation createEntity(const std::string& content) {
+	return new StringRepresentation(content,
+	    MediaType.valueOf("multipart/form-data; boundary=XyZ"));
+}
+
+TEST(MultipartReaderTest, ReadPartsWithDefaultLimits)
+{
+	MultipartReader reader(createEntity(
+	    "preamble\r\n--XyZ\r\n"
+	    "Content-Disposition: form-data; name=\"a\"\r\n\r\n"
+	    "1\r\n--XyZ\r\n"
+	    "Content-Disposition: form-data; name=\"f\"; filename=\"f.txt\"\r\n"
+	    "Content-Type: text/plain\r\n\r\n"
+	    "file\r\ncontent\r\n--XyZ--\r\n"));
+	MultipartReader::Part part;
+
+	ASSERT_TRUE(reader.readNextPart(part));
+	EXPECT_EQ("a", part.getName());
+	EXPECT_EQ("1", std::string(part.getData(), part.getSize()));
+
+	ASSERT_TRUE(reader.readNextPart(part));
+	EXPECT_EQ("f", part.getName());
+	EXPECT_EQ("f.txt", part.getFileName());
+	EXPECT_EQ("text/plain", part.getMediaType());
+	EXPECT_EQ("file\r\ncontent", std::string(part.getData(), part.getSize()));
+
+	EXPECT_FALSE(reader.readNextPart(part));
+}
+
+TEST(MultipartReaderTest, SpillLargePartToDeletedFile)
+{
+	const std::string content(1000, 'x');
+	std::string path;
+	{
+		MultipartReader reader(createEntity(
+		    "--XyZ\r\n\r\n" + content + "\r\n--XyZ\r\n\r\nb\r\n--XyZ--"),
+		    "XyZ", 100, -1, "/tmp");
+		MultipartReader::Part part;
+
+		ASSERT_TRUE(reader.readNextPart(part));
+		EXPECT_FALSE(part.isInMemory());
+		EXPECT_EQ(content.size(), part.getSize());
+		path = part.getFilePath();
+		EXPECT_EQ(0, access(path.c_str(), F_OK));
+
+		// The next part deletes the file nobody claimed
+		ASSERT_TRUE(reader.readNextPart(part));
+		EXPECT_TRUE(part.isInMemory());
+		EXPECT_NE(0, access(path.c_str(), F_OK));
+	}
+}
+
+TEST(MultipartReaderTest, KeepReleasedFile)
+{
+	std::string path;
+	{
+		MultipartReader reader(createEntity(
+		    "--XyZ\r\n\r\n" + std::string(1000, 'x') + "\r\n--XyZ--"),
+		    "XyZ", 100, -1, "/tmp");
+		MultipartReader::Part part;
+		ASSERT_TRUE(reader.readNextPart(part));
+		path = part.releaseFile();
+	}
+	EXPECT_EQ(0, access(path.c_str(), F_OK));
+	unlink(path.c_str());
+}
+
+TEST(MultipartReaderTest, RejectTruncatedEntity)
+{
+	MultipartReader reader(createEntity("--XyZ\r\n\r\nnever closed"));
+	MultipartReader::Part part;
+	EXPECT_THROW(reader.readNextPart(part), std::runtime_error);
+}
+
+TEST(MultipartReaderTest, RejectTooManyParts)
+{
+	MultipartReader reader(createEntity(
+	    "--XyZ\r\n\r\na\r\n--XyZ\r\n\r\nb\r\n--XyZ--"), "XyZ", 100, 1, "/tmp");
+	MultipartReader::Part part;
+	ASSERT_TRUE(reader.readNextPart(part));
+	EXPECT_THROW(reader.readNextPart(part), std::runtime_error);
+}
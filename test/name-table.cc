@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/intern-table.h>
+#include <echo/engine/util/name-table.h>
+
+#include <stdio.h>
+
+using echo::engine::util::InternTable;
+using echo::engine::util::NameTable;
+
+TEST(NameTableTest, FindNamesIgnoringCase)
+{
+	static const int values[] = { 1, 2, 3, 4, 5 };
+	static const char* names[] = { "GET", "POST", "PUT", "DELETE", "HEAD" };
+	NameTable<int> table;
+
+	for (int i = 0; i < 5; i++) {
+		table.add(names[i], &values[i]);
+	}
+
+	table.build();
+
+	for (int i = 0; i < 5; i++) {
+		EXPECT_EQ(&values[i], table.find(names[i]));
+	}
+
+	EXPECT_EQ(&values[1], table.find("post"));
+	EXPECT_EQ(NULL, table.find("PATCH"));
+	EXPECT_EQ(NULL, table.find("POS"));
+	EXPECT_EQ(NULL, table.find(""));
+}
+
+TEST(NameTableTest, FindManyNames)
+{
+	static int values[200];
+	char name[16];
+	NameTable<int> table;
+
+	for (int i = 0; i < 200; i++) {
+		snprintf(name, sizeof(name), "name-%d", i);
+		table.add(name, &values[i]);
+	}
+
+	table.build();
+
+	for (int i = 0; i < 200; i++) {
+		snprintf(name, sizeof(name), "NAME-%d", i);
+		EXPECT_EQ(&values[i], table.find(name));
+	}
+}
+
+TEST(NameTableTest, EmptyTableFindsNothing)
+{
+	NameTable<int> table;
+	EXPECT_EQ(NULL, table.find("GET"));
+}
+
+TEST(NameTableTest, RejectDuplicatesIgnoringCase)
+{
+	static const int values[] = { 1, 2, 3 };
+	NameTable<int> table;
+
+	EXPECT_TRUE(table.add("utf-8", &values[0]));
+	EXPECT_FALSE(table.add("UTF-8", &values[1]));
+	EXPECT_TRUE(table.add("utf-16", &values[2]));
+
+	table.build();
+
+	EXPECT_EQ(&values[0], table.find("Utf-8"));
+	EXPECT_EQ(&values[2], table.find("UTF-16"));
+}
+
+TEST(InternTableTest, InternUpToTheCapacity)
+{
+	InternTable<int> table(2);
+	int value = 0;
+
+	EXPECT_EQ(1, table.put("a", 1));
+	EXPECT_EQ(1, table.put("a", 3));
+	EXPECT_EQ(2, table.put("b", 2));
+	EXPECT_EQ(4, table.put("c", 4));
+	EXPECT_TRUE(table.get("a", value));
+	EXPECT_EQ(1, value);
+	EXPECT_FALSE(table.get("c", value));
+	EXPECT_FALSE(table.get("A", value));
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <echo/engine/util/pattern.h>
+
+using echo::engine::util::Pattern;
+
+TEST(PatternTest, ScanCommonFormats)
+{
+	Pattern digits = Pattern::compile("\\d+");
+	EXPECT_EQ(Pattern::KIND_SCANNER, digits.getKind());
+	EXPECT_TRUE(digits.matches("2024"));
+	EXPECT_FALSE(digits.matches(""));
+	EXPECT_FALSE(digits.matches("20a4"));
+
+	Pattern identifier = Pattern::compile("[a-zA-Z0-9]{1,4}");
+	EXPECT_TRUE(identifier.matches("ab12"));
+	EXPECT_FALSE(identifier.matches("ab123"));
+}
+
+TEST(PatternTest, RunAlternationsWithTheAutomaton)
+{
+	Pattern pattern = Pattern::compile("(foo|bar)+-\\w*");
+	EXPECT_EQ(Pattern::KIND_AUTOMATON, pattern.getKind());
+	EXPECT_TRUE(pattern.matches("foobar-x_1"));
+	EXPECT_FALSE(pattern.matches("foobaz-x"));
+}
+
+TEST(PatternTest, MatchWholeValues)
+{
+	Pattern pattern = Pattern::compile("a|ab");
+	EXPECT_TRUE(pattern.matches("ab"));
+	EXPECT_FALSE(pattern.matches("abc"));
+}
+
+TEST(PatternTest, RejectNamedEscapesInsteadOfPosix)
+{
+	EXPECT_FALSE(Pattern::compile("\\bword\\b").isValid());
+	EXPECT_FALSE(Pattern::compile("\\x41").isValid());
+	EXPECT_FALSE(Pattern::compile("\\Qa.b\\E").isValid());
+	EXPECT_FALSE(Pattern::compile("\\bword\\b").matches("bwordb"));
+}
+
+TEST(PatternTest, RejectSyntaxPosixWouldMisread)
+{
+	// Possessive: never matches in Java, "aaa" in POSIX
+	Pattern possessive = Pattern::compile("a++a");
+	EXPECT_FALSE(possessive.isValid());
+	EXPECT_FALSE(possessive.matches("aaa"));
+
+	// A plain set in Java, the alpha class in POSIX
+	Pattern bracket = Pattern::compile("[[:alpha:]]+");
+	EXPECT_FALSE(bracket.isValid());
+	EXPECT_FALSE(bracket.matches("abc"));
+
+	EXPECT_FALSE(Pattern::compile("a{,3}").isValid());
+}
+
+TEST(PatternTest, RunLargeRepetitionsWithPosix)
+{
+	Pattern pattern = Pattern::compile("(ab|cd){1,5000}");
+	EXPECT_EQ(Pattern::KIND_POSIX, pattern.getKind());
+	EXPECT_TRUE(pattern.matches("abcdab"));
+	EXPECT_FALSE(pattern.matches("abc"));
+}
+
+TEST(PatternTest, InvalidPatternMatchesNothing)
+{
+	Pattern pattern = Pattern::compile("(a");
+	EXPECT_FALSE(pattern.isValid());
+	EXPECT_FALSE(pattern.matches("a"));
+	EXPECT_FALSE(Pattern().matches(""));
+}
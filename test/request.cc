@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+#include <echo/request.h>
+
+TEST(RequestTest, QueryFormIsParsedOnce)
+{
+	Request request = new Request(Method::GET, "http://localhost/?a=1&b=2");
+	Form form = request.getQueryAsForm();
+	EXPECT_EQ("1", form.getFirstValue("a"));
+	EXPECT_EQ("2", form.getFirstValue("b"));
+	EXPECT_EQ(form, request.getQueryAsForm());
+}
+
+TEST(RequestTest, QueryFormFollowsTheResourceReference)
+{
+	Request request = new Request(Method::GET, "http://localhost/?a=1");
+	Form form = request.getQueryAsForm();
+	request.setResourceRef("http://localhost/?a=2");
+	EXPECT_NE(form, request.getQueryAsForm());
+	EXPECT_EQ("2", request.getQueryAsForm().getFirstValue("a"));
+}
+
+TEST(RequestTest, QueryFormWithoutResourceReference)
+{
+	Request request = new Request();
+	EXPECT_EQ(null, request.getQueryAsForm());
+}
+
+TEST(RequestTest, EntityFormFollowsTheEntity)
+{
+	Request request = new Request(Method::POST, "http://localhost/");
+	request.setEntity("a=1", MediaType.APPLICATION_WWW_FORM);
+	EXPECT_EQ("1", request.getEntityAsForm().getFirstValue("a"));
+	request.setEntity("a=2", MediaType.APPLICATION_WWW_FORM);
+	EXPECT_EQ("2", request.getEntityAsForm().getFirstValue("a"));
+}
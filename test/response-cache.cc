@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <echo/engine/application/response-cache.h>
+
+#include <time.h>
+
+#include <string>
+
+using echo::engine::application::CachedResponse;
+using echo::engine::application::ResponseCache;
+using echo::representation::SharedRepresentation;
+
+/**
+ * Creates a cached response whose entity has a given size.
+ */
+static ResponseCache::Entry createEntry(size_t size, int lifetime) {
+	Response response = new Response(null);
+	response.setEntity(new StringRepresentation(std::string(size, 'x'),
+			MediaType.TEXT_PLAIN));
+	return ResponseCache::Entry(new CachedResponse(response,
+			SharedRepresentation::Content(new std::string(size, 'x')),
+			time(NULL), lifetime));
+}
+
+TEST(ResponseCacheTest, GetFreshVariants)
+{
+	ResponseCache cache;
+	const time_t now = time(NULL);
+	int variance = -1;
+
+	EXPECT_FALSE(cache.getVariance("/a", variance));
+	cache.put("/a", 0, "/a", createEntry(10, 60));
+	EXPECT_TRUE(cache.getVariance("/a", variance));
+	EXPECT_EQ(0, variance);
+	EXPECT_TRUE(cache.get("/a", "/a", now));
+
+	// A stale variant is removed when looked up
+	cache.put("/b", 0, "/b", createEntry(10, 0));
+	EXPECT_FALSE(cache.get("/b", "/b", now));
+	EXPECT_FALSE(cache.getVariance("/b", variance));
+}
+
+TEST(ResponseCacheTest, ChangeOfVarianceDropsTheVariants)
+{
+	ResponseCache cache;
+	const time_t now = time(NULL);
+	int variance = 0;
+
+	cache.put("/a", 1 << LANGUAGE, "/a\nfr", createEntry(10, 60));
+	cache.put("/a", 1 << LANGUAGE, "/a\nen", createEntry(10, 60));
+	EXPECT_TRUE(cache.get("/a", "/a\nfr", now));
+
+	cache.put("/a", 1 << ENCODING, "/a\ngzip", createEntry(10, 60));
+	EXPECT_TRUE(cache.getVariance("/a", variance));
+	EXPECT_EQ(1 << ENCODING, variance);
+	EXPECT_FALSE(cache.get("/a", "/a\nfr", now));
+	EXPECT_FALSE(cache.get("/a", "/a\nen", now));
+	EXPECT_TRUE(cache.get("/a", "/a\ngzip", now));
+
+	cache.remove("/a");
+	EXPECT_FALSE(cache.getVariance("/a", variance));
+	EXPECT_EQ(0U, cache.getSize());
+}
+
+TEST(ResponseCacheTest, EvictLeastRecentlyUsedVariants)
+{
+	const size_t size = createEntry(100, 60)->getSize();
+
+	// Each shard holds three variants, all of them stored in the same shard
+	ResponseCache cache(ResponseCache::SHARDS * size * 3);
+	const time_t now = time(NULL);
+
+	cache.put("/a", 1 << LANGUAGE, "/a\n1", createEntry(100, 60));
+	cache.put("/a", 1 << LANGUAGE, "/a\n2", createEntry(100, 60));
+	cache.put("/a", 1 << LANGUAGE, "/a\n3", createEntry(100, 60));
+	EXPECT_EQ(size * 3, cache.getSize());
+
+	// The first variant becomes the most recently used one
+	EXPECT_TRUE(cache.get("/a", "/a\n1", now));
+	cache.put("/a", 1 << LANGUAGE, "/a\n4", createEntry(100, 60));
+	EXPECT_EQ(size * 3, cache.getSize());
+	EXPECT_TRUE(cache.get("/a", "/a\n1", now));
+	EXPECT_FALSE(cache.get("/a", "/a\n2", now));
+	EXPECT_TRUE(cache.get("/a", "/a\n3", now));
+	EXPECT_TRUE(cache.get("/a", "/a\n4", now));
+
+	// A response larger than a shard isn't stored
+	cache.put("/b", 0, "/b", createEntry(size * 3, 60));
+	EXPECT_FALSE(cache.get("/b", "/b", now));
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <echo/engine/component/riap-client.h>
+
+#include <stdexcept>
+
+using echo::engine::component::RiapClient;
+
+/**
+ * Echo changing the thread-local state of the caller, then answering or
+ * throwing.
+ */
+class StateEcho : public echo::Echo {
+ public:
+	StateEcho(bool throwing) : throwing(throwing) {
+		echo::Echo(null);
+	}
+
+	void handle(echo::Request request, echo::Response response) {
+		echo::Context::setCurrent(new echo::Context());
+		echo::Response::setCurrent(response);
+
+		if (throwing) {
+			throw std::runtime_error("failed");
+		}
+
+		response.setEntity("internal", MediaType.TEXT_PLAIN);
+	}
+
+ private:
+	bool throwing;
+};
+
+static RiapClient createClient(bool throwing) {
+	RiapClient client = new RiapClient(null);
+	client.setComponentRoot(new StateEcho(throwing));
+	return client;
+}
+
+TEST(RiapClientTest, DispatchesToTheRoot)
+{
+	Response response = new Response(null);
+	createClient(false).handle(new Request(Method::GET,
+			"riap://component/resource"), response);
+	EXPECT_EQ("internal", response.getEntityAsText());
+	EXPECT_EQ(Protocol::RIAP, response.getRequest().getProtocol());
+}
+
+TEST(RiapClientTest, AnswersNotFoundWithoutTarget)
+{
+	Response response = new Response(null);
+	createClient(false).handle(new Request(Method::GET,
+			"riap://host/resource"), response);
+	EXPECT_EQ(Status.CLIENT_ERROR_NOT_FOUND, response.getStatus());
+}
+
+TEST(RiapClientTest, RestoresTheCurrentState)
+{
+	echo::Context context = new echo::Context();
+	echo::Context::setCurrent(context);
+	echo::Response::setCurrent(null);
+
+	for (int i = 0; i < 2; i++) {
+		Response response = new Response(null);
+
+		try {
+			createClient(i == 1).handle(new Request(Method::GET,
+					"riap://component/resource"), response);
+		} catch (const std::runtime_error&) {
+		}
+
+		EXPECT_EQ(context, echo::Context::getCurrent());
+		EXPECT_EQ(null, echo::Response::getCurrent());
+	}
+}
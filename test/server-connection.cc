@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/message-parser.h>
+#include <echo/engine/http/server-connection.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/util/chunk-buffer.h>
+#include <echo/engine/util/chunk-stream.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <string>
+
+using echo::engine::http::MessageParser;
+using echo::engine::http::ServerConnection;
+using echo::engine::io::EventLoop;
+using echo::engine::util::ChunkBuffer;
+using echo::engine::util::ChunkStream;
+
+/**
+ * Listener answering each request with its target and body, except for
+ * "/stream" whose entity is streamed from a chunk stream.
+ */
+class EchoListener : public ServerConnection::Listener {
+ public:
+	EchoListener() : connection(NULL) {
+	}
+
+	void onClosed(ServerConnection* connection) {
+		delete connection;
+		this->connection = NULL;
+	}
+
+	void onRequest(ServerConnection* connection, const MessageParser& head,
+			ChunkBuffer& body) {
+		const std::string target = head.getTarget().toString();
+
+		if (target == "/stream") {
+			connection->respond("HTTP/1.1 200 OK\r\n"
+					"Transfer-Encoding: chunked\r\n\r\n", stream, true, false);
+			return;
+		}
+
+		std::string content;
+		body.toString(content);
+		content = target + ":" + content;
+		char response[64];
+		snprintf(response, sizeof(response),
+				"HTTP/1.1 200 OK\r\nContent-Length: %u\r\n\r\n",
+				(unsigned) content.size());
+		struct iovec vector;
+		vector.iov_base = const_cast<char*>(content.data());
+		vector.iov_len = content.size();
+		connection->respond(response, &vector, 1, false);
+	}
+
+	void onResponded(ServerConnection* connection) {
+	}
+
+	ServerConnection* connection;
+	ChunkStream stream;
+};
+
+/**
+ * Connection on one end of a socket pair, driven by a loop thread, the
+ * test being the client on the other end.
+ */
+class Session {
+ public:
+	Session(size_t maxEntitySize) {
+		int files[2];
+		socketpair(AF_UNIX, SOCK_STREAM, 0, files);
+		fcntl(files[0], F_SETFL, O_NONBLOCK);
+		client = files[1];
+
+		// A missing response fails the test instead of blocking it
+		struct timeval timeout = { 2, 0 };
+		setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+				sizeof(timeout));
+		listener.connection = new ServerConnection(loop, files[0], 5000,
+				5000, maxEntitySize, &listener);
+		listener.connection->open();
+		pthread_create(&thread, NULL, run, this);
+	}
+
+	~Session() {
+		loop.stop();
+		pthread_join(thread, NULL);
+		delete listener.connection;
+		close(client);
+	}
+
+	void send(const std::string& data) {
+		EXPECT_EQ((ssize_t) data.size(), write(client, data.data(),
+				data.size()));
+	}
+
+	/**
+	 * Reads the next response, returning its status and decoded content,
+	 * or an empty string once the connection is closed.
+	 */
+	std::string receive() {
+		MessageParser parser(MessageParser::RESPONSE);
+		ChunkBuffer content;
+		ssize_t size = 0;
+
+		while ((size = parser.parseHead(input.data(), input.size())) == 0) {
+			if (!fill()) {
+				return std::string();
+			}
+		}
+
+		if (size < 0) {
+			return "malformed";
+		}
+
+		char status[8];
+		snprintf(status, sizeof(status), "%d ", parser.getStatus());
+		parser.startBody(parser.getStatus() < 200);
+		input.erase(0, size);
+
+		while (!parser.isBodyDone()) {
+			const ssize_t count = parser.parseBody(input.data(), input.size(),
+					content);
+
+			if (count < 0) {
+				return "malformed";
+			}
+
+			input.erase(0, count);
+
+			if (!parser.isBodyDone() && !fill()) {
+				return "truncated";
+			}
+		}
+
+		std::string text;
+		content.toString(text);
+		return status + text;
+	}
+
+	/**
+	 * Indicates if the server closed the connection.
+	 */
+	bool isClosed() {
+		return input.empty() && !fill();
+	}
+
+	EchoListener listener;
+
+ private:
+	static void* run(void* session) {
+		static_cast<Session*>(session)->loop.run();
+		return NULL;
+	}
+
+	bool fill() {
+		char buffer[4096];
+		const ssize_t count = read(client, buffer, sizeof(buffer));
+
+		if (count <= 0) {
+			return false;
+		}
+
+		input.append(buffer, count);
+		return true;
+	}
+
+	EventLoop loop;
+	pthread_t thread;
+	int client;
+	std::string input;
+};
+
+TEST(ServerConnectionTest, KeepConnectionsAlive)
+{
+	Session session(1024);
+	session.send("GET /first HTTP/1.1\r\nHost: a\r\n\r\n");
+	EXPECT_EQ("200 /first:", session.receive());
+	session.send("POST /second HTTP/1.1\r\nHost: a\r\n"
+			"Content-Length: 4\r\n\r\nbody");
+	EXPECT_EQ("200 /second:body", session.receive());
+
+	// HTTP/1.0 closes unless asked otherwise
+	session.send("GET /last HTTP/1.0\r\n\r\n");
+	EXPECT_EQ("200 /last:", session.receive());
+	EXPECT_TRUE(session.isClosed());
+}
+
+TEST(ServerConnectionTest, AnswerPipelinedRequestsInOrder)
+{
+	Session session(1024);
+	session.send("GET /a HTTP/1.1\r\n\r\nPOST /b HTTP/1.1\r\n"
+			"Content-Length: 3\r\n\r\nbodGET /c HTTP/1.1\r\n"
+			"Connection: close\r\n\r\n");
+	EXPECT_EQ("200 /a:", session.receive());
+	EXPECT_EQ("200 /b:bod", session.receive());
+	EXPECT_EQ("200 /c:", session.receive());
+	EXPECT_TRUE(session.isClosed());
+}
+
+TEST(ServerConnectionTest, RejectMalformedHeads)
+{
+	Session session(1024);
+	session.send("GET /ok HTTP/1.1\r\n\r\nNONSENSE\r\n\r\n");
+	EXPECT_EQ("200 /ok:", session.receive());
+	EXPECT_EQ("400 ", session.receive());
+	EXPECT_TRUE(session.isClosed());
+}
+
+TEST(ServerConnectionTest, RejectLargeEntities)
+{
+	Session session(16);
+	session.send("POST /upload HTTP/1.1\r\nContent-Length: 17\r\n\r\n");
+	EXPECT_EQ("413 ", session.receive());
+	EXPECT_TRUE(session.isClosed());
+
+	// A chunked body is rejected once it grows past the limit
+	Session chunked(16);
+	chunked.send("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+			"\r\n10\r\n0123456789abcdef\r\n1\r\nX\r\n0\r\n\r\n");
+	EXPECT_EQ("413 ", chunked.receive());
+	EXPECT_TRUE(chunked.isClosed());
+}
+
+TEST(ServerConnectionTest, ContinueExpectingRequests)
+{
+	Session session(1024);
+	session.send("POST /upload HTTP/1.1\r\nContent-Length: 5\r\n"
+			"Expect: 100-continue\r\n\r\n");
+
+	// The body is only sent once the client is told to go on
+	EXPECT_EQ("100 ", session.receive());
+	session.send("hello");
+	EXPECT_EQ("200 /upload:hello", session.receive());
+}
+
+TEST(ServerConnectionTest, StreamChunkedResponses)
+{
+	Session session(1024);
+	ChunkBuffer first;
+	first.append("streamed ");
+	session.listener.stream.offer(first, true);
+	session.send("GET /stream HTTP/1.1\r\n\r\nGET /next HTTP/1.1\r\n\r\n");
+
+	// The connection waits for the rest of the stream before going on
+	usleep(50000);
+	ChunkBuffer last;
+	last.append("content");
+	session.listener.stream.offer(last, true);
+	session.listener.stream.close();
+	EXPECT_EQ("200 streamed content", session.receive());
+	EXPECT_EQ("200 /next:", session.receive());
+}
@@ -0,0 +1,21 @@
+#include <gtest/gtest.h>
+#include <echo/engine/session/session-filter.h>
+
+using echo::engine::session::SessionFilter;
+using echo::engine::session::SessionStore;
+
+TEST(SessionFilterTest, SharesTheStoreOfTheContext)
+{
+	echo::Context context = new echo::Context();
+	SessionFilter first(context, null);
+	SessionFilter second(context, null);
+	EXPECT_EQ(first.getStore(), second.getStore());
+	EXPECT_EQ(first.getStore(), SessionStore::getStore(context));
+}
+
+TEST(SessionFilterTest, OwnsTheStoreWithoutContext)
+{
+	SessionFilter first(null, null);
+	SessionFilter second(null, null);
+	EXPECT_NE(first.getStore(), second.getStore());
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <echo/engine/session/session-store.h>
+
+#include <unistd.h>
+
+using echo::engine::session::SessionStore;
+
+TEST(SessionStoreTest, CreateAndGetSession)
+{
+	SessionStore store;
+	const std::string id = store.create("user", "data");
+	std::string identifier;
+	std::string data;
+
+	ASSERT_TRUE(store.get(id, identifier, data));
+	EXPECT_EQ("user", identifier);
+	EXPECT_EQ("data", data);
+	EXPECT_EQ(1, store.getSize());
+	EXPECT_NE(id, store.create("", ""));
+}
+
+TEST(SessionStoreTest, UpdateAndRemoveSession)
+{
+	SessionStore store;
+	const std::string id = store.create("", "a");
+	std::string identifier;
+	std::string data;
+
+	ASSERT_TRUE(store.update(id, "b"));
+	ASSERT_TRUE(store.get(id, identifier, data));
+	EXPECT_EQ("b", data);
+	ASSERT_TRUE(store.remove(id));
+	EXPECT_FALSE(store.get(id, identifier, data));
+	EXPECT_FALSE(store.update(id, "c"));
+}
+
+TEST(SessionStoreTest, EvictLeastRecentlyUsedSessions)
+{
+	SessionStore store(SessionStore::SHARDS, 3600);
+
+	for (int i = 0; i < SessionStore::SHARDS * 4; i++) {
+		store.create("", "");
+	}
+
+	EXPECT_LE(store.getSize(), SessionStore::SHARDS);
+}
+
+TEST(SessionStoreTest, SaveAndLoadSnapshot)
+{
+	char path[] = "/tmp/echo-sessions-XXXXXX";
+	close(mkstemp(path));
+	std::string id;
+	{
+		SessionStore store;
+		id = store.create("user", "data");
+		ASSERT_TRUE(store.save(path));
+	}
+
+	SessionStore store;
+	std::string identifier;
+	std::string data;
+	ASSERT_TRUE(store.load(path));
+	ASSERT_TRUE(store.get(id, identifier, data));
+	EXPECT_EQ("user", identifier);
+	EXPECT_EQ("data", data);
+	unlink(path);
+}
+
+TEST(SessionStoreTest, LoadMissingSnapshot)
+{
+	SessionStore store;
+	EXPECT_FALSE(store.load("/tmp/echo-no-such-snapshot"));
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <echo/engine/http/status-table.h>
+
+#include <string.h>
+
+using echo::engine::http::StatusTable;
+
+TEST(StatusTableTest, FindWellKnownCodes)
+{
+	const StatusTable::Entry* entry = StatusTable::find(404);
+	ASSERT_TRUE(entry != NULL);
+	EXPECT_EQ(404, entry->code);
+	EXPECT_STREQ("Not Found", entry->reason);
+	EXPECT_EQ(strlen(entry->httpLine), entry->httpLength);
+	EXPECT_EQ(strlen(entry->cgiLine), entry->cgiLength);
+	EXPECT_TRUE(StatusTable::find(200) != NULL);
+	EXPECT_TRUE(StatusTable::find(298) == NULL);
+	EXPECT_TRUE(StatusTable::find(99) == NULL);
+	EXPECT_TRUE(StatusTable::find(1000) != NULL);
+	EXPECT_TRUE(StatusTable::find(1100) == NULL);
+	EXPECT_TRUE(StatusTable::find(-1) == NULL);
+}
+
+TEST(StatusTableTest, AppendStandardLines)
+{
+	std::string buffer("x");
+	StatusTable::appendHttpLine(buffer, 200, "");
+	EXPECT_EQ("xHTTP/1.1 200 OK\r\n", buffer);
+
+	buffer.clear();
+	StatusTable::appendCgiLine(buffer, 404, "");
+	EXPECT_EQ("Status: 404 Not Found\r\n", buffer);
+}
+
+TEST(StatusTableTest, AppendCustomLines)
+{
+	std::string buffer;
+	StatusTable::appendHttpLine(buffer, 200, "Fine");
+	EXPECT_EQ("HTTP/1.1 200 Fine\r\n", buffer);
+
+	buffer.clear();
+	StatusTable::appendHttpLine(buffer, 298, "");
+	EXPECT_EQ(0u, buffer.find("HTTP/1.1 298"));
+	EXPECT_EQ(buffer.size() - 2, buffer.find("\r\n"));
+}
@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+#include <echo/engine/io/deflating-source.h>
+#include <echo/engine/io/descriptor-source.h>
+#include <echo/engine/io/event-loop.h>
+#include <echo/engine/io/push-source.h>
+#include <echo/engine/io/transfer.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string>
+
+using echo::engine::io::DeflatingSource;
+using echo::engine::io::DescriptorSource;
+using echo::engine::io::EventLoop;
+using echo::engine::io::PushSource;
+using echo::engine::io::Transfer;
+
+/**
+ * Listener stopping the loop once the transfer is complete.
+ */
+class StopListener : public Transfer::Listener {
+ public:
+	StopListener(EventLoop* loop) : loop(loop), completed(false),
+	    success(false) {
+	}
+
+	void onComplete(Transfer* transfer, bool success) {
+		this->completed = true;
+		this->success = success;
+		loop->stop();
+	}
+
+	EventLoop* loop;
+	bool completed;
+	bool success;
+};
+
+/**
+ * Producer pushing a text in small pieces from another thread.
+ */
+struct Pusher {
+	PushSource* source;
+	std::string text;
+};
+
+static void* push(void* argument)
+{
+	Pusher* pusher = static_cast<Pusher*>(argument);
+
+	for (size_t i = 0; i < pusher->text.size(); i += 1000) {
+		pusher->source->offer(pusher->text.data() + i,
+				std::min((size_t) 1000, pusher->text.size() - i));
+	}
+
+	pusher->source->end();
+	return NULL;
+}
+
+/**
+ * Reader collecting everything written to a pipe.
+ */
+struct Collector {
+	int file;
+	std::string text;
+};
+
+static void* collect(void* argument)
+{
+	Collector* collector = static_cast<Collector*>(argument);
+	char buffer[4096];
+	ssize_t length;
+
+	while ((length = read(collector->file, buffer, sizeof(buffer))) > 0) {
+		collector->text.append(buffer, length);
+	}
+
+	return NULL;
+}
+
+/**
+ * Inflates gzip data, complete or flushed.
+ */
+static std::string inflate(const std::string& input, bool end)
+{
+	z_stream stream = z_stream();
+	EXPECT_EQ(Z_OK, inflateInit2(&stream, 31));
+	stream.next_in = (Bytef*) input.data();
+	stream.avail_in = input.size();
+
+	std::string result;
+	char buffer[4096];
+	int status;
+
+	do {
+		stream.next_out = (Bytef*) buffer;
+		stream.avail_out = sizeof(buffer);
+		status = ::inflate(&stream, Z_SYNC_FLUSH);
+		result.append(buffer, sizeof(buffer) - stream.avail_out);
+	} while ((status == Z_OK) && (stream.avail_in > 0));
+
+	EXPECT_EQ(end ? Z_STREAM_END : Z_OK, status);
+	inflateEnd(&stream);
+	return result;
+}
+
+static std::string sample(size_t size)
+{
+	std::string result;
+
+	for (size_t i = 0; i < size; i++) {
+		result += (char) ('a' + i % 26);
+	}
+
+	return result;
+}
+
+TEST(TransferTest, PushSourceReads)
+{
+	EventLoop loop;
+	PushSource source(loop);
+	char buffer[16];
+
+	errno = 0;
+	EXPECT_EQ(-1, source.read(buffer, sizeof(buffer)));
+	EXPECT_EQ(EAGAIN, errno);
+
+	EXPECT_TRUE(source.offer("hello", 5));
+	EXPECT_EQ(5U, source.getSize());
+	EXPECT_EQ(5, source.read(buffer, sizeof(buffer)));
+	EXPECT_EQ("hello", std::string(buffer, 5));
+
+	source.end();
+	EXPECT_FALSE(source.offer("late", 4));
+	EXPECT_EQ(0, source.read(buffer, sizeof(buffer)));
+}
+
+TEST(TransferTest, MovePushSourceToPipe)
+{
+	EventLoop loop;
+	PushSource source(loop);
+	int files[2];
+	ASSERT_EQ(0, pipe2(files, O_NONBLOCK));
+	fcntl(files[0], F_SETFL, 0);
+
+	// More than the pipe capacity, so that the transfer waits for writability
+	Pusher pusher = { &source, sample(300000) };
+	Collector collector = { files[0], "" };
+	pthread_t producer;
+	pthread_t consumer;
+	pthread_create(&consumer, NULL, collect, &collector);
+	pthread_create(&producer, NULL, push, &pusher);
+
+	StopListener listener(&loop);
+	Transfer transfer(loop, &source, files[1], 64 * 1024);
+	transfer.start(&listener);
+	loop.run();
+
+	pthread_join(producer, NULL);
+	close(files[1]);
+	pthread_join(consumer, NULL);
+	close(files[0]);
+
+	EXPECT_TRUE(listener.completed);
+	EXPECT_TRUE(listener.success);
+	EXPECT_EQ((long long) pusher.text.size(), transfer.getTransferred());
+	EXPECT_EQ(pusher.text, collector.text);
+}
+
+TEST(TransferTest, MoveDescriptorSourceToPipe)
+{
+	EventLoop loop;
+	int input[2];
+	int output[2];
+	ASSERT_EQ(0, pipe2(input, O_NONBLOCK));
+	ASSERT_EQ(0, pipe2(output, O_NONBLOCK));
+	fcntl(output[0], F_SETFL, 0);
+
+	const std::string text = sample(10000);
+	ASSERT_EQ((ssize_t) text.size(), write(input[1], text.data(),
+			text.size()));
+	close(input[1]);
+
+	Collector collector = { output[0], "" };
+	pthread_t consumer;
+	pthread_create(&consumer, NULL, collect, &collector);
+
+	DescriptorSource source(loop, input[0], true);
+	StopListener listener(&loop);
+	Transfer transfer(loop, &source, output[1],
+			Transfer::DEFAULT_HIGH_WATER_MARK);
+	transfer.start(&listener);
+	loop.run();
+
+	close(output[1]);
+	pthread_join(consumer, NULL);
+	close(output[0]);
+
+	EXPECT_TRUE(listener.success);
+	EXPECT_EQ(text, collector.text);
+}
+
+TEST(TransferTest, DeflatingSourceFlushesWhileWaiting)
+{
+	EventLoop loop;
+	PushSource pushed(loop);
+	DeflatingSource source(&pushed, true, 6);
+	const std::string text = sample(5000);
+	char buffer[65536];
+	std::string compressed;
+
+	errno = 0;
+	EXPECT_EQ(-1, source.read(buffer, sizeof(buffer)));
+	EXPECT_EQ(EAGAIN, errno);
+
+	// What was pushed so far decodes before the end
+	pushed.offer(text.data(), 1000);
+	ssize_t count;
+
+	while ((count = source.read(buffer, sizeof(buffer))) > 0) {
+		compressed.append(buffer, count);
+	}
+
+	EXPECT_EQ(-1, count);
+	EXPECT_EQ(EAGAIN, errno);
+	EXPECT_EQ(text.substr(0, 1000), inflate(compressed, false));
+
+	pushed.offer(text.data() + 1000, text.size() - 1000);
+	pushed.end();
+
+	while ((count = source.read(buffer, 10)) > 0) {
+		compressed.append(buffer, count);
+	}
+
+	EXPECT_EQ(0, count);
+	EXPECT_EQ(text, inflate(compressed, true));
+}
+
+TEST(TransferTest, MoveDeflatingSourceToPipe)
+{
+	EventLoop loop;
+	int input[2];
+	int output[2];
+	ASSERT_EQ(0, pipe2(input, O_NONBLOCK));
+	ASSERT_EQ(0, pipe2(output, O_NONBLOCK));
+	fcntl(output[0], F_SETFL, 0);
+
+	const std::string text = sample(50000);
+	ASSERT_EQ((ssize_t) text.size(), write(input[1], text.data(),
+			text.size()));
+	close(input[1]);
+
+	Collector collector = { output[0], "" };
+	pthread_t consumer;
+	pthread_create(&consumer, NULL, collect, &collector);
+
+	DescriptorSource descriptor(loop, input[0], true);
+	DeflatingSource source(&descriptor, true, 6);
+	StopListener listener(&loop);
+	Transfer transfer(loop, &source, output[1],
+			Transfer::DEFAULT_HIGH_WATER_MARK);
+	transfer.start(&listener);
+	loop.run();
+
+	close(output[1]);
+	pthread_join(consumer, NULL);
+	close(output[0]);
+
+	EXPECT_TRUE(listener.success);
+	EXPECT_LT(collector.text.size(), text.size());
+	EXPECT_EQ(text, inflate(collector.text, true));
+}
@@ -0,0 +1,75 @@
+/*
+ * Build step packing a directory of static assets for AssetPack.
+ *
+ *   echo-pack <directory> <output.pak>
+ *       writes a pack file, mapped at runtime by the "zip" references such
+ *       as "zip:file:///usr/share/app/assets.pak!/index.html";
+ *
+ *   echo-pack --source [--name <name>] <directory> <output.cc>
+ *       writes a C++ source file embedding the pack into the binary, which
+ *       registers it under <name>, by default the empty name backing the
+ *       "clap" references such as "clap://class/index.html".
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <fstream>
+#include <string>
+
+#include <echo/engine/util/asset-pack-writer.h>
+
+using echo::engine::util::AssetPackWriter;
+
+static int usage() {
+  fprintf(stderr, "usage: echo-pack [--source [--name <name>]] "
+          "<directory> <output>\n");
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  bool source = false;
+  std::string name;
+  int i = 1;
+
+  for (; (i < argc) && (strncmp(argv[i], "--", 2) == 0); i++) {
+    if (strcmp(argv[i], "--source") == 0) {
+      source = true;
+    } else if ((strcmp(argv[i], "--name") == 0) && (i + 1 < argc)) {
+      name = argv[++i];
+    } else {
+      return usage();
+    }
+  }
+
+  if (argc - i != 2) {
+    return usage();
+  }
+
+  AssetPackWriter writer;
+
+  if (!writer.addDirectory(argv[i])) {
+    fprintf(stderr, "echo-pack: can't read %s\n", argv[i]);
+    return 1;
+  }
+
+  std::string output;
+
+  if (source) {
+    writer.writeSource(name, output);
+  } else {
+    writer.write(output);
+  }
+
+  std::ofstream file(argv[i + 1], std::ios::out | std::ios::binary
+                     | std::ios::trunc);
+  file.write(output.data(), output.size());
+  file.close();
+
+  if (!file) {
+    fprintf(stderr, "echo-pack: can't write %s\n", argv[i + 1]);
+    return 1;
+  }
+
+  return 0;
+}